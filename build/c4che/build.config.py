@@ -1,2 +1,2 @@
 version = 0x1071000
-tools = [{'tool': 'relocation', 'tooldir': ['waf-tools'], 'funs': None}, {'tool': 'ar', 'tooldir': None, 'funs': None}, {'tool': 'c', 'tooldir': None, 'funs': None}, {'tool': 'gcc', 'tooldir': None, 'funs': None}, {'tool': 'compiler_c', 'tooldir': None, 'funs': None}, {'tool': 'cxx', 'tooldir': None, 'funs': None}, {'tool': 'g++', 'tooldir': None, 'funs': None}, {'tool': 'compiler_cxx', 'tooldir': None, 'funs': None}, {'tool': 'cflags', 'tooldir': ['waf-tools'], 'funs': None}, {'tool': 'command', 'tooldir': ['waf-tools'], 'funs': None}, {'tool': 'gnu_dirs', 'tooldir': None, 'funs': None}, {'tool': 'misc', 'tooldir': ['waf-tools'], 'funs': None}, {'tool': 'python', 'tooldir': None, 'funs': None}, {'tool': 'boost', 'tooldir': None, 'funs': None}]
+tools = [{'tool': 'relocation', 'tooldir': ['waf-tools'], 'funs': None}, {'tool': 'ar', 'tooldir': None, 'funs': None}, {'tool': 'c', 'tooldir': None, 'funs': None}, {'tool': 'gcc', 'tooldir': None, 'funs': None}, {'tool': 'compiler_c', 'tooldir': None, 'funs': None}, {'tool': 'cxx', 'tooldir': None, 'funs': None}, {'tool': 'g++', 'tooldir': None, 'funs': None}, {'tool': 'compiler_cxx', 'tooldir': None, 'funs': None}, {'tool': 'cflags', 'tooldir': ['waf-tools'], 'funs': None}, {'tool': 'command', 'tooldir': ['waf-tools'], 'funs': None}, {'tool': 'gnu_dirs', 'tooldir': None, 'funs': None}, {'tool': 'boost', 'tooldir': None, 'funs': None}]
@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#ifndef CACHED_PROPAGATION_LOSS_MODEL_H
+#define CACHED_PROPAGATION_LOSS_MODEL_H
+
+#include <vector>
+#include "ns3/vector.h"
+#include "propagation-loss-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Reuse the results of a costly model while the nodes stay in the
+ * same place.
+ *
+ * Space is divided in cubic cells of "CellSize" meters, and the received
+ * power computed by the "Model" for a transmitter in a cell and a
+ * receiver in another, at a given transmission power, is reused for any
+ * later transmission between the same cells, until it is evicted. The
+ * error is thus bounded by the change of the loss over a cell, which the
+ * cell size trades for the hit rate: with nodes moving a few centimeters
+ * between broadcasts, most of the N^2 calls of a broadcast round become
+ * lookups.
+ *
+ * Unlike PropagationCache, which keeps an object per pair of nodes
+ * forever, the entries are keyed on positions, not nodes, and at most
+ * "Capacity" of them are kept, in a hash table whose slots are recycled
+ * in CLOCK order, an approximation of least recently used that costs a
+ * bit per entry. No memory is allocated once the table is full.
+ *
+ * Caching only makes sense for models whose result depends on the
+ * positions only: the draws of a random model, such as the fading of
+ * the JakesPropagationLossModel, would be frozen.
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  CachedPropagationLossModel ();
+  virtual ~CachedPropagationLossModel ();
+
+  /**
+   * \param model the model whose results are cached, along with the
+   *        models chained to it
+   */
+  void SetModel (Ptr<PropagationLossModel> model);
+  /**
+   * \return the model whose results are cached
+   */
+  Ptr<PropagationLossModel> GetModel (void) const;
+  /**
+   * Forget every cached result, as needed after the cached model changed
+   */
+  void Clear (void);
+  /**
+   * \return the number of results found in the cache
+   */
+  uint64_t GetHits (void) const;
+  /**
+   * \return the number of results computed by the cached model
+   */
+  uint64_t GetMisses (void) const;
+
+private:
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   */
+  CachedPropagationLossModel (const CachedPropagationLossModel &);
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   * \returns
+   */
+  CachedPropagationLossModel & operator = (const CachedPropagationLossModel &);
+
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual double DoGetMaxRange (double lossDb) const;
+  virtual double DoGetMaxGain (void) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  /** A cached result */
+  struct Entry
+  {
+    int64_t cells[6];    //!< cells of the transmitter, then of the receiver
+    double txPowerDbm;   //!< transmission power
+    double rxPowerDbm;   //!< received power
+    uint32_t next;       //!< next entry of the same bucket, or NONE
+    bool referenced;     //!< whether the entry was used since the clock hand last passed
+  };
+
+  /**
+   * \param key the cells of the transmitter and of the receiver
+   * \param txPowerDbm the transmission power
+   * \return the bucket of the key
+   */
+  uint32_t Hash (const int64_t key[6], double txPowerDbm) const;
+  /**
+   * \return the slot of the entry to replace
+   */
+  uint32_t Evict (void) const;
+
+  Ptr<PropagationLossModel> m_model; //!< the cached model
+  double m_cellSize; //!< side of the cells
+  uint32_t m_capacity; //!< maximum number of entries
+
+  mutable std::vector<Entry> m_entries; //!< the entries, in clock order
+  mutable std::vector<uint32_t> m_buckets; //!< first entry of each bucket, or NONE
+  mutable uint32_t m_hand; //!< next slot examined by the clock hand
+  mutable double m_cellSizeUsed; //!< cell size of the cached entries
+  mutable uint32_t m_capacityUsed; //!< capacity of the table
+  mutable uint64_t m_hits; //!< number of hits
+  mutable uint64_t m_misses; //!< number of misses
+};
+
+} // namespace ns3
+
+#endif /* CACHED_PROPAGATION_LOSS_MODEL_H */
@@ -3,10 +3,6 @@
 #ifndef W_NS3_CONFIG_STORE_CONFIG_H_WAF
 #define W_NS3_CONFIG_STORE_CONFIG_H_WAF
 
-#define PYTHONDIR "/usr/local/lib/python2.7/dist-packages"
-#define PYTHONARCHDIR "/usr/local/lib/python2.7/dist-packages"
-#define HAVE_PYTHON_H 1
-#define HAVE_GTK2 1
 #define HAVE_LIBXML2 1
 
 #endif /* W_NS3_CONFIG_STORE_CONFIG_H_WAF */
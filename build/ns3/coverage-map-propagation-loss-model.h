@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#ifndef COVERAGE_MAP_PROPAGATION_LOSS_MODEL_H
+#define COVERAGE_MAP_PROPAGATION_LOSS_MODEL_H
+
+#include <string>
+#include "ns3/propagation-loss-model.h"
+#include "ns3/coverage-map.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup buildings
+ * \brief Path loss looked up in a precomputed CoverageMap.
+ *
+ * One end of the link must stand at a transmitter of the map, within
+ * "Tolerance" along each axis, and the other end inside the grid; the
+ * loss is then interpolated trilinearly between the 8 grid points
+ * around it, assuming the loss is reciprocal when the transmitter of
+ * the map is the receiver of the link. The other links are handed to
+ * the "Fallback" model, and abort the simulation if there is none.
+ */
+class CoverageMapPropagationLossModel : public PropagationLossModel
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  CoverageMapPropagationLossModel ();
+  virtual ~CoverageMapPropagationLossModel ();
+
+  /**
+   * \param filename the coverage map file to map
+   */
+  void SetFilename (std::string filename);
+  /**
+   * \param map a coverage map, possibly shared with other models
+   */
+  void SetCoverageMap (Ptr<CoverageMap> map);
+  /**
+   * \return the coverage map, or 0
+   */
+  Ptr<CoverageMap> GetCoverageMap (void) const;
+
+private:
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+  /**
+   * \param position a position
+   * \return the index of the transmitter at the position, or -1
+   */
+  int32_t FindTransmitter (const Vector &position) const;
+
+  Ptr<CoverageMap> m_map; //!< the map looked up
+  double m_tolerance; //!< largest distance to a transmitter
+  Ptr<PropagationLossModel> m_fallback; //!< model of the other links, or 0
+  mutable int32_t m_lastTransmitter; //!< transmitter found last, or -1
+};
+
+} // namespace ns3
+
+#endif /* COVERAGE_MAP_PROPAGATION_LOSS_MODEL_H */
@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#ifndef COVERAGE_MAP_H
+#define COVERAGE_MAP_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "ns3/simple-ref-count.h"
+#include "ns3/vector.h"
+#include "ns3/box.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup buildings
+ * \brief A file of path losses precomputed on a 3D grid, mapped in memory.
+ *
+ * The file holds, for each of a set of fixed transmitters, the path loss
+ * in dB from the transmitter to every point of a regular grid spanning a
+ * Box, with the same step along the three axes. It is filled once by
+ * CoverageMapHelper, and then mapped read-only by every run using it, so
+ * that a loss costs a trilinear interpolation between the 8 grid points
+ * around the receiver.
+ *
+ * The layout, in the byte order of the host, is:
+ *  - a header: the 8 bytes "ns3covm", a uint32_t version, the uint32_t
+ *    number T of transmitters, the uint32_t number of points nx, ny and
+ *    nz along each axis, then the doubles xMin, yMin, zMin of the first
+ *    point and the step between points;
+ *  - the positions of the T transmitters, as 3 doubles each;
+ *  - the losses, as floats, for each transmitter, then z, y and x, x
+ *    varying the fastest.
+ */
+class CoverageMap : public SimpleRefCount<CoverageMap>
+{
+public:
+  /**
+   * Map a file in memory. Aborts the simulation if the file cannot be
+   * read, or was not written by Allocate.
+   * \param filename the file to map
+   * \param writable whether the losses are to be written through GetLayer
+   */
+  CoverageMap (std::string filename, bool writable = false);
+  ~CoverageMap ();
+
+  /**
+   * \return the number of transmitters in the file
+   */
+  uint32_t GetNTransmitters (void) const;
+  /**
+   * \param transmitter the index of a transmitter
+   * \return the position of the transmitter
+   */
+  Vector GetTransmitter (uint32_t transmitter) const;
+  /**
+   * \param position a position
+   * \param tolerance the largest distance along each axis to a
+   *        transmitter, in meters
+   * \return the index of the transmitter at the position, or -1
+   */
+  int32_t FindTransmitter (const Vector &position, double tolerance) const;
+  /**
+   * \return the box spanned by the grid
+   */
+  Box GetBounds (void) const;
+  /**
+   * \return the step between the points of the grid, in meters
+   */
+  double GetResolution (void) const;
+  /**
+   * \return the number of points of the grid along the x axis
+   */
+  uint32_t GetNx (void) const;
+  /**
+   * \return the number of points of the grid along the y axis
+   */
+  uint32_t GetNy (void) const;
+  /**
+   * \return the number of points of the grid along the z axis
+   */
+  uint32_t GetNz (void) const;
+  /**
+   * \param i the index along the x axis
+   * \param j the index along the y axis
+   * \param k the index along the z axis
+   * \return the position of the point
+   */
+  Vector GetPoint (uint32_t i, uint32_t j, uint32_t k) const;
+
+  /**
+   * \param transmitter the index of a transmitter
+   * \param position the position of the receiver
+   * \param loss the interpolated loss, in dB
+   * \return false if the position is out of the bounds of the grid
+   */
+  bool GetLoss (uint32_t transmitter, const Vector &position, double &loss) const;
+  /**
+   * \param transmitter the index of a transmitter
+   * \param k the index along the z axis
+   * \return the nx * ny losses of the horizontal layer, y major, to write
+   *         them; the map must be writable
+   */
+  float * GetLayer (uint32_t transmitter, uint32_t k);
+
+  /**
+   * Create a file for the losses of a set of transmitters over a grid,
+   * all set to 0, to be filled through a writable CoverageMap.
+   * \param filename the file to create
+   * \param bounds the box to cover; the grid starts at its lowest corner
+   *        and covers it with whole steps, up to one step beyond it
+   * \param resolution the step between the points of the grid, in meters
+   * \param transmitters the positions of the transmitters
+   * \return true if the file was created
+   */
+  static bool Allocate (std::string filename, const Box &bounds, double resolution,
+                        const std::vector<Vector> &transmitters);
+
+private:
+  /** The copy constructor is disabled: the mapping is not shared. */
+  CoverageMap (const CoverageMap &);
+  /** The assignment operator is disabled: the mapping is not shared. */
+  CoverageMap & operator = (const CoverageMap &);
+
+  void *m_map;              //!< start of the mapping
+  uint64_t m_size;          //!< size of the mapping
+  bool m_writable;          //!< whether the mapping is writable
+  uint32_t m_nTransmitters; //!< number of transmitters
+  uint32_t m_n[3];          //!< number of points along each axis
+  double m_min[3];          //!< first point of the grid
+  double m_resolution;      //!< step between the points
+  const double *m_transmitters; //!< positions of the transmitters
+  float *m_losses;          //!< losses of all the transmitters
+};
+
+} // namespace ns3
+
+#endif /* COVERAGE_MAP_H */
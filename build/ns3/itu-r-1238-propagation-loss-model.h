@@ -0,0 +1,83 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2011, 2012 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Marco Miozzo  <marco.miozzo@cttc.es>
+ *         Nicola Baldo <nbaldo@cttc.es>
+ * 
+ */
+
+#ifndef ITU_R_1238_PROPAGATION_LOSS_MODEL_H
+#define ITU_R_1238_PROPAGATION_LOSS_MODEL_H
+
+#include <ns3/propagation-loss-model.h>
+#include <ns3/propagation-environment.h>
+#include <ns3/mobility-building-info.h>
+
+namespace ns3 {
+
+/**
+ * This class implements the ITU-R 1238 propagation loss model.
+ * 
+ */
+class ItuR1238PropagationLossModel : public PropagationLossModel
+{
+
+public:
+
+  // inherited from Object
+  static TypeId GetTypeId (void);
+
+  /** 
+   * 
+   * 
+   * \param a the first mobility model
+   * \param b the second mobility model
+   * 
+   * \return the loss in dBm for the propagation between
+   * the two given mobility models
+   */
+  double GetLoss (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+
+private:
+
+  // inherited from PropagationLossModel
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                   const Ptr<MobilityModel> *receivers,
+                                   uint32_t n, double *powerDbm) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+  /**
+   * \param a the building information of the first node
+   * \param b the building information of the second node
+   * \param pa the position of the first node
+   * \param pb the position of the second node
+   * \return the loss in dB between the two nodes
+   */
+  double DoGetLoss (Ptr<MobilityBuildingInfo> a, Ptr<MobilityBuildingInfo> b,
+                    const Vector &pa, const Vector &pb) const;
+  
+  double m_frequency; ///< frequency in MHz
+
+};
+
+} // namespace ns3
+
+
+#endif // ITU_R_1238_PROPAGATION_LOSS_MODEL_H
+
@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#ifndef NAVIGATION_GRID_H
+#define NAVIGATION_GRID_H
+
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/box.h"
+#include "ns3/vector.h"
+#include "obstacle-world.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief A grid of cells over an ObstacleWorld, to plan paths around
+ * the obstacles.
+ *
+ * Like the ObstacleWorld, a single instance is meant to be shared by
+ * every node, through the "Navigation" attribute of the
+ * PathPlanningMobilityModel, so that the grid is built once: the cells
+ * whose center is inside an obstacle are marked blocked the first time a
+ * path is planned, and again whenever obstacles were added to the world.
+ *
+ * Paths are planned with Theta*, an A* search over the 26 neighbors of
+ * each cell which links a cell directly to the parent of its predecessor
+ * whenever they see each other, so that the paths are not bound to the
+ * directions of the grid. The visibility is tested exactly against the
+ * obstacles, with ObstacleWorld::IsBlocked, so that no leg of a path
+ * crosses an obstacle whatever the size of the cells; smaller cells only
+ * find narrower passages and shorter paths.
+ *
+ * The state of the search is kept in arrays over the cells, allocated
+ * once and invalidated by a search counter rather than cleared, so that
+ * a search only costs the cells it visits. As a consequence, paths must
+ * not be planned from several threads at once.
+ */
+class NavigationGrid : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  NavigationGrid ();
+  virtual ~NavigationGrid ();
+
+  /**
+   * \param from the start of the path, outside of every obstacle
+   * \param to the end of the path, outside of every obstacle
+   * \param path on output, the corners of the path, from \p from to \p to
+   * \return true if a path was found, false if an end is out of the
+   *         bounds or inside an obstacle, or if no path joins them; ends
+   *         hidden from each other in the same cell are never joined
+   */
+  bool FindPath (const Vector &from, const Vector &to, std::vector<Vector> &path) const;
+  /**
+   * \return the number of cells of the grid
+   */
+  uint32_t GetNCells (void) const;
+  /**
+   * \return the number of cells whose center is inside an obstacle
+   */
+  uint32_t GetNBlocked (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * Mark the cells whose center is inside an obstacle, if not done yet
+   * for the current obstacles.
+   */
+  void Build (void) const;
+  /**
+   * \param position a position inside the bounds
+   * \return the index of the cell containing the position
+   */
+  uint32_t GetCell (const Vector &position) const;
+  /**
+   * \param cell the index of a cell
+   * \return the center of the cell
+   */
+  Vector GetCenter (uint32_t cell) const;
+  /**
+   * \param cell the index of a cell
+   * \return the position standing for the cell in the current search:
+   *         an end of the path for the cells of the ends, else the center
+   */
+  Vector GetNode (uint32_t cell) const;
+  /**
+   * \param a one end of a segment
+   * \param b the other end of the segment
+   * \return true if the segment crosses no obstacle
+   */
+  bool IsVisible (const Vector &a, const Vector &b) const;
+
+  Box m_bounds; //!< box covered by the grid
+  double m_resolution; //!< size of a cell
+  Ptr<ObstacleWorld> m_obstacles; //!< obstacles to plan around, or 0
+
+  mutable uint32_t m_n[3]; //!< number of cells along each axis
+  mutable double m_size[3]; //!< actual size of a cell along each axis
+  mutable std::vector<uint8_t> m_blocked; //!< whether each cell is blocked
+  mutable uint32_t m_nBlocked; //!< number of blocked cells
+  mutable uint32_t m_nObstacles; //!< obstacles marked, or ~0 if not built
+
+  mutable std::vector<uint32_t> m_visit; //!< search in which each cell was last reached
+  mutable std::vector<uint32_t> m_parent; //!< parent of each cell reached
+  mutable std::vector<double> m_cost; //!< length of the path to each cell reached
+  mutable std::vector<uint8_t> m_closed; //!< whether each cell reached was expanded
+  mutable uint32_t m_search; //!< number of the current search
+  mutable uint32_t m_start; //!< cell of the start of the current search
+  mutable uint32_t m_goal; //!< cell of the end of the current search
+  mutable Vector m_from; //!< start of the current search
+  mutable Vector m_to; //!< end of the current search
+};
+
+} // namespace ns3
+
+#endif /* NAVIGATION_GRID_H */
@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#ifndef OBSTACLE_POSITION_ALLOCATOR_H
+#define OBSTACLE_POSITION_ALLOCATOR_H
+
+#include <vector>
+#include "position-allocator.h"
+#include "obstacle-world.h"
+#include "ns3/box.h"
+#include "ns3/ptr.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Allocate random positions uniformly in a box, outside of the
+ * obstacles of an ObstacleWorld.
+ *
+ * Each position is drawn uniformly in the box and rejected if
+ * ObstacleWorld::FindObstacle finds it inside an obstacle, which only
+ * tests the obstacles around it. When the obstacles fill most of the box,
+ * as in a dense city, set "VoxelSize": the box is then split once into
+ * voxels of about that size, those inside a box obstacle are dropped,
+ * and the positions are drawn in the others, so that few draws are
+ * rejected; a position drawn in a voxel that no obstacle overlaps is not
+ * even tested. Either way the positions are uniform over the free space.
+ *
+ * The voxels are classified again if obstacles were added to the world
+ * since the last position.
+ */
+class ObstacleFreeBoxPositionAllocator : public PositionAllocator
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  ObstacleFreeBoxPositionAllocator ();
+  virtual ~ObstacleFreeBoxPositionAllocator ();
+
+  virtual Vector GetNext (void) const;
+  virtual int64_t AssignStreams (int64_t stream);
+
+private:
+  /** How a voxel overlaps the obstacles */
+  enum VoxelState
+  {
+    FREE = 0, //!< no obstacle overlaps the voxel
+    PARTIAL,  //!< obstacles overlap the voxel
+    FULL      //!< a box obstacle covers the voxel
+  };
+
+  /**
+   * Split the bounds into voxels and list those which are not full
+   */
+  void BuildVoxels (void) const;
+  /**
+   * \param position a position
+   * \return true if the position is outside of every obstacle
+   */
+  bool IsFree (const Vector &position) const;
+
+  Box m_bounds; //!< box the positions are drawn in
+  Ptr<ObstacleWorld> m_obstacles; //!< obstacles to avoid, or 0
+  double m_voxelSize; //!< requested size of a voxel, or 0 not to use voxels
+  uint32_t m_maxAttempts; //!< draws before giving up on a position
+  Ptr<UniformRandomVariable> m_random; //!< source of the draws
+
+  mutable std::vector<uint32_t> m_voxels; //!< voxels not full, the free ones first
+  mutable uint32_t m_nFree; //!< number of free voxels at the start of m_voxels
+  mutable uint32_t m_n[3]; //!< number of voxels along each axis
+  mutable double m_size[3]; //!< actual size of a voxel along each axis
+  mutable uint32_t m_nObstacles; //!< obstacles classified, or ~0 if not built
+};
+
+/**
+ * \ingroup mobility
+ * \brief Allocate the positions of a regular 3D grid in a box, skipping
+ * those inside the obstacles of an ObstacleWorld.
+ *
+ * The grid points are visited along x first, then y, then z, starting at
+ * the lower corner of the box, and the next round starts over once every
+ * point was returned.
+ */
+class ObstacleFreeGridPositionAllocator : public PositionAllocator
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  ObstacleFreeGridPositionAllocator ();
+  virtual ~ObstacleFreeGridPositionAllocator ();
+
+  virtual Vector GetNext (void) const;
+  virtual int64_t AssignStreams (int64_t stream);
+
+private:
+  Box m_bounds; //!< box of the grid
+  double m_deltaX; //!< spacing of the grid along x
+  double m_deltaY; //!< spacing of the grid along y
+  double m_deltaZ; //!< spacing of the grid along z
+  Ptr<ObstacleWorld> m_obstacles; //!< obstacles to avoid, or 0
+  mutable uint64_t m_current; //!< index of the next grid point to try
+};
+
+} // namespace ns3
+
+#endif /* OBSTACLE_POSITION_ALLOCATOR_H */
@@ -0,0 +1,104 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#ifndef OBSTACLE_PROPAGATION_LOSS_MODEL_H
+#define OBSTACLE_PROPAGATION_LOSS_MODEL_H
+
+#include <vector>
+#include "ns3/propagation-loss-model.h"
+#include "ns3/obstacle-world.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup buildings
+ * \brief Penetration loss of the buildings and obstacles on the direct path.
+ *
+ * The segment between the transmitter and the receiver is cast against
+ * the buildings of the BuildingList and, if set, the obstacles of an
+ * ObstacleWorld, through their bounding volume hierarchy, so that the
+ * cost of a link grows with the logarithm of the number of obstacles.
+ * Every wall crossed costs the external wall loss of its building, as
+ * in BuildingsPropagationLossModel, or "ObstacleWallLoss" for the other
+ * obstacles, and every meter of the path inside them "DepthLoss". A node
+ * inside a building only crosses the walls on its way out.
+ *
+ * With "LineOfSightOnly", the model only tells whether the path is
+ * blocked, and adds "NlosLoss" if it is; the search then stops at the
+ * first obstacle found.
+ *
+ * The model adds to the loss of the models chained after it, such as a
+ * FriisPropagationLossModel:
+ * \code
+    Ptr<ObstaclePropagationLossModel> obstacles = CreateObject<ObstaclePropagationLossModel> ();
+    obstacles->SetNext (CreateObject<FriisPropagationLossModel> ());
+ * \endcode
+ */
+class ObstaclePropagationLossModel : public PropagationLossModel
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  ObstaclePropagationLossModel ();
+  virtual ~ObstaclePropagationLossModel ();
+
+  /**
+   * \param a the position of one end of the link
+   * \param b the position of the other end
+   * \return the penetration loss of the link, in dB
+   */
+  double GetLoss (const Vector &a, const Vector &b) const;
+
+private:
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual double DoGetMaxGain (void) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+  /**
+   * Index the buildings again if the BuildingList changed
+   */
+  void UpdateBuildings (void) const;
+  /**
+   * \param a the position of one end of the link
+   * \param b the position of the other end
+   * \param wallLoss the loss of a wall of each obstacle of the crossings
+   * \return the loss of the crossings found last
+   */
+  double CrossingsLoss (const Vector &a, const Vector &b, const std::vector<double> *wallLoss) const;
+
+  bool m_useBuildings; //!< whether the buildings block the path
+  Ptr<ObstacleWorld> m_obstacles; //!< other obstacles, or 0
+  double m_obstacleWallLoss; //!< loss of a wall of the other obstacles, in dB
+  double m_depthLoss; //!< loss per meter inside an obstacle, in dB
+  bool m_losOnly; //!< whether to only tell line of sight
+  double m_nlosLoss; //!< loss of a blocked path with m_losOnly, in dB
+
+  mutable Ptr<ObstacleWorld> m_buildings; //!< the buildings, by index in the BuildingList
+  mutable std::vector<double> m_buildingWallLoss; //!< external wall loss of each building
+  mutable uint32_t m_buildingsVersion; //!< version of the BuildingList indexed
+  mutable std::vector<ObstacleCrossing> m_crossings; //!< crossings of the last query
+};
+
+} // namespace ns3
+
+#endif /* OBSTACLE_PROPAGATION_LOSS_MODEL_H */
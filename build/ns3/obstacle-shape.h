@@ -0,0 +1,158 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#ifndef OBSTACLE_SHAPE_H
+#define OBSTACLE_SHAPE_H
+
+#include <vector>
+#include "ns3/simple-ref-count.h"
+#include "ns3/vector.h"
+#include "ns3/box.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief An obstacle of an ObstacleWorld that is not an axis-aligned box.
+ *
+ * The world indexes the shapes by their bounding box, and only asks
+ * for the exact intersection when a ray crosses that box, so that a few
+ * exact shapes replace the many small boxes otherwise needed to
+ * approximate a building footprint.
+ */
+class ObstacleShape : public SimpleRefCount<ObstacleShape>
+{
+public:
+  virtual ~ObstacleShape ();
+
+  /**
+   * \return the smallest box containing the shape
+   */
+  virtual Box GetBoundingBox (void) const = 0;
+  /**
+   * \param position a position
+   * \return true if the position is strictly inside the shape
+   */
+  virtual bool IsInside (const Vector &position) const = 0;
+  /**
+   * \param origin the origin of the ray, outside of the shape
+   * \param velocity the direction of the ray, not necessarily normalized
+   * \param t on output, the ray parameter where the shape is entered, if
+   *        it is: the shape is hit at origin + t * velocity
+   * \param normal on output, the outward unit normal of the face entered
+   * \return true if the ray enters the shape at t >= 0
+   *
+   * Only faces entered by the ray are considered, so that a ray leaving
+   * a face it starts on, as after a rebound, never hits it again.
+   */
+  virtual bool Intersect (const Vector &origin, const Vector &velocity,
+                          double &t, Vector &normal) const = 0;
+};
+
+/**
+ * \ingroup mobility
+ * \brief A polygonal footprint extruded between two heights.
+ *
+ * The footprint may be any simple polygon, convex or not, given in
+ * either orientation; the prism is entered through its vertical walls or
+ * through its floor and roof.
+ */
+class PrismObstacle : public ObstacleShape
+{
+public:
+  /**
+   * \param footprint the vertices of a simple polygon, at least 3, without
+   *        repeating the first one at the end
+   * \param zMin the height of the floor
+   * \param zMax the height of the roof, above the floor
+   */
+  PrismObstacle (const std::vector<Vector2D> &footprint, double zMin, double zMax);
+
+  /**
+   * \return the vertices of the footprint, counterclockwise
+   */
+  const std::vector<Vector2D> & GetFootprint (void) const;
+
+  virtual Box GetBoundingBox (void) const;
+  virtual bool IsInside (const Vector &position) const;
+  virtual bool Intersect (const Vector &origin, const Vector &velocity,
+                          double &t, Vector &normal) const;
+
+private:
+  /**
+   * \param x the x coordinate of a point
+   * \param y the y coordinate of a point
+   * \return true if the point is inside the footprint
+   */
+  bool IsInsideFootprint (double x, double y) const;
+
+  std::vector<Vector2D> m_footprint; //!< vertices, counterclockwise
+  std::vector<Vector2D> m_normals; //!< outward unit normal of the edge starting at each vertex
+  double m_zMin; //!< height of the floor
+  double m_zMax; //!< height of the roof
+  Box m_bounds; //!< bounding box
+};
+
+/**
+ * \ingroup mobility
+ * \brief A convex polyhedron, the intersection of half-spaces.
+ *
+ * The ray intersection is the slab test generalized to the planes of the
+ * faces, linear in their number and free of any vertex or edge walk.
+ */
+class ConvexObstacle : public ObstacleShape
+{
+public:
+  /**
+   * \param points points whose convex hull is the obstacle, not all in a
+   *        plane
+   *
+   * The faces are found by testing every triple of points, which is meant
+   * for hulls of a few tens of points, such as measured building corners.
+   */
+  ConvexObstacle (const std::vector<Vector> &points);
+
+  /**
+   * \return the number of faces of the hull
+   */
+  uint32_t GetNFaces (void) const;
+
+  virtual Box GetBoundingBox (void) const;
+  virtual bool IsInside (const Vector &position) const;
+  virtual bool Intersect (const Vector &origin, const Vector &velocity,
+                          double &t, Vector &normal) const;
+
+private:
+  /**
+   * A face, the plane of the points p with normal.p == offset; the inside
+   * is where normal.p < offset.
+   */
+  struct Face
+  {
+    Vector normal; //!< outward unit normal
+    double offset; //!< signed distance of the plane to the origin
+  };
+
+  std::vector<Face> m_faces; //!< faces of the hull
+  Box m_bounds; //!< bounding box
+};
+
+} // namespace ns3
+
+#endif /* OBSTACLE_SHAPE_H */
@@ -0,0 +1,290 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#ifndef OBSTACLE_WORLD_H
+#define OBSTACLE_WORLD_H
+
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/vector.h"
+#include "ns3/box.h"
+#include "ns3/obstacle-shape.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief The part of a segment inside an obstacle.
+ */
+struct ObstacleCrossing
+{
+  uint32_t obstacle; //!< index of the obstacle crossed
+  double enter;      //!< fraction of the segment where the obstacle is entered, 0 if it starts inside
+  double exit;       //!< fraction of the segment where the obstacle is left, 1 if it ends inside
+};
+
+/**
+ * \ingroup mobility
+ * \brief A set of obstacles shared by the 3D obstacle mobility models.
+ *
+ * A single instance is meant to be created per scenario, filled with
+ * obstacles before the simulation starts and then handed to every
+ * mobility model through its "Obstacles" attribute, so that the
+ * obstacle set is stored once regardless of the number of nodes:
+ * \code
+    Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+    world->AddObstacle (Box (0.0, 100.0, 0.0, 100.0, 0.0, 100.0));
+    world->AddObstacle (Create<PrismObstacle> (footprint, 0.0, 30.0));
+
+    MobilityHelper mobility;
+    mobility.SetMobilityModel ("ns3::RandomWalk3dMobilityModel",
+      "Obstacles", PointerValue (world));
+ * \endcode
+ */
+class ObstacleWorld : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  ObstacleWorld ();
+  virtual ~ObstacleWorld ();
+
+  /**
+   * \param obstacle an obstacle to be added
+   *
+   * The box must be inside the boundaries of the mobility models
+   * using this world, this method does not verify it.
+   * This method assumes the box has dimensions > 0
+   */
+  void AddObstacle (const Box &obstacle);
+  /**
+   * \param shape an obstacle to be added, such as a PrismObstacle or a
+   *        ConvexObstacle
+   *
+   * The shape is indexed with the boxes, by its bounding box, and tested
+   * exactly only by the rays crossing that box. Prefer a box for
+   * obstacles that are boxes: its test is the cheapest.
+   */
+  void AddObstacle (Ptr<const ObstacleShape> shape);
+  /**
+   * \return the number of obstacles in this world
+   */
+  uint32_t GetNObstacles (void) const;
+  /**
+   * \param i index of the obstacle
+   * \return the i-th obstacle, or its bounding box if it is a shape
+   */
+  const Box & GetObstacle (uint32_t i) const;
+  /**
+   * \param i index of the obstacle
+   * \return the shape of the i-th obstacle, or 0 if it is a box
+   */
+  Ptr<const ObstacleShape> GetShape (uint32_t i) const;
+  /**
+   * \param i index of the obstacle
+   * \return whether the i-th obstacle is a box, without taking a
+   *         reference to its shape, so that it may be called from
+   *         several threads
+   */
+  bool IsBox (uint32_t i) const;
+  /**
+   * \param position the current position, outside of every obstacle
+   * \param velocity the current velocity
+   * \param distance on input, the maximum distance to look for a collision;
+   *        on output, the distance to the closest collision, if any
+   * \return the index of the closest obstacle hit by the position+velocity
+   *         ray within the input distance, or -1 if there is none
+   */
+  int32_t FindClosestCollision (const Vector &position, const Vector &velocity,
+                                double &distance) const;
+  /**
+   * \param position the current position, outside of every obstacle
+   * \param velocity the current velocity
+   * \param distance on input, the maximum distance to look for a collision;
+   *        on output, the distance to the closest collision, if any
+   * \param side on output, the side of the obstacle that is hit, if any
+   * \return the index of the closest obstacle hit by the position+velocity
+   *         ray within the input distance, or -1 if there is none
+   *
+   * The query is answered with a bounding volume hierarchy built over the
+   * obstacles the first time the world is queried, so its cost grows with
+   * the logarithm of the number of obstacles rather than linearly.
+   * Obstacles behind the position, or containing it, are never reported.
+   *
+   * For a shape, the side reported is the one of the bounding box whose
+   * normal is closest to the normal of the face hit.
+   */
+  int32_t FindClosestCollision (const Vector &position, const Vector &velocity,
+                                double &distance, Box::Side &side) const;
+  /**
+   * \param position the current position, outside of every obstacle
+   * \param velocity the current velocity
+   * \param distance on input, the maximum distance to look for a collision;
+   *        on output, the distance to the closest collision, if any
+   * \param side on output, the side of the obstacle that is hit, if any
+   * \param normal on output, the outward unit normal of the face hit, if any
+   * \return the index of the closest obstacle hit by the position+velocity
+   *         ray within the input distance, or -1 if there is none
+   */
+  int32_t FindClosestCollision (const Vector &position, const Vector &velocity,
+                                double &distance, Box::Side &side, Vector &normal) const;
+  /**
+   * \param a one end of a segment
+   * \param b the other end of the segment
+   * \param crossings on output, the obstacles crossed by the segment, in
+   *        no particular order
+   * \return the number of obstacles crossed
+   *
+   * Unlike the collision queries, the ends of the segment may be inside
+   * obstacles, such as the antenna of an indoor node. For a shape that
+   * the segment crosses several times, such as a concave prism, the
+   * crossing spans from the first entry to the last exit.
+   */
+  uint32_t FindCrossings (const Vector &a, const Vector &b,
+                          std::vector<ObstacleCrossing> &crossings) const;
+  /**
+   * \param a one end of a segment
+   * \param b the other end of the segment
+   * \return true if the segment crosses any obstacle
+   *
+   * The search stops at the first obstacle found, which makes this query
+   * cheaper than FindCrossings when only line of sight matters.
+   */
+  bool IsBlocked (const Vector &a, const Vector &b) const;
+  /**
+   * \param position a position
+   * \return the index of an obstacle containing the position, or -1 if it
+   *         is outside of every obstacle
+   *
+   * A position on the surface of a box is outside of it, as for
+   * Box::IsOutside. Only the obstacles whose bounding box contains the
+   * position are tested, through the hierarchy.
+   */
+  int32_t FindObstacle (const Vector &position) const;
+  /**
+   * \param box a box
+   * \param obstacles on output, the obstacles whose bounding box overlaps
+   *        the box, in no particular order
+   * \return the number of obstacles found
+   *
+   * Boxes which only touch are not reported.
+   */
+  uint32_t FindOverlaps (const Box &box, std::vector<uint32_t> &obstacles) const;
+  /**
+   * Build the hierarchy over the current obstacles, if not built yet.
+   *
+   * The queries build it on first use, which makes them unsafe to issue
+   * from several threads at once; once this method returned, and until
+   * the next obstacle is added, they only read the world.
+   */
+  void BuildIndex (void) const;
+
+private:
+  /**
+   * A node of the bounding volume hierarchy. The left child of an inner
+   * node is stored right after it, the right child at index \c right.
+   */
+  struct BvhNode
+  {
+    Box bounds;     //!< bounds of every obstacle below this node
+    uint32_t start; //!< first entry of m_order covered by a leaf
+    uint32_t count; //!< number of obstacles of a leaf, 0 for inner nodes
+    uint32_t right; //!< index of the right child of an inner node
+  };
+  /**
+   * \param start first entry of m_order to cover
+   * \param end one past the last entry of m_order to cover
+   * \return the index of the node covering the given entries
+   */
+  uint32_t BuildNode (uint32_t start, uint32_t end) const;
+  /**
+   * \param a one end of a segment
+   * \param b the other end of the segment
+   * \param crossings if not null, on output, the obstacles crossed;
+   *        if null, the search stops at the first obstacle crossed
+   * \return the number of obstacles crossed, at most 1 if crossings is null
+   */
+  uint32_t CrossSegment (const Vector &a, const Vector &b,
+                         std::vector<ObstacleCrossing> *crossings) const;
+
+  std::vector<Box> m_obstacles; //!< obstacles in this world, or their bounding box
+  std::vector<Ptr<const ObstacleShape> > m_shapes; //!< shape of each obstacle, 0 for boxes
+  mutable std::vector<BvhNode> m_nodes; //!< hierarchy, root first
+  mutable std::vector<uint32_t> m_order; //!< obstacle indices in leaf order
+  mutable std::vector<double> m_xMin; //!< left bounds, in leaf order
+  mutable std::vector<double> m_xMax; //!< right bounds, in leaf order
+  mutable std::vector<double> m_yMin; //!< bottom bounds, in leaf order
+  mutable std::vector<double> m_yMax; //!< top bounds, in leaf order
+  mutable std::vector<double> m_zMin; //!< down bounds, in leaf order
+  mutable std::vector<double> m_zMax; //!< up bounds, in leaf order
+  mutable bool m_indexed; //!< whether m_nodes matches m_obstacles
+};
+
+/**
+ * \ingroup mobility
+ * \brief The first event ending a straight walk inside bounds, among obstacles.
+ */
+struct WalkEvent
+{
+  /** What ends the walk */
+  enum Type
+  {
+    TIMEOUT,  //!< the walk lasted as long as allowed
+    BOUNDS,   //!< the walk reached the bounds
+    OBSTACLE  //!< the walk reached an obstacle
+  };
+  Type type;        //!< what ends the walk
+  double delay;     //!< time from the start of the walk to the event, in seconds
+  Box::Side side;   //!< side of the bounds or of the obstacle reached
+  int32_t obstacle; //!< index of the obstacle reached, or -1
+  Vector normal;    //!< unit normal of the side reached, toward the walk
+  Vector velocity;  //!< velocity reflected on the sides reached, unchanged on a timeout
+};
+
+/**
+ * \param bounds the bounds of the walk
+ * \param obstacles the obstacles, or 0 if there are none
+ * \param position the start of the walk, inside the bounds and outside
+ *        of every obstacle
+ * \param velocity the constant velocity of the walk
+ * \param timeout the longest walk, in seconds, possibly infinite
+ * \return the earliest of the timeout, the hit of the bounds and the hit
+ *         of an obstacle
+ *
+ * The time to the bounds is the exit time of the slab of each axis, so
+ * that the side reached is known exactly rather than guessed from the
+ * position afterwards; at a corner, the velocity is reflected on every
+ * side reached at once. The velocity is reflected specularly on the
+ * faces of the shapes, whatever their orientation. The obstacles are
+ * only searched up to the earlier of the bounds and the timeout. A hit
+ * at the same time as the timeout is reported, so that the delay never
+ * exceeds the timeout.
+ *
+ * Once the index of the obstacles is built, this function only reads
+ * them, and may be called from several threads.
+ */
+WalkEvent CalculateWalkEvent (const Box &bounds, const ObstacleWorld *obstacles,
+                              const Vector &position, const Vector &velocity, double timeout);
+
+} // namespace ns3
+
+#endif /* OBSTACLE_WORLD_H */
@@ -0,0 +1,115 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#ifndef PIECEWISE_LINEAR_TRAJECTORY_H
+#define PIECEWISE_LINEAR_TRAJECTORY_H
+
+#include <vector>
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/box.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ *
+ * \brief Utility class storing a trajectory as a list of legs flown at
+ * constant velocity.
+ *
+ * Each leg starts at a given time from a given origin, and lasts until
+ * the start of the next leg. Unlike ConstantVelocityHelper, evaluating
+ * the trajectory does not modify it, and positions are computed from
+ * the origin of their leg rather than accumulated over the queries, so
+ * the position at a given time does not depend on when it is asked for.
+ */
+class PiecewiseLinearTrajectory
+{
+public:
+  PiecewiseLinearTrajectory ();
+
+  /**
+   * Append a leg to the trajectory. A leg starting at the same time as
+   * the last one replaces it.
+   *
+   * \param start the time the leg starts, not before the last leg start
+   * \param origin the position at the start of the leg
+   * \param velocity the velocity during the leg
+   */
+  void AddLeg (Time start, const Vector &origin, const Vector &velocity);
+  /**
+   * \return the number of legs stored
+   */
+  uint32_t GetNLegs (void) const;
+  /**
+   * \return the start time of the last leg
+   */
+  Time GetLastStart (void) const;
+  /**
+   * \param t a time, not before the start of the first stored leg
+   * \return the position at time t
+   */
+  Vector GetPosition (Time t) const;
+  /**
+   * \param t a time, not before the start of the first stored leg
+   * \param bounds 3D bounding box for the resulting position
+   * \return the position at time t, moved inside the box if it lies
+   *         out of it because of rounding errors
+   */
+  Vector GetPosition (Time t, const Box &bounds) const;
+  /**
+   * \param t a time, not before the start of the first stored leg
+   * \return the velocity at time t
+   */
+  Vector GetVelocity (Time t) const;
+  /**
+   * Forget the legs that end before time t. The leg in progress at t,
+   * and the ones after it, are kept.
+   *
+   * \param t a time
+   */
+  void DiscardBefore (Time t);
+  /**
+   * Forget every leg.
+   */
+  void Clear (void);
+
+private:
+  /**
+   * A leg of the trajectory
+   */
+  struct Leg
+  {
+    Time start;      //!< time the leg starts
+    Vector origin;   //!< position at the start of the leg
+    Vector velocity; //!< velocity during the leg
+  };
+  /**
+   * \param t a time, not before the start of the first stored leg
+   * \return the index in m_legs of the leg in progress at time t
+   */
+  uint32_t FindLeg (Time t) const;
+
+  std::vector<Leg> m_legs; //!< legs in start order, the first m_first ones discarded
+  uint32_t m_first; //!< index of the first leg that was not discarded
+};
+
+} // namespace ns3
+
+#endif /* PIECEWISE_LINEAR_TRAJECTORY_H */
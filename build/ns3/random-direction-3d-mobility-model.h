@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#ifndef RANDOM_DIRECTION_3D_MOBILITY_MODEL_H
+#define RANDOM_DIRECTION_3D_MOBILITY_MODEL_H
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/box.h"
+#include "ns3/obstacle-world.h"
+#include "ns3/random-variable-stream.h"
+#include "mobility-model.h"
+#include "piecewise-linear-trajectory.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Random direction mobility model 3D.
+ *
+ * The movement of objects is based on random directions: each object
+ * pauses for a specific delay, chooses a random direction and speed and 
+ * then travels in the specific direction until it reaches one of
+ * the boundaries of the model. When it reaches the boundary, it pauses,
+ * selects a new direction and speed, aso.
+ *
+ * As in RandomWalk3dMobilityModel, the "Lazy" attribute makes the
+ * trajectory be computed only when a query goes past its known part,
+ * instead of scheduling an event at every pause and departure.
+ */
+class RandomDirection3dMobilityModel : public MobilityModel
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  RandomDirection3dMobilityModel ();
+  /**
+   * \param obstacle an obstacle to be added
+   *
+   * The obstacle is added to the ObstacleWorld set through the
+   * "Obstacles" attribute, which is shared by every model using it.
+   * If no world was set, a private one is created for this model.
+   * The box must be inside the boundaries,
+   * this method does not verify it.
+   * This method assumes the box has dimensions > 0
+   */
+  void AddObstacle(const Box &obstacle);
+
+private:
+  /** The change of course pending at the end of the known trajectory */
+  enum Action {
+    ACTION_INITIALIZE,
+    ACTION_PAUSE,
+    ACTION_RESET
+  };
+  /**
+   * Event handler, compute the trajectory up to the current time
+   */
+  void Update (void);
+  /**
+   * Apply every change of course due up to the given time, and notify
+   * the course change if there was one.
+   * \param now the current time
+   */
+  void Advance (Time now);
+  /**
+   * Set a new direction and speed
+   * \param at the time of the change of course
+   */
+  void ResetDirectionAndSpeed (Time at);
+  /**
+   * Pause, and set the end of the pause as next change of course
+   * \param at the time the pause starts
+   */
+  void BeginPause (Time at);
+  /**
+   * Set new velocity and direction, and set the next pause as next
+   * change of course
+   * \param at the time of the change of course
+   * \param direction (radians)
+   * \param pitch (radians)
+   */
+  void SetDirectionAndPitchAndSpeed (Time at, double direction, double pitch);
+  /**
+   * Sets a new random direction and calls SetDirectionAndSpeed
+   * \param at the time of the change of course
+   */
+  void DoInitializePrivate (Time at);
+  virtual void DoDispose (void);
+  virtual void DoInitialize (void);
+  virtual Vector DoGetPosition (void) const;
+  virtual void DoSetPosition (const Vector &position);
+  virtual Vector DoGetVelocity (void) const;
+  virtual int64_t DoAssignStreams (int64_t);
+
+  Ptr<UniformRandomVariable> m_direction; //!< rv to control direction
+  Ptr<RandomVariableStream> m_speed; //!< a random variable to control speed
+  Ptr<RandomVariableStream> m_pause; //!< a random variable to control pause 
+  EventId m_event; //!< event ID of next scheduled event
+  PiecewiseLinearTrajectory m_trajectory; //!< known part of the trajectory
+  bool m_lazy; //!< whether the trajectory is computed only when queried
+  Time m_next; //!< time of the next change of course
+  enum Action m_nextAction; //!< next change of course
+  Box m_bounds; //!< Bounds of the area to cruise
+
+  Ptr<UniformRandomVariable> m_pitch; //!< rv for picking pitch
+  Ptr<ObstacleWorld> m_obstacles; //!< obstacles shared with the other models
+  int m_closestObstacle; // if collision is detected, this wil be set as the id of the obstacle in the array
+  Box::Side m_closestSide; //!< side of the closest obstacle hit, if any
+  Vector m_closestNormal; //!< normal of the face of the closest obstacle hit, if any
+};
+
+} // namespace ns3
+
+#endif /* RANDOM_DIRECTION_3D_MOBILITY_MODEL_H */
@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#ifndef TRAJECTORY_CACHE_MOBILITY_MODEL_H
+#define TRAJECTORY_CACHE_MOBILITY_MODEL_H
+
+#include "mobility-model.h"
+#include "trajectory-cache.h"
+#include "ns3/event-id.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Replay the trajectory of a node from a TrajectoryCache.
+ *
+ * The position and velocity are looked up in the legs recorded for the
+ * node, without any random draw or obstacle search. Queries at increasing
+ * times, the common case, find their leg in constant time; others use a
+ * binary search. Before the first leg, the node stays at its origin.
+ *
+ * If the "CourseChanges" attribute is true, an event at the start of each
+ * leg fires CourseChange, as the recorded model did; otherwise the model
+ * schedules no event at all.
+ *
+ * Setting the position leaves the recorded trajectory: the node then
+ * stays at the given position.
+ *
+ * The models are usually installed by TrajectoryCacheHelper.
+ */
+class TrajectoryCacheMobilityModel : public MobilityModel
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  TrajectoryCacheMobilityModel ();
+  virtual ~TrajectoryCacheMobilityModel ();
+
+  /**
+   * \param cache the file of trajectories
+   * \param node the id of the node to replay, with at least one leg
+   */
+  void SetTrajectory (Ptr<const TrajectoryCache> cache, uint32_t node);
+
+private:
+  virtual void DoInitialize (void);
+  virtual void DoDispose (void);
+  virtual Vector DoGetPosition (void) const;
+  virtual void DoSetPosition (const Vector &position);
+  virtual Vector DoGetVelocity (void) const;
+  /**
+   * \param t a time step
+   * \return the index of the leg in progress at t, or -1 before the first leg
+   */
+  int32_t FindLeg (int64_t t) const;
+  /**
+   * Fire CourseChange for the leg starting now, and schedule the next one
+   */
+  void StartLeg (void);
+  /**
+   * Schedule StartLeg for the first leg starting after the current time
+   */
+  void ScheduleNextLeg (void);
+
+  Ptr<const TrajectoryCache> m_cache; //!< file the legs are mapped from
+  const TrajectoryCache::Leg *m_legs; //!< legs of the node
+  uint32_t m_nLegs; //!< number of legs of the node
+  mutable uint32_t m_current; //!< leg found by the last query
+  bool m_courseChanges; //!< whether to fire CourseChange at each leg
+  EventId m_event; //!< start of the next leg
+  bool m_detached; //!< whether the position was set, leaving the legs
+  Vector m_position; //!< position set, once detached
+};
+
+} // namespace ns3
+
+#endif /* TRAJECTORY_CACHE_MOBILITY_MODEL_H */
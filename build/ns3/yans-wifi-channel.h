@@ -0,0 +1,220 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2006,2007 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Mathieu Lacage, <mathieu.lacage@sophia.inria.fr>
+ */
+#ifndef YANS_WIFI_CHANNEL_H
+#define YANS_WIFI_CHANNEL_H
+
+#include <vector>
+#include <map>
+#include <stdint.h>
+#include "ns3/packet.h"
+#include "wifi-channel.h"
+#include "wifi-mode.h"
+#include "wifi-preamble.h"
+#include "wifi-tx-vector.h"
+#include "ns3/nstime.h"
+#include "ns3/spatial-grid.h"
+
+namespace ns3 {
+
+class NetDevice;
+class MobilityModel;
+class PropagationLossModel;
+class PropagationDelayModel;
+class YansWifiPhy;
+
+/**
+ * \brief A Yans wifi channel
+ * \ingroup wifi
+ *
+ * This wifi channel implements the propagation model described in
+ * "Yet Another Network Simulator", (http://cutebugs.net/files/wns2-yans.pdf).
+ *
+ * This class is expected to be used in tandem with the ns3::YansWifiPhy
+ * class and contains a ns3::PropagationLossModel and a ns3::PropagationDelayModel.
+ * By default, no propagation models are set so, it is the caller's responsability
+ * to set them before using the channel.
+ *
+ * With "SpatialIndex", the PHYs are kept in a SpatialGrid, moved along
+ * the CourseChange trace of their mobility model, and a transmission
+ * only reaches the PHYs within the range of the propagation loss model,
+ * as bounded by PropagationLossModel::GetMaxRange, which the grid finds
+ * without visiting the others. The threshold of the range is the lowest
+ * EnergyDetectionThreshold of the PHYs, less their RxGain and the
+ * "PruningMargin": the frames received below it are not delivered at
+ * all, so that they neither reach the PHY nor add to its interference.
+ * The cells are as large as the range of the first transmission, unless
+ * "CellSize" is set. If the loss model cannot bound its range, as with
+ * the random fading models, every PHY is visited as usual.
+ *
+ * The receptions of a transmission are delivered by a single event,
+ * scheduled again in the context of each receiver in the order of their
+ * propagation delay, rather than by one event per receiver, so that the
+ * scheduler holds one event per transmission in flight.
+ *
+ * The thresholds and the mobility model of a PHY are read when the PHY
+ * is first indexed, at the first transmission after it was added, and
+ * the mobility models must fire CourseChange at every change of
+ * velocity: the "Lazy" 3D models are not supported.
+ */
+class YansWifiChannel : public WifiChannel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  YansWifiChannel ();
+  virtual ~YansWifiChannel ();
+
+  // inherited from Channel.
+  virtual uint32_t GetNDevices (void) const;
+  virtual Ptr<NetDevice> GetDevice (uint32_t i) const;
+
+  /**
+   * Adds the given YansWifiPhy to the PHY list
+   *
+   * \param phy the YansWifiPhy to be added to the PHY list
+   */
+  void Add (Ptr<YansWifiPhy> phy);
+
+  /**
+   * \param phy a YansWifiPhy of the PHY list which switched channel
+   *
+   * This method should not be invoked by normal users. It is
+   * currently invoked only from YansWifiPhy::SetChannelNumber, so
+   * that Send visits only the PHYs on the channel of the sender.
+   */
+  void UpdateChannelNumber (Ptr<YansWifiPhy> phy);
+
+  /**
+   * \param loss the new propagation loss model.
+   */
+  void SetPropagationLossModel (Ptr<PropagationLossModel> loss);
+  /**
+   * \param delay the new propagation delay model.
+   */
+  void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay);
+
+  /**
+   * \param sender the device from which the packet is originating.
+   * \param packet the packet to send
+   * \param txPowerDbm the tx power associated to the packet
+   * \param txVector the TXVECTOR associated to the packet
+   * \param preamble the preamble associated to the packet
+   * \param packetType the type of packet, used for A-MPDU to say whether it's the last MPDU or not
+   * \param duration the transmission duration associated to the packet
+   *
+   * This method should not be invoked by normal users. It is
+   * currently invoked only from WifiPhy::Send. YansWifiChannel
+   * delivers packets only between PHYs with the same m_channelNumber,
+   * e.g. PHYs that are operating on the same channel.
+   */
+  void Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
+             WifiTxVector txVector, WifiPreamble preamble, uint8_t packetType, Time duration) const;
+
+ /**
+  * Assign a fixed random variable stream number to the random variables
+  * used by this model.  Return the number of streams (possibly zero) that
+  * have been assigned.
+  *
+  * \param stream first stream index to use
+  * \return the number of stream indices assigned by this model
+  */
+  int64_t AssignStreams (int64_t stream);
+
+private:
+  //YansWifiChannel& operator = (const YansWifiChannel &);
+  //YansWifiChannel (const YansWifiChannel &);
+
+  /**
+   * A vector of pointers to YansWifiPhy.
+   */
+  typedef std::vector<Ptr<YansWifiPhy> > PhyList;
+  /**
+   * The parameters of a reception, held by value in the event of Receive
+   */
+  struct ReceiveParams
+  {
+    double rxPowerDbm;      //!< the received power (dBm)
+    WifiTxVector txVector;  //!< the TXVECTOR of the packet
+    WifiPreamble preamble;  //!< the type of preamble of the packet
+    uint8_t packetType;     //!< whether the packet is part of an A-MPDU, and the last one
+    Time duration;          //!< the transmission duration of the packet
+  };
+  /**
+   * The receptions of a transmission, delivered by a single event
+   */
+  class FanOut;
+  /**
+   * This method is called for each associated YansWifiPhy by the FanOut
+   * of the transmission, in the context of the node of the PHY.
+   * The method then calls the corresponding YansWifiPhy that the first
+   * bit of the packet has arrived.
+   *
+   * \param i index of the corresponding YansWifiPhy in the PHY list
+   * \param packet the packet being sent, shared by all the receivers
+   * \param params the received power and the other parameters of the reception
+   */
+  void Receive (uint32_t i, Ptr<const Packet> packet, ReceiveParams params) const;
+  /**
+   * \param i index of a YansWifiPhy in the PHY list
+   * \return the identifier of the node of its device, or 0xffffffff if
+   *         it has none, looked up once
+   */
+  uint32_t GetNodeId (uint32_t i) const;
+  /**
+   * Add the PHYs added since the last transmission to the spatial grid
+   */
+  void IndexPhys (void) const;
+  /**
+   * Move the PHYs of a node in the spatial grid
+   *
+   * \param mobility the mobility model of the node
+   */
+  void CourseChange (Ptr<const MobilityModel> mobility) const;
+  virtual void DoDispose (void);
+
+  PhyList m_phyList; //!< List of YansWifiPhys connected to this YansWifiChannel
+  std::vector<uint16_t> m_phyChannel; //!< channel number of each PHY
+  std::map<uint16_t, std::vector<uint32_t> > m_channelPhys; //!< index of the PHYs on each channel number, in order
+  Ptr<PropagationLossModel> m_loss; //!< Propagation loss model
+  Ptr<PropagationDelayModel> m_delay; //!< Propagation delay model
+  mutable std::vector<uint32_t> m_nodeIds; //!< node of the device of each PHY, once known
+  mutable std::vector<uint32_t> m_receivers; //!< index of the receivers of the current Send
+  mutable std::vector<Ptr<MobilityModel> > m_receiverMobility; //!< their mobility models
+  mutable std::vector<double> m_rxPowerDbm; //!< the power they receive
+  mutable std::vector<Ptr<FanOut> > m_fanOuts; //!< the fan-out events, reused once delivered
+
+  bool m_spatialIndex; //!< whether only the PHYs within range are visited
+  double m_cellSize; //!< side of the cells of the grid, or 0 for the first range
+  double m_pruningMargin; //!< margin below the lowest threshold of the PHYs, in dB
+  mutable SpatialGrid m_grid; //!< the PHYs indexed, by position
+  mutable bool m_gridReady; //!< whether the cell size of the grid is set
+  mutable uint32_t m_nIndexed; //!< number of PHYs of m_phyList indexed
+  mutable double m_thresholdDbm; //!< power below which a frame is not delivered
+  mutable std::vector<Ptr<MobilityModel> > m_phyMobility; //!< mobility model of each indexed PHY
+  mutable std::map<const MobilityModel *, std::vector<uint32_t> > m_mobilityPhys; //!< indexed PHYs of each mobility model
+  mutable double m_rangeTxPowerDbm; //!< transmission power of m_range
+  mutable double m_range; //!< range at m_rangeTxPowerDbm
+  mutable std::vector<uint32_t> m_near; //!< PHYs found in range of the current Send
+};
+
+} // namespace ns3
+
+
+#endif /* YANS_WIFI_CHANNEL_H */
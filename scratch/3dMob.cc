@@ -86,9 +86,13 @@ Experiment::Run(double simtime, int model, uint32_t nodes, uint32_t speed, bool
       mobility.Install (sta);
       if (withObstacles)
 	{
-	  Ptr<RandomWalk3dMobilityModel> mob = sta.Get(0)->GetObject<RandomWalk3dMobilityModel> ();
-	  mob->AddObstacle(Box(0.0, 100.0, 0.0, 100.0, 0.0, 100.0));
-	  mob->AddObstacle(Box(100, 200.0, 100, 200.0, 0.0, 200.0));
+	  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+	  world->AddObstacle(Box(0.0, 100.0, 0.0, 100.0, 0.0, 100.0));
+	  world->AddObstacle(Box(100, 200.0, 100, 200.0, 0.0, 200.0));
+	  for (NodeContainer::Iterator i = sta.Begin (); i != sta.End (); ++i)
+	    {
+	      (*i)->GetObject<MobilityModel> ()->SetAttribute ("Obstacles", PointerValue (world));
+	    }
 	}
       break;
     case Experiment::WALK_DISTANCE:
@@ -100,9 +104,13 @@ Experiment::Run(double simtime, int model, uint32_t nodes, uint32_t speed, bool
       mobility.Install (sta);
       if (withObstacles)
 	{
-	  Ptr<RandomWalk3dMobilityModel> mob = sta.Get(0)->GetObject<RandomWalk3dMobilityModel> ();
-	  mob->AddObstacle(Box(0.0, 100.0, 0.0, 100.0, 0.0, 100.0));
-	  mob->AddObstacle(Box(100, 200.0, 100, 200.0, 0.0, 200.0));
+	  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+	  world->AddObstacle(Box(0.0, 100.0, 0.0, 100.0, 0.0, 100.0));
+	  world->AddObstacle(Box(100, 200.0, 100, 200.0, 0.0, 200.0));
+	  for (NodeContainer::Iterator i = sta.Begin (); i != sta.End (); ++i)
+	    {
+	      (*i)->GetObject<MobilityModel> ()->SetAttribute ("Obstacles", PointerValue (world));
+	    }
 	}
       break;
     case Experiment::DIRECTION:
@@ -113,9 +121,13 @@ Experiment::Run(double simtime, int model, uint32_t nodes, uint32_t speed, bool
       mobility.Install (sta);
       if (withObstacles)
 	{
-	  Ptr<RandomDirection3dMobilityModel> mob = sta.Get(0)->GetObject<RandomDirection3dMobilityModel> ();
-	  mob->AddObstacle(Box(0.0, 100.0, 0.0, 100.0, 0.0, 100.0));
-	  mob->AddObstacle(Box(100, 200.0, 100, 200.0, 0.0, 200.0));
+	  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+	  world->AddObstacle(Box(0.0, 100.0, 0.0, 100.0, 0.0, 100.0));
+	  world->AddObstacle(Box(100, 200.0, 100, 200.0, 0.0, 200.0));
+	  for (NodeContainer::Iterator i = sta.Begin (); i != sta.End (); ++i)
+	    {
+	      (*i)->GetObject<MobilityModel> ()->SetAttribute ("Obstacles", PointerValue (world));
+	    }
 	}
       break;
     case Experiment::GAUSS_MARKOV:
@@ -127,9 +139,13 @@ Experiment::Run(double simtime, int model, uint32_t nodes, uint32_t speed, bool
       mobility.Install (sta);
       if (withObstacles)
 	{
-	  Ptr<ObstacleGaussMarkovMobilityModel> mob = sta.Get(0)->GetObject<ObstacleGaussMarkovMobilityModel> ();
-	  mob->AddObstacle(Box(0.0, 100.0, 0.0, 100.0, 0.0, 100.0));
-	  mob->AddObstacle(Box(100, 200.0, 100, 200.0, 0.0, 200.0));
+	  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+	  world->AddObstacle(Box(0.0, 100.0, 0.0, 100.0, 0.0, 100.0));
+	  world->AddObstacle(Box(100, 200.0, 100, 200.0, 0.0, 200.0));
+	  for (NodeContainer::Iterator i = sta.Begin (); i != sta.End (); ++i)
+	    {
+	      (*i)->GetObject<MobilityModel> ()->SetAttribute ("Obstacles", PointerValue (world));
+	    }
 	}
       break;
   }
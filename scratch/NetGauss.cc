@@ -75,9 +75,13 @@ int main (int argc, char *argv[])
 
   if (withObstacles)
     {
-      Ptr<ObstacleGaussMarkovMobilityModel> mob = sta.Get(0)->GetObject<ObstacleGaussMarkovMobilityModel> ();
-      mob->AddObstacle(Box(0.0, 100.0, 0.0, 100.0, 0.0, 100.0));
-      mob->AddObstacle(Box(100, 200.0, 100, 200.0, 0.0, 200.0));
+      Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+      world->AddObstacle(Box(0.0, 100.0, 0.0, 100.0, 0.0, 100.0));
+      world->AddObstacle(Box(100, 200.0, 100, 200.0, 0.0, 200.0));
+      for (NodeContainer::Iterator i = sta.Begin (); i != sta.End (); ++i)
+	{
+	  (*i)->GetObject<MobilityModel> ()->SetAttribute ("Obstacles", PointerValue (world));
+	}
 
       Ptr<Building> b1 = CreateObject<Building> ();
       b1->SetBoundaries(Box(0.0, 100.0, 0.0, 100.0, 0.0, 100.0));
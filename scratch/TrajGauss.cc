@@ -46,9 +46,13 @@ int main (int argc, char *argv[])
 
   mobility.Install (sta);
 
-  Ptr<ObstacleGaussMarkovMobilityModel> mob = sta.Get(0)->GetObject<ObstacleGaussMarkovMobilityModel> ();
-  mob->AddObstacle(Box(100, 200.0, 100, 200.0, 0.0, 200.0));
-  mob->AddObstacle(Box(0.0, 100.0, 0.0, 100.0, 0.0, 100.0));
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  world->AddObstacle(Box(100, 200.0, 100, 200.0, 0.0, 200.0));
+  world->AddObstacle(Box(0.0, 100.0, 0.0, 100.0, 0.0, 100.0));
+  for (NodeContainer::Iterator i = sta.Begin (); i != sta.End (); ++i)
+    {
+      (*i)->GetObject<MobilityModel> ()->SetAttribute ("Obstacles", PointerValue (world));
+    }
 
   ofstream f;
   f.open(fname, ofstream::out | ofstream::trunc);
@@ -25,6 +25,7 @@
 #include <ns3/building-list.h>
 #include <ns3/mobility-model.h>
 #include <ns3/mobility-building-info.h>
+#include <ns3/obstacle-world.h>
 #include <ns3/abort.h>
 #include <ns3/log.h>
 
@@ -79,28 +80,21 @@ void
 BuildingsHelper::MakeConsistent (Ptr<MobilityModel> mm)
 {
   Ptr<MobilityBuildingInfo> bmm = mm->GetObject<MobilityBuildingInfo> ();
-  bool found = false;
+  NS_ABORT_MSG_UNLESS (0 != bmm, "MobilityModel " << mm << " does not have a MobilityBuildingInfo");
+  bmm->MakeConsistent (mm);
+}
+
+
+Ptr<ObstacleWorld>
+BuildingsHelper::CreateObstacleWorld ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
   for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
     {
-      NS_LOG_LOGIC ("checking building " << (*bit)->GetId () << " with boundaries " << (*bit)->GetBoundaries ());
-      Vector pos = mm->GetPosition ();
-      if ((*bit)->IsInside (pos))
-        {
-          NS_LOG_LOGIC ("MobilityBuildingInfo " << bmm << " pos " << mm->GetPosition () << " falls inside building " << (*bit)->GetId ());
-          NS_ABORT_MSG_UNLESS (found == false, " MobilityBuildingInfo already inside another building!");		
-          found = true;
-          uint16_t floor = (*bit)->GetFloor (pos);
-          uint16_t roomX = (*bit)->GetRoomX (pos);
-          uint16_t roomY = (*bit)->GetRoomY (pos);	   
-          bmm->SetIndoor (*bit, floor, roomX, roomY);	      
-        }		    	  
-    }
-  if (!found)
-    {
-      NS_LOG_LOGIC ("MobilityBuildingInfo " << bmm << " pos " << mm->GetPosition ()  << " is outdoor");
-      bmm->SetOutdoor ();
+      world->AddObstacle ((*bit)->GetBoundaries ());
     }
-
+  return world;
 }
 
 } // namespace ns3
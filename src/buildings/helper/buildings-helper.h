@@ -32,6 +32,7 @@ namespace ns3 {
 
 class MobilityModel;
 class Building;
+class ObstacleWorld;
 
 class BuildingsHelper
 {
@@ -59,10 +60,20 @@ public:
   * Make the given mobility model consistent, by determining whether
   * its position falls inside any of the building in BuildingList, and
   * updating accordingly the BuildingInfo aggregated with the MobilityModel.
+  * The BuildingInfo keeps following the position of the model afterwards,
+  * even if it was marked indoor or outdoor by hand.
   *
   * \param bmm the mobility model to be made consistent
   */
   static void MakeConsistent (Ptr<MobilityModel> bmm);
+  /**
+  * Create an ObstacleWorld holding the boundaries of every building
+  * in BuildingList, to be shared by the 3D obstacle mobility models
+  * through their "Obstacles" attribute.
+  *
+  * \return the new ObstacleWorld
+  */
+  static Ptr<ObstacleWorld> CreateObstacleWorld ();
   
 };
 
@@ -0,0 +1,156 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#include "coverage-map-helper.h"
+#include "ns3/coverage-map.h"
+#include "ns3/mobility-building-info.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/fatal-error.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CoverageMapHelper");
+
+CoverageMapHelper::CoverageMapHelper ()
+  : m_resolution (1.0),
+    m_nProcesses (0)
+{
+}
+
+void
+CoverageMapHelper::SetPropagationLossModel (Ptr<PropagationLossModel> model)
+{
+  m_model = model;
+}
+
+void
+CoverageMapHelper::SetBounds (const Box &bounds)
+{
+  m_bounds = bounds;
+}
+
+void
+CoverageMapHelper::SetResolution (double resolution)
+{
+  NS_ASSERT (resolution > 0.0);
+  m_resolution = resolution;
+}
+
+void
+CoverageMapHelper::AddTransmitter (const Vector &position)
+{
+  m_transmitters.push_back (position);
+}
+
+void
+CoverageMapHelper::SetNProcesses (uint32_t n)
+{
+  m_nProcesses = n;
+}
+
+void
+CoverageMapHelper::Compute (Ptr<CoverageMap> map, uint64_t begin, uint64_t end) const
+{
+  NS_LOG_FUNCTION (this << begin << end);
+  Ptr<MobilityModel> tx = CreateObject<ConstantPositionMobilityModel> ();
+  tx->AggregateObject (CreateObject<MobilityBuildingInfo> ());
+  Ptr<MobilityModel> rx = CreateObject<ConstantPositionMobilityModel> ();
+  rx->AggregateObject (CreateObject<MobilityBuildingInfo> ());
+  uint32_t nx = map->GetNx ();
+  uint32_t ny = map->GetNy ();
+  uint32_t nz = map->GetNz ();
+  for (uint64_t layer = begin; layer < end; layer++)
+    {
+      uint32_t t = layer / nz;
+      uint32_t k = layer % nz;
+      tx->SetPosition (map->GetTransmitter (t));
+      float *losses = map->GetLayer (t, k);
+      for (uint32_t j = 0; j < ny; j++)
+        {
+          for (uint32_t i = 0; i < nx; i++)
+            {
+              rx->SetPosition (map->GetPoint (i, j, k));
+              *losses++ = -m_model->CalcRxPower (0.0, tx, rx);
+            }
+        }
+    }
+}
+
+void
+CoverageMapHelper::Write (std::string filename) const
+{
+  NS_LOG_FUNCTION (this << filename);
+  NS_ASSERT_MSG (m_model != 0, "No propagation loss model to evaluate");
+  if (!CoverageMap::Allocate (filename, m_bounds, m_resolution, m_transmitters))
+    {
+      NS_FATAL_ERROR ("Cannot write coverage map " << filename);
+    }
+  Ptr<CoverageMap> map = Create<CoverageMap> (filename, true);
+  uint64_t layers = uint64_t (map->GetNTransmitters ()) * map->GetNz ();
+  uint64_t processes = m_nProcesses;
+  if (processes == 0)
+    {
+      long online = sysconf (_SC_NPROCESSORS_ONLN);
+      processes = online > 0 ? online : 1;
+    }
+  processes = std::max<uint64_t> (std::min (processes, layers), 1);
+  NS_LOG_INFO ("Computing " << layers << " layers of " << map->GetNx () << "x" << map->GetNy ()
+               << " points in " << processes << " processes");
+
+  // each child writes its share of the layers into the shared mapping,
+  // while the parent computes the first share
+  std::vector<pid_t> children;
+  for (uint64_t p = 1; p < processes; p++)
+    {
+      pid_t pid = fork ();
+      if (pid < 0)
+        {
+          NS_FATAL_ERROR ("Cannot fork the processes computing " << filename);
+        }
+      if (pid == 0)
+        {
+          Compute (map, layers * p / processes, layers * (p + 1) / processes);
+          // skip the destructors and buffers shared with the parent
+          _exit (0);
+        }
+      children.push_back (pid);
+    }
+  Compute (map, 0, layers / processes);
+
+  bool failed = false;
+  for (std::vector<pid_t>::const_iterator it = children.begin (); it != children.end (); ++it)
+    {
+      int status;
+      if (waitpid (*it, &status, 0) != *it || !WIFEXITED (status) || WEXITSTATUS (status) != 0)
+        {
+          failed = true;
+        }
+    }
+  if (failed)
+    {
+      NS_FATAL_ERROR ("A process computing the coverage map " << filename << " failed");
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,115 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#ifndef COVERAGE_MAP_HELPER_H
+#define COVERAGE_MAP_HELPER_H
+
+#include <string>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/box.h"
+#include "ns3/vector.h"
+#include "ns3/propagation-loss-model.h"
+
+namespace ns3 {
+
+class CoverageMap;
+class MobilityModel;
+
+/**
+ * \ingroup buildings
+ * \brief Precompute the path loss of fixed transmitters over a 3D grid.
+ *
+ * The loss of a propagation model, with the chain of models after it,
+ * is evaluated from every transmitter added to every point of a grid
+ * covering the bounds, and written to a CoverageMap file, to be used
+ * later through CoverageMapPropagationLossModel. Both ends of every link
+ * carry a MobilityBuildingInfo, so the building-aware models can be
+ * used; a line-of-sight mask is obtained with an
+ * ObstaclePropagationLossModel set to "LineOfSightOnly".
+ *
+ * The horizontal layers of the grid are shared between several
+ * processes forked from the simulation, each one writing its layers
+ * directly into the mapped file. The models must therefore be
+ * deterministic for the map to be reproducible: random models draw
+ * different values in each process.
+ * \code
+    CoverageMapHelper coverage;
+    coverage.SetPropagationLossModel (model);
+    coverage.SetBounds (Box (0, 1000, 0, 1000, 0, 120));
+    coverage.SetResolution (5.0);
+    coverage.AddTransmitter (Vector (500, 500, 30));
+    coverage.Write ("city.covm");
+ * \endcode
+ */
+class CoverageMapHelper
+{
+public:
+  CoverageMapHelper ();
+
+  /**
+   * \param model the model to evaluate
+   */
+  void SetPropagationLossModel (Ptr<PropagationLossModel> model);
+  /**
+   * \param bounds the box to cover
+   */
+  void SetBounds (const Box &bounds);
+  /**
+   * \param resolution the step between the points of the grid, 1 m by
+   *        default
+   */
+  void SetResolution (double resolution);
+  /**
+   * \param position the position of a transmitter
+   */
+  void AddTransmitter (const Vector &position);
+  /**
+   * \param n the number of processes computing the map; 0, the default,
+   *        uses one per online processor
+   */
+  void SetNProcesses (uint32_t n);
+
+  /**
+   * Compute the map and write it. Aborts the simulation if the file
+   * cannot be written, or a process fails.
+   * \param filename the file to write
+   */
+  void Write (std::string filename) const;
+
+private:
+  /**
+   * Compute a range of the horizontal layers of all the transmitters
+   * \param map the writable map
+   * \param begin the first layer, counting the layers of each
+   *        transmitter in turn
+   * \param end one past the last layer
+   */
+  void Compute (Ptr<CoverageMap> map, uint64_t begin, uint64_t end) const;
+
+  Ptr<PropagationLossModel> m_model; //!< model evaluated
+  Box m_bounds; //!< box covered
+  double m_resolution; //!< step between the points
+  std::vector<Vector> m_transmitters; //!< positions of the transmitters
+  uint32_t m_nProcesses; //!< number of processes, or 0
+};
+
+} // namespace ns3
+
+#endif /* COVERAGE_MAP_HELPER_H */
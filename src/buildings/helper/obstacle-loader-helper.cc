@@ -0,0 +1,1332 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#include "obstacle-loader-helper.h"
+#include "ns3/building.h"
+#include "ns3/obstacle-shape.h"
+#include "ns3/fatal-error.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sys/stat.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ObstacleLoaderHelper");
+
+/**
+ * Largest number of distinct points of an OBJ object turned into a
+ * ConvexObstacle, whose construction is quartic in it; bigger objects
+ * are replaced by their bounding box.
+ */
+static const uint32_t MAX_HULL_POINTS = 128;
+
+/** Version of the layout of the cache files */
+static const uint32_t CACHE_VERSION = 1;
+
+/**
+ * Reads the tokens of a JSON document in place, without building a tree
+ */
+class JsonCursor
+{
+public:
+  /**
+   * \param begin the document, terminated by a null character
+   * \param end one past the last character of the document
+   */
+  JsonCursor (const char *begin, const char *end)
+    : m_begin (begin),
+      m_p (begin),
+      m_end (end)
+  {
+  }
+  /**
+   * \return the offset of the next character to read
+   */
+  size_t GetOffset (void) const
+  {
+    return m_p - m_begin;
+  }
+  /**
+   * Skip the blanks before the next token
+   */
+  void SkipBlanks (void)
+  {
+    while (m_p < m_end && (*m_p == ' ' || *m_p == '\n' || *m_p == '\r' || *m_p == '\t'))
+      {
+        ++m_p;
+      }
+  }
+  /**
+   * \param c a structural character
+   * \return true if the next token is c
+   */
+  bool Peek (char c)
+  {
+    SkipBlanks ();
+    return m_p < m_end && *m_p == c;
+  }
+  /**
+   * \param c a structural character
+   * \return true if the next token was c, and was consumed
+   */
+  bool Consume (char c)
+  {
+    if (Peek (c))
+      {
+        ++m_p;
+        return true;
+      }
+    return false;
+  }
+  /**
+   * \param s on output, the string read, with its escapes left as they are
+   * \return true if a string was read
+   */
+  bool ReadString (std::string &s)
+  {
+    if (!Consume ('"'))
+      {
+        return false;
+      }
+    const char *start = m_p;
+    while (m_p < m_end && *m_p != '"')
+      {
+        m_p += (*m_p == '\\') ? 2 : 1;
+      }
+    if (m_p >= m_end)
+      {
+        return false;
+      }
+    s.assign (start, m_p);
+    ++m_p;
+    return true;
+  }
+  /**
+   * \param v on output, the number read
+   * \return true if a number was read
+   */
+  bool ReadNumber (double &v)
+  {
+    SkipBlanks ();
+    char *end;
+    v = std::strtod (m_p, &end);
+    if (end == m_p)
+      {
+        return false;
+      }
+    m_p = end;
+    return true;
+  }
+  /**
+   * Skip a value of any type
+   * \return true if a value was skipped
+   */
+  bool SkipValue (void)
+  {
+    SkipBlanks ();
+    if (m_p >= m_end)
+      {
+        return false;
+      }
+    std::string s;
+    switch (*m_p)
+      {
+      case '"':
+        return ReadString (s);
+      case '{':
+        ++m_p;
+        if (Consume ('}'))
+          {
+            return true;
+          }
+        do
+          {
+            if (!ReadString (s) || !Consume (':') || !SkipValue ())
+              {
+                return false;
+              }
+          }
+        while (Consume (','));
+        return Consume ('}');
+      case '[':
+        ++m_p;
+        if (Consume (']'))
+          {
+            return true;
+          }
+        do
+          {
+            if (!SkipValue ())
+              {
+                return false;
+              }
+          }
+        while (Consume (','));
+        return Consume (']');
+      default:
+        {
+          // number, true, false or null
+          const char *start = m_p;
+          while (m_p < m_end && (std::isalnum (*m_p) || *m_p == '-' || *m_p == '+' || *m_p == '.'))
+            {
+              ++m_p;
+            }
+          return m_p != start;
+        }
+      }
+  }
+
+private:
+  const char *m_begin; //!< start of the document
+  const char *m_p; //!< next character to read
+  const char *m_end; //!< end of the document
+};
+
+/** A ring of positions of a GeoJSON geometry */
+struct GeoJsonRing
+{
+  std::vector<Vector2D> positions; //!< positions, x and y only
+  uint32_t depth; //!< nesting depth of the ring in the coordinates
+  bool first; //!< whether the ring is the first of its parent array
+};
+
+/** The parts of a GeoJSON feature needed to extrude it */
+struct GeoJsonFeature
+{
+  std::string type; //!< type of the geometry
+  std::vector<GeoJsonRing> rings; //!< rings of the geometry
+  double height; //!< height property, NaN if missing
+  double minHeight; //!< min_height property
+  bool hasGeometry; //!< whether a geometry was found
+  size_t where; //!< offset of the feature in the document
+};
+
+/**
+ * \param c the cursor, before a coordinates array
+ * \param depth the nesting depth of the array
+ * \param first whether the array is the first of its parent
+ * \param rings the rings read so far, completed on output
+ * \return true if the array was read
+ */
+static bool
+ReadCoordinates (JsonCursor &c, uint32_t depth, bool first, std::vector<GeoJsonRing> &rings)
+{
+  if (!c.Consume ('['))
+    {
+      return false;
+    }
+  if (c.Consume (']'))
+    {
+      return true;
+    }
+  if (!c.Peek ('['))
+    {
+      // a single position, as in a Point
+      double v;
+      do
+        {
+          if (!c.ReadNumber (v))
+            {
+              return false;
+            }
+        }
+      while (c.Consume (','));
+      return c.Consume (']');
+    }
+  JsonCursor peek = c;
+  peek.Consume ('[');
+  if (!peek.Peek ('['))
+    {
+      // an array of positions
+      rings.push_back (GeoJsonRing ());
+      GeoJsonRing &ring = rings.back ();
+      ring.depth = depth;
+      ring.first = first;
+      do
+        {
+          double x, y, z;
+          if (!c.Consume ('[') || !c.ReadNumber (x) || !c.Consume (',') || !c.ReadNumber (y))
+            {
+              return false;
+            }
+          while (c.Consume (','))
+            {
+              if (!c.ReadNumber (z))
+                {
+                  return false;
+                }
+            }
+          if (!c.Consume (']'))
+            {
+              return false;
+            }
+          ring.positions.push_back (Vector2D (x, y));
+        }
+      while (c.Consume (','));
+      return c.Consume (']');
+    }
+  bool firstChild = true;
+  do
+    {
+      if (!ReadCoordinates (c, depth + 1, firstChild, rings))
+        {
+          return false;
+        }
+      firstChild = false;
+    }
+  while (c.Consume (','));
+  return c.Consume (']');
+}
+
+/**
+ * \param c the cursor, before the value of a height property
+ * \param v on output, the height, NaN if it is not a number
+ * \return true if a value was read
+ */
+static bool
+ReadHeight (JsonCursor &c, double &v)
+{
+  if (c.Peek ('"'))
+    {
+      // heights are often strings in exported maps
+      std::string s;
+      if (!c.ReadString (s))
+        {
+          return false;
+        }
+      char *end;
+      v = std::strtod (s.c_str (), &end);
+      if (end == s.c_str ())
+        {
+          v = std::numeric_limits<double>::quiet_NaN ();
+        }
+      return true;
+    }
+  if (c.ReadNumber (v))
+    {
+      return true;
+    }
+  v = std::numeric_limits<double>::quiet_NaN ();
+  return c.SkipValue ();
+}
+
+/**
+ * \param c the cursor, after the colon following the key
+ * \param key a key of a feature object
+ * \param f the feature, completed on output
+ * \return true if the value was read
+ */
+static bool
+ReadFeatureMember (JsonCursor &c, const std::string &key, GeoJsonFeature &f)
+{
+  std::string k;
+  if (key == "geometry" && c.Peek ('{'))
+    {
+      c.Consume ('{');
+      f.hasGeometry = true;
+      if (c.Consume ('}'))
+        {
+          return true;
+        }
+      do
+        {
+          if (!c.ReadString (k) || !c.Consume (':'))
+            {
+              return false;
+            }
+          bool ok;
+          if (k == "type")
+            {
+              ok = c.ReadString (f.type);
+            }
+          else if (k == "coordinates")
+            {
+              ok = ReadCoordinates (c, 0, true, f.rings);
+            }
+          else
+            {
+              ok = c.SkipValue ();
+            }
+          if (!ok)
+            {
+              return false;
+            }
+        }
+      while (c.Consume (','));
+      return c.Consume ('}');
+    }
+  else if (key == "properties" && c.Peek ('{'))
+    {
+      c.Consume ('{');
+      if (c.Consume ('}'))
+        {
+          return true;
+        }
+      do
+        {
+          if (!c.ReadString (k) || !c.Consume (':'))
+            {
+              return false;
+            }
+          bool ok;
+          if (k == "height")
+            {
+              ok = ReadHeight (c, f.height);
+            }
+          else if (k == "min_height")
+            {
+              ok = ReadHeight (c, f.minHeight);
+            }
+          else
+            {
+              ok = c.SkipValue ();
+            }
+          if (!ok)
+            {
+              return false;
+            }
+        }
+      while (c.Consume (','));
+      return c.Consume ('}');
+    }
+  return c.SkipValue ();
+}
+
+/**
+ * \param f the feature to reset
+ * \param where the offset of the feature in the document
+ */
+static void
+ClearFeature (GeoJsonFeature &f, size_t where)
+{
+  f.type.clear ();
+  f.rings.clear ();
+  f.height = std::numeric_limits<double>::quiet_NaN ();
+  f.minHeight = 0.0;
+  f.hasGeometry = false;
+  f.where = where;
+}
+
+/** Orders boxes to bring together those that may be merged along an axis */
+class BoxSweepLess
+{
+public:
+  /**
+   * \param axis the axis along which boxes are merged
+   */
+  BoxSweepLess (int axis)
+    : m_axis (axis)
+  {
+  }
+  /**
+   * \param b a box
+   * \param axis an axis
+   * \return the lower bound of the box along the axis
+   */
+  static double Low (const Box &b, int axis)
+  {
+    return axis == 0 ? b.xMin : (axis == 1 ? b.yMin : b.zMin);
+  }
+  /**
+   * \param b a box
+   * \param axis an axis
+   * \return the upper bound of the box along the axis
+   */
+  static double High (const Box &b, int axis)
+  {
+    return axis == 0 ? b.xMax : (axis == 1 ? b.yMax : b.zMax);
+  }
+  /**
+   * \param a a box
+   * \param b another box
+   * \param axis an axis
+   * \return true if the boxes have the same section across the axis
+   */
+  static bool SameSection (const Box &a, const Box &b, int axis)
+  {
+    int u = (axis + 1) % 3;
+    int v = (axis + 2) % 3;
+    return Low (a, u) == Low (b, u) && High (a, u) == High (b, u)
+           && Low (a, v) == Low (b, v) && High (a, v) == High (b, v);
+  }
+  /**
+   * \param a a box
+   * \param b another box
+   * \return true if a comes before b: by section across the axis, then
+   *         along the axis
+   */
+  bool operator () (const Box &a, const Box &b) const
+  {
+    int u = (m_axis + 1) % 3;
+    int v = (m_axis + 2) % 3;
+    double ka[5] = { Low (a, u), High (a, u), Low (a, v), High (a, v), Low (a, m_axis) };
+    double kb[5] = { Low (b, u), High (b, u), Low (b, v), High (b, v), Low (b, m_axis) };
+    return std::lexicographical_compare (ka, ka + 5, kb, kb + 5);
+  }
+private:
+  int m_axis; //!< axis along which boxes are merged
+};
+
+/**
+ * \param v a value
+ * \return true if the value is neither infinite nor NaN
+ */
+static inline bool
+IsFinite (double v)
+{
+  return v - v == 0.0;
+}
+
+/**
+ * \param a first end of a segment
+ * \param b second end of the segment
+ * \param c first end of another segment
+ * \param d second end of the other segment
+ * \return true if the segments cross at a point inside both
+ */
+static bool
+SegmentsCross (const Vector2D &a, const Vector2D &b, const Vector2D &c, const Vector2D &d)
+{
+  double d1 = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+  double d2 = (b.x - a.x) * (d.y - a.y) - (b.y - a.y) * (d.x - a.x);
+  double d3 = (d.x - c.x) * (a.y - c.y) - (d.y - c.y) * (a.x - c.x);
+  double d4 = (d.x - c.x) * (b.y - c.y) - (d.y - c.y) * (b.x - c.x);
+  return ((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0));
+}
+
+/** Orders points lexicographically, to remove the repeated ones */
+static bool
+PointLess (const Vector &a, const Vector &b)
+{
+  if (a.x != b.x)
+    {
+      return a.x < b.x;
+    }
+  if (a.y != b.y)
+    {
+      return a.y < b.y;
+    }
+  return a.z < b.z;
+}
+
+/** \return true if both points are the same */
+static bool
+PointEqual (const Vector &a, const Vector &b)
+{
+  return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+ObstacleLoaderHelper::ObstacleLoaderHelper ()
+  : m_createBuildings (true),
+    m_floorHeight (0.0),
+    m_defaultHeight (0.0),
+    m_merge (true),
+    m_strict (false),
+    m_byLine (true),
+    m_skipped (0),
+    m_nObstacles (0)
+{
+  m_buildingFactory.SetTypeId ("ns3::Building");
+}
+
+void
+ObstacleLoaderHelper::SetWorld (Ptr<ObstacleWorld> world)
+{
+  m_world = world;
+}
+
+void
+ObstacleLoaderHelper::SetCreateBuildings (bool create)
+{
+  m_createBuildings = create;
+}
+
+void
+ObstacleLoaderHelper::SetBuildingAttribute (std::string n, const AttributeValue &v)
+{
+  m_buildingFactory.Set (n, v);
+}
+
+void
+ObstacleLoaderHelper::SetFloorHeight (double height)
+{
+  m_floorHeight = height;
+}
+
+void
+ObstacleLoaderHelper::SetDefaultHeight (double height)
+{
+  m_defaultHeight = height;
+}
+
+void
+ObstacleLoaderHelper::SetMergeBoxes (bool merge)
+{
+  m_merge = merge;
+}
+
+void
+ObstacleLoaderHelper::SetCacheFile (std::string filename)
+{
+  m_cacheFile = filename;
+}
+
+void
+ObstacleLoaderHelper::SetStrict (bool strict)
+{
+  m_strict = strict;
+}
+
+uint32_t
+ObstacleLoaderHelper::GetNSkipped (void) const
+{
+  return m_skipped;
+}
+
+uint32_t
+ObstacleLoaderHelper::GetNObstacles (void) const
+{
+  return m_nObstacles;
+}
+
+uint32_t
+ObstacleLoaderHelper::Load (std::string filename, Format format)
+{
+  NS_LOG_FUNCTION (this << filename << format);
+  m_filename = filename;
+  m_skipped = 0;
+  m_nObstacles = 0;
+  m_footprints.clear ();
+  m_boxes.clear ();
+  m_prisms.clear ();
+  m_vertices.clear ();
+  m_hulls.clear ();
+  m_points.clear ();
+
+  if (format == AUTO)
+    {
+      std::string extension = filename.substr (filename.find_last_of ('.') + 1);
+      std::transform (extension.begin (), extension.end (), extension.begin (), ::tolower);
+      if (extension == "geojson" || extension == "json")
+        {
+          format = GEOJSON;
+        }
+      else if (extension == "obj")
+        {
+          format = OBJ;
+        }
+      else
+        {
+          format = CSV;
+        }
+    }
+
+  struct stat st;
+  if (stat (filename.c_str (), &st) != 0)
+    {
+      NS_FATAL_ERROR ("Cannot open obstacle file " << filename);
+    }
+  // anything that changes what the parse produces
+  std::vector<uint64_t> key;
+  key.push_back (format);
+  key.push_back (m_merge);
+  key.push_back (st.st_size);
+  key.push_back (st.st_mtime);
+  uint64_t height;
+  std::memcpy (&height, &m_defaultHeight, sizeof (height));
+  key.push_back (height);
+
+  if (m_cacheFile.empty () || !ReadCache (key))
+    {
+      std::FILE *file = std::fopen (filename.c_str (), "rb");
+      if (file == 0)
+        {
+          NS_FATAL_ERROR ("Cannot open obstacle file " << filename);
+        }
+      std::vector<char> buffer (st.st_size + 1);
+      size_t size = std::fread (&buffer[0], 1, st.st_size, file);
+      std::fclose (file);
+      buffer[size] = '\0';
+
+      switch (format)
+        {
+        case GEOJSON:
+          m_byLine = false;
+          ParseGeoJson (&buffer[0], size);
+          break;
+        case OBJ:
+          m_byLine = true;
+          ParseObj (&buffer[0], size);
+          break;
+        default:
+          m_byLine = true;
+          ParseCsv (&buffer[0], size);
+          break;
+        }
+      if (m_merge)
+        {
+          MergeBoxes ();
+        }
+      if (!m_cacheFile.empty ())
+        {
+          WriteCache (key);
+        }
+    }
+  Emit ();
+  NS_LOG_INFO (filename << ": " << m_footprints.size () << " footprints, " << m_nObstacles
+                        << " obstacles, " << m_skipped << " skipped");
+  return m_footprints.size ();
+}
+
+void
+ObstacleLoaderHelper::Skip (const std::string &reason, size_t where)
+{
+  m_skipped++;
+  if (m_strict)
+    {
+      NS_FATAL_ERROR (m_filename << (m_byLine ? ", line " : ", byte ") << where << ": " << reason);
+    }
+  NS_LOG_WARN (m_filename << (m_byLine ? ", line " : ", byte ") << where << ": " << reason << ", skipped");
+}
+
+void
+ObstacleLoaderHelper::ParseCsv (const char *buffer, size_t size)
+{
+  const char *p = buffer;
+  const char *end = buffer + size;
+  size_t line = 0;
+  while (p < end)
+    {
+      const char *eol = static_cast<const char *> (std::memchr (p, '\n', end - p));
+      if (eol == 0)
+        {
+          eol = end;
+        }
+      line++;
+      while (p < eol && (*p == ' ' || *p == '\t' || *p == '\r'))
+        {
+          ++p;
+        }
+      if (p < eol && *p != '#')
+        {
+          double v[6];
+          uint32_t n = 0;
+          while (true)
+            {
+              while (p < eol && (*p == ',' || *p == ';' || *p == ' ' || *p == '\t' || *p == '\r'))
+                {
+                  ++p;
+                }
+              if (p >= eol || n == 6)
+                {
+                  break;
+                }
+              char *next;
+              v[n] = std::strtod (p, &next);
+              if (next == p)
+                {
+                  break;
+                }
+              p = next;
+              n++;
+            }
+          if (n == 6 && p >= eol)
+            {
+              AddBox (Box (v[0], v[1], v[2], v[3], v[4], v[5]), line);
+            }
+          else if (line > 1 || n > 0)
+            {
+              Skip ("expected 6 numbers", line);
+            }
+        }
+      p = eol + 1;
+    }
+}
+
+void
+ObstacleLoaderHelper::ParseGeoJson (const char *buffer, size_t size)
+{
+  JsonCursor c (buffer, buffer + size);
+  GeoJsonFeature top;
+  GeoJsonFeature feature;
+  ClearFeature (top, 0);
+  bool ok = c.Consume ('{');
+  if (ok && !c.Consume ('}'))
+    {
+      do
+        {
+          std::string key;
+          ok = c.ReadString (key) && c.Consume (':');
+          if (ok && key == "features")
+            {
+              // a FeatureCollection, read one feature at a time
+              ok = c.Consume ('[');
+              if (ok && !c.Consume (']'))
+                {
+                  do
+                    {
+                      ClearFeature (feature, c.GetOffset ());
+                      ok = c.Consume ('{');
+                      if (ok && !c.Consume ('}'))
+                        {
+                          do
+                            {
+                              ok = c.ReadString (key) && c.Consume (':')
+                                && ReadFeatureMember (c, key, feature);
+                            }
+                          while (ok && c.Consume (','));
+                          ok = ok && c.Consume ('}');
+                        }
+                      if (ok)
+                        {
+                          AddFeature (feature);
+                        }
+                    }
+                  while (ok && c.Consume (','));
+                  ok = ok && c.Consume (']');
+                }
+            }
+          else if (ok)
+            {
+              ok = ReadFeatureMember (c, key, top);
+            }
+        }
+      while (ok && c.Consume (','));
+      ok = ok && c.Consume ('}');
+    }
+  if (!ok)
+    {
+      NS_FATAL_ERROR (m_filename << ": malformed GeoJSON at byte " << c.GetOffset ());
+    }
+  // a single feature at the top level
+  if (top.hasGeometry)
+    {
+      AddFeature (top);
+    }
+}
+
+void
+ObstacleLoaderHelper::AddFeature (const GeoJsonFeature &f)
+{
+  if (!f.hasGeometry)
+    {
+      Skip ("no geometry", f.where);
+      return;
+    }
+  if (f.type != "Polygon" && f.type != "MultiPolygon")
+    {
+      Skip ("unsupported geometry type \"" + f.type + "\"", f.where);
+      return;
+    }
+  bool hasHeight = f.height == f.height;
+  if (!hasHeight && m_defaultHeight <= 0.0)
+    {
+      Skip ("no height", f.where);
+      return;
+    }
+  // the outer ring of each polygon
+  uint32_t depth = f.type == "MultiPolygon" ? 2 : 1;
+  for (std::vector<GeoJsonRing>::const_iterator r = f.rings.begin (); r != f.rings.end (); ++r)
+    {
+      if (r->depth == depth && r->first)
+        {
+          AddPolygon (r->positions, f.minHeight, hasHeight ? f.height : m_defaultHeight, f.where);
+        }
+    }
+}
+
+void
+ObstacleLoaderHelper::ParseObj (const char *buffer, size_t size)
+{
+  std::vector<Vector> vertices;
+  std::vector<Vector> object;
+  size_t objectLine = 1;
+  const char *p = buffer;
+  const char *end = buffer + size;
+  size_t line = 0;
+  while (p < end)
+    {
+      const char *eol = static_cast<const char *> (std::memchr (p, '\n', end - p));
+      if (eol == 0)
+        {
+          eol = end;
+        }
+      line++;
+      while (p < eol && (*p == ' ' || *p == '\t'))
+        {
+          ++p;
+        }
+      if (eol - p >= 2 && p[0] == 'v' && (p[1] == ' ' || p[1] == '\t'))
+        {
+          char *next;
+          double x = std::strtod (p + 1, &next);
+          double y = std::strtod (next, &next);
+          double z = std::strtod (next, &next);
+          vertices.push_back (Vector (x, y, z));
+        }
+      else if (eol - p >= 2 && p[0] == 'f' && (p[1] == ' ' || p[1] == '\t'))
+        {
+          const char *q = p + 1;
+          while (true)
+            {
+              while (q < eol && (*q == ' ' || *q == '\t' || *q == '\r'))
+                {
+                  ++q;
+                }
+              if (q >= eol)
+                {
+                  break;
+                }
+              char *next;
+              long index = std::strtol (q, &next, 10);
+              if (next == q)
+                {
+                  Skip ("malformed face", line);
+                  break;
+                }
+              // indices are 1-based, or relative to the end if negative
+              long i = index > 0 ? index - 1 : static_cast<long> (vertices.size ()) + index;
+              if (index == 0 || i < 0 || i >= static_cast<long> (vertices.size ()))
+                {
+                  Skip ("face vertex out of range", line);
+                  break;
+                }
+              object.push_back (vertices[i]);
+              // skip the texture and normal indices
+              q = next;
+              while (q < eol && *q != ' ' && *q != '\t' && *q != '\r')
+                {
+                  ++q;
+                }
+            }
+        }
+      else if (eol - p >= 1 && (p[0] == 'o' || p[0] == 'g')
+               && (eol - p == 1 || p[1] == ' ' || p[1] == '\t' || p[1] == '\r'))
+        {
+          if (!object.empty ())
+            {
+              AddHull (object, objectLine);
+              object.clear ();
+            }
+          objectLine = line;
+        }
+      p = eol + 1;
+    }
+  if (!object.empty ())
+    {
+      AddHull (object, objectLine);
+    }
+}
+
+void
+ObstacleLoaderHelper::AddBox (const Box &box, size_t where)
+{
+  if (!IsFinite (box.xMin) || !IsFinite (box.xMax) || !IsFinite (box.yMin)
+      || !IsFinite (box.yMax) || !IsFinite (box.zMin) || !IsFinite (box.zMax))
+    {
+      Skip ("non-finite coordinate", where);
+      return;
+    }
+  if (!(box.xMin < box.xMax && box.yMin < box.yMax && box.zMin < box.zMax))
+    {
+      Skip ("empty box", where);
+      return;
+    }
+  m_footprints.push_back (box);
+  m_boxes.push_back (box);
+}
+
+void
+ObstacleLoaderHelper::AddPolygon (std::vector<Vector2D> ring, double zMin, double zMax, size_t where)
+{
+  if (!IsFinite (zMin) || !IsFinite (zMax) || !(zMin < zMax))
+    {
+      Skip ("invalid heights", where);
+      return;
+    }
+  // drop the repeated vertices, such as the closing one
+  std::vector<Vector2D> polygon;
+  polygon.reserve (ring.size ());
+  for (uint32_t i = 0; i < ring.size (); i++)
+    {
+      if (!IsFinite (ring[i].x) || !IsFinite (ring[i].y))
+        {
+          Skip ("non-finite coordinate", where);
+          return;
+        }
+      if (polygon.empty () || polygon.back ().x != ring[i].x || polygon.back ().y != ring[i].y)
+        {
+          polygon.push_back (ring[i]);
+        }
+    }
+  while (polygon.size () > 1 && polygon.back ().x == polygon[0].x && polygon.back ().y == polygon[0].y)
+    {
+      polygon.pop_back ();
+    }
+  uint32_t n = polygon.size ();
+  if (n < 3)
+    {
+      Skip ("polygon with less than 3 vertices", where);
+      return;
+    }
+  double area = 0.0;
+  Box bounds (polygon[0].x, polygon[0].x, polygon[0].y, polygon[0].y, zMin, zMax);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      const Vector2D &a = polygon[i];
+      const Vector2D &b = polygon[(i + 1) % n];
+      area += a.x * b.y - b.x * a.y;
+      bounds.xMin = std::min (bounds.xMin, a.x);
+      bounds.xMax = std::max (bounds.xMax, a.x);
+      bounds.yMin = std::min (bounds.yMin, a.y);
+      bounds.yMax = std::max (bounds.yMax, a.y);
+    }
+  if (area == 0.0)
+    {
+      Skip ("polygon without area", where);
+      return;
+    }
+  for (uint32_t i = 0; i < n; i++)
+    {
+      for (uint32_t j = i + 2; j < n; j++)
+        {
+          if (i == 0 && j == n - 1)
+            {
+              continue;
+            }
+          if (SegmentsCross (polygon[i], polygon[i + 1], polygon[j], polygon[(j + 1) % n]))
+            {
+              Skip ("polygon with crossing edges", where);
+              return;
+            }
+        }
+    }
+
+  bool rectangle = n == 4;
+  for (uint32_t i = 0; i < n && rectangle; i++)
+    {
+      const Vector2D &a = polygon[i];
+      const Vector2D &b = polygon[(i + 1) % n];
+      rectangle = a.x == b.x || a.y == b.y;
+    }
+  m_footprints.push_back (bounds);
+  if (rectangle)
+    {
+      m_boxes.push_back (bounds);
+      return;
+    }
+  Prism prism;
+  prism.start = m_vertices.size ();
+  prism.count = n;
+  prism.zMin = zMin;
+  prism.zMax = zMax;
+  m_prisms.push_back (prism);
+  m_vertices.insert (m_vertices.end (), polygon.begin (), polygon.end ());
+}
+
+void
+ObstacleLoaderHelper::AddHull (std::vector<Vector> points, size_t where)
+{
+  for (uint32_t i = 0; i < points.size (); i++)
+    {
+      if (!IsFinite (points[i].x) || !IsFinite (points[i].y) || !IsFinite (points[i].z))
+        {
+          Skip ("non-finite coordinate", where);
+          return;
+        }
+    }
+  std::sort (points.begin (), points.end (), &PointLess);
+  points.erase (std::unique (points.begin (), points.end (), &PointEqual), points.end ());
+  if (points.size () < 4)
+    {
+      Skip ("object with less than 4 vertices", where);
+      return;
+    }
+  Box bounds (points[0].x, points[0].x, points[0].y, points[0].y, points[0].z, points[0].z);
+  for (uint32_t i = 1; i < points.size (); i++)
+    {
+      bounds.xMin = std::min (bounds.xMin, points[i].x);
+      bounds.xMax = std::max (bounds.xMax, points[i].x);
+      bounds.yMin = std::min (bounds.yMin, points[i].y);
+      bounds.yMax = std::max (bounds.yMax, points[i].y);
+      bounds.zMin = std::min (bounds.zMin, points[i].z);
+      bounds.zMax = std::max (bounds.zMax, points[i].z);
+    }
+  if (!(bounds.xMin < bounds.xMax && bounds.yMin < bounds.yMax && bounds.zMin < bounds.zMax))
+    {
+      Skip ("flat object", where);
+      return;
+    }
+
+  // the 8 corners of the bounding box, and nothing else, make a box
+  bool box = points.size () == 8;
+  for (uint32_t i = 0; i < points.size () && box; i++)
+    {
+      box = (points[i].x == bounds.xMin || points[i].x == bounds.xMax)
+        && (points[i].y == bounds.yMin || points[i].y == bounds.yMax)
+        && (points[i].z == bounds.zMin || points[i].z == bounds.zMax);
+    }
+  if (box || points.size () > MAX_HULL_POINTS)
+    {
+      if (!box)
+        {
+          NS_LOG_WARN (m_filename << ", line " << where << ": object with " << points.size ()
+                                  << " vertices replaced by its bounding box");
+        }
+      m_footprints.push_back (bounds);
+      m_boxes.push_back (bounds);
+      return;
+    }
+
+  // a flat object passes the bounds check when tilted: look for a point
+  // off the plane of three others
+  const Vector &a = points[0];
+  uint32_t b = 1;
+  double farthest = 0.0;
+  for (uint32_t i = 1; i < points.size (); i++)
+    {
+      double d = CalculateDistance (a, points[i]);
+      if (d > farthest)
+        {
+          farthest = d;
+          b = i;
+        }
+    }
+  Vector u (points[b].x - a.x, points[b].y - a.y, points[b].z - a.z);
+  Vector normal;
+  double largest = 0.0;
+  for (uint32_t i = 1; i < points.size (); i++)
+    {
+      Vector v (points[i].x - a.x, points[i].y - a.y, points[i].z - a.z);
+      Vector n (u.y * v.z - u.z * v.y, u.z * v.x - u.x * v.z, u.x * v.y - u.y * v.x);
+      double length = std::sqrt (n.x * n.x + n.y * n.y + n.z * n.z);
+      if (length > largest)
+        {
+          largest = length;
+          normal = Vector (n.x / length, n.y / length, n.z / length);
+        }
+    }
+  double height = 0.0;
+  for (uint32_t i = 1; i < points.size () && largest > 0.0; i++)
+    {
+      height = std::max (height, std::abs (normal.x * (points[i].x - a.x) + normal.y * (points[i].y - a.y)
+                                           + normal.z * (points[i].z - a.z)));
+    }
+  if (height <= 1e-9 * farthest)
+    {
+      Skip ("flat object", where);
+      return;
+    }
+  m_footprints.push_back (bounds);
+  Hull hull;
+  hull.start = m_points.size ();
+  hull.count = points.size ();
+  m_hulls.push_back (hull);
+  m_points.insert (m_points.end (), points.begin (), points.end ());
+}
+
+void
+ObstacleLoaderHelper::MergeBoxes (void)
+{
+  NS_LOG_FUNCTION (this << m_boxes.size ());
+  // sweep the axes in turn, until none merges anything
+  int idle = 0;
+  int axis = 0;
+  std::vector<Box> merged;
+  while (idle < 3 && m_boxes.size () > 1)
+    {
+      std::sort (m_boxes.begin (), m_boxes.end (), BoxSweepLess (axis));
+      merged.clear ();
+      for (std::vector<Box>::const_iterator i = m_boxes.begin (); i != m_boxes.end (); ++i)
+        {
+          if (!merged.empty () && BoxSweepLess::SameSection (merged.back (), *i, axis)
+              && BoxSweepLess::Low (*i, axis) <= BoxSweepLess::High (merged.back (), axis))
+            {
+              Box &last = merged.back ();
+              double high = std::max (BoxSweepLess::High (last, axis), BoxSweepLess::High (*i, axis));
+              switch (axis)
+                {
+                case 0:
+                  last.xMax = high;
+                  break;
+                case 1:
+                  last.yMax = high;
+                  break;
+                default:
+                  last.zMax = high;
+                  break;
+                }
+            }
+          else
+            {
+              merged.push_back (*i);
+            }
+        }
+      idle = (merged.size () < m_boxes.size ()) ? 0 : idle + 1;
+      m_boxes.swap (merged);
+      axis = (axis + 1) % 3;
+    }
+  NS_LOG_LOGIC ("merged into " << m_boxes.size () << " boxes");
+}
+
+/**
+ * \param file the file to read from
+ * \param v the vector to fill, already sized
+ * \return true if the vector was filled
+ */
+template <typename T>
+static bool
+ReadArray (std::FILE *file, std::vector<T> &v)
+{
+  return v.empty () || std::fread (&v[0], sizeof (T), v.size (), file) == v.size ();
+}
+
+/**
+ * \param file the file to write to
+ * \param v the vector to write
+ * \return true if the vector was written
+ */
+template <typename T>
+static bool
+WriteArray (std::FILE *file, const std::vector<T> &v)
+{
+  return v.empty () || std::fwrite (&v[0], sizeof (T), v.size (), file) == v.size ();
+}
+
+bool
+ObstacleLoaderHelper::ReadCache (const std::vector<uint64_t> &key)
+{
+  std::FILE *file = std::fopen (m_cacheFile.c_str (), "rb");
+  if (file == 0)
+    {
+      return false;
+    }
+  char magic[8];
+  uint32_t version;
+  std::vector<uint64_t> header (key.size () + 7);
+  bool ok = std::fread (magic, 1, 8, file) == 8 && std::memcmp (magic, "ns3obst", 8) == 0
+    && std::fread (&version, sizeof (version), 1, file) == 1 && version == CACHE_VERSION
+    && ReadArray (file, header)
+    && std::equal (key.begin (), key.end (), header.begin ());
+  if (ok)
+    {
+      uint64_t *counts = &header[key.size ()];
+      m_footprints.resize (counts[0]);
+      m_boxes.resize (counts[1]);
+      m_prisms.resize (counts[2]);
+      m_vertices.resize (counts[3]);
+      m_hulls.resize (counts[4]);
+      m_points.resize (counts[5]);
+      m_skipped = counts[6];
+      ok = ReadArray (file, m_footprints) && ReadArray (file, m_boxes) && ReadArray (file, m_prisms)
+        && ReadArray (file, m_vertices) && ReadArray (file, m_hulls) && ReadArray (file, m_points);
+    }
+  std::fclose (file);
+  if (!ok)
+    {
+      NS_LOG_INFO ("cache " << m_cacheFile << " out of date, parsing " << m_filename);
+      m_footprints.clear ();
+      m_boxes.clear ();
+      m_prisms.clear ();
+      m_vertices.clear ();
+      m_hulls.clear ();
+      m_points.clear ();
+      m_skipped = 0;
+      return false;
+    }
+  NS_LOG_INFO ("obstacles of " << m_filename << " read from the cache " << m_cacheFile);
+  return true;
+}
+
+void
+ObstacleLoaderHelper::WriteCache (const std::vector<uint64_t> &key) const
+{
+  std::FILE *file = std::fopen (m_cacheFile.c_str (), "wb");
+  if (file == 0)
+    {
+      NS_LOG_WARN ("Cannot write the cache " << m_cacheFile);
+      return;
+    }
+  std::vector<uint64_t> header (key);
+  header.push_back (m_footprints.size ());
+  header.push_back (m_boxes.size ());
+  header.push_back (m_prisms.size ());
+  header.push_back (m_vertices.size ());
+  header.push_back (m_hulls.size ());
+  header.push_back (m_points.size ());
+  header.push_back (m_skipped);
+  char magic[8] = "ns3obst";
+  uint32_t version = CACHE_VERSION;
+  bool ok = std::fwrite (magic, 1, 8, file) == 8 && std::fwrite (&version, sizeof (version), 1, file) == 1
+    && WriteArray (file, header) && WriteArray (file, m_footprints) && WriteArray (file, m_boxes)
+    && WriteArray (file, m_prisms) && WriteArray (file, m_vertices) && WriteArray (file, m_hulls)
+    && WriteArray (file, m_points);
+  ok = (std::fclose (file) == 0) && ok;
+  if (!ok)
+    {
+      NS_LOG_WARN ("Cannot write the cache " << m_cacheFile);
+      std::remove (m_cacheFile.c_str ());
+    }
+}
+
+void
+ObstacleLoaderHelper::Emit (void)
+{
+  if (m_world != 0)
+    {
+      for (std::vector<Box>::const_iterator i = m_boxes.begin (); i != m_boxes.end (); ++i)
+        {
+          m_world->AddObstacle (*i);
+        }
+      for (std::vector<Prism>::const_iterator i = m_prisms.begin (); i != m_prisms.end (); ++i)
+        {
+          std::vector<Vector2D> footprint (m_vertices.begin () + i->start,
+                                           m_vertices.begin () + i->start + i->count);
+          m_world->AddObstacle (Create<PrismObstacle> (footprint, i->zMin, i->zMax));
+        }
+      for (std::vector<Hull>::const_iterator i = m_hulls.begin (); i != m_hulls.end (); ++i)
+        {
+          std::vector<Vector> points (m_points.begin () + i->start,
+                                      m_points.begin () + i->start + i->count);
+          m_world->AddObstacle (Create<ConvexObstacle> (points));
+        }
+      m_nObstacles = m_boxes.size () + m_prisms.size () + m_hulls.size ();
+    }
+  if (m_createBuildings)
+    {
+      for (std::vector<Box>::const_iterator i = m_footprints.begin (); i != m_footprints.end (); ++i)
+        {
+          Ptr<Building> building = m_buildingFactory.Create<Building> ();
+          building->SetBoundaries (*i);
+          if (m_floorHeight > 0.0)
+            {
+              double floors = std::floor ((i->zMax - i->zMin) / m_floorHeight);
+              building->SetNFloors (static_cast<uint16_t> (std::max (1.0, std::min (floors, 65535.0))));
+            }
+        }
+    }
+}
+
+} // namespace ns3
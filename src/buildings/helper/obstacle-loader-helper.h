@@ -0,0 +1,252 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#ifndef OBSTACLE_LOADER_HELPER_H
+#define OBSTACLE_LOADER_HELPER_H
+
+#include <string>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/box.h"
+#include "ns3/vector.h"
+#include "ns3/object-factory.h"
+#include "ns3/obstacle-world.h"
+
+namespace ns3 {
+
+struct GeoJsonFeature;
+
+/**
+ * \ingroup buildings
+ * \brief Load the obstacles and buildings of a city from a file.
+ *
+ * The file is read in a single pass into the ObstacleWorld set with
+ * SetWorld, and into the BuildingList, one Building per footprint unless
+ * disabled. Three formats are understood, guessed from the file
+ * extension by default:
+ *  - CSV (.csv, .txt): one box per line,
+ *    "xMin,xMax,yMin,yMax,zMin,zMax", in the order of the Box
+ *    constructor; commas, semicolons and blanks separate the values, and
+ *    lines starting with '#', as well as a first line that is not
+ *    numeric, are ignored.
+ *  - GeoJSON (.geojson, .json): the Polygon and MultiPolygon features of
+ *    a FeatureCollection, extruded from the "min_height" property, or 0,
+ *    up to the "height" property, or the default height. The coordinates
+ *    are used as they are, in meters: project longitudes and latitudes
+ *    beforehand. Holes are ignored.
+ *  - Wavefront OBJ (.obj): every object or group is the convex hull of
+ *    the vertices of its faces.
+ *
+ * Every entry is validated: invalid ones, such as empty or flat boxes,
+ * polygons with less than 3 vertices, crossing edges or no area, or
+ * non-finite coordinates, are skipped with a warning and counted, or
+ * abort the load if SetStrict was called. Axis-aligned rectangles and
+ * boxes become Box obstacles, and boxes sharing a face are merged into
+ * one; other polygons become a PrismObstacle, and OBJ objects a
+ * ConvexObstacle. Buildings always get the bounding box of their
+ * footprint, before merging, since the Building class is a box.
+ *
+ * Parsing can be skipped by later runs with SetCacheFile: the validated
+ * and merged obstacles are stored there in binary, along with the size
+ * and modification time of the source file, and read back as long as
+ * they match.
+ * \code
+    Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+    ObstacleLoaderHelper loader;
+    loader.SetWorld (world);
+    loader.SetCacheFile ("city.cache");
+    loader.Load ("city.geojson");
+ * \endcode
+ */
+class ObstacleLoaderHelper
+{
+public:
+  /** Format of the file to load */
+  enum Format
+  {
+    AUTO,    //!< guess from the extension
+    CSV,     //!< boxes, one per line
+    GEOJSON, //!< extruded polygons
+    OBJ      //!< convex meshes
+  };
+
+  ObstacleLoaderHelper ();
+
+  /**
+   * \param world the world to add the obstacles to, or 0 to only create
+   *        buildings
+   */
+  void SetWorld (Ptr<ObstacleWorld> world);
+  /**
+   * \param create whether to create a Building for each footprint, true
+   *        by default
+   */
+  void SetCreateBuildings (bool create);
+  /**
+   * \param n the name of an attribute of ns3::Building
+   * \param v the value of the attribute
+   *
+   * Set an attribute of the buildings created.
+   */
+  void SetBuildingAttribute (std::string n, const AttributeValue &v);
+  /**
+   * \param height the height of a floor, to derive the number of floors
+   *        of each building from its height; 0, the default, leaves the
+   *        "NFloors" attribute
+   */
+  void SetFloorHeight (double height);
+  /**
+   * \param height the height of the GeoJSON features without a "height"
+   *        property; 0, the default, makes them invalid
+   */
+  void SetDefaultHeight (double height);
+  /**
+   * \param merge whether to merge the boxes sharing a face, true by default
+   */
+  void SetMergeBoxes (bool merge);
+  /**
+   * \param filename the file to cache the parsed obstacles in, or an
+   *        empty string, the default, not to cache them
+   */
+  void SetCacheFile (std::string filename);
+  /**
+   * \param strict whether an invalid entry aborts the load, false by
+   *        default
+   */
+  void SetStrict (bool strict);
+
+  /**
+   * \param filename the file to load
+   * \param format the format of the file
+   * \return the number of footprints loaded
+   */
+  uint32_t Load (std::string filename, Format format = AUTO);
+  /**
+   * \return the number of invalid entries skipped by the last load
+   */
+  uint32_t GetNSkipped (void) const;
+  /**
+   * \return the number of obstacles added to the world by the last load
+   */
+  uint32_t GetNObstacles (void) const;
+
+private:
+  /** A polygonal footprint between two heights */
+  struct Prism
+  {
+    uint32_t start; //!< first vertex in m_vertices
+    uint32_t count; //!< number of vertices
+    double zMin;    //!< height of the floor
+    double zMax;    //!< height of the roof
+  };
+  /** The convex hull of a set of points */
+  struct Hull
+  {
+    uint32_t start; //!< first point in m_points
+    uint32_t count; //!< number of points
+  };
+
+  /**
+   * \param buffer the contents of a CSV file
+   * \param size the size of the contents
+   */
+  void ParseCsv (const char *buffer, size_t size);
+  /**
+   * \param buffer the contents of a GeoJSON file
+   * \param size the size of the contents
+   */
+  void ParseGeoJson (const char *buffer, size_t size);
+  /**
+   * \param buffer the contents of an OBJ file
+   * \param size the size of the contents
+   */
+  void ParseObj (const char *buffer, size_t size);
+  /**
+   * Validate and add the outer rings of a GeoJSON feature
+   * \param f the feature
+   */
+  void AddFeature (const GeoJsonFeature &f);
+  /**
+   * Validate and add a box footprint
+   * \param box the box
+   * \param where the line or byte of the entry in the file, for the warnings
+   */
+  void AddBox (const Box &box, size_t where);
+  /**
+   * Validate and add a polygonal footprint
+   * \param ring the vertices of the polygon, possibly closed
+   * \param zMin the height of the floor
+   * \param zMax the height of the roof
+   * \param where the line or byte of the entry in the file, for the warnings
+   */
+  void AddPolygon (std::vector<Vector2D> ring, double zMin, double zMax, size_t where);
+  /**
+   * Validate and add a convex hull
+   * \param points the points, possibly repeated
+   * \param where the line or byte of the entry in the file, for the warnings
+   */
+  void AddHull (std::vector<Vector> points, size_t where);
+  /**
+   * Count an invalid entry
+   * \param reason why the entry is invalid
+   * \param where the line or byte of the entry in the file
+   */
+  void Skip (const std::string &reason, size_t where);
+  /**
+   * Merge the boxes of m_boxes sharing a face
+   */
+  void MergeBoxes (void);
+  /**
+   * \param key the identity of the source file
+   * \return true if the cache file matches the key and was read
+   */
+  bool ReadCache (const std::vector<uint64_t> &key);
+  /**
+   * \param key the identity of the source file
+   */
+  void WriteCache (const std::vector<uint64_t> &key) const;
+  /**
+   * Add the loaded obstacles to the world, and create the buildings
+   */
+  void Emit (void);
+
+  Ptr<ObstacleWorld> m_world; //!< world the obstacles are added to
+  bool m_createBuildings; //!< whether to create buildings
+  ObjectFactory m_buildingFactory; //!< factory of the buildings
+  double m_floorHeight; //!< height of a floor, or 0
+  double m_defaultHeight; //!< height of the features without one, or 0
+  bool m_merge; //!< whether to merge boxes
+  std::string m_cacheFile; //!< cache file, or empty
+  bool m_strict; //!< whether invalid entries are fatal
+  std::string m_filename; //!< file being loaded
+  bool m_byLine; //!< whether the entries are located by line, or by byte
+  uint32_t m_skipped; //!< invalid entries of the last load
+  uint32_t m_nObstacles; //!< obstacles added by the last load
+
+  std::vector<Box> m_footprints; //!< bounding box of each footprint
+  std::vector<Box> m_boxes; //!< box obstacles
+  std::vector<Prism> m_prisms; //!< prism obstacles
+  std::vector<Vector2D> m_vertices; //!< vertices of the prisms
+  std::vector<Hull> m_hulls; //!< convex obstacles
+  std::vector<Vector> m_points; //!< points of the convex obstacles
+};
+
+} // namespace ns3
+
+#endif /* OBSTACLE_LOADER_HELPER_H */
@@ -27,6 +27,8 @@
 #include "ns3/assert.h"
 #include "building-list.h"
 #include "building.h"
+#include <algorithm>
+#include <cmath>
 
 namespace ns3 {
 
@@ -47,6 +49,9 @@ public:
   BuildingList::Iterator End (void) const;
   Ptr<Building> GetBuilding (uint32_t n);
   uint32_t GetNBuildings (void);
+  Ptr<Building> FindBuilding (const Vector &position);
+  void NotifyBuildingChanged (void);
+  uint32_t GetVersion (void) const;
 
   static Ptr<BuildingListPriv> Get (void);
 
@@ -54,7 +59,20 @@ private:
   virtual void DoDispose (void);
   static Ptr<BuildingListPriv> *DoGet (void);
   static void Delete (void);
+  /**
+   * Build the grid of the building footprints
+   */
+  void BuildIndex (void);
   std::vector<Ptr<Building> > m_buildings;
+  uint32_t m_version; //!< incremented by every change of the buildings
+  bool m_indexed; //!< whether the grid is up to date
+  double m_xMin; //!< x of the corner of the grid
+  double m_yMin; //!< y of the corner of the grid
+  double m_cellSize; //!< side of the grid cells
+  uint32_t m_nx; //!< number of cells along x
+  uint32_t m_ny; //!< number of cells along y
+  std::vector<uint32_t> m_cellStart; //!< first entry of each cell in m_cellBuildings, plus the end
+  std::vector<uint32_t> m_cellBuildings; //!< buildings overlapping each cell, by index
 };
 
 NS_OBJECT_ENSURE_REGISTERED (BuildingListPriv);
@@ -100,6 +118,8 @@ BuildingListPriv::Delete (void)
 
 
 BuildingListPriv::BuildingListPriv ()
+  : m_version (0),
+    m_indexed (false)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -118,6 +138,10 @@ BuildingListPriv::DoDispose (void)
       *i = 0;
     }
   m_buildings.erase (m_buildings.begin (), m_buildings.end ());
+  m_cellStart.clear ();
+  m_cellBuildings.clear ();
+  m_indexed = false;
+  m_version++;
   Object::DoDispose ();
 }
 
@@ -127,6 +151,7 @@ BuildingListPriv::Add (Ptr<Building> building)
 {
   uint32_t index = m_buildings.size ();
   m_buildings.push_back (building);
+  NotifyBuildingChanged ();
   Simulator::ScheduleWithContext (index, TimeStep (0), &Building::Initialize, building);
   return index;
 
@@ -155,6 +180,134 @@ BuildingListPriv::GetBuilding (uint32_t n)
   return m_buildings.at (n);
 }
 
+void
+BuildingListPriv::NotifyBuildingChanged (void)
+{
+  m_indexed = false;
+  m_version++;
+}
+
+uint32_t
+BuildingListPriv::GetVersion (void) const
+{
+  return m_version;
+}
+
+void
+BuildingListPriv::BuildIndex (void)
+{
+  NS_LOG_FUNCTION (this << m_buildings.size ());
+  m_indexed = true;
+  m_cellStart.clear ();
+  m_cellBuildings.clear ();
+  m_nx = 0;
+  m_ny = 0;
+  if (m_buildings.empty ())
+    {
+      return;
+    }
+
+  // cells about the size of a building, but no more cells than a few per
+  // building, however sparse the buildings are
+  Box area = m_buildings[0]->GetBoundaries ();
+  double extent = 0.0;
+  for (std::vector<Ptr<Building> >::const_iterator i = m_buildings.begin (); i != m_buildings.end (); ++i)
+    {
+      Box b = (*i)->GetBoundaries ();
+      area.xMin = std::min (area.xMin, b.xMin);
+      area.xMax = std::max (area.xMax, b.xMax);
+      area.yMin = std::min (area.yMin, b.yMin);
+      area.yMax = std::max (area.yMax, b.yMax);
+      extent += std::max (b.xMax - b.xMin, b.yMax - b.yMin);
+    }
+  double width = area.xMax - area.xMin;
+  double height = area.yMax - area.yMin;
+  m_cellSize = std::max (extent / m_buildings.size (),
+                         std::sqrt (width * height / (4.0 * m_buildings.size ())));
+  if (!(m_cellSize > 0.0))
+    {
+      m_cellSize = 1.0;
+    }
+  m_xMin = area.xMin;
+  m_yMin = area.yMin;
+  m_nx = static_cast<uint32_t> (width / m_cellSize) + 1;
+  m_ny = static_cast<uint32_t> (height / m_cellSize) + 1;
+
+  // count, then fill the entries of each cell
+  m_cellStart.assign (m_nx * m_ny + 1, 0);
+  for (uint32_t pass = 0; pass < 2; pass++)
+    {
+      for (uint32_t n = 0; n < m_buildings.size (); n++)
+        {
+          Box b = m_buildings[n]->GetBoundaries ();
+          uint32_t x0 = static_cast<uint32_t> ((b.xMin - m_xMin) / m_cellSize);
+          uint32_t x1 = std::min (static_cast<uint32_t> ((b.xMax - m_xMin) / m_cellSize), m_nx - 1);
+          uint32_t y0 = static_cast<uint32_t> ((b.yMin - m_yMin) / m_cellSize);
+          uint32_t y1 = std::min (static_cast<uint32_t> ((b.yMax - m_yMin) / m_cellSize), m_ny - 1);
+          for (uint32_t y = y0; y <= y1; y++)
+            {
+              for (uint32_t x = x0; x <= x1; x++)
+                {
+                  uint32_t cell = y * m_nx + x;
+                  if (pass == 0)
+                    {
+                      m_cellStart[cell + 1]++;
+                    }
+                  else
+                    {
+                      m_cellBuildings[m_cellStart[cell]++] = n;
+                    }
+                }
+            }
+        }
+      if (pass == 0)
+        {
+          for (uint32_t cell = 0; cell < m_nx * m_ny; cell++)
+            {
+              m_cellStart[cell + 1] += m_cellStart[cell];
+            }
+          m_cellBuildings.resize (m_cellStart.back ());
+        }
+      else
+        {
+          // the fill advanced every start to the next cell
+          for (uint32_t cell = m_nx * m_ny; cell > 0; cell--)
+            {
+              m_cellStart[cell] = m_cellStart[cell - 1];
+            }
+          m_cellStart[0] = 0;
+        }
+    }
+  NS_LOG_LOGIC (m_nx << "x" << m_ny << " cells of " << m_cellSize << " m, "
+                     << m_cellBuildings.size () << " entries");
+}
+
+Ptr<Building>
+BuildingListPriv::FindBuilding (const Vector &position)
+{
+  if (!m_indexed)
+    {
+      BuildIndex ();
+    }
+  double fx = (position.x - m_xMin) / m_cellSize;
+  double fy = (position.y - m_yMin) / m_cellSize;
+  if (!(fx >= 0.0 && fy >= 0.0 && fx < m_nx && fy < m_ny))
+    {
+      return 0;
+    }
+  uint32_t cell = static_cast<uint32_t> (fy) * m_nx + static_cast<uint32_t> (fx);
+  // the entries of a cell are in increasing index order
+  for (uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1]; i++)
+    {
+      const Ptr<Building> &building = m_buildings[m_cellBuildings[i]];
+      if (building->IsInside (position))
+        {
+          return building;
+        }
+    }
+  return 0;
+}
+
 }
 
 /**
@@ -189,5 +342,20 @@ BuildingList::GetNBuildings (void)
 {
   return BuildingListPriv::Get ()->GetNBuildings ();
 }
+Ptr<Building>
+BuildingList::FindBuilding (const Vector &position)
+{
+  return BuildingListPriv::Get ()->FindBuilding (position);
+}
+void
+BuildingList::NotifyBuildingChanged (void)
+{
+  BuildingListPriv::Get ()->NotifyBuildingChanged ();
+}
+uint32_t
+BuildingList::GetVersion (void)
+{
+  return BuildingListPriv::Get ()->GetVersion ();
+}
 
 } // namespace ns3
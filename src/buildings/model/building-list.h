@@ -25,6 +25,7 @@
 
 #include <vector>
 #include "ns3/ptr.h"
+#include "ns3/vector.h"
 
 namespace ns3 {
 
@@ -62,6 +63,27 @@ public:
    * \returns the number of buildings currently in the list.
    */
   static uint32_t GetNBuildings (void);
+  /**
+   * \param position a position
+   * \returns the building the position is inside of, the one with the
+   *          smallest index if they overlap, or 0 if outdoor.
+   *
+   * The buildings are looked up in a uniform grid over their footprints,
+   * built on the first call after a building was added or changed, so
+   * that the cost of a lookup does not grow with the number of buildings.
+   */
+  static Ptr<Building> FindBuilding (const Vector &position);
+  /**
+   * Notify that the boundaries, walls, floors or rooms of a building changed.
+   *
+   * This method is called automatically by the setters of Building.
+   */
+  static void NotifyBuildingChanged (void);
+  /**
+   * \returns a number that changes every time a building is added or
+   *          changed, to tell when a lookup needs to be repeated.
+   */
+  static uint32_t GetVersion (void);
 };
 
 } // namespace ns3
@@ -37,28 +37,6 @@ NS_LOG_COMPONENT_DEFINE ("BuildingsPropagationLossModel");
 
 NS_OBJECT_ENSURE_REGISTERED (BuildingsPropagationLossModel);
 
-BuildingsPropagationLossModel::ShadowingLoss::ShadowingLoss ()
-{
-}
-
-BuildingsPropagationLossModel::ShadowingLoss::ShadowingLoss (double shadowingValue, Ptr<MobilityModel> receiver)
-  : m_shadowingValue (shadowingValue), m_receiver (receiver)
-{
-  NS_LOG_INFO (this << " New Shadowing value " << m_shadowingValue);
-}
-
-double
-BuildingsPropagationLossModel::ShadowingLoss::GetLoss () const
-{
-  return (m_shadowingValue);
-}
-
-Ptr<MobilityModel>
-BuildingsPropagationLossModel::ShadowingLoss::GetReceiver () const
-{
-  return m_receiver;
-}
-
 TypeId
 BuildingsPropagationLossModel::GetTypeId (void)
 {
@@ -96,34 +74,48 @@ BuildingsPropagationLossModel::GetTypeId (void)
 }
 
 BuildingsPropagationLossModel::BuildingsPropagationLossModel ()
+  : m_shadowingCount (0)
 {
   m_randVariable = CreateObject<NormalRandomVariable> ();
 }
 
+void
+BuildingsPropagationLossModel::DoDispose (void)
+{
+  m_shadowingTable.clear ();
+  m_shadowingCount = 0;
+  PropagationLossModel::DoDispose ();
+}
+
 double
-BuildingsPropagationLossModel::ExternalWallLoss (Ptr<MobilityBuildingInfo> a) const
+BuildingsPropagationLossModel::GetExternalWallLoss (Building::ExtWallsType_t type)
 {
   double loss = 0.0;
-  Ptr<Building> aBuilding = a->GetBuilding ();
-  if (aBuilding->GetExtWallsType () == Building::Wood)
+  if (type == Building::Wood)
     {
       loss = 4;
     }
-  else if (aBuilding->GetExtWallsType () == Building::ConcreteWithWindows)
+  else if (type == Building::ConcreteWithWindows)
     {
       loss = 7;
     }
-  else if (aBuilding->GetExtWallsType () == Building::ConcreteWithoutWindows)
+  else if (type == Building::ConcreteWithoutWindows)
     {
       loss = 15; // 10 ~ 20 dB
     }
-  else if (aBuilding->GetExtWallsType () == Building::StoneBlocks)
+  else if (type == Building::StoneBlocks)
     {
       loss = 12;
     }
   return (loss);
 }
 
+double
+BuildingsPropagationLossModel::ExternalWallLoss (Ptr<MobilityBuildingInfo> a) const
+{
+  return GetExternalWallLoss (a->GetBuilding ()->GetExtWallsType ());
+}
+
 double
 BuildingsPropagationLossModel::HeightLoss (Ptr<MobilityBuildingInfo> node) const
 {
@@ -145,41 +137,72 @@ BuildingsPropagationLossModel::InternalWallsLoss (Ptr<MobilityBuildingInfo> a, P
 
 
 
+uint32_t
+BuildingsPropagationLossModel::HashLink (const MobilityModel *a, const MobilityModel *b) const
+{
+  uint64_t h = reinterpret_cast<uintptr_t> (a) * 0x9e3779b97f4a7c15ULL;
+  h ^= reinterpret_cast<uintptr_t> (b) + (h << 6) + (h >> 2);
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return static_cast<uint32_t> (h) & (m_shadowingTable.size () - 1);
+}
+
 double
 BuildingsPropagationLossModel::GetShadowing (Ptr<MobilityModel> a, Ptr<MobilityModel> b)
 const
 {
-    Ptr<MobilityBuildingInfo> a1 = a->GetObject <MobilityBuildingInfo> ();
-    Ptr<MobilityBuildingInfo> b1 = b->GetObject <MobilityBuildingInfo> ();
-    NS_ASSERT_MSG ((a1 != 0) && (b1 != 0), "BuildingsPropagationLossModel only works with MobilityBuildingInfo");
-  
-  std::map<Ptr<MobilityModel>,  std::map<Ptr<MobilityModel>, ShadowingLoss> >::iterator ait = m_shadowingLossMap.find (a);
-  if (ait != m_shadowingLossMap.end ())
+  if (m_shadowingTable.empty ())
     {
-      std::map<Ptr<MobilityModel>, ShadowingLoss>::iterator bit = ait->second.find (b);
-      if (bit != ait->second.end ())
-        {
-          return (bit->second.GetLoss ());
-        }
-      else
+      m_shadowingTable.resize (64);
+    }
+  uint32_t mask = m_shadowingTable.size () - 1;
+  uint32_t i = HashLink (PeekPointer (a), PeekPointer (b));
+  while (m_shadowingTable[i].a != 0)
+    {
+      if (m_shadowingTable[i].a == a && m_shadowingTable[i].b == b)
         {
-          double sigma = EvaluateSigma (a1, b1);
-          // side effect: will create new entry          
-          // sigma is standard deviation, not variance
-          double shadowingValue = m_randVariable->GetValue (0.0, (sigma*sigma));
-          ait->second[b] = ShadowingLoss (shadowingValue, b);          
-          return (ait->second[b].GetLoss ());
+          return m_shadowingTable[i].loss;
         }
+      i = (i + 1) & mask;
     }
-  else
+
+  Ptr<MobilityBuildingInfo> a1 = a->GetObject <MobilityBuildingInfo> ();
+  Ptr<MobilityBuildingInfo> b1 = b->GetObject <MobilityBuildingInfo> ();
+  NS_ASSERT_MSG ((a1 != 0) && (b1 != 0), "BuildingsPropagationLossModel only works with MobilityBuildingInfo");
+  double sigma = EvaluateSigma (a1, b1);
+  // sigma is standard deviation, not variance
+  double shadowingValue = m_randVariable->GetValue (0.0, (sigma*sigma));
+  NS_LOG_INFO (this << " New Shadowing value " << shadowingValue);
+
+  if (4 * (m_shadowingCount + 1) > 3 * m_shadowingTable.size ())
     {
-      double sigma = EvaluateSigma (a1, b1);
-      // side effect: will create new entries in both maps
-      // sigma is standard deviation, not variance
-      double shadowingValue = m_randVariable->GetValue (0.0, (sigma*sigma));
-      m_shadowingLossMap[a][b] = ShadowingLoss (shadowingValue, b);  
-      return (m_shadowingLossMap[a][b].GetLoss ());       
+      // keep the table at most three quarters full, for short probes
+      std::vector<ShadowingEntry> old (2 * m_shadowingTable.size ());
+      old.swap (m_shadowingTable);
+      mask = m_shadowingTable.size () - 1;
+      for (std::vector<ShadowingEntry>::const_iterator it = old.begin (); it != old.end (); ++it)
+        {
+          if (it->a != 0)
+            {
+              uint32_t j = HashLink (PeekPointer (it->a), PeekPointer (it->b));
+              while (m_shadowingTable[j].a != 0)
+                {
+                  j = (j + 1) & mask;
+                }
+              m_shadowingTable[j] = *it;
+            }
+        }
+      i = HashLink (PeekPointer (a), PeekPointer (b));
+      while (m_shadowingTable[i].a != 0)
+        {
+          i = (i + 1) & mask;
+        }
     }
+  m_shadowingTable[i].a = a;
+  m_shadowingTable[i].b = b;
+  m_shadowingTable[i].loss = shadowingValue;
+  m_shadowingCount++;
+  return shadowingValue;
 }
 
 
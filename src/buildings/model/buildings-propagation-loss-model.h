@@ -28,6 +28,7 @@
 #include "ns3/random-variable-stream.h"
 #include <ns3/building.h>
 #include <ns3/mobility-building-info.h>
+#include <vector>
 
 
 
@@ -71,6 +72,12 @@ public:
   // inherited from PropagationLossModel
   virtual double DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
 
+  /**
+   * \param type the material of the external walls of a building
+   * \returns the penetration loss of one external wall (in dB)
+   */
+  static double GetExternalWallLoss (Building::ExtWallsType_t type);
+
 protected:
   double ExternalWallLoss (Ptr<MobilityBuildingInfo> a) const;
   double HeightLoss (Ptr<MobilityBuildingInfo> n) const;
@@ -80,20 +87,26 @@ protected:
 
   double m_lossInternalWall; // in meters
 
-  
-  class ShadowingLoss
+  /**
+   * The shadowing drawn for the link from a to b, stored in an open
+   * addressing hash table with linear probing.
+   */
+  struct ShadowingEntry
   {
-  public:
-    ShadowingLoss ();
-    ShadowingLoss (double shadowingValue, Ptr<MobilityModel> receiver);
-    double GetLoss () const;
-    Ptr<MobilityModel> GetReceiver (void) const;
-  protected:
-    double m_shadowingValue;
-    Ptr<MobilityModel> m_receiver;
+    Ptr<MobilityModel> a; //!< source, or 0 if the slot is free
+    Ptr<MobilityModel> b; //!< destination
+    double loss;          //!< shadowing (in dB)
   };
 
-  mutable std::map<Ptr<MobilityModel>,  std::map<Ptr<MobilityModel>, ShadowingLoss> > m_shadowingLossMap;
+  /**
+   * \param a the mobility model of the source
+   * \param b the mobility model of the destination
+   * \returns the first slot of the link in m_shadowingTable
+   */
+  uint32_t HashLink (const MobilityModel *a, const MobilityModel *b) const;
+
+  mutable std::vector<ShadowingEntry> m_shadowingTable; //!< power of two slots, at most 3/4 used
+  mutable uint32_t m_shadowingCount; //!< used slots of m_shadowingTable
   double EvaluateSigma (Ptr<MobilityBuildingInfo> a, Ptr<MobilityBuildingInfo> b) const;
 
 
@@ -102,6 +115,7 @@ protected:
   double m_shadowingSigmaIndoor;
   Ptr<NormalRandomVariable> m_randVariable;
 
+  virtual void DoDispose (void);
   virtual int64_t DoAssignStreams (int64_t stream);
 };
 
@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#include "coverage-map-propagation-loss-model.h"
+#include "ns3/mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/fatal-error.h"
+#include "ns3/log.h"
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CoverageMapPropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED (CoverageMapPropagationLossModel);
+
+TypeId
+CoverageMapPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CoverageMapPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Buildings")
+    .AddConstructor<CoverageMapPropagationLossModel> ()
+    .AddAttribute ("Filename", "The coverage map file to look the losses up in.",
+                   StringValue (""),
+                   MakeStringAccessor (&CoverageMapPropagationLossModel::SetFilename),
+                   MakeStringChecker ())
+    .AddAttribute ("Tolerance", "The largest distance along each axis between an end of a link "
+                   "and a transmitter of the map (m).",
+                   DoubleValue (0.01),
+                   MakeDoubleAccessor (&CoverageMapPropagationLossModel::m_tolerance),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("Fallback", "The model of the links not covered by the map, if any.",
+                   PointerValue (),
+                   MakePointerAccessor (&CoverageMapPropagationLossModel::m_fallback),
+                   MakePointerChecker<PropagationLossModel> ())
+  ;
+  return tid;
+}
+
+CoverageMapPropagationLossModel::CoverageMapPropagationLossModel ()
+  : m_lastTransmitter (-1)
+{
+}
+
+CoverageMapPropagationLossModel::~CoverageMapPropagationLossModel ()
+{
+}
+
+void
+CoverageMapPropagationLossModel::SetFilename (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  SetCoverageMap (filename.empty () ? 0 : Create<CoverageMap> (filename));
+}
+
+void
+CoverageMapPropagationLossModel::SetCoverageMap (Ptr<CoverageMap> map)
+{
+  m_map = map;
+  m_lastTransmitter = -1;
+}
+
+Ptr<CoverageMap>
+CoverageMapPropagationLossModel::GetCoverageMap (void) const
+{
+  return m_map;
+}
+
+int32_t
+CoverageMapPropagationLossModel::FindTransmitter (const Vector &position) const
+{
+  // the same transmitter usually sends many packets in a row
+  if (m_lastTransmitter >= 0)
+    {
+      Vector t = m_map->GetTransmitter (m_lastTransmitter);
+      if (std::fabs (t.x - position.x) <= m_tolerance
+          && std::fabs (t.y - position.y) <= m_tolerance
+          && std::fabs (t.z - position.z) <= m_tolerance)
+        {
+          return m_lastTransmitter;
+        }
+    }
+  int32_t transmitter = m_map->FindTransmitter (position, m_tolerance);
+  if (transmitter >= 0)
+    {
+      m_lastTransmitter = transmitter;
+    }
+  return transmitter;
+}
+
+double
+CoverageMapPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                                Ptr<MobilityModel> a,
+                                                Ptr<MobilityModel> b) const
+{
+  if (m_map != 0)
+    {
+      Vector pa = a->GetPosition ();
+      Vector pb = b->GetPosition ();
+      double loss;
+      int32_t transmitter = FindTransmitter (pa);
+      if (transmitter >= 0 && m_map->GetLoss (transmitter, pb, loss))
+        {
+          return txPowerDbm - loss;
+        }
+      transmitter = FindTransmitter (pb);
+      if (transmitter >= 0 && m_map->GetLoss (transmitter, pa, loss))
+        {
+          return txPowerDbm - loss;
+        }
+    }
+  if (m_fallback == 0)
+    {
+      NS_FATAL_ERROR ("Link from " << a->GetPosition () << " to " << b->GetPosition ()
+                      << " not covered by the coverage map, and no fallback model");
+    }
+  return m_fallback->CalcRxPower (txPowerDbm, a, b);
+}
+
+int64_t
+CoverageMapPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  return m_fallback != 0 ? m_fallback->AssignStreams (stream) : 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,300 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#include "coverage-map.h"
+#include "ns3/assert.h"
+#include "ns3/fatal-error.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CoverageMap");
+
+namespace {
+
+/** Header of a coverage map file */
+struct Header
+{
+  char magic[8];          //!< "ns3covm"
+  uint32_t version;       //!< version of the layout
+  uint32_t nTransmitters; //!< number of transmitters
+  uint32_t n[3];          //!< number of points along each axis
+  uint32_t pad;           //!< aligns the doubles
+  double min[3];          //!< first point of the grid
+  double resolution;      //!< step between the points
+};
+
+/** Magic bytes starting a coverage map file */
+const char g_magic[8] = "ns3covm";
+/** Version of the layout written */
+const uint32_t g_version = 1;
+
+/**
+ * \param header the header of a file
+ * \return the size of the file
+ */
+uint64_t
+GetFileSize (const Header &header)
+{
+  return sizeof (Header)
+         + uint64_t (header.nTransmitters) * 3 * sizeof (double)
+         + uint64_t (header.nTransmitters) * header.n[0] * header.n[1] * header.n[2] * sizeof (float);
+}
+
+} // anonymous namespace
+
+CoverageMap::CoverageMap (std::string filename, bool writable)
+  : m_map (0),
+    m_size (0),
+    m_writable (writable),
+    m_nTransmitters (0),
+    m_resolution (0.0),
+    m_transmitters (0),
+    m_losses (0)
+{
+  NS_LOG_FUNCTION (this << filename << writable);
+  int fd = open (filename.c_str (), writable ? O_RDWR : O_RDONLY);
+  if (fd < 0)
+    {
+      NS_FATAL_ERROR ("Cannot open coverage map " << filename);
+    }
+  struct stat st;
+  if (fstat (fd, &st) != 0 || static_cast<uint64_t> (st.st_size) < sizeof (Header))
+    {
+      close (fd);
+      NS_FATAL_ERROR ("Coverage map " << filename << " is too short");
+    }
+  m_size = st.st_size;
+  m_map = mmap (0, m_size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+  // the mapping stays valid once the descriptor is closed
+  close (fd);
+  if (m_map == MAP_FAILED)
+    {
+      m_map = 0;
+      NS_FATAL_ERROR ("Cannot map coverage map " << filename);
+    }
+
+  const Header *header = static_cast<const Header *> (m_map);
+  if (std::memcmp (header->magic, g_magic, sizeof (g_magic)) != 0
+      || header->version != g_version)
+    {
+      NS_FATAL_ERROR (filename << " is not a coverage map of version " << g_version);
+    }
+  if (m_size != GetFileSize (*header))
+    {
+      NS_FATAL_ERROR ("Coverage map " << filename << " is truncated");
+    }
+  m_nTransmitters = header->nTransmitters;
+  for (uint32_t axis = 0; axis < 3; axis++)
+    {
+      m_n[axis] = header->n[axis];
+      m_min[axis] = header->min[axis];
+    }
+  m_resolution = header->resolution;
+  m_transmitters = reinterpret_cast<const double *> (header + 1);
+  m_losses = reinterpret_cast<float *> (const_cast<double *> (m_transmitters + 3 * m_nTransmitters));
+}
+
+CoverageMap::~CoverageMap ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_map != 0)
+    {
+      munmap (m_map, m_size);
+    }
+}
+
+uint32_t
+CoverageMap::GetNTransmitters (void) const
+{
+  return m_nTransmitters;
+}
+
+Vector
+CoverageMap::GetTransmitter (uint32_t transmitter) const
+{
+  NS_ASSERT (transmitter < m_nTransmitters);
+  const double *p = m_transmitters + 3 * transmitter;
+  return Vector (p[0], p[1], p[2]);
+}
+
+int32_t
+CoverageMap::FindTransmitter (const Vector &position, double tolerance) const
+{
+  for (uint32_t t = 0; t < m_nTransmitters; t++)
+    {
+      const double *p = m_transmitters + 3 * t;
+      if (std::fabs (p[0] - position.x) <= tolerance
+          && std::fabs (p[1] - position.y) <= tolerance
+          && std::fabs (p[2] - position.z) <= tolerance)
+        {
+          return t;
+        }
+    }
+  return -1;
+}
+
+Box
+CoverageMap::GetBounds (void) const
+{
+  return Box (m_min[0], m_min[0] + (m_n[0] - 1) * m_resolution,
+              m_min[1], m_min[1] + (m_n[1] - 1) * m_resolution,
+              m_min[2], m_min[2] + (m_n[2] - 1) * m_resolution);
+}
+
+double
+CoverageMap::GetResolution (void) const
+{
+  return m_resolution;
+}
+
+uint32_t
+CoverageMap::GetNx (void) const
+{
+  return m_n[0];
+}
+
+uint32_t
+CoverageMap::GetNy (void) const
+{
+  return m_n[1];
+}
+
+uint32_t
+CoverageMap::GetNz (void) const
+{
+  return m_n[2];
+}
+
+Vector
+CoverageMap::GetPoint (uint32_t i, uint32_t j, uint32_t k) const
+{
+  return Vector (m_min[0] + i * m_resolution,
+                 m_min[1] + j * m_resolution,
+                 m_min[2] + k * m_resolution);
+}
+
+bool
+CoverageMap::GetLoss (uint32_t transmitter, const Vector &position, double &loss) const
+{
+  NS_ASSERT (transmitter < m_nTransmitters);
+  double p[3] = { position.x, position.y, position.z };
+  uint32_t lo[3];
+  uint32_t hi[3];
+  double w[3];
+  for (uint32_t axis = 0; axis < 3; axis++)
+    {
+      double f = (p[axis] - m_min[axis]) / m_resolution;
+      double last = m_n[axis] - 1;
+      // tolerate the rounding of positions on the faces of the grid
+      if (!(f >= -1e-9 && f <= last + 1e-9))
+        {
+          return false;
+        }
+      f = std::min (std::max (f, 0.0), last);
+      lo[axis] = std::min (static_cast<uint32_t> (f), m_n[axis] > 1 ? m_n[axis] - 2 : 0);
+      hi[axis] = m_n[axis] > 1 ? lo[axis] + 1 : lo[axis];
+      w[axis] = f - lo[axis];
+    }
+
+  uint64_t nx = m_n[0];
+  uint64_t nxy = nx * m_n[1];
+  const float *losses = m_losses + transmitter * nxy * m_n[2];
+  double value = 0.0;
+  for (uint32_t corner = 0; corner < 8; corner++)
+    {
+      uint32_t i = (corner & 1) ? hi[0] : lo[0];
+      uint32_t j = (corner & 2) ? hi[1] : lo[1];
+      uint32_t k = (corner & 4) ? hi[2] : lo[2];
+      double weight = ((corner & 1) ? w[0] : 1.0 - w[0])
+        * ((corner & 2) ? w[1] : 1.0 - w[1])
+        * ((corner & 4) ? w[2] : 1.0 - w[2]);
+      if (weight != 0.0)
+        {
+          value += weight * losses[k * nxy + j * nx + i];
+        }
+    }
+  loss = value;
+  return true;
+}
+
+float *
+CoverageMap::GetLayer (uint32_t transmitter, uint32_t k)
+{
+  NS_ASSERT_MSG (m_writable, "Coverage map not mapped for writing");
+  NS_ASSERT (transmitter < m_nTransmitters && k < m_n[2]);
+  uint64_t nxy = uint64_t (m_n[0]) * m_n[1];
+  return m_losses + (uint64_t (transmitter) * m_n[2] + k) * nxy;
+}
+
+bool
+CoverageMap::Allocate (std::string filename, const Box &bounds, double resolution,
+                       const std::vector<Vector> &transmitters)
+{
+  NS_LOG_FUNCTION (filename << bounds << resolution << transmitters.size ());
+  NS_ASSERT (resolution > 0.0);
+  Header header;
+  std::memset (&header, 0, sizeof (header));
+  std::memcpy (header.magic, g_magic, sizeof (g_magic));
+  header.version = g_version;
+  header.nTransmitters = transmitters.size ();
+  double min[3] = { bounds.xMin, bounds.yMin, bounds.zMin };
+  double max[3] = { bounds.xMax, bounds.yMax, bounds.zMax };
+  for (uint32_t axis = 0; axis < 3; axis++)
+    {
+      double steps = std::ceil ((max[axis] - min[axis]) / resolution - 1e-9);
+      header.n[axis] = static_cast<uint32_t> (std::max (steps, 0.0)) + 1;
+      header.min[axis] = min[axis];
+    }
+  header.resolution = resolution;
+
+  int fd = open (filename.c_str (), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    {
+      NS_LOG_WARN ("Cannot create coverage map " << filename);
+      return false;
+    }
+  std::vector<double> positions;
+  for (std::vector<Vector>::const_iterator it = transmitters.begin (); it != transmitters.end (); ++it)
+    {
+      positions.push_back (it->x);
+      positions.push_back (it->y);
+      positions.push_back (it->z);
+    }
+  size_t bytes = positions.size () * sizeof (double);
+  // the losses are left to ftruncate, which fills them with zeros
+  bool ok = write (fd, &header, sizeof (header)) == static_cast<ssize_t> (sizeof (header))
+    && (bytes == 0 || write (fd, &positions[0], bytes) == static_cast<ssize_t> (bytes))
+    && ftruncate (fd, GetFileSize (header)) == 0;
+  close (fd);
+  if (!ok)
+    {
+      NS_LOG_WARN ("Cannot write coverage map " << filename);
+    }
+  return ok;
+}
+
+} // namespace ns3
@@ -56,8 +56,14 @@ double
 ItuR1238PropagationLossModel::GetLoss (Ptr<MobilityModel> a1, Ptr<MobilityModel> b1) const
 {
   NS_LOG_FUNCTION (this << a1 << b1);
-  Ptr<MobilityBuildingInfo> a = a1->GetObject<MobilityBuildingInfo> ();
-  Ptr<MobilityBuildingInfo> b = b1->GetObject<MobilityBuildingInfo> ();
+  return DoGetLoss (a1->GetObject<MobilityBuildingInfo> (), b1->GetObject<MobilityBuildingInfo> (),
+                    a1->GetPosition (), b1->GetPosition ());
+}
+
+double
+ItuR1238PropagationLossModel::DoGetLoss (Ptr<MobilityBuildingInfo> a, Ptr<MobilityBuildingInfo> b,
+                                         const Vector &pa, const Vector &pb) const
+{
   NS_ASSERT_MSG ((a != 0) && (b != 0), "ItuR1238PropagationLossModel only works with MobilityBuildingInfo");
   NS_ASSERT_MSG (a->GetBuilding ()->GetId () == b->GetBuilding ()->GetId (), "ITU-R 1238 applies only to nodes that are in the same building");
   double N = 0.0;
@@ -96,8 +102,8 @@ ItuR1238PropagationLossModel::GetLoss (Ptr<MobilityModel> a1, Ptr<MobilityModel>
     {
       NS_LOG_ERROR (this << " Unkwnon Wall Type");
     }
-  double loss = 20 * std::log10 (m_frequency / 1e6 /*MHz*/) + N * std::log10 (a1->GetDistanceFrom (b1)) + Lf - 28.0;
-  NS_LOG_INFO (this << " Node " << a1->GetPosition () << " <-> " << b1->GetPosition () << " loss = " << loss << " dB");
+  double loss = 20 * std::log10 (m_frequency / 1e6 /*MHz*/) + N * std::log10 (CalculateDistance (pa, pb)) + Lf - 28.0;
+  NS_LOG_INFO (this << " Node " << pa << " <-> " << pb << " loss = " << loss << " dB");
 
   return loss;
 }
@@ -111,6 +117,20 @@ ItuR1238PropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return (txPowerDbm - GetLoss (a, b));
 }
 
+void
+ItuR1238PropagationLossModel::DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                                  const Ptr<MobilityModel> *receivers,
+                                                  uint32_t n, double *powerDbm) const
+{
+  Ptr<MobilityBuildingInfo> info = a->GetObject<MobilityBuildingInfo> ();
+  Vector position = a->GetPosition ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      powerDbm[i] -= DoGetLoss (info, receivers[i]->GetObject<MobilityBuildingInfo> (),
+                                position, receivers[i]->GetPosition ());
+    }
+}
+
 
 int64_t
 ItuR1238PropagationLossModel::DoAssignStreams (int64_t stream)
@@ -25,6 +25,7 @@
 
 #include <ns3/propagation-loss-model.h>
 #include <ns3/propagation-environment.h>
+#include <ns3/mobility-building-info.h>
 
 namespace ns3 {
 
@@ -57,7 +58,19 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                   const Ptr<MobilityModel> *receivers,
+                                   uint32_t n, double *powerDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  /**
+   * \param a the building information of the first node
+   * \param b the building information of the second node
+   * \param pa the position of the first node
+   * \param pb the position of the second node
+   * \return the loss in dB between the two nodes
+   */
+  double DoGetLoss (Ptr<MobilityBuildingInfo> a, Ptr<MobilityBuildingInfo> b,
+                    const Vector &pa, const Vector &pb) const;
   
   double m_frequency; ///< frequency in MHz
 
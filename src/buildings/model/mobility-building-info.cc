@@ -22,6 +22,7 @@
 #include <ns3/simulator.h>
 #include <ns3/position-allocator.h>
 #include <ns3/mobility-building-info.h>
+#include <ns3/building-list.h>
 #include <ns3/pointer.h>
 #include <ns3/log.h>
 #include <ns3/assert.h>
@@ -45,6 +46,10 @@ MobilityBuildingInfo::GetTypeId (void)
 
 
 MobilityBuildingInfo::MobilityBuildingInfo ()
+  : m_tracking (true),
+    m_dirty (true),
+    m_moving (true),
+    m_version (0)
 {
   NS_LOG_FUNCTION (this);
   m_indoor = false;
@@ -55,7 +60,11 @@ MobilityBuildingInfo::MobilityBuildingInfo ()
 
 
 MobilityBuildingInfo::MobilityBuildingInfo (Ptr<Building> building)
-  : m_myBuilding (building)
+  : m_tracking (true),
+    m_dirty (true),
+    m_moving (true),
+    m_version (0),
+    m_myBuilding (building)
 {
   NS_LOG_FUNCTION (this);
   m_indoor = false;
@@ -64,10 +73,101 @@ MobilityBuildingInfo::MobilityBuildingInfo (Ptr<Building> building)
   m_roomY = 1;
 }
 
+void
+MobilityBuildingInfo::NotifyNewAggregate (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_mobility == 0)
+    {
+      Ptr<MobilityModel> mm = GetObject<MobilityModel> ();
+      if (mm != 0)
+        {
+          m_mobility = mm;
+          m_mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&MobilityBuildingInfo::CourseChange, this));
+          m_dirty = true;
+        }
+    }
+  Object::NotifyNewAggregate ();
+}
+
+void
+MobilityBuildingInfo::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_mobility = 0;
+  m_myBuilding = 0;
+  Object::DoDispose ();
+}
+
+void
+MobilityBuildingInfo::CourseChange (Ptr<const MobilityModel> model)
+{
+  m_dirty = true;
+}
+
+void
+MobilityBuildingInfo::MakeConsistent (Ptr<MobilityModel> mm)
+{
+  NS_LOG_FUNCTION (this << mm);
+  if (m_mobility == 0)
+    {
+      m_mobility = mm;
+      m_mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&MobilityBuildingInfo::CourseChange, this));
+    }
+  m_tracking = true;
+  m_dirty = true;
+  Update ();
+}
+
+void
+MobilityBuildingInfo::Update (void)
+{
+  if (!m_tracking || m_mobility == 0)
+    {
+      return;
+    }
+  uint32_t version = BuildingList::GetVersion ();
+  if (!m_dirty && !m_moving && version == m_version)
+    {
+      return;
+    }
+  Vector position = m_mobility->GetPosition ();
+  if (!m_dirty && version == m_version && position.x == m_position.x
+      && position.y == m_position.y && position.z == m_position.z)
+    {
+      return;
+    }
+  Vector velocity = m_mobility->GetVelocity ();
+  m_moving = velocity.x != 0.0 || velocity.y != 0.0 || velocity.z != 0.0;
+  bool changed = version != m_version;
+  m_dirty = false;
+  m_position = position;
+  m_version = version;
+
+  // most moves stay in the same building
+  if (changed || !(m_indoor && m_myBuilding->IsInside (position)))
+    {
+      Ptr<Building> building = BuildingList::FindBuilding (position);
+      if (building == 0)
+        {
+          NS_LOG_LOGIC ("MobilityBuildingInfo " << this << " pos " << position << " is outdoor");
+          m_indoor = false;
+          return;
+        }
+      NS_LOG_LOGIC ("MobilityBuildingInfo " << this << " pos " << position << " falls inside building " << building->GetId ());
+      m_myBuilding = building;
+      m_indoor = true;
+    }
+  m_nFloor = m_myBuilding->GetFloor (position);
+  m_roomX = m_myBuilding->GetRoomX (position);
+  m_roomY = m_myBuilding->GetRoomY (position);
+}
+
 bool
 MobilityBuildingInfo::IsIndoor (void)
 {
   NS_LOG_FUNCTION (this);
+  Update ();
   return (m_indoor);
 }
 
@@ -75,6 +175,7 @@ bool
 MobilityBuildingInfo::IsOutdoor (void)
 {
   NS_LOG_FUNCTION (this);
+  Update ();
   return (!m_indoor);
 }
 
@@ -82,6 +183,7 @@ void
 MobilityBuildingInfo::SetIndoor (Ptr<Building> building, uint8_t nfloor, uint8_t nroomx, uint8_t nroomy)
 {
   NS_LOG_FUNCTION (this);
+  m_tracking = false;
   m_indoor = true;
   m_myBuilding = building;
   m_nFloor = nfloor;
@@ -103,6 +205,7 @@ void
 MobilityBuildingInfo::SetIndoor (uint8_t nfloor, uint8_t nroomx, uint8_t nroomy)
 {
   NS_LOG_FUNCTION (this);
+  m_tracking = false;
   m_indoor = true;
   m_nFloor = nfloor;
   m_roomX = nroomx;
@@ -123,6 +226,7 @@ void
 MobilityBuildingInfo::SetOutdoor (void)
 {
   NS_LOG_FUNCTION (this);
+  m_tracking = false;
   m_indoor = false;
 }
 
@@ -130,6 +234,7 @@ uint8_t
 MobilityBuildingInfo::GetFloorNumber (void)
 {
   NS_LOG_FUNCTION (this);
+  Update ();
   return (m_nFloor);
 }
 
@@ -137,6 +242,7 @@ uint8_t
 MobilityBuildingInfo::GetRoomNumberX (void)
 {
   NS_LOG_FUNCTION (this);
+  Update ();
   return (m_roomX);
 }
 
@@ -144,6 +250,7 @@ uint8_t
 MobilityBuildingInfo::GetRoomNumberY (void)
 {
   NS_LOG_FUNCTION (this);
+  Update ();
   return (m_roomY);
 }
 
@@ -152,6 +259,7 @@ Ptr<Building>
 MobilityBuildingInfo::GetBuilding ()
 {
   NS_LOG_FUNCTION (this);
+  Update ();
   return (m_myBuilding);
 }
 
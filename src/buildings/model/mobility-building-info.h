@@ -30,6 +30,7 @@
 #include <map>
 #include <ns3/building.h>
 #include <ns3/constant-velocity-helper.h>
+#include <ns3/mobility-model.h>
 
 
 
@@ -42,7 +43,14 @@ namespace ns3 {
  *
  * This model implements the managment of scenarios where users might be
  * either indoor (e.g., houses, offices, etc.) and outdoor.
- * 
+ *
+ * Once aggregated to a MobilityModel, the building, floor and room follow
+ * the position of the model: they are looked up again, through
+ * BuildingList::FindBuilding, when queried after the position changed
+ * or after the buildings changed. A node standing still since its last
+ * CourseChange is not even asked for its position. Marking the instance
+ * by hand with SetIndoor or SetOutdoor stops these updates, until
+ * MakeConsistent is called.
  */
 class MobilityBuildingInfo : public Object
 {
@@ -83,6 +91,14 @@ public:
    */
   void SetOutdoor ();
 
+  /**
+   * Locate the MobilityBuildingInfo instance from the position of the
+   * mobility model, and keep following it from now on.
+   *
+   * \param mm the mobility model of the node
+   */
+  void MakeConsistent (Ptr<MobilityModel> mm);
+
   /** 
    * 
    * \return 
@@ -109,7 +125,26 @@ public:
 
 
 
+protected:
+  virtual void NotifyNewAggregate (void);
+  virtual void DoDispose (void);
+
 private:
+  /**
+   * Look up the building again if the position may have changed
+   */
+  void Update (void);
+  /**
+   * \param model the mobility model whose course changed
+   */
+  void CourseChange (Ptr<const MobilityModel> model);
+
+  Ptr<MobilityModel> m_mobility; //!< the mobility model followed, or 0
+  bool m_tracking; //!< whether to follow the mobility model
+  bool m_dirty; //!< whether the course changed since the last update
+  bool m_moving; //!< whether the velocity was not zero at the last update
+  Vector m_position; //!< position at the last update
+  uint32_t m_version; //!< version of the BuildingList at the last update
 
   Ptr<Building> m_myBuilding;
   bool m_indoor;
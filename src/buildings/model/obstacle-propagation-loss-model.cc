@@ -0,0 +1,170 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#include "obstacle-propagation-loss-model.h"
+#include "buildings-propagation-loss-model.h"
+#include "building.h"
+#include "building-list.h"
+#include "ns3/mobility-model.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ObstaclePropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED (ObstaclePropagationLossModel);
+
+TypeId
+ObstaclePropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ObstaclePropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Buildings")
+    .AddConstructor<ObstaclePropagationLossModel> ()
+    .AddAttribute ("UseBuildings",
+                   "Whether the buildings of the BuildingList block the path.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&ObstaclePropagationLossModel::m_useBuildings),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Obstacles",
+                   "Other obstacles blocking the path, or none.",
+                   PointerValue (),
+                   MakePointerAccessor (&ObstaclePropagationLossModel::m_obstacles),
+                   MakePointerChecker<ObstacleWorld> ())
+    .AddAttribute ("ObstacleWallLoss",
+                   "Loss of each wall of the other obstacles crossed [dB].",
+                   DoubleValue (10.0),
+                   MakeDoubleAccessor (&ObstaclePropagationLossModel::m_obstacleWallLoss),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("DepthLoss",
+                   "Loss of each meter of the path inside a building or obstacle [dB/m].",
+                   DoubleValue (0.5),
+                   MakeDoubleAccessor (&ObstaclePropagationLossModel::m_depthLoss),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("LineOfSightOnly",
+                   "Whether to only tell if the path is blocked, and add NlosLoss if it is.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&ObstaclePropagationLossModel::m_losOnly),
+                   MakeBooleanChecker ())
+    .AddAttribute ("NlosLoss",
+                   "Loss of a blocked path, with LineOfSightOnly [dB].",
+                   DoubleValue (20.0),
+                   MakeDoubleAccessor (&ObstaclePropagationLossModel::m_nlosLoss),
+                   MakeDoubleChecker<double> (0.0))
+  ;
+  return tid;
+}
+
+ObstaclePropagationLossModel::ObstaclePropagationLossModel ()
+  : m_buildingsVersion (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ObstaclePropagationLossModel::~ObstaclePropagationLossModel ()
+{
+}
+
+void
+ObstaclePropagationLossModel::UpdateBuildings (void) const
+{
+  uint32_t version = BuildingList::GetVersion ();
+  if (m_buildings != 0 && version == m_buildingsVersion)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << BuildingList::GetNBuildings ());
+  m_buildingsVersion = version;
+  m_buildings = CreateObject<ObstacleWorld> ();
+  m_buildingWallLoss.clear ();
+  for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
+    {
+      m_buildings->AddObstacle ((*bit)->GetBoundaries ());
+      m_buildingWallLoss.push_back (BuildingsPropagationLossModel::GetExternalWallLoss ((*bit)->GetExtWallsType ()));
+    }
+  m_buildings->BuildIndex ();
+}
+
+double
+ObstaclePropagationLossModel::CrossingsLoss (const Vector &a, const Vector &b,
+                                             const std::vector<double> *wallLoss) const
+{
+  double length = CalculateDistance (a, b);
+  double loss = 0.0;
+  for (std::vector<ObstacleCrossing>::const_iterator c = m_crossings.begin (); c != m_crossings.end (); ++c)
+    {
+      // the walls crossed, unless an end of the path is inside
+      uint32_t walls = (c->enter > 0.0 ? 1 : 0) + (c->exit < 1.0 ? 1 : 0);
+      double wall = wallLoss != 0 ? (*wallLoss)[c->obstacle] : m_obstacleWallLoss;
+      loss += walls * wall + (c->exit - c->enter) * length * m_depthLoss;
+    }
+  return loss;
+}
+
+double
+ObstaclePropagationLossModel::GetLoss (const Vector &a, const Vector &b) const
+{
+  if (m_useBuildings)
+    {
+      UpdateBuildings ();
+    }
+  if (m_losOnly)
+    {
+      bool blocked = (m_useBuildings && m_buildings->IsBlocked (a, b))
+        || (m_obstacles != 0 && m_obstacles->IsBlocked (a, b));
+      return blocked ? m_nlosLoss : 0.0;
+    }
+  double loss = 0.0;
+  if (m_useBuildings && m_buildings->FindCrossings (a, b, m_crossings) > 0)
+    {
+      loss += CrossingsLoss (a, b, &m_buildingWallLoss);
+    }
+  if (m_obstacles != 0 && m_obstacles->FindCrossings (a, b, m_crossings) > 0)
+    {
+      loss += CrossingsLoss (a, b, 0);
+    }
+  NS_LOG_LOGIC (this << " loss " << loss << " dB between " << a << " and " << b);
+  return loss;
+}
+
+double
+ObstaclePropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                             Ptr<MobilityModel> a,
+                                             Ptr<MobilityModel> b) const
+{
+  return txPowerDbm - GetLoss (a->GetPosition (), b->GetPosition ());
+}
+
+double
+ObstaclePropagationLossModel::DoGetMaxGain (void) const
+{
+  // the losses are never negative
+  return 0.0;
+}
+
+int64_t
+ObstaclePropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  return 0;
+}
+
+} // namespace ns3
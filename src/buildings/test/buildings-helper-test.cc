@@ -27,6 +27,8 @@
 #include <ns3/building.h>
 #include <ns3/buildings-helper.h>
 #include <ns3/mobility-helper.h>
+#include <ns3/constant-velocity-mobility-model.h>
+#include <ns3/building-list.h>
 #include <ns3/simulator.h>
 
 using namespace ns3;
@@ -173,6 +175,135 @@ BuildingsHelperOneTestCase::DoRun ()
 
 
 
+/**
+ * Move a node across buildings, and check that its MobilityBuildingInfo
+ * follows it without being made consistent again
+ */
+class BuildingsHelperMovingTestCase : public TestCase
+{
+public:
+  BuildingsHelperMovingTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param info the building info of the node
+   * \param bid the expected building id, or -1 if outdoor
+   * \param fn the expected floor number, if indoor
+   */
+  void Check (Ptr<MobilityBuildingInfo> info, int32_t bid, uint32_t fn);
+};
+
+BuildingsHelperMovingTestCase::BuildingsHelperMovingTestCase ()
+  : TestCase ("moving node")
+{
+}
+
+void
+BuildingsHelperMovingTestCase::Check (Ptr<MobilityBuildingInfo> info, int32_t bid, uint32_t fn)
+{
+  NS_TEST_ASSERT_MSG_EQ (info->IsIndoor (), (bid >= 0), "indoor/outdoor mismatch at " << Simulator::Now ().GetSeconds ());
+  if (bid >= 0)
+    {
+      NS_TEST_ASSERT_MSG_EQ (info->GetBuilding ()->GetId (), (uint32_t) bid, "Building ID mismatch");
+      NS_TEST_ASSERT_MSG_EQ ((uint32_t) info->GetFloorNumber (), fn, "floor number mismatch");
+    }
+}
+
+void
+BuildingsHelperMovingTestCase::DoRun ()
+{
+  // a row of buildings, 10 m wide every 20 m along x
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      Ptr<Building> b = CreateObject<Building> ();
+      b->SetBoundaries (Box (20.0 * i, 20.0 * i + 10.0, 0.0, 10.0, 0.0, 9.0));
+      b->SetNFloors (3);
+    }
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.Install (nodes);
+  BuildingsHelper::Install (nodes);
+  Ptr<ConstantVelocityMobilityModel> flying = nodes.Get (0)->GetObject<ConstantVelocityMobilityModel> ();
+  flying->SetPosition (Vector (-5.0, 5.0, 4.0));
+  flying->SetVelocity (Vector (1.0, 0.0, 0.0));
+  Ptr<ConstantVelocityMobilityModel> still = nodes.Get (1)->GetObject<ConstantVelocityMobilityModel> ();
+  still->SetPosition (Vector (95.0, 5.0, 1.0));
+  BuildingsHelper::MakeMobilityModelConsistent ();
+
+  Ptr<MobilityBuildingInfo> info = flying->GetObject<MobilityBuildingInfo> ();
+  Ptr<MobilityBuildingInfo> stillInfo = still->GetObject<MobilityBuildingInfo> ();
+  Check (info, -1, 0);
+  Check (stillInfo, -1, 0);
+  Simulator::Schedule (Seconds (10.0), &BuildingsHelperMovingTestCase::Check, this, info, 0, 2);
+  Simulator::Schedule (Seconds (20.0), &BuildingsHelperMovingTestCase::Check, this, info, -1, 0);
+  Simulator::Schedule (Seconds (30.0), &BuildingsHelperMovingTestCase::Check, this, info, 1, 2);
+  // climbing inside the building
+  Simulator::Schedule (Seconds (31.0), &ConstantVelocityMobilityModel::SetVelocity, flying, Vector (0.0, 0.0, 1.0));
+  Simulator::Schedule (Seconds (34.5), &BuildingsHelperMovingTestCase::Check, this, info, 1, 3);
+  Simulator::Schedule (Seconds (36.5), &BuildingsHelperMovingTestCase::Check, this, info, -1, 0);
+  // a building moved onto a node standing still
+  Simulator::Schedule (Seconds (40.0), &BuildingsHelperMovingTestCase::Check, this, stillInfo, -1, 0);
+  Ptr<Building> late = CreateObject<Building> ();
+  late->SetBoundaries (Box (200.0, 210.0, 0.0, 10.0, 0.0, 3.0));
+  Simulator::Schedule (Seconds (41.0), &Building::SetBoundaries, late, Box (90.0, 100.0, 0.0, 10.0, 0.0, 3.0));
+  Simulator::Schedule (Seconds (41.0), &BuildingsHelperMovingTestCase::Check, this, stillInfo, 5, 1);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * Compare BuildingList::FindBuilding with a scan of all the buildings
+ */
+class BuildingsHelperFindTestCase : public TestCase
+{
+public:
+  BuildingsHelperFindTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BuildingsHelperFindTestCase::BuildingsHelperFindTestCase ()
+  : TestCase ("building lookup")
+{
+}
+
+void
+BuildingsHelperFindTestCase::DoRun ()
+{
+  // buildings of various sizes, sparse, and some overlapping
+  for (uint32_t i = 0; i < 200; i++)
+    {
+      double x = (i * 37) % 500;
+      double y = (i * 91) % 300 + (i > 150 ? 2000.0 : 0.0);
+      double w = 5.0 + (i * 13) % 40;
+      Ptr<Building> b = CreateObject<Building> ();
+      b->SetBoundaries (Box (x, x + w, y, y + w / 2, 0.0, 10.0 + i % 20));
+    }
+  uint32_t indoor = 0;
+  for (uint32_t i = 0; i < 5000; i++)
+    {
+      Vector pos ((i * 7919) % 600 - 50.0 + 0.25, (i * 104729) % 2400 - 50.0 + 0.5, (i * 31) % 40);
+      Ptr<Building> expected = 0;
+      for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End () && expected == 0; ++bit)
+        {
+          if ((*bit)->IsInside (pos))
+            {
+              expected = *bit;
+            }
+        }
+      indoor += (expected != 0);
+      NS_TEST_ASSERT_MSG_EQ (BuildingList::FindBuilding (pos), expected, "lookup mismatch at " << pos);
+    }
+  NS_TEST_ASSERT_MSG_GT (indoor, 100, "too few positions inside buildings");
+  Simulator::Destroy ();
+}
+
+
 class BuildingsHelperTestSuite : public TestSuite
 {
 public:
@@ -321,6 +452,9 @@ BuildingsHelperTestSuite::BuildingsHelperTestSuite ()
   q7.pos = vq7;
   q7.indoor = false;
   AddTestCase (new BuildingsHelperOneTestCase (q7, b2), TestCase::QUICK);     
+
+  AddTestCase (new BuildingsHelperMovingTestCase, TestCase::QUICK);
+  AddTestCase (new BuildingsHelperFindTestCase, TestCase::QUICK);
 }
 
 static BuildingsHelperTestSuite buildingsHelperAntennaTestSuiteInstance;
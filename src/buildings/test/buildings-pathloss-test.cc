@@ -30,6 +30,7 @@
 #include <ns3/enum.h>
 #include <ns3/constant-position-mobility-model.h>
 #include <ns3/mobility-building-info.h>
+#include <ns3/itu-r-1238-propagation-loss-model.h>
 #include "buildings-pathloss-test.h"
 
 
@@ -123,6 +124,9 @@ BuildingsPathlossTestSuite::BuildingsPathlossTestSuite ()
   // (2 floors x 2 dB/floor = 4) -> 180.90 + 7 - 4 = 183.90
   AddTestCase (new BuildingsPathlossTestCase (freq, 9, 11, UrbanEnvironment, LargeCity, 183.90, "ITU1411 NLOS Indoor -> Outdoor"), TestCase::QUICK);
 
+  // Test #11 ITUP1238 batch, across the floors
+  AddTestCase (new BuildingsPathlossBatchTestCase, TestCase::QUICK);
+
 
 }
 
@@ -270,3 +274,55 @@ BuildingsPathlossTestCase::CreateMobilityModel (uint16_t index)
   BuildingsHelper::MakeConsistent (mm); 
   return mm;
 }
+
+
+BuildingsPathlossBatchTestCase::BuildingsPathlossBatchTestCase ()
+  : TestCase ("LOSS calculation: ITUP1238 batch")
+{
+}
+
+BuildingsPathlossBatchTestCase::~BuildingsPathlossBatchTestCase ()
+{
+}
+
+void
+BuildingsPathlossBatchTestCase::DoRun (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Ptr<Building> building = CreateObject<Building> ();
+  building->SetBoundaries (Box (0.0, 60.0, 0.0, 40.0, 0.0, 15.0));
+  building->SetBuildingType (Building::Office);
+  building->SetExtWallsType (Building::ConcreteWithWindows);
+  building->SetNFloors (5);
+
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (5.0, 5.0, 4.0));
+  a->AggregateObject (CreateObject<MobilityBuildingInfo> ());
+  BuildingsHelper::MakeConsistent (a);
+
+  // receivers on each floor, the sender's included
+  std::vector<Ptr<MobilityModel> > receivers;
+  for (uint32_t i = 0; i < 15; i++)
+    {
+      Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+      b->SetPosition (Vector (10.0 + 3.0 * i, 2.0 + 2.5 * i, 1.5 + 3.0 * (i % 5)));
+      b->AggregateObject (CreateObject<MobilityBuildingInfo> ());
+      BuildingsHelper::MakeConsistent (b);
+      receivers.push_back (b);
+    }
+
+  Ptr<ItuR1238PropagationLossModel> propagationLossModel = CreateObject<ItuR1238PropagationLossModel> ();
+  std::vector<double> rxPowerDbm;
+  propagationLossModel->CalcRxPowerBatch (20.0, a, receivers, rxPowerDbm);
+  NS_TEST_ASSERT_MSG_EQ (rxPowerDbm.size (), receivers.size (), "Wrong number of powers");
+  for (uint32_t i = 0; i < receivers.size (); i++)
+    {
+      double expected = propagationLossModel->CalcRxPower (20.0, a, receivers[i]);
+      NS_LOG_INFO ("Receiver " << i << " on floor " << (uint32_t) receivers[i]->GetObject<MobilityBuildingInfo> ()->GetFloorNumber ()
+                   << ": " << rxPowerDbm[i] << " dBm");
+      // the same computation, so the same result to the bit
+      NS_TEST_EXPECT_MSG_EQ (rxPowerDbm[i], expected, "Wrong power at receiver " << i);
+    }
+  Simulator::Destroy ();
+}
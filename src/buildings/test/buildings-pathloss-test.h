@@ -56,5 +56,20 @@ private:
 
 };
 
+/**
+* Compare the batch path loss of ItuR1238PropagationLossModel to the loss
+* computed for each receiver alone, across the floors of a building
+*/
+class BuildingsPathlossBatchTestCase : public TestCase
+{
+public:
+  BuildingsPathlossBatchTestCase ();
+  virtual ~BuildingsPathlossBatchTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+
 
 #endif /* BUILDING_PATHLOSS_TEST_H */
@@ -101,6 +101,8 @@ BuildingsShadowingTestCase::DoRun (void)
   Ptr<HybridBuildingsPropagationLossModel> propagationLossModel = CreateObject<HybridBuildingsPropagationLossModel> ();
   
   std::vector<double> loss;
+  std::vector<Ptr<MobilityModel> > mmas;
+  std::vector<Ptr<MobilityModel> > mmbs;
   double sum = 0.0;
   double sumSquared = 0.0;
   int samples = 1000;
@@ -113,9 +115,17 @@ BuildingsShadowingTestCase::DoRun (void)
       NS_TEST_ASSERT_MSG_EQ_TOL (shadowingLoss, shadowingLoss2, 0.001, 
                                  "Shadowing is not constant for the same mobility model pair!");
       loss.push_back (shadowingLoss);
+      mmas.push_back (mma);
+      mmbs.push_back (mmb);
       sum += shadowingLoss;
       sumSquared += (shadowingLoss * shadowingLoss);
     }
+  for (int i = 0; i < samples; i++)
+    {
+      double shadowingLoss = propagationLossModel->DoCalcRxPower (0.0, mmas[i], mmbs[i]) + m_lossRef;
+      NS_TEST_ASSERT_MSG_EQ_TOL (shadowingLoss, loss[i], 0.001,
+                                 "Shadowing changed after other mobility model pairs were added!");
+    }
   double sampleMean = sum / samples;
   double sampleVariance = (sumSquared - (sum * sum / samples)) / (samples - 1);
   double sampleStd = std::sqrt (sampleVariance);
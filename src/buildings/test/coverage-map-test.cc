@@ -0,0 +1,199 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/obstacle-world.h"
+#include "ns3/obstacle-propagation-loss-model.h"
+#include "ns3/coverage-map.h"
+#include "ns3/coverage-map-helper.h"
+#include "ns3/coverage-map-propagation-loss-model.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/constant-position-mobility-model.h"
+
+using namespace ns3;
+
+/**
+ * Check a map of the Friis loss against the model, at and between the
+ * grid points, and written by one or several processes
+ */
+class CoverageMapLossTest : public TestCase
+{
+public:
+  CoverageMapLossTest ();
+private:
+  virtual void DoRun (void);
+};
+
+CoverageMapLossTest::CoverageMapLossTest ()
+  : TestCase ("Check the losses of a coverage map")
+{
+}
+
+void
+CoverageMapLossTest::DoRun (void)
+{
+  Ptr<FriisPropagationLossModel> friis = CreateObject<FriisPropagationLossModel> ();
+  std::string filename = CreateTempDirFilename ("coverage-map-test.covm");
+  std::string forked = CreateTempDirFilename ("coverage-map-test-forked.covm");
+  CoverageMapHelper coverage;
+  coverage.SetPropagationLossModel (friis);
+  coverage.SetBounds (Box (0.0, 10.0, 0.0, 7.0, 0.0, 4.0));
+  coverage.SetResolution (2.0);
+  coverage.AddTransmitter (Vector (50.0, 50.0, 30.0));
+  coverage.AddTransmitter (Vector (-20.0, 3.0, 1.5));
+  coverage.SetNProcesses (1);
+  coverage.Write (filename);
+  coverage.SetNProcesses (4);
+  coverage.Write (forked);
+
+  Ptr<CoverageMap> map = Create<CoverageMap> (filename);
+  Ptr<CoverageMap> forkedMap = Create<CoverageMap> (forked);
+  NS_TEST_ASSERT_MSG_EQ (map->GetNTransmitters (), 2, "Wrong number of transmitters");
+  NS_TEST_EXPECT_MSG_EQ (map->GetNx (), 6, "Wrong number of points along x");
+  NS_TEST_EXPECT_MSG_EQ (map->GetNy (), 5, "Wrong number of points along y");
+  NS_TEST_EXPECT_MSG_EQ (map->GetNz (), 3, "Wrong number of points along z");
+  NS_TEST_EXPECT_MSG_EQ_TOL (map->GetBounds ().yMax, 8.0, 1e-12, "Wrong bounds");
+  NS_TEST_EXPECT_MSG_EQ (map->FindTransmitter (Vector (-20.0, 3.001, 1.5), 0.01), 1, "Transmitter not found");
+  NS_TEST_EXPECT_MSG_EQ (map->FindTransmitter (Vector (-20.0, 3.1, 1.5), 0.01), -1, "Wrong transmitter found");
+
+  Ptr<MobilityModel> tx = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> rx = CreateObject<ConstantPositionMobilityModel> ();
+  for (uint32_t t = 0; t < 2; t++)
+    {
+      tx->SetPosition (map->GetTransmitter (t));
+      for (uint32_t k = 0; k < map->GetNz (); k++)
+        {
+          for (uint32_t j = 0; j < map->GetNy (); j++)
+            {
+              for (uint32_t i = 0; i < map->GetNx (); i++)
+                {
+                  Vector point = map->GetPoint (i, j, k);
+                  rx->SetPosition (point);
+                  double loss;
+                  double forkedLoss;
+                  NS_TEST_ASSERT_MSG_EQ (map->GetLoss (t, point, loss), true, "Grid point out of the map");
+                  forkedMap->GetLoss (t, point, forkedLoss);
+                  NS_TEST_ASSERT_MSG_EQ_TOL (loss, -friis->CalcRxPower (0.0, tx, rx), 1e-4, "Wrong loss at a grid point");
+                  NS_TEST_ASSERT_MSG_EQ (loss, forkedLoss, "Processes computed another loss");
+                }
+            }
+        }
+    }
+
+  // half way between points, the average of their losses
+  double l0;
+  double l1;
+  double mid;
+  map->GetLoss (1, map->GetPoint (2, 1, 1), l0);
+  map->GetLoss (1, map->GetPoint (3, 1, 1), l1);
+  map->GetLoss (1, Vector (5.0, 2.0, 2.0), mid);
+  NS_TEST_EXPECT_MSG_EQ_TOL (mid, (l0 + l1) / 2, 1e-9, "Wrong interpolation");
+  double corners = 0.0;
+  for (uint32_t c = 0; c < 8; c++)
+    {
+      double l;
+      map->GetLoss (0, map->GetPoint (2 + (c & 1), 1 + ((c >> 1) & 1), (c >> 2) & 1), l);
+      corners += l / 8;
+    }
+  map->GetLoss (0, Vector (5.0, 3.0, 1.0), mid);
+  NS_TEST_EXPECT_MSG_EQ_TOL (mid, corners, 1e-9, "Wrong interpolation in the center of a cell");
+  NS_TEST_EXPECT_MSG_EQ (map->GetLoss (0, Vector (5.0, 8.5, 1.0), mid), false, "Position out of the map");
+
+  // the model looks up either end, and hands the other links over
+  Ptr<CoverageMapPropagationLossModel> model = CreateObject<CoverageMapPropagationLossModel> ();
+  model->SetAttribute ("Filename", StringValue (filename));
+  tx->SetPosition (Vector (-20.0, 3.0, 1.5));
+  rx->SetPosition (Vector (5.0, 2.0, 2.0));
+  double expected = 10.0 - (l0 + l1) / 2;
+  NS_TEST_EXPECT_MSG_EQ_TOL (model->CalcRxPower (10.0, tx, rx), expected, 1e-9, "Wrong received power");
+  NS_TEST_EXPECT_MSG_EQ_TOL (model->CalcRxPower (10.0, rx, tx), expected, 1e-9, "Wrong received power uplink");
+  rx->SetPosition (Vector (5.0, 20.0, 2.0));
+  model->SetAttribute ("Fallback", PointerValue (friis));
+  NS_TEST_EXPECT_MSG_EQ_TOL (model->CalcRxPower (10.0, tx, rx), friis->CalcRxPower (10.0, tx, rx), 1e-9,
+                             "Link out of the map not handed over");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * Check a line-of-sight mask around an obstacle
+ */
+class CoverageMapLosTest : public TestCase
+{
+public:
+  CoverageMapLosTest ();
+private:
+  virtual void DoRun (void);
+};
+
+CoverageMapLosTest::CoverageMapLosTest ()
+  : TestCase ("Check a line-of-sight coverage map")
+{
+}
+
+void
+CoverageMapLosTest::DoRun (void)
+{
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  world->AddObstacle (Box (10.0, 12.0, -5.0, 5.0, 0.0, 20.0));
+  Ptr<ObstaclePropagationLossModel> los = CreateObject<ObstaclePropagationLossModel> ();
+  los->SetAttribute ("Obstacles", PointerValue (world));
+  los->SetAttribute ("LineOfSightOnly", BooleanValue (true));
+  los->SetAttribute ("NlosLoss", DoubleValue (1.0));
+
+  std::string filename = CreateTempDirFilename ("coverage-map-test-los.covm");
+  CoverageMapHelper coverage;
+  coverage.SetPropagationLossModel (los);
+  coverage.SetBounds (Box (0.0, 30.0, -10.0, 10.0, 5.0, 5.0));
+  coverage.SetResolution (1.0);
+  coverage.AddTransmitter (Vector (0.0, 0.0, 5.0));
+  coverage.SetNProcesses (2);
+  coverage.Write (filename);
+
+  Ptr<CoverageMap> map = Create<CoverageMap> (filename);
+  NS_TEST_ASSERT_MSG_EQ (map->GetNz (), 1, "A flat map has one layer");
+  double loss;
+  map->GetLoss (0, Vector (20.0, 0.0, 5.0), loss);
+  NS_TEST_EXPECT_MSG_EQ_TOL (loss, 1.0, 1e-9, "Point behind the obstacle visible");
+  map->GetLoss (0, Vector (5.0, 3.0, 5.0), loss);
+  NS_TEST_EXPECT_MSG_EQ_TOL (loss, 0.0, 1e-9, "Point in front of the obstacle hidden");
+  map->GetLoss (0, Vector (16.0, 10.0, 5.0), loss);
+  NS_TEST_EXPECT_MSG_EQ_TOL (loss, 0.0, 1e-9, "Point beside the obstacle hidden");
+
+  Simulator::Destroy ();
+}
+
+static class CoverageMapTestSuite : public TestSuite
+{
+public:
+  CoverageMapTestSuite ();
+} g_coverageMapTestSuite;
+
+CoverageMapTestSuite::CoverageMapTestSuite ()
+  : TestSuite ("coverage-map", UNIT)
+{
+  AddTestCase (new CoverageMapLossTest, TestCase::QUICK);
+  AddTestCase (new CoverageMapLosTest, TestCase::QUICK);
+}
@@ -0,0 +1,272 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/building.h"
+#include "ns3/building-list.h"
+#include "ns3/obstacle-world.h"
+#include "ns3/obstacle-shape.h"
+#include "ns3/obstacle-loader-helper.h"
+#include <fstream>
+
+using namespace ns3;
+
+/**
+ * \param filename the file to write
+ * \param contents the contents of the file
+ */
+static void
+WriteFile (std::string filename, std::string contents)
+{
+  std::ofstream file (filename.c_str ());
+  file << contents;
+}
+
+/**
+ * Load boxes from a CSV file, skipping the invalid lines and merging the
+ * boxes sharing a face
+ */
+class ObstacleLoaderCsvTest : public TestCase
+{
+public:
+  ObstacleLoaderCsvTest ();
+private:
+  virtual void DoRun (void);
+};
+
+ObstacleLoaderCsvTest::ObstacleLoaderCsvTest ()
+  : TestCase ("Check the loading of a CSV file")
+{
+}
+
+void
+ObstacleLoaderCsvTest::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("obstacle-loader-test.csv");
+  WriteFile (filename,
+             "xMin,xMax,yMin,yMax,zMin,zMax\n"
+             "# two halves of a block\n"
+             "0,10,0,10,0,30\n"
+             "10;20;0;10;0;30\r\n"
+             "\n"
+             "50 60 50 60 0 9\n"
+             "1,2,3,4,5\n"
+             "5,5,0,10,0,10\n");
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  ObstacleLoaderHelper loader;
+  loader.SetWorld (world);
+  loader.SetFloorHeight (3.0);
+  NS_TEST_ASSERT_MSG_EQ (loader.Load (filename), 3, "Wrong number of footprints");
+  NS_TEST_EXPECT_MSG_EQ (loader.GetNSkipped (), 2, "Invalid lines not skipped");
+  NS_TEST_EXPECT_MSG_EQ (loader.GetNObstacles (), 2, "Boxes sharing a face not merged");
+  NS_TEST_EXPECT_MSG_EQ (world->GetNObstacles (), 2, "Obstacles not added");
+  bool merged = false;
+  for (uint32_t i = 0; i < world->GetNObstacles (); i++)
+    {
+      const Box &box = world->GetObstacle (i);
+      merged = merged || (box.xMin == 0.0 && box.xMax == 20.0 && box.yMax == 10.0 && box.zMax == 30.0);
+    }
+  NS_TEST_EXPECT_MSG_EQ (merged, true, "Merged box not found");
+  NS_TEST_ASSERT_MSG_EQ (BuildingList::GetNBuildings (), 3, "One building per footprint expected");
+  NS_TEST_EXPECT_MSG_EQ (BuildingList::GetBuilding (0)->GetNFloors (), 10, "Floors not derived from the height");
+  NS_TEST_EXPECT_MSG_EQ (BuildingList::GetBuilding (2)->GetNFloors (), 3, "Floors not derived from the height");
+  Simulator::Destroy ();
+
+  // without merging
+  world = CreateObject<ObstacleWorld> ();
+  loader.SetWorld (world);
+  loader.SetMergeBoxes (false);
+  loader.SetCreateBuildings (false);
+  loader.Load (filename);
+  NS_TEST_EXPECT_MSG_EQ (world->GetNObstacles (), 3, "Boxes merged");
+  NS_TEST_EXPECT_MSG_EQ (BuildingList::GetNBuildings (), 0, "Buildings created");
+  Simulator::Destroy ();
+}
+
+/**
+ * Load extruded polygons from a GeoJSON file
+ */
+class ObstacleLoaderGeoJsonTest : public TestCase
+{
+public:
+  ObstacleLoaderGeoJsonTest ();
+private:
+  virtual void DoRun (void);
+};
+
+ObstacleLoaderGeoJsonTest::ObstacleLoaderGeoJsonTest ()
+  : TestCase ("Check the loading of a GeoJSON file")
+{
+}
+
+void
+ObstacleLoaderGeoJsonTest::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("obstacle-loader-test.geojson");
+  WriteFile (filename,
+             "{ \"type\": \"FeatureCollection\", \"name\": \"city\",\n"
+             "  \"features\": [\n"
+             "  { \"type\": \"Feature\", \"properties\": { \"height\": 20, \"name\": \"a \\\"block\\\"\" },\n"
+             "    \"geometry\": { \"type\": \"Polygon\", \"coordinates\": [[[0,0],[10,0],[10,10],[0,10],[0,0]]] } },\n"
+             "  { \"type\": \"Feature\", \"properties\": { \"height\": \"15.5\", \"min_height\": 2 },\n"
+             "    \"geometry\": { \"type\": \"Polygon\", \"coordinates\": [\n"
+             "      [[20,0],[40,0],[40,10],[30,10],[30,20],[20,20],[20,0]],\n"
+             "      [[22,2],[24,2],[24,4],[22,2]]] } },\n"
+             "  { \"type\": \"Feature\", \"properties\": { \"levels\": [1, 2, null, true] },\n"
+             "    \"geometry\": { \"type\": \"MultiPolygon\", \"coordinates\": [\n"
+             "      [[[50,0],[60,0],[60,10],[50,10]]],\n"
+             "      [[[70,0],[80,0],[75,8],[70,0]]]] } },\n"
+             "  { \"type\": \"Feature\", \"properties\": { \"height\": 5 },\n"
+             "    \"geometry\": { \"type\": \"Point\", \"coordinates\": [1, 2] } },\n"
+             "  { \"type\": \"Feature\", \"properties\": { \"height\": 5 },\n"
+             "    \"geometry\": { \"type\": \"Polygon\", \"coordinates\": [[[0,50],[10,60],[10,50],[0,60]]] } }\n"
+             "  ] }\n");
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  ObstacleLoaderHelper loader;
+  loader.SetWorld (world);
+  loader.SetDefaultHeight (12.0);
+  // the rectangle, the L, the square and the triangle; the Point and the
+  // bow tie are skipped
+  NS_TEST_ASSERT_MSG_EQ (loader.Load (filename), 4, "Wrong number of footprints");
+  NS_TEST_EXPECT_MSG_EQ (loader.GetNSkipped (), 2, "Invalid features not skipped");
+  NS_TEST_ASSERT_MSG_EQ (world->GetNObstacles (), 4, "Wrong number of obstacles");
+  uint32_t boxes = 0;
+  uint32_t prisms = 0;
+  for (uint32_t i = 0; i < world->GetNObstacles (); i++)
+    {
+      if (world->GetShape (i) == 0)
+        {
+          boxes++;
+        }
+      else
+        {
+          prisms++;
+          Box bounds = world->GetShape (i)->GetBoundingBox ();
+          if (bounds.xMin == 20.0)
+            {
+              NS_TEST_EXPECT_MSG_EQ (bounds.zMin, 2.0, "Wrong min_height");
+              NS_TEST_EXPECT_MSG_EQ (bounds.zMax, 15.5, "Wrong height");
+              NS_TEST_EXPECT_MSG_EQ (world->GetShape (i)->IsInside (Vector (35.0, 15.0, 5.0)), false,
+                                     "The notch of the L is inside");
+              NS_TEST_EXPECT_MSG_EQ (world->GetShape (i)->IsInside (Vector (23.0, 3.0, 5.0)), true,
+                                     "Holes are not ignored");
+            }
+          else
+            {
+              NS_TEST_EXPECT_MSG_EQ (bounds.zMax, 12.0, "Default height not used");
+            }
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (boxes, 2, "Rectangles not turned into boxes");
+  NS_TEST_EXPECT_MSG_EQ (prisms, 2, "Polygons not turned into prisms");
+  NS_TEST_EXPECT_MSG_EQ (BuildingList::GetNBuildings (), 4, "One building per footprint expected");
+  Simulator::Destroy ();
+
+  // without a default height, the feature without one is skipped
+  world = CreateObject<ObstacleWorld> ();
+  ObstacleLoaderHelper other;
+  other.SetWorld (world);
+  other.SetCreateBuildings (false);
+  NS_TEST_EXPECT_MSG_EQ (other.Load (filename), 2, "Feature without height not skipped");
+  NS_TEST_EXPECT_MSG_EQ (other.GetNSkipped (), 3, "Feature without height not counted");
+  Simulator::Destroy ();
+}
+
+/**
+ * Load convex objects from an OBJ file, and cache them
+ */
+class ObstacleLoaderObjTest : public TestCase
+{
+public:
+  ObstacleLoaderObjTest ();
+private:
+  virtual void DoRun (void);
+};
+
+ObstacleLoaderObjTest::ObstacleLoaderObjTest ()
+  : TestCase ("Check the loading of an OBJ file, and the cache")
+{
+}
+
+void
+ObstacleLoaderObjTest::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("obstacle-loader-test.obj");
+  std::string cache = CreateTempDirFilename ("obstacle-loader-test.cache");
+  WriteFile (filename,
+             "# a cube and a tetrahedron\n"
+             "o cube\n"
+             "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+             "v 0 0 1\nv 1 0 1\nv 1 1 1\nv 0 1 1\n"
+             "f 1 2 3 4\nf 5/1 6/1 7/1 8/1\nf 1//1 2//1 6//1 5//1\nf 3 4 8 7\n"
+             "o tetrahedron\n"
+             "v 5 5 0\nv 7 5 0\nv 5 7 0\nv 5 5 2\n"
+             "f -4 -3 -2\nf -4 -3 -1\nf -4 -2 -1\nf -3 -2 -1\n"
+             "o flat\n"
+             "v 9 9 0\nv 10 9 0\nv 10 10 0\nv 9 10 0\n"
+             "f -1 -2 -3 -4\n");
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  ObstacleLoaderHelper loader;
+  loader.SetWorld (world);
+  loader.SetCreateBuildings (false);
+  loader.SetCacheFile (cache);
+  NS_TEST_ASSERT_MSG_EQ (loader.Load (filename), 2, "Wrong number of objects");
+  NS_TEST_EXPECT_MSG_EQ (loader.GetNSkipped (), 1, "Flat object not skipped");
+  NS_TEST_ASSERT_MSG_EQ (world->GetNObstacles (), 2, "Wrong number of obstacles");
+  NS_TEST_EXPECT_MSG_EQ ((world->GetShape (0) == 0), true, "Cube not turned into a box");
+  Ptr<const ConvexObstacle> hull = DynamicCast<const ConvexObstacle> (world->GetShape (1));
+  NS_TEST_ASSERT_MSG_NE (hull, 0, "Tetrahedron not turned into a convex obstacle");
+  NS_TEST_EXPECT_MSG_EQ (hull->GetNFaces (), 4, "Wrong hull");
+
+  // the cache is used as long as it matches the source
+  std::ifstream check (cache.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (check.good (), true, "Cache not written");
+  world = CreateObject<ObstacleWorld> ();
+  loader.SetWorld (world);
+  NS_TEST_EXPECT_MSG_EQ (loader.Load (filename), 2, "Cache not read");
+  NS_TEST_EXPECT_MSG_EQ (loader.GetNSkipped (), 1, "Skipped count not cached");
+  NS_TEST_EXPECT_MSG_EQ (world->GetNObstacles (), 2, "Cache not read");
+
+  // a different source invalidates it
+  WriteFile (filename,
+             "v 0 0 0\nv 2 0 0\nv 0 2 0\nv 0 0 2\nv 2 2 2\n"
+             "f 1 2 3\nf 1 2 4\nf 2 3 5\n");
+  world = CreateObject<ObstacleWorld> ();
+  loader.SetWorld (world);
+  NS_TEST_EXPECT_MSG_EQ (loader.Load (filename), 1, "Cache not invalidated");
+  NS_TEST_EXPECT_MSG_EQ (loader.GetNSkipped (), 0, "Cache not invalidated");
+  NS_TEST_EXPECT_MSG_EQ ((world->GetShape (0) != 0), true, "Cache not invalidated");
+  Simulator::Destroy ();
+}
+
+static class ObstacleLoaderTestSuite : public TestSuite
+{
+public:
+  ObstacleLoaderTestSuite ();
+} g_obstacleLoaderTestSuite;
+
+ObstacleLoaderTestSuite::ObstacleLoaderTestSuite ()
+  : TestSuite ("obstacle-loader", UNIT)
+{
+  AddTestCase (new ObstacleLoaderCsvTest, TestCase::QUICK);
+  AddTestCase (new ObstacleLoaderGeoJsonTest, TestCase::QUICK);
+  AddTestCase (new ObstacleLoaderObjTest, TestCase::QUICK);
+}
@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "ns3/building.h"
+#include "ns3/obstacle-world.h"
+#include "ns3/obstacle-propagation-loss-model.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/constant-position-mobility-model.h"
+
+using namespace ns3;
+
+/**
+ * Check the walls and depth crossed between two positions, around a
+ * building and an obstacle
+ */
+class ObstaclePropagationLossTest : public TestCase
+{
+public:
+  ObstaclePropagationLossTest ();
+private:
+  virtual void DoRun (void);
+};
+
+ObstaclePropagationLossTest::ObstaclePropagationLossTest ()
+  : TestCase ("Check the penetration loss of buildings and obstacles")
+{
+}
+
+void
+ObstaclePropagationLossTest::DoRun (void)
+{
+  Ptr<Building> building = CreateObject<Building> ();
+  building->SetBoundaries (Box (10.0, 20.0, -5.0, 5.0, 0.0, 30.0));
+  building->SetExtWallsType (Building::ConcreteWithWindows);
+
+  Ptr<ObstaclePropagationLossModel> model = CreateObject<ObstaclePropagationLossModel> ();
+  Vector tx (0.0, 0.0, 1.5);
+  // two walls of 7 dB and 10 m inside at 0.5 dB/m
+  NS_TEST_EXPECT_MSG_EQ_TOL (model->GetLoss (tx, Vector (30.0, 0.0, 1.5)), 19.0, 1e-9, "Wrong loss across the building");
+  NS_TEST_EXPECT_MSG_EQ_TOL (model->GetLoss (Vector (30.0, 0.0, 1.5), tx), 19.0, 1e-9, "Loss not symmetric");
+  // indoor: one wall and 5 m inside
+  NS_TEST_EXPECT_MSG_EQ_TOL (model->GetLoss (tx, Vector (15.0, 0.0, 1.5)), 9.5, 1e-9, "Wrong loss to an indoor node");
+  // over the roof
+  NS_TEST_EXPECT_MSG_EQ (model->GetLoss (Vector (0.0, 0.0, 40.0), Vector (30.0, 0.0, 40.0)), 0.0, "Loss in line of sight");
+
+  // the changes of the buildings are seen
+  building->SetExtWallsType (Building::Wood);
+  NS_TEST_EXPECT_MSG_EQ_TOL (model->GetLoss (tx, Vector (30.0, 0.0, 1.5)), 13.0, 1e-9, "Wall type change missed");
+
+  // the other obstacles
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  world->AddObstacle (Box (40.0, 45.0, -5.0, 5.0, 0.0, 10.0));
+  model->SetAttribute ("Obstacles", PointerValue (world));
+  model->SetAttribute ("ObstacleWallLoss", DoubleValue (10.0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (model->GetLoss (tx, Vector (50.0, 0.0, 1.5)), 13.0 + 22.5, 1e-9, "Wrong loss across both");
+  model->SetAttribute ("UseBuildings", BooleanValue (false));
+  NS_TEST_EXPECT_MSG_EQ_TOL (model->GetLoss (tx, Vector (50.0, 0.0, 1.5)), 22.5, 1e-9, "Buildings not ignored");
+
+  // line of sight only
+  model->SetAttribute ("UseBuildings", BooleanValue (true));
+  model->SetAttribute ("LineOfSightOnly", BooleanValue (true));
+  NS_TEST_EXPECT_MSG_EQ (model->GetLoss (tx, Vector (50.0, 0.0, 1.5)), 20.0, "Blocked path not seen");
+  NS_TEST_EXPECT_MSG_EQ (model->GetLoss (tx, Vector (0.0, 30.0, 1.5)), 0.0, "Clear path blocked");
+
+  // chained with a distance model
+  model->SetAttribute ("LineOfSightOnly", BooleanValue (false));
+  Ptr<FriisPropagationLossModel> friis = CreateObject<FriisPropagationLossModel> ();
+  model->SetNext (friis);
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (tx);
+  b->SetPosition (Vector (30.0, 0.0, 1.5));
+  NS_TEST_EXPECT_MSG_EQ_TOL (model->CalcRxPower (20.0, a, b), friis->CalcRxPower (20.0, a, b) - 13.0, 1e-9,
+                             "Loss not added to the next model");
+  Simulator::Destroy ();
+}
+
+static class ObstaclePropagationLossTestSuite : public TestSuite
+{
+public:
+  ObstaclePropagationLossTestSuite ();
+} g_obstaclePropagationLossTestSuite;
+
+ObstaclePropagationLossTestSuite::ObstaclePropagationLossTestSuite ()
+  : TestSuite ("obstacle-propagation-loss", UNIT)
+{
+  AddTestCase (new ObstaclePropagationLossTest, TestCase::QUICK);
+}
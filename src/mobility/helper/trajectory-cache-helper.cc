@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#include "trajectory-cache-helper.h"
+#include "ns3/trajectory-cache-mobility-model.h"
+#include "ns3/mobility-model.h"
+#include "ns3/node-list.h"
+#include "ns3/simulator.h"
+#include "ns3/callback.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TrajectoryCacheHelper");
+
+TrajectoryCacheHelper::TrajectoryCacheHelper (std::string filename)
+  : m_filename (filename)
+{
+  m_factory.SetTypeId ("ns3::TrajectoryCacheMobilityModel");
+}
+
+void
+TrajectoryCacheHelper::SetModelAttribute (std::string name, const AttributeValue &value)
+{
+  m_factory.Set (name, value);
+}
+
+void
+TrajectoryCacheHelper::Record (NodeContainer c)
+{
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Record (*i);
+    }
+}
+
+void
+TrajectoryCacheHelper::Record (Ptr<Node> node)
+{
+  NS_LOG_FUNCTION (this << node);
+  Ptr<MobilityModel> model = node->GetObject<MobilityModel> ();
+  if (model == 0)
+    {
+      NS_FATAL_ERROR ("Node " << node->GetId () << " has no mobility model to record");
+    }
+  // the map never moves its elements, so that the callback can keep a
+  // pointer to the legs of the node
+  std::vector<TrajectoryCache::Leg> *legs = &m_legs[node->GetId ()];
+  CourseChange (legs, model);
+  model->TraceConnectWithoutContext ("CourseChange", MakeBoundCallback (&TrajectoryCacheHelper::CourseChange, legs));
+}
+
+void
+TrajectoryCacheHelper::CourseChange (std::vector<TrajectoryCache::Leg> *legs, Ptr<const MobilityModel> model)
+{
+  TrajectoryCache::Leg leg = TrajectoryCache::MakeLeg (Simulator::Now (), model->GetPosition (), model->GetVelocity ());
+  // several changes at the same time only leave the last one
+  if (!legs->empty () && legs->back ().start == leg.start)
+    {
+      legs->back () = leg;
+    }
+  else
+    {
+      legs->push_back (leg);
+    }
+}
+
+bool
+TrajectoryCacheHelper::Write (void) const
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<std::vector<TrajectoryCache::Leg> > legs;
+  if (!m_legs.empty ())
+    {
+      legs.resize (m_legs.rbegin ()->first + 1);
+    }
+  for (std::map<uint32_t, std::vector<TrajectoryCache::Leg> >::const_iterator i = m_legs.begin ();
+       i != m_legs.end (); ++i)
+    {
+      legs[i->first] = i->second;
+    }
+  return TrajectoryCache::Write (m_filename, legs);
+}
+
+void
+TrajectoryCacheHelper::Install (NodeContainer c) const
+{
+  Ptr<const TrajectoryCache> cache = Create<TrajectoryCache> (m_filename);
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      if (cache->GetNLegs ((*i)->GetId ()) == 0)
+        {
+          NS_FATAL_ERROR ("No trajectory recorded for node " << (*i)->GetId () << " in " << m_filename);
+        }
+      Install (cache, *i);
+    }
+}
+
+void
+TrajectoryCacheHelper::Install (void) const
+{
+  Ptr<const TrajectoryCache> cache = Create<TrajectoryCache> (m_filename);
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      if (cache->GetNLegs ((*i)->GetId ()) > 0)
+        {
+          Install (cache, *i);
+        }
+    }
+}
+
+void
+TrajectoryCacheHelper::Install (Ptr<const TrajectoryCache> cache, Ptr<Node> node) const
+{
+  NS_LOG_FUNCTION (this << node);
+  Ptr<MobilityModel> existing = node->GetObject<MobilityModel> ();
+  Ptr<TrajectoryCacheMobilityModel> model;
+  if (existing == 0)
+    {
+      model = m_factory.Create<TrajectoryCacheMobilityModel> ();
+      node->AggregateObject (model);
+    }
+  else
+    {
+      model = DynamicCast<TrajectoryCacheMobilityModel> (existing);
+      if (model == 0)
+        {
+          NS_FATAL_ERROR ("Node " << node->GetId () << " already has a mobility model other than "
+                          "ns3::TrajectoryCacheMobilityModel");
+        }
+    }
+  model->SetTrajectory (cache, node->GetId ());
+}
+
+} // namespace ns3
@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#ifndef TRAJECTORY_CACHE_HELPER_H
+#define TRAJECTORY_CACHE_HELPER_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "ns3/attribute.h"
+#include "ns3/object-factory.h"
+#include "ns3/trajectory-cache.h"
+#include "ns3/node-container.h"
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup mobility
+ * \brief Record the trajectories of nodes into a file, and replay them.
+ *
+ * Runs sweeping parameters unrelated to mobility can compute the motion
+ * of the nodes once, and then replay it without any random draw or
+ * obstacle search. The file is binary and mapped in memory by the
+ * replaying runs, unlike the text traces read by Ns2MobilityHelper.
+ *
+ * Recording follows the CourseChange trace of the mobility models, so
+ * it works with any model moving in straight lines between its course
+ * changes, such as the 3D obstacle models. Lazy models only fire
+ * CourseChange when queried, and must be recorded with their "Lazy"
+ * attribute false.
+ * \code
+    TrajectoryCacheHelper cache ("mobility.traj");
+    // first run
+    mobility.Install (nodes);
+    cache.Record (nodes);
+    Simulator::Run ();
+    cache.Write ();
+    // next runs
+    cache.Install (nodes);
+    Simulator::Run ();
+ * \endcode
+ *
+ * The helper must outlive the recorded run, since the recorded legs are
+ * kept in it until Write is called.
+ */
+class TrajectoryCacheHelper
+{
+public:
+  /**
+   * \param filename the file to record to, or to replay from
+   */
+  TrajectoryCacheHelper (std::string filename);
+
+  /**
+   * \param name the name of the attribute to set
+   * \param value the value of the attribute
+   *
+   * Set an attribute of the TrajectoryCacheMobilityModel instances
+   * created by Install.
+   */
+  void SetModelAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * Start recording the trajectory of some nodes, from their current
+   * position. The nodes must have a mobility model.
+   * \param c the nodes to record
+   */
+  void Record (NodeContainer c);
+  /**
+   * Start recording the trajectory of a node, from its current position.
+   * \param node the node to record
+   */
+  void Record (Ptr<Node> node);
+  /**
+   * Write the trajectories recorded so far to the file
+   * \return true if the file was written
+   */
+  bool Write (void) const;
+
+  /**
+   * Replay the trajectories of the file on some nodes, matched by node
+   * id. Every node must have been recorded; the nodes must have no
+   * mobility model yet, or a TrajectoryCacheMobilityModel.
+   * \param c the nodes to move
+   */
+  void Install (NodeContainer c) const;
+  /**
+   * Replay the trajectories of the file on every node of the NodeList
+   * recorded in it.
+   */
+  void Install (void) const;
+
+private:
+  /**
+   * \param legs the legs recorded for a node
+   * \param model the mobility model of the node
+   */
+  static void CourseChange (std::vector<TrajectoryCache::Leg> *legs, Ptr<const MobilityModel> model);
+  /**
+   * \param cache the file to replay
+   * \param node the node to move
+   */
+  void Install (Ptr<const TrajectoryCache> cache, Ptr<Node> node) const;
+
+  std::string m_filename; //!< file to record to, or to replay from
+  ObjectFactory m_factory; //!< factory of the replaying models
+  std::map<uint32_t, std::vector<TrajectoryCache::Leg> > m_legs; //!< recorded legs of each node id
+};
+
+} // namespace ns3
+
+#endif /* TRAJECTORY_CACHE_HELPER_H */
@@ -0,0 +1,318 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#include "navigation-grid.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NavigationGrid");
+
+NS_OBJECT_ENSURE_REGISTERED (NavigationGrid);
+
+TypeId
+NavigationGrid::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::NavigationGrid")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<NavigationGrid> ()
+    .AddAttribute ("Bounds",
+                   "The box covered by the grid, which the paths never leave.",
+                   BoxValue (Box (0.0, 100.0, 0.0, 100.0, 0.0, 100.0)),
+                   MakeBoxAccessor (&NavigationGrid::m_bounds),
+                   MakeBoxChecker ())
+    .AddAttribute ("Resolution",
+                   "The size of a cell (m).",
+                   DoubleValue (5.0),
+                   MakeDoubleAccessor (&NavigationGrid::m_resolution),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("Obstacles",
+                   "The obstacles to plan around, shared with the mobility models.",
+                   PointerValue (),
+                   MakePointerAccessor (&NavigationGrid::m_obstacles),
+                   MakePointerChecker<ObstacleWorld> ());
+  return tid;
+}
+
+NavigationGrid::NavigationGrid ()
+  : m_nBlocked (0),
+    m_nObstacles (~0U),
+    m_search (0),
+    m_start (0),
+    m_goal (0)
+{
+  m_n[0] = m_n[1] = m_n[2] = 0;
+  m_size[0] = m_size[1] = m_size[2] = 0.0;
+}
+
+NavigationGrid::~NavigationGrid ()
+{
+}
+
+void
+NavigationGrid::DoDispose (void)
+{
+  m_obstacles = 0;
+  Object::DoDispose ();
+}
+
+void
+NavigationGrid::Build (void) const
+{
+  uint32_t nObstacles = m_obstacles == 0 ? 0 : m_obstacles->GetNObstacles ();
+  if (m_nObstacles == nObstacles)
+    {
+      return;
+    }
+  NS_ABORT_MSG_IF (m_resolution <= 0.0, "The resolution must be positive");
+  const double min[3] = { m_bounds.xMin, m_bounds.yMin, m_bounds.zMin };
+  const double max[3] = { m_bounds.xMax, m_bounds.yMax, m_bounds.zMax };
+  uint64_t total = 1;
+  for (uint32_t axis = 0; axis < 3; ++axis)
+    {
+      m_n[axis] = std::max (1.0, std::ceil ((max[axis] - min[axis]) / m_resolution));
+      m_size[axis] = (max[axis] - min[axis]) / m_n[axis];
+      total *= m_n[axis];
+    }
+  NS_ABORT_MSG_IF (total > 0x7fffffffULL, "Too many cells, increase the resolution");
+
+  m_blocked.assign (total, 0);
+  m_nBlocked = 0;
+  for (uint32_t cell = 0; cell < total && nObstacles > 0; ++cell)
+    {
+      if (m_obstacles->FindObstacle (GetCenter (cell)) != -1)
+        {
+          m_blocked[cell] = 1;
+          m_nBlocked++;
+        }
+    }
+  if (m_visit.size () != total)
+    {
+      m_visit.assign (total, 0);
+      m_parent.resize (total);
+      m_cost.resize (total);
+      m_closed.resize (total);
+      m_search = 0;
+    }
+  m_nObstacles = nObstacles;
+  NS_LOG_DEBUG (total << " cells, " << m_nBlocked << " blocked");
+}
+
+uint32_t
+NavigationGrid::GetNCells (void) const
+{
+  Build ();
+  return m_blocked.size ();
+}
+
+uint32_t
+NavigationGrid::GetNBlocked (void) const
+{
+  Build ();
+  return m_nBlocked;
+}
+
+uint32_t
+NavigationGrid::GetCell (const Vector &position) const
+{
+  const double p[3] = { position.x - m_bounds.xMin, position.y - m_bounds.yMin, position.z - m_bounds.zMin };
+  uint32_t index[3];
+  for (uint32_t axis = 0; axis < 3; ++axis)
+    {
+      double i = std::floor (p[axis] / m_size[axis]);
+      index[axis] = std::min<double> (std::max (i, 0.0), m_n[axis] - 1);
+    }
+  return (index[2] * m_n[1] + index[1]) * m_n[0] + index[0];
+}
+
+Vector
+NavigationGrid::GetCenter (uint32_t cell) const
+{
+  uint32_t i = cell % m_n[0];
+  uint32_t j = cell / m_n[0] % m_n[1];
+  uint32_t k = cell / m_n[0] / m_n[1];
+  return Vector (m_bounds.xMin + (i + 0.5) * m_size[0],
+                 m_bounds.yMin + (j + 0.5) * m_size[1],
+                 m_bounds.zMin + (k + 0.5) * m_size[2]);
+}
+
+Vector
+NavigationGrid::GetNode (uint32_t cell) const
+{
+  // the ends stand for their cell, which may be blocked by an obstacle
+  // that does not contain them
+  if (cell == m_start)
+    {
+      return m_from;
+    }
+  if (cell == m_goal)
+    {
+      return m_to;
+    }
+  return GetCenter (cell);
+}
+
+bool
+NavigationGrid::IsVisible (const Vector &a, const Vector &b) const
+{
+  return m_obstacles == 0 || !m_obstacles->IsBlocked (a, b);
+}
+
+bool
+NavigationGrid::FindPath (const Vector &from, const Vector &to, std::vector<Vector> &path) const
+{
+  path.clear ();
+  Build ();
+  if (!m_bounds.IsInside (from) || !m_bounds.IsInside (to))
+    {
+      NS_LOG_DEBUG ("End of the path out of the bounds");
+      return false;
+    }
+  if (m_obstacles != 0
+      && (m_obstacles->FindObstacle (from) != -1 || m_obstacles->FindObstacle (to) != -1))
+    {
+      NS_LOG_DEBUG ("End of the path inside an obstacle");
+      return false;
+    }
+  if (IsVisible (from, to))
+    {
+      path.push_back (from);
+      path.push_back (to);
+      return true;
+    }
+
+  if (++m_search == 0)
+    {
+      // the counter wrapped around: the marks of old searches may collide
+      std::fill (m_visit.begin (), m_visit.end (), 0);
+      m_search = 1;
+    }
+  uint32_t start = GetCell (from);
+  uint32_t goal = GetCell (to);
+  if (start == goal)
+    {
+      NS_LOG_DEBUG ("Ends in the same cell, on both sides of an obstacle");
+      return false;
+    }
+  m_start = start;
+  m_goal = goal;
+  m_from = from;
+  m_to = to;
+
+  typedef std::pair<double, uint32_t> Entry;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > open;
+  m_visit[start] = m_search;
+  m_parent[start] = start;
+  m_cost[start] = 0.0;
+  m_closed[start] = 0;
+  open.push (Entry (CalculateDistance (from, to), start));
+
+  while (!open.empty ())
+    {
+      uint32_t cell = open.top ().second;
+      open.pop ();
+      if (m_closed[cell])
+        {
+          continue;
+        }
+      if (cell == goal)
+        {
+          for (uint32_t c = goal; c != start; c = m_parent[c])
+            {
+              path.push_back (GetNode (c));
+            }
+          path.push_back (from);
+          std::reverse (path.begin (), path.end ());
+          NS_LOG_DEBUG ("Path of " << path.size () << " corners, " << m_cost[goal] << " m");
+          return true;
+        }
+      m_closed[cell] = 1;
+
+      Vector position = GetNode (cell);
+      uint32_t parent = m_parent[cell];
+      Vector parentPosition = GetNode (parent);
+      int32_t ci = cell % m_n[0];
+      int32_t cj = cell / m_n[0] % m_n[1];
+      int32_t ck = cell / m_n[0] / m_n[1];
+      for (int32_t dk = -1; dk <= 1; ++dk)
+        {
+          for (int32_t dj = -1; dj <= 1; ++dj)
+            {
+              for (int32_t di = -1; di <= 1; ++di)
+                {
+                  int32_t i = ci + di;
+                  int32_t j = cj + dj;
+                  int32_t k = ck + dk;
+                  if ((di == 0 && dj == 0 && dk == 0)
+                      || i < 0 || j < 0 || k < 0
+                      || i >= static_cast<int32_t> (m_n[0])
+                      || j >= static_cast<int32_t> (m_n[1])
+                      || k >= static_cast<int32_t> (m_n[2]))
+                    {
+                      continue;
+                    }
+                  uint32_t next = (k * m_n[1] + j) * m_n[0] + i;
+                  bool reached = m_visit[next] == m_search;
+                  if ((reached && m_closed[next]) || (m_blocked[next] && next != goal))
+                    {
+                      continue;
+                    }
+                  Vector nextPosition = GetNode (next);
+                  // Theta*: skip the current cell if its parent sees the neighbor
+                  uint32_t via;
+                  double cost;
+                  if (parent != cell && IsVisible (parentPosition, nextPosition))
+                    {
+                      via = parent;
+                      cost = m_cost[parent] + CalculateDistance (parentPosition, nextPosition);
+                    }
+                  else if (IsVisible (position, nextPosition))
+                    {
+                      via = cell;
+                      cost = m_cost[cell] + CalculateDistance (position, nextPosition);
+                    }
+                  else
+                    {
+                      continue;
+                    }
+                  if (!reached || cost < m_cost[next])
+                    {
+                      m_visit[next] = m_search;
+                      m_closed[next] = 0;
+                      m_parent[next] = via;
+                      m_cost[next] = cost;
+                      open.push (Entry (cost + CalculateDistance (nextPosition, to), next));
+                    }
+                }
+            }
+        }
+    }
+  NS_LOG_DEBUG ("No path found");
+  return false;
+}
+
+} // namespace ns3
@@ -18,10 +18,12 @@
  * Author: Dan Broyles <dbroyl01@ku.edu>
  * Modifications made by: Paulo Regis <pregis@nevada.unr.edu>
  */
+#include <algorithm>
 #include <cmath>
 #include "ns3/simulator.h"
 #include "ns3/double.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
 #include "ns3/string.h"
 #include "obstacle-gauss-markov-mobility-model.h"
 #include "position-allocator.h"
@@ -46,6 +48,9 @@ namespace ns3 {
 		.AddAttribute ("NormalVelocity","A gaussian random variable used to calculate the next velocity value.",StringValue ("ns3::NormalRandomVariable[Mean=0.0|Variance=1.0|Bound=10.0]"),MakePointerAccessor (&ObstacleGaussMarkovMobilityModel::m_normalVelocity),MakePointerChecker<NormalRandomVariable> ())
 		.AddAttribute ("NormalDirection","A gaussian random variable used to calculate the next direction value.",StringValue ("ns3::NormalRandomVariable[Mean=0.0|Variance=1.0|Bound=10.0]"),MakePointerAccessor (&ObstacleGaussMarkovMobilityModel::m_normalDirection),MakePointerChecker<NormalRandomVariable> ())
 		.AddAttribute ("NormalPitch","A gaussian random variable used to calculate the next pitch value.",StringValue ("ns3::NormalRandomVariable[Mean=0.0|Variance=1.0|Bound=10.0]"),MakePointerAccessor (&ObstacleGaussMarkovMobilityModel::m_normalPitch),MakePointerChecker<NormalRandomVariable> ())
+		.AddAttribute ("Obstacles","The set of obstacles, shared with the other mobility models.",PointerValue (),MakePointerAccessor (&ObstacleGaussMarkovMobilityModel::m_obstacles),MakePointerChecker<ObstacleWorld> ())
+		.AddAttribute ("Swarm","The swarm moving this node along with others; when set, the motion attributes of this model are ignored, but for the streams of its normal random variables.",PointerValue (),MakePointerAccessor (&ObstacleGaussMarkovMobilityModel::m_swarm),MakePointerChecker<ObstacleGaussMarkovSwarm> ())
+		.AddAttribute ("Lazy","Compute the trajectory only when the position is queried, instead of scheduling an event at every change of course.",BooleanValue (false),MakeBooleanAccessor (&ObstacleGaussMarkovMobilityModel::m_lazy),MakeBooleanChecker ())
 		;
 
     return tid;
@@ -56,9 +61,12 @@ namespace ns3 {
     m_meanVelocity = 0.0;
     m_meanDirection = 0.0;
     m_meanPitch = 0.0;
-    m_event = Simulator::ScheduleNow (&ObstacleGaussMarkovMobilityModel::Start, this);
-    m_helper.Unpause ();
-    m_closestObstacle = -1;
+    m_trajectory.AddLeg (Simulator::Now (), Vector (0.0, 0.0, 0.0), Vector (0.0, 0.0, 0.0));
+    m_next = Simulator::Now ();
+    m_nextAction = ACTION_START;
+    m_event = Simulator::ScheduleNow (&ObstacleGaussMarkovMobilityModel::Update, this);
+    m_joined = false;
+    m_swarmIndex = 0;
   }
 
   void
@@ -66,11 +74,63 @@ namespace ns3 {
   {
 //    double fat = 50;//m_Velocity*m_timeStep.GetSeconds();
 //    m_obstacles.push_back(Box(obstacle.xMin-fat,obstacle.xMax+fat,obstacle.yMin-fat,obstacle.yMax+fat,obstacle.zMin-fat,obstacle.zMax+fat));
-    m_obstacles.push_back(obstacle);
+    if (m_obstacles == 0)
+      {
+	m_obstacles = CreateObject<ObstacleWorld> ();
+      }
+    m_obstacles->AddObstacle (obstacle);
+  }
+
+  void
+  ObstacleGaussMarkovMobilityModel::Update (void)
+  {
+    if (m_swarm != 0)
+      {
+	JoinSwarm ();
+	return;
+      }
+    Advance (Simulator::Now ());
+  }
+
+  void
+  ObstacleGaussMarkovMobilityModel::JoinSwarm (void)
+  {
+    if (!m_joined)
+      {
+	m_swarmIndex = m_swarm->Add (this, m_trajectory.GetPosition (Simulator::Now ()));
+	m_joined = true;
+      }
+  }
+
+  void
+  ObstacleGaussMarkovMobilityModel::Advance (Time now)
+  {
+    if (m_next > now)
+      {
+	return;
+      }
+    while (m_next <= now)
+      {
+	if (m_nextAction == ACTION_START)
+	  {
+	    Start (m_next);
+	  }
+	else
+	  {
+	    Rebound (m_next, m_nextTimeLeft);
+	  }
+      }
+    m_trajectory.DiscardBefore (now);
+    if (!m_lazy)
+      {
+	m_event.Cancel ();
+	m_event = Simulator::Schedule (m_next - now, &ObstacleGaussMarkovMobilityModel::Update, this);
+      }
+    NotifyCourseChange ();
   }
 
   void
-  ObstacleGaussMarkovMobilityModel::Start (void)
+  ObstacleGaussMarkovMobilityModel::Start (Time at)
   {
     if (m_meanVelocity == 0.0)
       {
@@ -78,18 +138,11 @@ namespace ns3 {
 	m_meanVelocity = m_rndMeanVelocity->GetValue ();
 	m_meanDirection = m_rndMeanDirection->GetValue ();
 	m_meanPitch = m_rndMeanPitch->GetValue ();
-	double cosD = std::cos (m_meanDirection);
-	double cosP = std::cos (m_meanPitch);
-	double sinD = std::sin (m_meanDirection);
-	double sinP = std::sin (m_meanPitch);
 	//Initialize the starting velocity, direction, and pitch to be identical to the mean ones
 	m_Velocity = m_meanVelocity;
 	m_Direction = m_meanDirection;
 	m_Pitch = m_meanPitch;
-	//Set the velocity vector to give to the constant velocity helper
-	m_helper.SetVelocity (Vector (m_Velocity*cosD*cosP, m_Velocity*sinD*cosP, m_Velocity*sinP));
       }
-    m_helper.Update ();
 
     //Get the next values from the gaussian distributions for velocity, direction, and pitch
     double rv = m_normalVelocity->GetValue ();
@@ -105,7 +158,7 @@ namespace ns3 {
     m_Direction = m_alpha * m_Direction + one_minus_alpha * m_meanDirection + sqrt_alpha * rd;
     m_Pitch     = m_alpha * m_Pitch     + one_minus_alpha * m_meanPitch     + sqrt_alpha * rp;
 
-    //Calculate the linear velocity vector to give to the constant velocity helper
+    //Calculate the linear velocity vector of the next leg
     double cosDir = std::cos (m_Direction);
     double cosPit = std::cos (m_Pitch);
     double sinDir = std::sin (m_Direction);
@@ -113,110 +166,82 @@ namespace ns3 {
     double vx = m_Velocity * cosDir * cosPit;
     double vy = m_Velocity * sinDir * cosPit;
     double vz = m_Velocity * sinPit;
-    m_helper.SetVelocity (Vector (vx, vy, vz));
 
-    m_helper.Unpause ();
-
-    DoWalk (m_timeStep);
+    DoWalk (at, Vector (vx, vy, vz), m_timeStep);
   }
 
   void
-  ObstacleGaussMarkovMobilityModel::DoWalk (Time delayLeft)
+  ObstacleGaussMarkovMobilityModel::DoWalk (Time at, const Vector &speed, Time delayLeft)
   {
-    m_helper.UpdateWithBounds (m_bounds);
-    Vector position = m_helper.GetCurrentPosition ();
-    Vector speed = m_helper.GetVelocity ();
-
-    double speedM = std::sqrt(speed.x*speed.x + speed.y*speed.y + speed.z*speed.z);
-
-    Vector nextPosition = position;
-    nextPosition.x += speed.x * delayLeft.GetSeconds ();
-    nextPosition.y += speed.y * delayLeft.GetSeconds ();
-    nextPosition.z += speed.z * delayLeft.GetSeconds ();
-    if (delayLeft.GetSeconds () < 0.0) delayLeft = Seconds (1.0);
-
-    if (m_bounds.IsInside (nextPosition))
-      {
-        double distance = CalculateDistance (position, nextPosition);
-        m_closestObstacle = -1;
-        int obstacle_id = 0;
-        for (std::vector<Box>::iterator it = m_obstacles.begin() ; it != m_obstacles.end(); ++it)
-  	{
-  	  Vector collision;
-  	  if (it->WillCollide(position,speed,collision) && CalculateDistance(position,collision) < distance)
-  	    {
-  	      distance = CalculateDistance(position,collision);
-  	      m_closestObstacle = obstacle_id;
-  	    }
-  	  obstacle_id++;
-  	}
-        Time delay_tmp = Seconds(distance/speedM);
-        m_event = Simulator::Schedule (delay_tmp, &ObstacleGaussMarkovMobilityModel::Start, this);
+    Vector position = m_trajectory.GetPosition (at, m_bounds);
+    m_trajectory.AddLeg (at, position, speed);
+
+    WalkEvent event = CalculateWalkEvent (m_bounds, PeekPointer (m_obstacles), position, speed, delayLeft.GetSeconds ());
+    if (event.type == WalkEvent::TIMEOUT)
+      {
+        m_next = at + delayLeft;
+        m_nextAction = ACTION_START;
       }
     else
       {
-        nextPosition = m_bounds.CalculateIntersection (position, speed);
-        double distance = CalculateDistance (position, nextPosition);
-        m_closestObstacle = -1;
-        int obstacle_id = 0;
-        for (std::vector<Box>::iterator it = m_obstacles.begin() ; it != m_obstacles.end(); ++it)
-  	{
-  	  Vector collision;
-  	  if (it->WillCollide(position,speed,collision) && CalculateDistance(position,collision) < distance)
-  	    {
-  	      distance = CalculateDistance(position,collision);
-  	      m_closestObstacle = obstacle_id;
-  	    }
-  	  obstacle_id++;
-  	}
-        Time delay_tmp = Seconds(distance/speedM);
-
-        m_event = Simulator::Schedule (delay_tmp, &ObstacleGaussMarkovMobilityModel::Rebound, this,
-  				     delayLeft - delay_tmp);
+        // rebound on the obstacles as on the bounds: drawing a new
+        // course at the surface of an obstacle would mostly lead back
+        // into it, given the memory of the Gauss-Markov process
+        Time delay = std::min (Seconds (event.delay), delayLeft);
+        m_next = at + delay;
+        m_nextAction = ACTION_REBOUND;
+        m_nextTimeLeft = delayLeft - delay;
+        m_nextVelocity = event.velocity;
+        m_nextNormal = event.normal;
       }
-    NotifyCourseChange ();
   }
 
   void
-  ObstacleGaussMarkovMobilityModel::Rebound (Time delayLeft)
+  ObstacleGaussMarkovMobilityModel::Rebound (Time at, Time delayLeft)
   {
-    m_helper.UpdateWithBounds (m_bounds);
-    Vector position = m_helper.GetCurrentPosition ();
-    Vector speed = m_helper.GetVelocity ();
-    Box bx;
-    if (m_closestObstacle == -1){
-	bx = m_bounds;
-    }
-    else
+    Vector speed = m_trajectory.GetVelocity (at);
+    if ((m_nextNormal.x != 0.0) + (m_nextNormal.y != 0.0) + (m_nextNormal.z != 0.0) > 1)
       {
-	bx = m_obstacles[m_closestObstacle];
+	ReflectMeans (m_meanDirection, m_meanPitch, m_nextNormal);
+	DoWalk (at, m_nextVelocity, delayLeft);
+	return;
       }
-    switch (bx.GetClosestSide (position))
-    {
-      case Box::RIGHT:
-      case Box::LEFT:
-	speed.x = -speed.x;
+    // turn the means along with the velocity, on every side reached
+    if (m_nextVelocity.x != speed.x)
+      {
 	m_meanDirection = M_PI - m_meanDirection;
-	break;
-      case Box::TOP:
-      case Box::BOTTOM:
-	speed.y = -speed.y;
+      }
+    if (m_nextVelocity.y != speed.y)
+      {
 	m_meanDirection = -m_meanDirection;
-	break;
-      case Box::UP:
-      case Box::DOWN:
-	speed.z = -speed.z;
+      }
+    if (m_nextVelocity.z != speed.z)
+      {
 	m_meanPitch = -m_meanPitch;
-	break;
-    }
-    m_helper.SetVelocity (speed);
-    m_helper.Unpause ();
-    DoWalk (delayLeft);
+      }
+    DoWalk (at, m_nextVelocity, delayLeft);
+  }
+
+  void
+  ObstacleGaussMarkovMobilityModel::ReflectMeans (double &direction, double &pitch, const Vector &normal)
+  {
+    double cosPit = std::cos (pitch);
+    Vector mean (std::cos (direction) * cosPit, std::sin (direction) * cosPit, std::sin (pitch));
+    double dot = 2.0 * (mean.x * normal.x + mean.y * normal.y + mean.z * normal.z);
+    mean = Vector (mean.x - dot * normal.x, mean.y - dot * normal.y, mean.z - dot * normal.z);
+    direction = std::atan2 (mean.y, mean.x);
+    pitch = std::asin (std::max (-1.0, std::min (1.0, mean.z)));
   }
 
   void
   ObstacleGaussMarkovMobilityModel::DoDispose (void)
   {
+    if (m_joined)
+      {
+	m_swarm->Remove (m_swarmIndex);
+      }
+    m_swarm = 0;
+    m_obstacles = 0;
     // chain up
     MobilityModel::DoDispose ();
   }
@@ -224,20 +249,53 @@ namespace ns3 {
   Vector
   ObstacleGaussMarkovMobilityModel::DoGetPosition (void) const
   {
-    m_helper.Update ();
-    return m_helper.GetCurrentPosition ();
+    if (m_swarm != 0)
+      {
+	const_cast<ObstacleGaussMarkovMobilityModel *> (this)->JoinSwarm ();
+	return m_swarm->GetPosition (m_swarmIndex);
+      }
+    Time now = Simulator::Now ();
+    // catching up with the current time only extends the trajectory
+    const_cast<ObstacleGaussMarkovMobilityModel *> (this)->Advance (now);
+    return m_trajectory.GetPosition (now, m_bounds);
   }
   void
   ObstacleGaussMarkovMobilityModel::DoSetPosition (const Vector &position)
   {
-    m_helper.SetPosition (position);
+    if (m_swarm != 0)
+      {
+	if (m_joined)
+	  {
+	    m_swarm->SetPosition (m_swarmIndex, position);
+	  }
+	else
+	  {
+	    m_swarmIndex = m_swarm->Add (this, position);
+	    m_joined = true;
+	  }
+	return;
+      }
+    m_trajectory.Clear ();
+    m_trajectory.AddLeg (Simulator::Now (), position, Vector (0.0, 0.0, 0.0));
+    m_next = Simulator::Now ();
+    m_nextAction = ACTION_START;
     Simulator::Remove (m_event);
-    m_event = Simulator::ScheduleNow (&ObstacleGaussMarkovMobilityModel::Start, this);
+    if (!m_lazy)
+      {
+	m_event = Simulator::ScheduleNow (&ObstacleGaussMarkovMobilityModel::Update, this);
+      }
   }
   Vector
   ObstacleGaussMarkovMobilityModel::DoGetVelocity (void) const
   {
-    return m_helper.GetVelocity ();
+    if (m_swarm != 0)
+      {
+	const_cast<ObstacleGaussMarkovMobilityModel *> (this)->JoinSwarm ();
+	return m_swarm->GetVelocity (m_swarmIndex);
+      }
+    Time now = Simulator::Now ();
+    const_cast<ObstacleGaussMarkovMobilityModel *> (this)->Advance (now);
+    return m_trajectory.GetVelocity (now);
   }
 
   int64_t
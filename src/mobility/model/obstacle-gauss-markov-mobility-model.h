@@ -24,7 +24,7 @@
 #ifndef OBS_GAUSS_MARKOV_MOBILITY_MODEL_H
 #define OBS_GAUSS_MARKOV_MOBILITY_MODEL_H
 
-#include "constant-velocity-helper.h"
+#include "piecewise-linear-trajectory.h"
 #include "mobility-model.h"
 #include "position-allocator.h"
 #include "ns3/ptr.h"
@@ -32,6 +32,8 @@
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
 #include "ns3/box.h"
+#include "ns3/obstacle-world.h"
+#include "ns3/obstacle-gauss-markov-swarm.h"
 #include "ns3/random-variable-stream.h"
 
 namespace ns3 {
@@ -78,6 +80,16 @@ namespace ns3 {
  * [1] Tracy Camp, Jeff Boleng, Vanessa Davies, "A Survey of Mobility Models
  * for Ad Hoc Network Research", Wireless Communications and Mobile Computing,
  * Wiley, vol.2 iss.5, September 2002, pp.483-502
+ *
+ * As in RandomWalk3dMobilityModel, the "Lazy" attribute makes the
+ * trajectory be computed only when a query goes past its known part,
+ * instead of scheduling an event at every TimeStep and collision.
+ *
+ * For large numbers of nodes, the models can instead be attached to an
+ * ObstacleGaussMarkovSwarm through the "Swarm" attribute, which then
+ * moves all of them with one event per TimeStep; the model only answers
+ * the position queries, fires CourseChange for its node and lends the
+ * streams of its normal random variables to the draws of its node.
  */
 class ObstacleGaussMarkovMobilityModel : public MobilityModel
 {
@@ -91,32 +103,70 @@ public:
   /**
    * \param obstacle an obstacle to be added
    *
+   * The obstacle is added to the ObstacleWorld set through the
+   * "Obstacles" attribute, which is shared by every model using it.
+   * If no world was set, a private one is created for this model.
    * The box must be inside the boundaries,
    * this method does not verify it.
    * This method assumes the box has dimensions > 0
    */
   void AddObstacle(const Box &obstacle);
 private:
+  friend class ObstacleGaussMarkovSwarm;
+  /** The change of course pending at the end of the known trajectory */
+  enum Action {
+    ACTION_START,
+    ACTION_REBOUND
+  };
+  /**
+   * Event handler, compute the trajectory up to the current time
+   */
+  void Update (void);
+  /**
+   * Apply every change of course due up to the given time, and notify
+   * the course change if there was one.
+   * \param now the current time
+   */
+  void Advance (Time now);
   /**
    * Initialize the model and calculate new velocity, direction, and pitch
+   * \param at the time of the change of course
    */
-  void Start (void);
+  void Start (Time at);
   /**
    * Perform a walk operation
+   * \param at the time the walk starts
+   * \param velocity the velocity of the walk
    * \param timeLeft time until Start method is called again
    */
-  void DoWalk (Time timeLeft);
+  void DoWalk (Time at, const Vector &velocity, Time timeLeft);
   /**
-   * \brief Performs the rebound of the node if it reaches a boundary
+   * \brief Performs the rebound of the node if it reaches a boundary or an obstacle
+   * \param at the time of the rebound
    * \param timeLeft The remaining time of the walk
    */
-  void Rebound (Time timeLeft);
+  void Rebound (Time at, Time timeLeft);
+  /**
+   * Reflect the mean course on an oblique face of an obstacle shape
+   * \param direction the mean direction to reflect
+   * \param pitch the mean pitch to reflect
+   * \param normal the unit normal of the face
+   */
+  static void ReflectMeans (double &direction, double &pitch, const Vector &normal);
+  /**
+   * Add this node to the swarm, if not done yet
+   */
+  void JoinSwarm (void);
   virtual void DoDispose (void);
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
   virtual int64_t DoAssignStreams (int64_t);
-  ConstantVelocityHelper m_helper; //!< constant velocity helper
+  PiecewiseLinearTrajectory m_trajectory; //!< known part of the trajectory
+  bool m_lazy; //!< whether the trajectory is computed only when queried
+  Time m_next; //!< time of the next change of course
+  enum Action m_nextAction; //!< next change of course
+  Time m_nextTimeLeft; //!< remaining time of the walk after the next rebound
   Time m_timeStep; //!< duraiton after which direction and speed should change
   double m_alpha; //!< tunable constant in the model
   double m_meanVelocity; //!< current mean velocity
@@ -134,8 +184,12 @@ private:
   EventId m_event; //!< event id of scheduled start
   Box m_bounds; //!< bounding box
 
-  mutable std::vector<Box> m_obstacles; // list of obstacles
-  int m_closestObstacle; // if collision is detected, this wil be set as the id of the obstacle in the array
+  Ptr<ObstacleWorld> m_obstacles; //!< obstacles shared with the other models
+  Vector m_nextVelocity; //!< velocity after the next rebound
+  Vector m_nextNormal; //!< normal of the face of the next rebound
+  Ptr<ObstacleGaussMarkovSwarm> m_swarm; //!< swarm moving this node, if any
+  bool m_joined; //!< whether this node was added to the swarm
+  uint32_t m_swarmIndex; //!< index of this node in the swarm
 };
 
 } // namespace ns3
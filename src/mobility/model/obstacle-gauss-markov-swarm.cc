@@ -0,0 +1,695 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#include "obstacle-gauss-markov-swarm.h"
+#include "obstacle-gauss-markov-mobility-model.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/log.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ObstacleGaussMarkovSwarm");
+
+NS_OBJECT_ENSURE_REGISTERED (ObstacleGaussMarkovSwarm);
+
+#ifdef HAVE_PTHREAD_H
+/**
+ * The threads updating the nodes along with the simulation thread:
+ * started at the first step run on several threads, they wait for each
+ * batch until the swarm is disposed of.
+ */
+class ObstacleGaussMarkovSwarm::WorkerPool
+{
+public:
+  /**
+   * Start the threads
+   *
+   * \param swarm the swarm of the nodes
+   * \param threads the number of threads, including the simulation thread
+   */
+  WorkerPool (ObstacleGaussMarkovSwarm *swarm, uint32_t threads);
+  /**
+   * Stop and join the threads
+   */
+  ~WorkerPool ();
+  /**
+   * \return the number of threads, including the simulation thread
+   */
+  uint32_t GetNThreads (void) const;
+  /**
+   * Update the n first entries of m_batch, split among the threads, and
+   * return once they are all updated
+   *
+   * \param n the number of entries to update
+   */
+  void Run (uint32_t n);
+
+private:
+  /** A thread of the pool */
+  struct Worker
+  {
+    WorkerPool *pool; //!< pool of the thread
+    uint32_t index; //!< index of the thread, from 1
+
+    /**
+     * Update the range of each batch of the thread
+     */
+    void Run (void)
+    {
+      pool->Loop (index);
+    }
+  };
+
+  /**
+   * Wait for the batches and update a range of each
+   *
+   * \param t the index of the thread
+   */
+  void Loop (uint32_t t);
+  /**
+   * \param t the index of a thread
+   * \param n the number of entries to update
+   * \return the first entry of m_batch the thread updates
+   */
+  uint32_t GetBegin (uint32_t t, uint32_t n) const;
+
+  ObstacleGaussMarkovSwarm *m_swarm; //!< swarm of the nodes
+  uint32_t m_threads; //!< number of threads, including the simulation thread
+  std::vector<Worker> m_workers; //!< the threads, but the simulation thread
+  std::vector<Ptr<SystemThread> > m_running; //!< the threads started
+  pthread_mutex_t m_mutex; //!< protects the fields below
+  pthread_cond_t m_start; //!< signaled at each new batch, and to stop
+  pthread_cond_t m_done; //!< signaled once the threads updated their range
+  uint64_t m_generation; //!< number of batches started
+  uint32_t m_n; //!< number of entries of the current batch
+  uint32_t m_busy; //!< threads still updating their range
+  bool m_stop; //!< whether the threads must return
+};
+
+ObstacleGaussMarkovSwarm::WorkerPool::WorkerPool (ObstacleGaussMarkovSwarm *swarm, uint32_t threads)
+  : m_swarm (swarm),
+    m_threads (threads),
+    m_workers (threads - 1),
+    m_generation (0),
+    m_n (0),
+    m_busy (0),
+    m_stop (false)
+{
+  pthread_mutex_init (&m_mutex, 0);
+  pthread_cond_init (&m_start, 0);
+  pthread_cond_init (&m_done, 0);
+  for (uint32_t t = 1; t < threads; ++t)
+    {
+      Worker &worker = m_workers[t - 1];
+      worker.pool = this;
+      worker.index = t;
+      Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&Worker::Run, &worker));
+      thread->Start ();
+      m_running.push_back (thread);
+    }
+}
+
+ObstacleGaussMarkovSwarm::WorkerPool::~WorkerPool ()
+{
+  pthread_mutex_lock (&m_mutex);
+  m_stop = true;
+  pthread_cond_broadcast (&m_start);
+  pthread_mutex_unlock (&m_mutex);
+  for (std::vector<Ptr<SystemThread> >::iterator t = m_running.begin (); t != m_running.end (); ++t)
+    {
+      (*t)->Join ();
+    }
+  pthread_cond_destroy (&m_done);
+  pthread_cond_destroy (&m_start);
+  pthread_mutex_destroy (&m_mutex);
+}
+
+uint32_t
+ObstacleGaussMarkovSwarm::WorkerPool::GetNThreads (void) const
+{
+  return m_threads;
+}
+
+uint32_t
+ObstacleGaussMarkovSwarm::WorkerPool::GetBegin (uint32_t t, uint32_t n) const
+{
+  return static_cast<uint64_t> (n) * t / m_threads;
+}
+
+void
+ObstacleGaussMarkovSwarm::WorkerPool::Run (uint32_t n)
+{
+  pthread_mutex_lock (&m_mutex);
+  m_n = n;
+  m_busy = m_threads - 1;
+  m_generation++;
+  pthread_cond_broadcast (&m_start);
+  pthread_mutex_unlock (&m_mutex);
+
+  // the simulation thread takes the first range
+  m_swarm->UpdateNodes (0, GetBegin (1, n));
+
+  pthread_mutex_lock (&m_mutex);
+  while (m_busy > 0)
+    {
+      pthread_cond_wait (&m_done, &m_mutex);
+    }
+  pthread_mutex_unlock (&m_mutex);
+}
+
+void
+ObstacleGaussMarkovSwarm::WorkerPool::Loop (uint32_t t)
+{
+  uint64_t generation = 0;
+  pthread_mutex_lock (&m_mutex);
+  while (true)
+    {
+      while (!m_stop && m_generation == generation)
+        {
+          pthread_cond_wait (&m_start, &m_mutex);
+        }
+      if (m_stop)
+        {
+          break;
+        }
+      generation = m_generation;
+      uint32_t n = m_n;
+      pthread_mutex_unlock (&m_mutex);
+
+      m_swarm->UpdateNodes (GetBegin (t, n), GetBegin (t + 1, n));
+
+      pthread_mutex_lock (&m_mutex);
+      if (--m_busy == 0)
+        {
+          pthread_cond_signal (&m_done);
+        }
+    }
+  pthread_mutex_unlock (&m_mutex);
+}
+#endif /* HAVE_PTHREAD_H */
+
+TypeId
+ObstacleGaussMarkovSwarm::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ObstacleGaussMarkovSwarm")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<ObstacleGaussMarkovSwarm> ()
+    .AddAttribute ("Bounds",
+                   "Bounds of the area to cruise.",
+                   BoxValue (Box (-100.0, 100.0, -100.0, 100.0, 0.0, 100.0)),
+                   MakeBoxAccessor (&ObstacleGaussMarkovSwarm::m_bounds),
+                   MakeBoxChecker ())
+    .AddAttribute ("TimeStep",
+                   "Change current direction and speed of every node at each multiple of this time.",
+                   TimeValue (Seconds (1.0)),
+                   MakeTimeAccessor (&ObstacleGaussMarkovSwarm::m_timeStep),
+                   MakeTimeChecker (TimeStep (1)))
+    .AddAttribute ("Alpha",
+                   "A constant representing the tunable parameter in the Gauss-Markov model.",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&ObstacleGaussMarkovSwarm::m_alpha),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MeanVelocity",
+                   "A random variable used to assign the average velocity.",
+                   StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=1.0]"),
+                   MakePointerAccessor (&ObstacleGaussMarkovSwarm::m_rndMeanVelocity),
+                   MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("MeanDirection",
+                   "A random variable used to assign the average direction.",
+                   StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=6.283185307]"),
+                   MakePointerAccessor (&ObstacleGaussMarkovSwarm::m_rndMeanDirection),
+                   MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("MeanPitch",
+                   "A random variable used to assign the average pitch.",
+                   StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"),
+                   MakePointerAccessor (&ObstacleGaussMarkovSwarm::m_rndMeanPitch),
+                   MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("NormalVelocity",
+                   "The gaussian distribution of the next velocity value. Only its "
+                   "mean, variance and bound are used.",
+                   StringValue ("ns3::NormalRandomVariable[Mean=0.0|Variance=1.0|Bound=10.0]"),
+                   MakePointerAccessor (&ObstacleGaussMarkovSwarm::m_normalVelocity),
+                   MakePointerChecker<NormalRandomVariable> ())
+    .AddAttribute ("NormalDirection",
+                   "The gaussian distribution of the next direction value. Only its "
+                   "mean, variance and bound are used.",
+                   StringValue ("ns3::NormalRandomVariable[Mean=0.0|Variance=1.0|Bound=10.0]"),
+                   MakePointerAccessor (&ObstacleGaussMarkovSwarm::m_normalDirection),
+                   MakePointerChecker<NormalRandomVariable> ())
+    .AddAttribute ("NormalPitch",
+                   "The gaussian distribution of the next pitch value. Only its "
+                   "mean, variance and bound are used.",
+                   StringValue ("ns3::NormalRandomVariable[Mean=0.0|Variance=1.0|Bound=10.0]"),
+                   MakePointerAccessor (&ObstacleGaussMarkovSwarm::m_normalPitch),
+                   MakePointerChecker<NormalRandomVariable> ())
+    .AddAttribute ("Obstacles",
+                   "The set of obstacles, shared with the other mobility models.",
+                   PointerValue (),
+                   MakePointerAccessor (&ObstacleGaussMarkovSwarm::m_obstacles),
+                   MakePointerChecker<ObstacleWorld> ())
+    .AddAttribute ("Threads",
+                   "The number of threads updating the nodes at each tick. With 1, they are "
+                   "updated in the simulation thread. Ignored without threading support.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&ObstacleGaussMarkovSwarm::m_threads),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+ObstacleGaussMarkovSwarm::ObstacleGaussMarkovSwarm ()
+  : m_batchStep (0.0),
+    m_pool (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ObstacleGaussMarkovSwarm::~ObstacleGaussMarkovSwarm ()
+{
+  NS_LOG_FUNCTION (this);
+  StopThreads ();
+}
+
+void
+ObstacleGaussMarkovSwarm::StopThreads (void)
+{
+#ifdef HAVE_PTHREAD_H
+  delete m_pool;
+  m_pool = 0;
+#endif /* HAVE_PTHREAD_H */
+}
+
+void
+ObstacleGaussMarkovSwarm::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_tick.Cancel ();
+  StopThreads ();
+  for (std::vector<EventId>::iterator i = m_events.begin (); i != m_events.end (); ++i)
+    {
+      i->Cancel ();
+    }
+  m_events.clear ();
+  m_models.clear ();
+  m_pending.clear ();
+  m_obstacles = 0;
+  Object::DoDispose ();
+}
+
+uint32_t
+ObstacleGaussMarkovSwarm::Add (ObstacleGaussMarkovMobilityModel *model, const Vector &position)
+{
+  NS_LOG_FUNCTION (this << model << position);
+  uint32_t i = m_models.size ();
+  Time now = Simulator::Now ();
+  m_models.push_back (model);
+  m_pending.push_back (PENDING_EVENT);
+  m_events.push_back (Simulator::ScheduleNow (&ObstacleGaussMarkovSwarm::Start, this, i));
+  m_stepEnd.push_back (now);
+  m_legStart.push_back (now);
+  m_x.push_back (position.x);
+  m_y.push_back (position.y);
+  m_z.push_back (position.z);
+  m_vx.push_back (0.0);
+  m_vy.push_back (0.0);
+  m_vz.push_back (0.0);
+  m_velocity.push_back (0.0);
+  m_direction.push_back (0.0);
+  m_pitch.push_back (0.0);
+  m_meanVelocity.push_back (0.0);
+  m_meanDirection.push_back (0.0);
+  m_meanPitch.push_back (0.0);
+  m_closestObstacle.push_back (-1);
+  m_closestSide.push_back (Box::RIGHT);
+  m_closestNormal.push_back (Vector (0.0, 0.0, 0.0));
+  if (!m_tick.IsRunning ())
+    {
+      m_tick = Simulator::Schedule (GetNextTick (now) - now, &ObstacleGaussMarkovSwarm::Tick, this);
+    }
+  return i;
+}
+
+void
+ObstacleGaussMarkovSwarm::Remove (uint32_t i)
+{
+  NS_LOG_FUNCTION (this << i);
+  if (i < m_models.size ())
+    {
+      m_events[i].Cancel ();
+      m_pending[i] = PENDING_NONE;
+      m_models[i] = 0;
+    }
+}
+
+uint32_t
+ObstacleGaussMarkovSwarm::GetNNodes (void) const
+{
+  return m_models.size ();
+}
+
+void
+ObstacleGaussMarkovSwarm::SetPosition (uint32_t i, const Vector &position)
+{
+  NS_LOG_FUNCTION (this << i << position);
+  NS_ASSERT (i < m_models.size ());
+  m_legStart[i] = Simulator::Now ();
+  m_x[i] = position.x;
+  m_y[i] = position.y;
+  m_z[i] = position.z;
+  m_vx[i] = 0.0;
+  m_vy[i] = 0.0;
+  m_vz[i] = 0.0;
+  m_events[i].Cancel ();
+  m_pending[i] = PENDING_EVENT;
+  m_events[i] = Simulator::ScheduleNow (&ObstacleGaussMarkovSwarm::Start, this, i);
+}
+
+Vector
+ObstacleGaussMarkovSwarm::GetPosition (uint32_t i) const
+{
+  return GetPosition (i, Simulator::Now ());
+}
+
+Vector
+ObstacleGaussMarkovSwarm::GetPosition (uint32_t i, Time t) const
+{
+  NS_ASSERT (i < m_models.size ());
+  double deltaS = (t - m_legStart[i]).GetSeconds ();
+  return Vector (std::max (m_bounds.xMin, std::min (m_bounds.xMax, m_x[i] + m_vx[i] * deltaS)),
+                 std::max (m_bounds.yMin, std::min (m_bounds.yMax, m_y[i] + m_vy[i] * deltaS)),
+                 std::max (m_bounds.zMin, std::min (m_bounds.zMax, m_z[i] + m_vz[i] * deltaS)));
+}
+
+Vector
+ObstacleGaussMarkovSwarm::GetVelocity (uint32_t i) const
+{
+  NS_ASSERT (i < m_models.size ());
+  return Vector (m_vx[i], m_vy[i], m_vz[i]);
+}
+
+int64_t
+ObstacleGaussMarkovSwarm::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_rndMeanVelocity->SetStream (stream);
+  m_rndMeanDirection->SetStream (stream + 1);
+  m_rndMeanPitch->SetStream (stream + 2);
+  return 3;
+}
+
+Time
+ObstacleGaussMarkovSwarm::GetNextTick (Time t) const
+{
+  int64_t step = m_timeStep.GetTimeStep ();
+  return TimeStep ((t.GetTimeStep () / step + 1) * step);
+}
+
+void
+ObstacleGaussMarkovSwarm::Tick (void)
+{
+  NS_LOG_FUNCTION (this);
+  Time now = Simulator::Now ();
+  m_batch.clear ();
+  for (uint32_t i = 0; i < m_models.size (); ++i)
+    {
+      if (m_pending[i] == PENDING_TICK && m_stepEnd[i] <= now)
+        {
+          m_batch.push_back (i);
+        }
+    }
+  Step ();
+  m_tick = Simulator::Schedule (GetNextTick (now) - now, &ObstacleGaussMarkovSwarm::Tick, this);
+}
+
+void
+ObstacleGaussMarkovSwarm::Start (uint32_t i)
+{
+  NS_LOG_FUNCTION (this << i);
+  m_batch.assign (1, i);
+  Step ();
+}
+
+void
+ObstacleGaussMarkovSwarm::Rebound (uint32_t i)
+{
+  NS_LOG_FUNCTION (this << i);
+  Time now = Simulator::Now ();
+  Vector position = GetPosition (i, now);
+  const Vector &normal = m_closestNormal[i];
+  if ((normal.x != 0.0) + (normal.y != 0.0) + (normal.z != 0.0) > 1)
+    {
+      // oblique face of an obstacle shape
+      double dot = 2.0 * (m_vx[i] * normal.x + m_vy[i] * normal.y + m_vz[i] * normal.z);
+      m_vx[i] -= dot * normal.x;
+      m_vy[i] -= dot * normal.y;
+      m_vz[i] -= dot * normal.z;
+      ObstacleGaussMarkovMobilityModel::ReflectMeans (m_meanDirection[i], m_meanPitch[i], normal);
+    }
+  else
+    {
+      // at a corner of the bounds, the other sides are rebounded on by
+      // the walk computed next, with no delay
+      switch (static_cast<Box::Side> (m_closestSide[i]))
+        {
+        case Box::RIGHT:
+        case Box::LEFT:
+          m_vx[i] = -m_vx[i];
+          m_meanDirection[i] = M_PI - m_meanDirection[i];
+          break;
+        case Box::TOP:
+        case Box::BOTTOM:
+          m_vy[i] = -m_vy[i];
+          m_meanDirection[i] = -m_meanDirection[i];
+          break;
+        case Box::UP:
+        case Box::DOWN:
+          m_vz[i] = -m_vz[i];
+          m_meanPitch[i] = -m_meanPitch[i];
+          break;
+        }
+    }
+  m_x[i] = position.x;
+  m_y[i] = position.y;
+  m_z[i] = position.z;
+  m_legStart[i] = now;
+  if (m_stepEnd[i] <= now)
+    {
+      // the rebound ends the step; keep the reflected velocity for a
+      // step rather than drawing one that may lead out again
+      m_stepEnd[i] = GetNextTick (now);
+    }
+  ScheduleWalk (i, ComputeWalk (i, (m_stepEnd[i] - now).GetSeconds ()));
+  m_models[i]->NotifyCourseChange ();
+}
+
+void
+ObstacleGaussMarkovSwarm::Step (void)
+{
+  uint32_t n = m_batch.size ();
+  if (n == 0)
+    {
+      return;
+    }
+
+  // move the legs of the stepping nodes to the current time before
+  // their velocity changes; everything touching the simulator or a
+  // shared random stream is done here, in the simulation thread
+  Time now = Simulator::Now ();
+  Time stepEnd = GetNextTick (now);
+  for (std::vector<uint32_t>::const_iterator k = m_batch.begin (); k != m_batch.end (); ++k)
+    {
+      Vector position = GetPosition (*k, now);
+      m_x[*k] = position.x;
+      m_y[*k] = position.y;
+      m_z[*k] = position.z;
+      m_legStart[*k] = now;
+      m_stepEnd[*k] = stepEnd;
+      InitializeMeans (*k);
+    }
+  m_batchStep = (stepEnd - now).GetSeconds ();
+  m_batchDelay.resize (n);
+  m_batchVelocity.resize (n);
+  m_batchDirection.resize (n);
+  m_batchPitch.resize (n);
+  m_batchVx.resize (n);
+  m_batchVy.resize (n);
+  m_batchVz.resize (n);
+
+  uint32_t threads = std::min (m_threads, n);
+#ifdef HAVE_PTHREAD_H
+  if (threads > 1)
+    {
+      if (m_obstacles != 0)
+        {
+          m_obstacles->BuildIndex ();
+        }
+      // the threads are started once, and kept for the next steps
+      if (m_pool == 0 || m_pool->GetNThreads () != m_threads)
+        {
+          StopThreads ();
+          m_pool = new WorkerPool (this, m_threads);
+        }
+      m_pool->Run (n);
+    }
+  else
+#endif /* HAVE_PTHREAD_H */
+    {
+      UpdateNodes (0, n);
+    }
+
+  for (uint32_t k = 0; k < n; ++k)
+    {
+      ScheduleWalk (m_batch[k], m_batchDelay[k]);
+    }
+  for (uint32_t k = 0; k < n; ++k)
+    {
+      m_models[m_batch[k]]->NotifyCourseChange ();
+    }
+}
+
+void
+ObstacleGaussMarkovSwarm::InitializeMeans (uint32_t i)
+{
+  if (m_meanVelocity[i] == 0.0)
+    {
+      //Initialize the mean velocity, direction, and pitch variables
+      m_meanVelocity[i] = m_rndMeanVelocity->GetValue ();
+      m_meanDirection[i] = m_rndMeanDirection->GetValue ();
+      m_meanPitch[i] = m_rndMeanPitch->GetValue ();
+      //Initialize the starting velocity, direction, and pitch to be identical to the mean ones
+      m_velocity[i] = m_meanVelocity[i];
+      m_direction[i] = m_meanDirection[i];
+      m_pitch[i] = m_meanPitch[i];
+    }
+}
+
+void
+ObstacleGaussMarkovSwarm::UpdateNodes (uint32_t begin, uint32_t end)
+{
+  if (begin == end)
+    {
+      return;
+    }
+  uint32_t n = end - begin;
+  const uint32_t *nodes = &m_batch[begin];
+
+  //Get the next values from the gaussian distributions for velocity, direction, and pitch,
+  //each node drawing from the streams of its own model
+  double meanV = m_normalVelocity->GetMean ();
+  double varianceV = m_normalVelocity->GetVariance ();
+  double boundV = m_normalVelocity->GetBound ();
+  double meanD = m_normalDirection->GetMean ();
+  double varianceD = m_normalDirection->GetVariance ();
+  double boundD = m_normalDirection->GetBound ();
+  double meanP = m_normalPitch->GetMean ();
+  double varianceP = m_normalPitch->GetVariance ();
+  double boundP = m_normalPitch->GetBound ();
+  // each thread works on its own range of the scratch arrays, which only
+  // grow with the batch, so that a step allocates nothing
+  double *velocity = &m_batchVelocity[begin];
+  double *direction = &m_batchDirection[begin];
+  double *pitch = &m_batchPitch[begin];
+  for (uint32_t k = 0; k < n; ++k)
+    {
+      ObstacleGaussMarkovMobilityModel *model = m_models[nodes[k]];
+      velocity[k] = model->m_normalVelocity->GetValue (meanV, varianceV, boundV);
+      direction[k] = model->m_normalDirection->GetValue (meanD, varianceD, boundD);
+      pitch[k] = model->m_normalPitch->GetValue (meanP, varianceP, boundP);
+    }
+
+  //Calculate the NEW velocity, direction, and pitch values using the Gauss-Markov formula:
+  //newVal = alpha*oldVal + (1-alpha)*meanVal + sqrt(1-alpha^2)*rv
+  //where rv is a random number from a normal (gaussian) distribution
+  double one_minus_alpha = 1 - m_alpha;
+  double sqrt_alpha = std::sqrt (1 - m_alpha*m_alpha);
+  for (uint32_t k = 0; k < n; ++k)
+    {
+      uint32_t i = nodes[k];
+      velocity[k]  = m_alpha * m_velocity[i]  + one_minus_alpha * m_meanVelocity[i]  + sqrt_alpha * velocity[k];
+      direction[k] = m_alpha * m_direction[i] + one_minus_alpha * m_meanDirection[i] + sqrt_alpha * direction[k];
+      pitch[k]     = m_alpha * m_pitch[i]     + one_minus_alpha * m_meanPitch[i]     + sqrt_alpha * pitch[k];
+    }
+
+  // contiguous loop without dependencies, so that the compiler can use
+  // vector versions of cos and sin where available
+  double *vx = &m_batchVx[begin];
+  double *vy = &m_batchVy[begin];
+  double *vz = &m_batchVz[begin];
+  for (uint32_t k = 0; k < n; ++k)
+    {
+      double cosPit = std::cos (pitch[k]);
+      vx[k] = velocity[k] * std::cos (direction[k]) * cosPit;
+      vy[k] = velocity[k] * std::sin (direction[k]) * cosPit;
+      vz[k] = velocity[k] * std::sin (pitch[k]);
+    }
+
+  for (uint32_t k = 0; k < n; ++k)
+    {
+      uint32_t i = nodes[k];
+      m_velocity[i] = velocity[k];
+      m_direction[i] = direction[k];
+      m_pitch[i] = pitch[k];
+      m_vx[i] = vx[k];
+      m_vy[i] = vy[k];
+      m_vz[i] = vz[k];
+      m_batchDelay[begin + k] = ComputeWalk (i, m_batchStep);
+    }
+}
+
+double
+ObstacleGaussMarkovSwarm::ComputeWalk (uint32_t i, double delayLeft)
+{
+  Vector position (m_x[i], m_y[i], m_z[i]);
+  Vector speed (m_vx[i], m_vy[i], m_vz[i]);
+  WalkEvent event = CalculateWalkEvent (m_bounds, PeekPointer (m_obstacles), position, speed, delayLeft);
+  m_closestObstacle[i] = event.obstacle;
+  m_closestSide[i] = event.side;
+  m_closestNormal[i] = event.normal;
+  // without anything ahead, the step ends on the tick grid, with the rest
+  // of the swarm
+  return (event.type == WalkEvent::TIMEOUT) ? -1.0 : event.delay;
+}
+
+void
+ObstacleGaussMarkovSwarm::ScheduleWalk (uint32_t i, double delay)
+{
+  m_events[i].Cancel ();
+  if (delay < 0.0)
+    {
+      m_pending[i] = PENDING_TICK;
+    }
+  else
+    {
+      m_pending[i] = PENDING_EVENT;
+      m_events[i] = Simulator::Schedule (Seconds (delay), &ObstacleGaussMarkovSwarm::Rebound, this, i);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,251 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#ifndef OBSTACLE_GAUSS_MARKOV_SWARM_H
+#define OBSTACLE_GAUSS_MARKOV_SWARM_H
+
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/vector.h"
+#include "ns3/box.h"
+#include "ns3/obstacle-world.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3 {
+
+class ObstacleGaussMarkovMobilityModel;
+
+/**
+ * \ingroup mobility
+ * \brief Steps the Gauss-Markov motion of many nodes together.
+ *
+ * A swarm holds the state of every ObstacleGaussMarkovMobilityModel
+ * attached to it through their "Swarm" attribute in contiguous arrays,
+ * and draws the new speed, direction and pitch of all of them in a
+ * single event per TimeStep, instead of one event per node. The models
+ * remain the per-node facade: positions and velocities are queried, and
+ * CourseChange is fired, through them. The parameters of the motion are
+ * the attributes of the swarm; those of the attached models are ignored.
+ * \code
+    Ptr<ObstacleGaussMarkovSwarm> swarm = CreateObject<ObstacleGaussMarkovSwarm> ();
+    swarm->SetAttribute ("TimeStep", TimeValue (Seconds (0.1)));
+
+    MobilityHelper mobility;
+    mobility.SetMobilityModel ("ns3::ObstacleGaussMarkovMobilityModel",
+      "Swarm", PointerValue (swarm));
+ * \endcode
+ *
+ * The Gauss-Markov updates of the whole swarm happen on a common grid,
+ * the multiples of TimeStep. Only the rebounds on the bounds and on the
+ * obstacles get an event of their own, after which the node walks on
+ * until the next tick of the grid and rejoins the batch.
+ *
+ * The "Threads" attribute splits the update of the nodes at each tick
+ * among several threads. The normal draws of a node come from the
+ * NormalVelocity, NormalDirection and NormalPitch streams of its own
+ * model, which MobilityHelper::AssignStreams fixes, with the parameters
+ * of the swarm; so each node moves the same whatever the number of
+ * threads and the order in which they run. The threads are started at
+ * the first tick with more than one node to update, wait for the next
+ * ticks, and are joined when the swarm is disposed of.
+ */
+class ObstacleGaussMarkovSwarm : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  ObstacleGaussMarkovSwarm ();
+  virtual ~ObstacleGaussMarkovSwarm ();
+
+  /**
+   * \param model the facade of the new node
+   * \param position the initial position of the node
+   * \return the index of the node in the swarm
+   *
+   * The node starts moving at the current time.
+   */
+  uint32_t Add (ObstacleGaussMarkovMobilityModel *model, const Vector &position);
+  /**
+   * \param i index of a node
+   *
+   * The node stops being updated. Its index is not reused.
+   */
+  void Remove (uint32_t i);
+  /**
+   * \return the number of nodes added to the swarm
+   */
+  uint32_t GetNNodes (void) const;
+  /**
+   * \param i index of a node
+   * \param position the new position of the node
+   *
+   * The node picks a new course from there at the current time.
+   */
+  void SetPosition (uint32_t i, const Vector &position);
+  /**
+   * \param i index of a node
+   * \return the current position of the node
+   */
+  Vector GetPosition (uint32_t i) const;
+  /**
+   * \param i index of a node
+   * \return the current velocity of the node
+   */
+  Vector GetVelocity (uint32_t i) const;
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this swarm.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned
+   *
+   * Only the mean speed, direction and pitch are drawn from the streams
+   * of the swarm; the other draws use the streams of the models.
+   */
+  int64_t AssignStreams (int64_t stream);
+
+private:
+  /** What a node is waiting for */
+  enum Pending {
+    PENDING_NONE,   //!< removed from the swarm
+    PENDING_TICK,   //!< the end of its step, on the tick grid
+    PENDING_EVENT   //!< an event of its own, for its start or a rebound
+  };
+  class WorkerPool;
+
+  virtual void DoDispose (void);
+  /**
+   * Stop and join the threads updating the nodes, if started
+   */
+  void StopThreads (void);
+  /**
+   * \param t a time
+   * \return the first tick of the grid strictly after t
+   */
+  Time GetNextTick (Time t) const;
+  /**
+   * Update the nodes whose step ends now, and schedule the next tick
+   */
+  void Tick (void);
+  /**
+   * Pick a new course for a node added or moved at the current time
+   * \param i index of the node
+   */
+  void Start (uint32_t i);
+  /**
+   * Rebound one node on the side it reached, at the current time
+   * \param i index of the node
+   */
+  void Rebound (uint32_t i);
+  /**
+   * Start a new step for every node of m_batch at the current time: draw
+   * their new velocity, walk them and notify their course change
+   */
+  void Step (void);
+  /**
+   * Draw the mean speed, direction and pitch of a node, if not done yet
+   * \param i index of the node
+   */
+  void InitializeMeans (uint32_t i);
+  /**
+   * Draw the new speed, direction and pitch of a range of m_batch, and
+   * walk them until the end of the step. Only the state of these nodes
+   * is written, so that disjoint ranges can be updated concurrently.
+   * \param begin first entry of m_batch to update
+   * \param end one past the last entry of m_batch to update
+   */
+  void UpdateNodes (uint32_t begin, uint32_t end);
+  /**
+   * Find how far one node can walk from the start of its current leg, at
+   * its current velocity, until the end of its step, an obstacle or the
+   * bounds, and record the side it would reach. Does not touch the
+   * simulator.
+   * \param i index of the node
+   * \param delayLeft time left until the end of the step, in seconds
+   * \return the delay until the node reaches an obstacle or the bounds,
+   *         in seconds, or -1 if it walks until the end of its step
+   */
+  double ComputeWalk (uint32_t i, double delayLeft);
+  /**
+   * Set what a node waits for after a walk
+   * \param i index of the node
+   * \param delay the result of ComputeWalk for the node
+   */
+  void ScheduleWalk (uint32_t i, double delay);
+  /**
+   * \param i index of a node
+   * \param t a time, not before the start of the current leg of the node
+   * \return the position of the node at time t, inside the bounds
+   */
+  Vector GetPosition (uint32_t i, Time t) const;
+
+  Box m_bounds; //!< bounding box
+  Time m_timeStep; //!< period of the Gauss-Markov updates
+  double m_alpha; //!< tunable constant in the model
+  Ptr<RandomVariableStream> m_rndMeanVelocity; //!< rv used to assign avg velocity
+  Ptr<NormalRandomVariable> m_normalVelocity; //!< Gaussian rv used to for next velocity
+  Ptr<RandomVariableStream> m_rndMeanDirection; //!< rv used to assign avg direction
+  Ptr<NormalRandomVariable> m_normalDirection; //!< Gaussian rv for next direction value
+  Ptr<RandomVariableStream> m_rndMeanPitch; //!< rv used to assign avg. pitch
+  Ptr<NormalRandomVariable> m_normalPitch; //!< Gaussian rv for next pitch
+  uint32_t m_threads; //!< number of threads updating the nodes
+  Ptr<ObstacleWorld> m_obstacles; //!< obstacles shared with the other models
+  EventId m_tick; //!< next tick of the grid
+  std::vector<uint32_t> m_batch; //!< nodes starting a new step now
+  std::vector<double> m_batchDelay; //!< result of ComputeWalk for each node of m_batch
+  double m_batchStep; //!< time left until the next tick, in seconds
+  // scratch of UpdateNodes, indexed as m_batch and kept across the steps
+  std::vector<double> m_batchVelocity; //!< gaussian deviate, then new speed of each node of m_batch
+  std::vector<double> m_batchDirection; //!< gaussian deviate, then new direction of each node of m_batch
+  std::vector<double> m_batchPitch; //!< gaussian deviate, then new pitch of each node of m_batch
+  std::vector<double> m_batchVx; //!< new x velocity of each node of m_batch
+  std::vector<double> m_batchVy; //!< new y velocity of each node of m_batch
+  std::vector<double> m_batchVz; //!< new z velocity of each node of m_batch
+  WorkerPool *m_pool; //!< threads updating the nodes with the simulation thread, once started
+
+  std::vector<ObstacleGaussMarkovMobilityModel *> m_models; //!< facade of each node
+  std::vector<uint8_t> m_pending; //!< what each node is waiting for
+  std::vector<EventId> m_events; //!< event of each node waiting for one
+  std::vector<Time> m_stepEnd; //!< end of the current step of each node
+  std::vector<Time> m_legStart; //!< start of the current leg of each node
+  std::vector<double> m_x; //!< x of the start of the current leg of each node
+  std::vector<double> m_y; //!< y of the start of the current leg of each node
+  std::vector<double> m_z; //!< z of the start of the current leg of each node
+  std::vector<double> m_vx; //!< x velocity of each node
+  std::vector<double> m_vy; //!< y velocity of each node
+  std::vector<double> m_vz; //!< z velocity of each node
+  std::vector<double> m_velocity; //!< speed of each node
+  std::vector<double> m_direction; //!< direction of each node
+  std::vector<double> m_pitch; //!< pitch of each node
+  std::vector<double> m_meanVelocity; //!< mean speed of each node
+  std::vector<double> m_meanDirection; //!< mean direction of each node
+  std::vector<double> m_meanPitch; //!< mean pitch of each node
+  std::vector<int32_t> m_closestObstacle; //!< obstacle ahead of each node, or -1
+  std::vector<uint8_t> m_closestSide; //!< side of the obstacle or bound ahead of each node
+  std::vector<Vector> m_closestNormal; //!< normal of the face ahead of each node
+};
+
+} // namespace ns3
+
+#endif /* OBSTACLE_GAUSS_MARKOV_SWARM_H */
@@ -0,0 +1,295 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#include "obstacle-position-allocator.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/pointer.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ObstaclePositionAllocator");
+
+NS_OBJECT_ENSURE_REGISTERED (ObstacleFreeBoxPositionAllocator);
+
+TypeId
+ObstacleFreeBoxPositionAllocator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ObstacleFreeBoxPositionAllocator")
+    .SetParent<PositionAllocator> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<ObstacleFreeBoxPositionAllocator> ()
+    .AddAttribute ("Bounds",
+                   "The box the positions are drawn in.",
+                   BoxValue (Box (0.0, 100.0, 0.0, 100.0, 0.0, 100.0)),
+                   MakeBoxAccessor (&ObstacleFreeBoxPositionAllocator::m_bounds),
+                   MakeBoxChecker ())
+    .AddAttribute ("Obstacles",
+                   "The obstacles the positions avoid.",
+                   PointerValue (),
+                   MakePointerAccessor (&ObstacleFreeBoxPositionAllocator::m_obstacles),
+                   MakePointerChecker<ObstacleWorld> ())
+    .AddAttribute ("VoxelSize",
+                   "The size of the voxels the box is split into to skip the obstacles "
+                   "quickly, or 0 to draw in the whole box.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&ObstacleFreeBoxPositionAllocator::m_voxelSize),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("MaxAttempts",
+                   "The number of draws after which a position is given up as impossible.",
+                   UintegerValue (100000),
+                   MakeUintegerAccessor (&ObstacleFreeBoxPositionAllocator::m_maxAttempts),
+                   MakeUintegerChecker<uint32_t> (1));
+  return tid;
+}
+
+ObstacleFreeBoxPositionAllocator::ObstacleFreeBoxPositionAllocator ()
+  : m_nFree (0),
+    m_nObstacles (~0U)
+{
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_n[0] = m_n[1] = m_n[2] = 0;
+  m_size[0] = m_size[1] = m_size[2] = 0.0;
+}
+
+ObstacleFreeBoxPositionAllocator::~ObstacleFreeBoxPositionAllocator ()
+{
+}
+
+bool
+ObstacleFreeBoxPositionAllocator::IsFree (const Vector &position) const
+{
+  return m_obstacles == 0 || m_obstacles->FindObstacle (position) == -1;
+}
+
+void
+ObstacleFreeBoxPositionAllocator::BuildVoxels (void) const
+{
+  const double min[3] = { m_bounds.xMin, m_bounds.yMin, m_bounds.zMin };
+  const double max[3] = { m_bounds.xMax, m_bounds.yMax, m_bounds.zMax };
+  uint64_t total = 1;
+  for (uint32_t axis = 0; axis < 3; ++axis)
+    {
+      m_n[axis] = std::max (1.0, std::ceil ((max[axis] - min[axis]) / m_voxelSize));
+      m_size[axis] = (max[axis] - min[axis]) / m_n[axis];
+      total *= m_n[axis];
+    }
+  NS_ABORT_MSG_IF (total > 0xffffffffULL, "Too many voxels, increase VoxelSize");
+
+  std::vector<uint8_t> state (total, FREE);
+  uint32_t nObstacles = m_obstacles->GetNObstacles ();
+  for (uint32_t o = 0; o < nObstacles; ++o)
+    {
+      const Box &box = m_obstacles->GetObstacle (o);
+      bool isBox = m_obstacles->IsBox (o);
+      const double lo[3] = { box.xMin, box.yMin, box.zMin };
+      const double hi[3] = { box.xMax, box.yMax, box.zMax };
+      int64_t first[3], last[3];
+      bool outside = false;
+      for (uint32_t axis = 0; axis < 3; ++axis)
+        {
+          // widened, so that rounding errors never leave an overlapped voxel free
+          first[axis] = std::max<int64_t> (0, std::floor ((lo[axis] - min[axis]) / m_size[axis] - 1e-9));
+          last[axis] = std::min<int64_t> (m_n[axis] - 1,
+                                          std::ceil ((hi[axis] - min[axis]) / m_size[axis] + 1e-9) - 1);
+          outside = outside || first[axis] > last[axis];
+        }
+      if (outside)
+        {
+          continue;
+        }
+      for (int64_t k = first[2]; k <= last[2]; ++k)
+        {
+          for (int64_t j = first[1]; j <= last[1]; ++j)
+            {
+              for (int64_t i = first[0]; i <= last[0]; ++i)
+                {
+                  uint8_t &s = state[(k * m_n[1] + j) * m_n[0] + i];
+                  if (s == FULL)
+                    {
+                      continue;
+                    }
+                  const int64_t index[3] = { i, j, k };
+                  bool covered = isBox;
+                  for (uint32_t axis = 0; axis < 3 && covered; ++axis)
+                    {
+                      covered = min[axis] + index[axis] * m_size[axis] >= lo[axis]
+                        && min[axis] + (index[axis] + 1) * m_size[axis] <= hi[axis];
+                    }
+                  s = covered ? FULL : PARTIAL;
+                }
+            }
+        }
+    }
+
+  m_voxels.clear ();
+  for (uint32_t v = 0; v < total; ++v)
+    {
+      if (state[v] == FREE)
+        {
+          m_voxels.push_back (v);
+        }
+    }
+  m_nFree = m_voxels.size ();
+  for (uint32_t v = 0; v < total; ++v)
+    {
+      if (state[v] == PARTIAL)
+        {
+          m_voxels.push_back (v);
+        }
+    }
+  m_nObstacles = nObstacles;
+  NS_LOG_DEBUG (total << " voxels, " << m_nFree << " free, "
+                << m_voxels.size () - m_nFree << " partial");
+}
+
+Vector
+ObstacleFreeBoxPositionAllocator::GetNext (void) const
+{
+  bool voxels = m_voxelSize > 0.0 && m_obstacles != 0;
+  if (voxels && m_nObstacles != m_obstacles->GetNObstacles ())
+    {
+      BuildVoxels ();
+    }
+  NS_ABORT_MSG_IF (voxels && m_voxels.empty (), "The obstacles fill the whole box");
+
+  for (uint32_t attempt = 0; attempt < m_maxAttempts; ++attempt)
+    {
+      if (!voxels)
+        {
+          Vector position (m_random->GetValue (m_bounds.xMin, m_bounds.xMax),
+                           m_random->GetValue (m_bounds.yMin, m_bounds.yMax),
+                           m_random->GetValue (m_bounds.zMin, m_bounds.zMax));
+          if (IsFree (position))
+            {
+              return position;
+            }
+          continue;
+        }
+      uint32_t v = m_random->GetInteger (0, m_voxels.size () - 1);
+      uint32_t index = m_voxels[v];
+      uint32_t i = index % m_n[0];
+      uint32_t j = (index / m_n[0]) % m_n[1];
+      uint32_t k = index / m_n[0] / m_n[1];
+      double x = m_bounds.xMin + i * m_size[0];
+      double y = m_bounds.yMin + j * m_size[1];
+      double z = m_bounds.zMin + k * m_size[2];
+      Vector position (m_random->GetValue (x, x + m_size[0]),
+                       m_random->GetValue (y, y + m_size[1]),
+                       m_random->GetValue (z, z + m_size[2]));
+      if (v < m_nFree || IsFree (position))
+        {
+          return position;
+        }
+    }
+  NS_FATAL_ERROR ("No position outside of the obstacles found in " << m_maxAttempts << " draws");
+  return Vector ();
+}
+
+int64_t
+ObstacleFreeBoxPositionAllocator::AssignStreams (int64_t stream)
+{
+  m_random->SetStream (stream);
+  return 1;
+}
+
+
+NS_OBJECT_ENSURE_REGISTERED (ObstacleFreeGridPositionAllocator);
+
+TypeId
+ObstacleFreeGridPositionAllocator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ObstacleFreeGridPositionAllocator")
+    .SetParent<PositionAllocator> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<ObstacleFreeGridPositionAllocator> ()
+    .AddAttribute ("Bounds",
+                   "The box of the grid, whose lower corner is the first grid point.",
+                   BoxValue (Box (0.0, 100.0, 0.0, 100.0, 0.0, 100.0)),
+                   MakeBoxAccessor (&ObstacleFreeGridPositionAllocator::m_bounds),
+                   MakeBoxChecker ())
+    .AddAttribute ("DeltaX",
+                   "The x space between grid points.",
+                   DoubleValue (10.0),
+                   MakeDoubleAccessor (&ObstacleFreeGridPositionAllocator::m_deltaX),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("DeltaY",
+                   "The y space between grid points.",
+                   DoubleValue (10.0),
+                   MakeDoubleAccessor (&ObstacleFreeGridPositionAllocator::m_deltaY),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("DeltaZ",
+                   "The z space between grid points.",
+                   DoubleValue (10.0),
+                   MakeDoubleAccessor (&ObstacleFreeGridPositionAllocator::m_deltaZ),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("Obstacles",
+                   "The obstacles the grid points inside of are skipped.",
+                   PointerValue (),
+                   MakePointerAccessor (&ObstacleFreeGridPositionAllocator::m_obstacles),
+                   MakePointerChecker<ObstacleWorld> ());
+  return tid;
+}
+
+ObstacleFreeGridPositionAllocator::ObstacleFreeGridPositionAllocator ()
+  : m_current (0)
+{
+}
+
+ObstacleFreeGridPositionAllocator::~ObstacleFreeGridPositionAllocator ()
+{
+}
+
+Vector
+ObstacleFreeGridPositionAllocator::GetNext (void) const
+{
+  NS_ASSERT (m_deltaX > 0.0 && m_deltaY > 0.0 && m_deltaZ > 0.0);
+  // the points on the far sides are kept despite rounding errors
+  uint64_t nx = std::floor ((m_bounds.xMax - m_bounds.xMin) / m_deltaX + 1e-9) + 1;
+  uint64_t ny = std::floor ((m_bounds.yMax - m_bounds.yMin) / m_deltaY + 1e-9) + 1;
+  uint64_t nz = std::floor ((m_bounds.zMax - m_bounds.zMin) / m_deltaZ + 1e-9) + 1;
+  uint64_t total = nx * ny * nz;
+
+  for (uint64_t tried = 0; tried < total; ++tried)
+    {
+      uint64_t index = m_current % total;
+      m_current = index + 1;
+      Vector position (m_bounds.xMin + (index % nx) * m_deltaX,
+                       m_bounds.yMin + (index / nx % ny) * m_deltaY,
+                       m_bounds.zMin + (index / nx / ny) * m_deltaZ);
+      if (m_obstacles == 0 || m_obstacles->FindObstacle (position) == -1)
+        {
+          return position;
+        }
+    }
+  NS_FATAL_ERROR ("Every grid point is inside an obstacle");
+  return Vector ();
+}
+
+int64_t
+ObstacleFreeGridPositionAllocator::AssignStreams (int64_t stream)
+{
+  return 0;
+}
+
+} // namespace ns3
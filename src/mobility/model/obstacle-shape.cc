@@ -0,0 +1,330 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#include "obstacle-shape.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ObstacleShape");
+
+ObstacleShape::~ObstacleShape ()
+{
+}
+
+PrismObstacle::PrismObstacle (const std::vector<Vector2D> &footprint, double zMin, double zMax)
+  : m_footprint (footprint),
+    m_zMin (zMin),
+    m_zMax (zMax)
+{
+  NS_LOG_FUNCTION (this << footprint.size () << zMin << zMax);
+  NS_ASSERT_MSG (footprint.size () >= 3, "A footprint needs at least 3 vertices");
+  NS_ASSERT_MSG (zMin < zMax, "The roof must be above the floor");
+  double area = 0.0;
+  for (uint32_t i = 0; i < m_footprint.size (); i++)
+    {
+      const Vector2D &a = m_footprint[i];
+      const Vector2D &b = m_footprint[(i + 1) % m_footprint.size ()];
+      area += a.x * b.y - b.x * a.y;
+    }
+  NS_ASSERT_MSG (area != 0.0, "Degenerate footprint");
+  if (area < 0.0)
+    {
+      std::reverse (m_footprint.begin (), m_footprint.end ());
+    }
+
+  m_bounds = Box (m_footprint[0].x, m_footprint[0].x, m_footprint[0].y, m_footprint[0].y, zMin, zMax);
+  m_normals.reserve (m_footprint.size ());
+  for (uint32_t i = 0; i < m_footprint.size (); i++)
+    {
+      const Vector2D &a = m_footprint[i];
+      const Vector2D &b = m_footprint[(i + 1) % m_footprint.size ()];
+      double dx = b.x - a.x;
+      double dy = b.y - a.y;
+      double length = std::sqrt (dx * dx + dy * dy);
+      NS_ASSERT_MSG (length > 0.0, "Repeated vertex in the footprint");
+      // right of a counterclockwise edge
+      m_normals.push_back (Vector2D (dy / length, -dx / length));
+      m_bounds.xMin = std::min (m_bounds.xMin, a.x);
+      m_bounds.xMax = std::max (m_bounds.xMax, a.x);
+      m_bounds.yMin = std::min (m_bounds.yMin, a.y);
+      m_bounds.yMax = std::max (m_bounds.yMax, a.y);
+    }
+}
+
+const std::vector<Vector2D> &
+PrismObstacle::GetFootprint (void) const
+{
+  return m_footprint;
+}
+
+Box
+PrismObstacle::GetBoundingBox (void) const
+{
+  return m_bounds;
+}
+
+bool
+PrismObstacle::IsInsideFootprint (double x, double y) const
+{
+  // crossing number of a ray toward +x
+  bool inside = false;
+  uint32_t n = m_footprint.size ();
+  for (uint32_t i = 0, j = n - 1; i < n; j = i++)
+    {
+      const Vector2D &a = m_footprint[i];
+      const Vector2D &b = m_footprint[j];
+      if ((a.y > y) != (b.y > y)
+          && x < (b.x - a.x) * (y - a.y) / (b.y - a.y) + a.x)
+        {
+          inside = !inside;
+        }
+    }
+  return inside;
+}
+
+bool
+PrismObstacle::IsInside (const Vector &position) const
+{
+  return m_zMin < position.z && position.z < m_zMax
+         && IsInsideFootprint (position.x, position.y);
+}
+
+bool
+PrismObstacle::Intersect (const Vector &origin, const Vector &velocity,
+                          double &t, Vector &normal) const
+{
+  double best = std::numeric_limits<double>::infinity ();
+
+  // floor and roof
+  if (velocity.z > 0.0 && origin.z <= m_zMin)
+    {
+      double tz = (m_zMin - origin.z) / velocity.z;
+      if (IsInsideFootprint (origin.x + velocity.x * tz, origin.y + velocity.y * tz))
+        {
+          best = tz;
+          normal = Vector (0.0, 0.0, -1.0);
+        }
+    }
+  else if (velocity.z < 0.0 && origin.z >= m_zMax)
+    {
+      double tz = (m_zMax - origin.z) / velocity.z;
+      if (IsInsideFootprint (origin.x + velocity.x * tz, origin.y + velocity.y * tz))
+        {
+          best = tz;
+          normal = Vector (0.0, 0.0, 1.0);
+        }
+    }
+
+  // walls entered from their outer side
+  uint32_t n = m_footprint.size ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      const Vector2D &edgeNormal = m_normals[i];
+      double approach = velocity.x * edgeNormal.x + velocity.y * edgeNormal.y;
+      if (approach >= 0.0)
+        {
+          continue;
+        }
+      const Vector2D &a = m_footprint[i];
+      double distance = (origin.x - a.x) * edgeNormal.x + (origin.y - a.y) * edgeNormal.y;
+      if (distance < 0.0)
+        {
+          continue;
+        }
+      double tw = -distance / approach;
+      if (tw >= best)
+        {
+          continue;
+        }
+      double z = origin.z + velocity.z * tw;
+      if (z < m_zMin || z > m_zMax)
+        {
+          continue;
+        }
+      const Vector2D &b = m_footprint[(i + 1) % n];
+      double dx = b.x - a.x;
+      double dy = b.y - a.y;
+      double along = (origin.x + velocity.x * tw - a.x) * dx + (origin.y + velocity.y * tw - a.y) * dy;
+      if (along < 0.0 || along > dx * dx + dy * dy)
+        {
+          continue;
+        }
+      best = tw;
+      normal = Vector (edgeNormal.x, edgeNormal.y, 0.0);
+    }
+
+  if (best == std::numeric_limits<double>::infinity ())
+    {
+      return false;
+    }
+  t = best;
+  return true;
+}
+
+ConvexObstacle::ConvexObstacle (const std::vector<Vector> &points)
+{
+  NS_LOG_FUNCTION (this << points.size ());
+  NS_ASSERT_MSG (points.size () >= 4, "A convex hull needs at least 4 points");
+  m_bounds = Box (points[0].x, points[0].x, points[0].y, points[0].y, points[0].z, points[0].z);
+  for (uint32_t i = 1; i < points.size (); i++)
+    {
+      m_bounds.xMin = std::min (m_bounds.xMin, points[i].x);
+      m_bounds.xMax = std::max (m_bounds.xMax, points[i].x);
+      m_bounds.yMin = std::min (m_bounds.yMin, points[i].y);
+      m_bounds.yMax = std::max (m_bounds.yMax, points[i].y);
+      m_bounds.zMin = std::min (m_bounds.zMin, points[i].z);
+      m_bounds.zMax = std::max (m_bounds.zMax, points[i].z);
+    }
+  double scale = CalculateDistance (Vector (m_bounds.xMin, m_bounds.yMin, m_bounds.zMin),
+                                    Vector (m_bounds.xMax, m_bounds.yMax, m_bounds.zMax));
+  double epsilon = 1e-9 * scale;
+
+  // a triple of points spans a face if every other point is on one side
+  // of its plane
+  uint32_t n = points.size ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      for (uint32_t j = i + 1; j < n; j++)
+        {
+          for (uint32_t k = j + 1; k < n; k++)
+            {
+              Vector u (points[j].x - points[i].x, points[j].y - points[i].y, points[j].z - points[i].z);
+              Vector v (points[k].x - points[i].x, points[k].y - points[i].y, points[k].z - points[i].z);
+              Vector normal (u.y * v.z - u.z * v.y, u.z * v.x - u.x * v.z, u.x * v.y - u.y * v.x);
+              double length = std::sqrt (normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+              if (length <= epsilon * scale)
+                {
+                  continue;
+                }
+              normal = Vector (normal.x / length, normal.y / length, normal.z / length);
+              double offset = normal.x * points[i].x + normal.y * points[i].y + normal.z * points[i].z;
+              bool above = false;
+              bool below = false;
+              for (uint32_t p = 0; p < n && !(above && below); p++)
+                {
+                  double s = normal.x * points[p].x + normal.y * points[p].y + normal.z * points[p].z - offset;
+                  above = above || s > epsilon;
+                  below = below || s < -epsilon;
+                }
+              if (above == below)
+                {
+                  continue;
+                }
+              if (above)
+                {
+                  normal = Vector (-normal.x, -normal.y, -normal.z);
+                  offset = -offset;
+                }
+              bool known = false;
+              for (std::vector<Face>::const_iterator f = m_faces.begin (); f != m_faces.end () && !known; ++f)
+                {
+                  known = CalculateDistance (f->normal, normal) < 1e-9 && std::abs (f->offset - offset) <= epsilon;
+                }
+              if (!known)
+                {
+                  Face face;
+                  face.normal = normal;
+                  face.offset = offset;
+                  m_faces.push_back (face);
+                }
+            }
+        }
+    }
+  NS_ASSERT_MSG (m_faces.size () >= 4, "The points of a convex obstacle are all in a plane");
+}
+
+uint32_t
+ConvexObstacle::GetNFaces (void) const
+{
+  return m_faces.size ();
+}
+
+Box
+ConvexObstacle::GetBoundingBox (void) const
+{
+  return m_bounds;
+}
+
+bool
+ConvexObstacle::IsInside (const Vector &position) const
+{
+  for (std::vector<Face>::const_iterator f = m_faces.begin (); f != m_faces.end (); ++f)
+    {
+      if (f->normal.x * position.x + f->normal.y * position.y + f->normal.z * position.z >= f->offset)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+bool
+ConvexObstacle::Intersect (const Vector &origin, const Vector &velocity,
+                           double &t, Vector &normal) const
+{
+  // the ray is inside the plane of a face while
+  // t * approach < distance, with distance >= 0 outside
+  double tEnter = -std::numeric_limits<double>::infinity ();
+  double tExit = std::numeric_limits<double>::infinity ();
+  const Face *entered = 0;
+  for (std::vector<Face>::const_iterator f = m_faces.begin (); f != m_faces.end (); ++f)
+    {
+      double approach = f->normal.x * velocity.x + f->normal.y * velocity.y + f->normal.z * velocity.z;
+      double distance = f->offset - (f->normal.x * origin.x + f->normal.y * origin.y + f->normal.z * origin.z);
+      if (approach == 0.0)
+        {
+          if (distance < 0.0)
+            {
+              return false;
+            }
+          continue;
+        }
+      double tf = distance / approach;
+      if (approach < 0.0)
+        {
+          if (tf > tEnter)
+            {
+              tEnter = tf;
+              entered = &*f;
+            }
+        }
+      else
+        {
+          tExit = std::min (tExit, tf);
+        }
+      if (tEnter > tExit)
+        {
+          return false;
+        }
+    }
+  if (entered == 0 || tEnter < 0.0)
+    {
+      return false;
+    }
+  t = tEnter;
+  normal = entered->normal;
+  return true;
+}
+
+} // namespace ns3
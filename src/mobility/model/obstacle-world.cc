@@ -0,0 +1,913 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#include "obstacle-world.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#if defined (__AVX__)
+#include <immintrin.h>
+#elif defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ObstacleWorld");
+
+NS_OBJECT_ENSURE_REGISTERED (ObstacleWorld);
+
+/**
+ * Maximum number of obstacles in a leaf of the hierarchy. Every leaf
+ * is padded to this size so that it can be tested with a single pass
+ * of the batched slab test.
+ */
+static const uint32_t BVH_LEAF_SIZE = 4;
+
+/**
+ * Pick the entry parameter of a ray into a box out of the entry
+ * parameters into its three slabs.
+ *
+ * \param nearX the entry parameter into the x slab
+ * \param nearY the entry parameter into the y slab
+ * \param nearZ the entry parameter into the z slab
+ * \param inv the component-wise inverse of the velocity
+ * \param side if not null, on output, the side through which the box is entered
+ * \return the entry parameter into the box
+ */
+static inline double
+SelectEntry (double nearX, double nearY, double nearZ, const Vector &inv, Box::Side *side)
+{
+  if (nearX >= nearY && nearX >= nearZ)
+    {
+      if (side != 0)
+        {
+          *side = inv.x >= 0 ? Box::LEFT : Box::RIGHT;
+        }
+      return nearX;
+    }
+  else if (nearY >= nearZ)
+    {
+      if (side != 0)
+        {
+          *side = inv.y >= 0 ? Box::BOTTOM : Box::TOP;
+        }
+      return nearY;
+    }
+  if (side != 0)
+    {
+      *side = inv.z >= 0 ? Box::DOWN : Box::UP;
+    }
+  return nearZ;
+}
+
+/**
+ * \param side a side of a box
+ * \return the outward unit normal of the side
+ */
+static inline Vector
+SideNormal (Box::Side side)
+{
+  switch (side)
+    {
+    case Box::RIGHT:
+      return Vector (1.0, 0.0, 0.0);
+    case Box::LEFT:
+      return Vector (-1.0, 0.0, 0.0);
+    case Box::TOP:
+      return Vector (0.0, 1.0, 0.0);
+    case Box::BOTTOM:
+      return Vector (0.0, -1.0, 0.0);
+    case Box::UP:
+      return Vector (0.0, 0.0, 1.0);
+    default:
+      return Vector (0.0, 0.0, -1.0);
+    }
+}
+
+/**
+ * \param normal an outward unit normal
+ * \return the side of a box whose normal is the closest to the given one
+ */
+static inline Box::Side
+ClosestSide (const Vector &normal)
+{
+  double x = std::abs (normal.x);
+  double y = std::abs (normal.y);
+  double z = std::abs (normal.z);
+  if (x >= y && x >= z)
+    {
+      return normal.x > 0 ? Box::RIGHT : Box::LEFT;
+    }
+  else if (y >= z)
+    {
+      return normal.y > 0 ? Box::TOP : Box::BOTTOM;
+    }
+  return normal.z > 0 ? Box::UP : Box::DOWN;
+}
+
+/**
+ * Slab test of the ray origin+t*velocity against a box.
+ *
+ * \param box the box to test
+ * \param origin the origin of the ray
+ * \param inv the component-wise inverse of the velocity
+ * \param tNear on output, the ray parameter where the box is entered
+ * \param tFar on output, the ray parameter where the box is left
+ * \param side if not null, on output, the side through which the box is entered
+ * \return true if the ray line crosses the box
+ */
+static bool
+IntersectSlabs (const Box &box, const Vector &origin, const Vector &inv,
+                double &tNear, double &tFar, Box::Side *side)
+{
+  double tx1 = (box.xMin - origin.x) * inv.x;
+  double tx2 = (box.xMax - origin.x) * inv.x;
+  double ty1 = (box.yMin - origin.y) * inv.y;
+  double ty2 = (box.yMax - origin.y) * inv.y;
+  double tz1 = (box.zMin - origin.z) * inv.z;
+  double tz2 = (box.zMax - origin.z) * inv.z;
+
+  tFar = std::min (std::max (tx1, tx2), std::min (std::max (ty1, ty2), std::max (tz1, tz2)));
+  tNear = SelectEntry (std::min (tx1, tx2), std::min (ty1, ty2), std::min (tz1, tz2), inv, side);
+  return tNear <= tFar;
+}
+
+/**
+ * Batched slab test of a ray against the BVH_LEAF_SIZE boxes of a leaf,
+ * stored as structure of arrays. The vector versions are chosen at build
+ * time from the instruction sets enabled in the compiler flags, and give
+ * the same results as IntersectSlabs: the operations are done in the same
+ * order, and the min/max operands are swapped so that NaNs propagate as
+ * with std::min and std::max.
+ *
+ * \param bounds the xMin, xMax, yMin, yMax, zMin and zMax arrays of the leaf
+ * \param origin the origin of the ray
+ * \param inv the component-wise inverse of the velocity
+ * \param nearX on output, the entry parameter into the x slab of each box
+ * \param nearY on output, the entry parameter into the y slab of each box
+ * \param nearZ on output, the entry parameter into the z slab of each box
+ * \param far on output, the exit parameter out of each box
+ */
+static inline void
+IntersectLeaf (const double * const bounds[6], const Vector &origin, const Vector &inv,
+               double *nearX, double *nearY, double *nearZ, double *far)
+{
+#if defined (__AVX__)
+  const __m256d ox = _mm256_set1_pd (origin.x);
+  const __m256d oy = _mm256_set1_pd (origin.y);
+  const __m256d oz = _mm256_set1_pd (origin.z);
+  const __m256d ix = _mm256_set1_pd (inv.x);
+  const __m256d iy = _mm256_set1_pd (inv.y);
+  const __m256d iz = _mm256_set1_pd (inv.z);
+  for (uint32_t i = 0; i < BVH_LEAF_SIZE; i += 4)
+    {
+      __m256d tx1 = _mm256_mul_pd (_mm256_sub_pd (_mm256_loadu_pd (bounds[0] + i), ox), ix);
+      __m256d tx2 = _mm256_mul_pd (_mm256_sub_pd (_mm256_loadu_pd (bounds[1] + i), ox), ix);
+      __m256d ty1 = _mm256_mul_pd (_mm256_sub_pd (_mm256_loadu_pd (bounds[2] + i), oy), iy);
+      __m256d ty2 = _mm256_mul_pd (_mm256_sub_pd (_mm256_loadu_pd (bounds[3] + i), oy), iy);
+      __m256d tz1 = _mm256_mul_pd (_mm256_sub_pd (_mm256_loadu_pd (bounds[4] + i), oz), iz);
+      __m256d tz2 = _mm256_mul_pd (_mm256_sub_pd (_mm256_loadu_pd (bounds[5] + i), oz), iz);
+      _mm256_storeu_pd (nearX + i, _mm256_min_pd (tx2, tx1));
+      _mm256_storeu_pd (nearY + i, _mm256_min_pd (ty2, ty1));
+      _mm256_storeu_pd (nearZ + i, _mm256_min_pd (tz2, tz1));
+      __m256d farYZ = _mm256_min_pd (_mm256_max_pd (tz2, tz1), _mm256_max_pd (ty2, ty1));
+      _mm256_storeu_pd (far + i, _mm256_min_pd (farYZ, _mm256_max_pd (tx2, tx1)));
+    }
+#elif defined (__SSE2__)
+  const __m128d ox = _mm_set1_pd (origin.x);
+  const __m128d oy = _mm_set1_pd (origin.y);
+  const __m128d oz = _mm_set1_pd (origin.z);
+  const __m128d ix = _mm_set1_pd (inv.x);
+  const __m128d iy = _mm_set1_pd (inv.y);
+  const __m128d iz = _mm_set1_pd (inv.z);
+  for (uint32_t i = 0; i < BVH_LEAF_SIZE; i += 2)
+    {
+      __m128d tx1 = _mm_mul_pd (_mm_sub_pd (_mm_loadu_pd (bounds[0] + i), ox), ix);
+      __m128d tx2 = _mm_mul_pd (_mm_sub_pd (_mm_loadu_pd (bounds[1] + i), ox), ix);
+      __m128d ty1 = _mm_mul_pd (_mm_sub_pd (_mm_loadu_pd (bounds[2] + i), oy), iy);
+      __m128d ty2 = _mm_mul_pd (_mm_sub_pd (_mm_loadu_pd (bounds[3] + i), oy), iy);
+      __m128d tz1 = _mm_mul_pd (_mm_sub_pd (_mm_loadu_pd (bounds[4] + i), oz), iz);
+      __m128d tz2 = _mm_mul_pd (_mm_sub_pd (_mm_loadu_pd (bounds[5] + i), oz), iz);
+      _mm_storeu_pd (nearX + i, _mm_min_pd (tx2, tx1));
+      _mm_storeu_pd (nearY + i, _mm_min_pd (ty2, ty1));
+      _mm_storeu_pd (nearZ + i, _mm_min_pd (tz2, tz1));
+      __m128d farYZ = _mm_min_pd (_mm_max_pd (tz2, tz1), _mm_max_pd (ty2, ty1));
+      _mm_storeu_pd (far + i, _mm_min_pd (farYZ, _mm_max_pd (tx2, tx1)));
+    }
+#else
+  for (uint32_t i = 0; i < BVH_LEAF_SIZE; ++i)
+    {
+      double tx1 = (bounds[0][i] - origin.x) * inv.x;
+      double tx2 = (bounds[1][i] - origin.x) * inv.x;
+      double ty1 = (bounds[2][i] - origin.y) * inv.y;
+      double ty2 = (bounds[3][i] - origin.y) * inv.y;
+      double tz1 = (bounds[4][i] - origin.z) * inv.z;
+      double tz2 = (bounds[5][i] - origin.z) * inv.z;
+      nearX[i] = std::min (tx1, tx2);
+      nearY[i] = std::min (ty1, ty2);
+      nearZ[i] = std::min (tz1, tz2);
+      far[i] = std::min (std::max (tx1, tx2), std::min (std::max (ty1, ty2), std::max (tz1, tz2)));
+    }
+#endif
+}
+
+TypeId
+ObstacleWorld::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ObstacleWorld")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<ObstacleWorld> ()
+  ;
+  return tid;
+}
+
+ObstacleWorld::ObstacleWorld ()
+  : m_indexed (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ObstacleWorld::~ObstacleWorld ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+ObstacleWorld::AddObstacle (const Box &obstacle)
+{
+  NS_LOG_FUNCTION (this << obstacle);
+  m_obstacles.push_back (obstacle);
+  m_shapes.push_back (0);
+  m_indexed = false;
+}
+
+void
+ObstacleWorld::AddObstacle (Ptr<const ObstacleShape> shape)
+{
+  NS_LOG_FUNCTION (this << shape);
+  NS_ASSERT (shape != 0);
+  m_obstacles.push_back (shape->GetBoundingBox ());
+  m_shapes.push_back (shape);
+  m_indexed = false;
+}
+
+uint32_t
+ObstacleWorld::GetNObstacles (void) const
+{
+  return m_obstacles.size ();
+}
+
+const Box &
+ObstacleWorld::GetObstacle (uint32_t i) const
+{
+  NS_ASSERT (i < m_obstacles.size ());
+  return m_obstacles[i];
+}
+
+Ptr<const ObstacleShape>
+ObstacleWorld::GetShape (uint32_t i) const
+{
+  NS_ASSERT (i < m_shapes.size ());
+  return m_shapes[i];
+}
+
+bool
+ObstacleWorld::IsBox (uint32_t i) const
+{
+  NS_ASSERT (i < m_shapes.size ());
+  return m_shapes[i] == 0;
+}
+
+int32_t
+ObstacleWorld::FindClosestCollision (const Vector &position, const Vector &velocity,
+                                     double &distance) const
+{
+  Box::Side side;
+  return FindClosestCollision (position, velocity, distance, side);
+}
+
+int32_t
+ObstacleWorld::FindClosestCollision (const Vector &position, const Vector &velocity,
+                                     double &distance, Box::Side &side) const
+{
+  Vector normal;
+  return FindClosestCollision (position, velocity, distance, side, normal);
+}
+
+int32_t
+ObstacleWorld::FindClosestCollision (const Vector &position, const Vector &velocity,
+                                     double &distance, Box::Side &side, Vector &normal) const
+{
+  double speed = std::sqrt (velocity.x * velocity.x + velocity.y * velocity.y + velocity.z * velocity.z);
+  if (m_obstacles.empty () || speed == 0.0)
+    {
+      return -1;
+    }
+  BuildIndex ();
+
+  Vector inv (1.0 / velocity.x, 1.0 / velocity.y, 1.0 / velocity.z);
+  double best = distance / speed;
+  int32_t closest = -1;
+  Vector shapeNormal;
+
+  // Depth-first traversal, visiting the nearest child first so that
+  // farther subtrees can be pruned against the best hit found so far.
+  uint32_t stack[64];
+  double stackEntry[64];
+  uint32_t top = 0;
+  double tNear, tFar;
+  if (IntersectSlabs (m_nodes[0].bounds, position, inv, tNear, tFar, 0)
+      && tFar >= 0 && tNear <= best)
+    {
+      stack[top] = 0;
+      stackEntry[top++] = tNear;
+    }
+  while (top > 0)
+    {
+      --top;
+      uint32_t index = stack[top];
+      double entry = stackEntry[top];
+      if (entry > best)
+        {
+          continue;
+        }
+      const BvhNode &node = m_nodes[index];
+      if (node.count > 0)
+        {
+          const double * const bounds[6] = {
+            &m_xMin[node.start], &m_xMax[node.start], &m_yMin[node.start],
+            &m_yMax[node.start], &m_zMin[node.start], &m_zMax[node.start]
+          };
+          double nearX[BVH_LEAF_SIZE], nearY[BVH_LEAF_SIZE], nearZ[BVH_LEAF_SIZE], far[BVH_LEAF_SIZE];
+          IntersectLeaf (bounds, position, inv, nearX, nearY, nearZ, far);
+          for (uint32_t i = 0; i < node.count; ++i)
+            {
+              uint32_t id = m_order[node.start + i];
+              Box::Side hitSide;
+              tNear = SelectEntry (nearX[i], nearY[i], nearZ[i], inv, &hitSide);
+              // written so that NaN parameters, as for a ray inside the
+              // plane of a side, never hit
+              if (!(tNear <= far[i] && tNear <= best))
+                {
+                  continue;
+                }
+              const Ptr<const ObstacleShape> &shape = m_shapes[id];
+              Vector hitNormal;
+              if (shape != 0)
+                {
+                  // the ray may start inside the bounding box of a shape
+                  // without being inside the shape
+                  if (!(far[i] >= 0) || !shape->Intersect (position, velocity, tNear, hitNormal)
+                      || tNear > best)
+                    {
+                      continue;
+                    }
+                  hitSide = ClosestSide (hitNormal);
+                }
+              else if (!(tNear >= 0))
+                {
+                  continue;
+                }
+              if (tNear < best
+                  || (tNear == best && (closest == -1 || id < static_cast<uint32_t> (closest))))
+                {
+                  best = tNear;
+                  closest = id;
+                  side = hitSide;
+                  shapeNormal = hitNormal;
+                }
+            }
+          continue;
+        }
+      uint32_t children[2] = { index + 1, node.right };
+      double entries[2];
+      bool hits[2];
+      for (uint32_t c = 0; c < 2; ++c)
+        {
+          hits[c] = IntersectSlabs (m_nodes[children[c]].bounds, position, inv, tNear, tFar, 0)
+            && tFar >= 0 && tNear <= best;
+          entries[c] = tNear;
+        }
+      uint32_t first = (hits[0] && hits[1] && entries[1] < entries[0]) ? 1 : 0;
+      uint32_t second = 1 - first;
+      if (hits[second])
+        {
+          NS_ASSERT (top < 64);
+          stack[top] = children[second];
+          stackEntry[top++] = entries[second];
+        }
+      if (hits[first])
+        {
+          NS_ASSERT (top < 64);
+          stack[top] = children[first];
+          stackEntry[top++] = entries[first];
+        }
+    }
+
+  if (closest != -1)
+    {
+      distance = best * speed;
+      normal = m_shapes[closest] != 0 ? shapeNormal : SideNormal (side);
+    }
+  return closest;
+}
+
+uint32_t
+ObstacleWorld::FindCrossings (const Vector &a, const Vector &b,
+                              std::vector<ObstacleCrossing> &crossings) const
+{
+  crossings.clear ();
+  return CrossSegment (a, b, &crossings);
+}
+
+bool
+ObstacleWorld::IsBlocked (const Vector &a, const Vector &b) const
+{
+  return CrossSegment (a, b, 0) > 0;
+}
+
+int32_t
+ObstacleWorld::FindObstacle (const Vector &position) const
+{
+  if (m_obstacles.empty ())
+    {
+      return -1;
+    }
+  BuildIndex ();
+
+  uint32_t stack[64];
+  uint32_t top = 0;
+  if (m_nodes[0].bounds.IsInside (position))
+    {
+      stack[top++] = 0;
+    }
+  while (top > 0)
+    {
+      const BvhNode &node = m_nodes[stack[--top]];
+      if (node.count == 0)
+        {
+          uint32_t children[2] = { static_cast<uint32_t> (&node - &m_nodes[0]) + 1, node.right };
+          for (uint32_t c = 0; c < 2; ++c)
+            {
+              if (m_nodes[children[c]].bounds.IsInside (position))
+                {
+                  NS_ASSERT (top < 64);
+                  stack[top++] = children[c];
+                }
+            }
+          continue;
+        }
+      for (uint32_t i = node.start; i < node.start + node.count; ++i)
+        {
+          if (position.x > m_xMin[i] && position.x < m_xMax[i]
+              && position.y > m_yMin[i] && position.y < m_yMax[i]
+              && position.z > m_zMin[i] && position.z < m_zMax[i])
+            {
+              uint32_t id = m_order[i];
+              if (m_shapes[id] == 0 || m_shapes[id]->IsInside (position))
+                {
+                  return id;
+                }
+            }
+        }
+    }
+  return -1;
+}
+
+uint32_t
+ObstacleWorld::FindOverlaps (const Box &box, std::vector<uint32_t> &obstacles) const
+{
+  obstacles.clear ();
+  if (m_obstacles.empty ())
+    {
+      return 0;
+    }
+  BuildIndex ();
+
+  uint32_t stack[64];
+  uint32_t top = 0;
+  stack[top++] = 0;
+  while (top > 0)
+    {
+      const BvhNode &node = m_nodes[stack[--top]];
+      if (node.bounds.xMax <= box.xMin || node.bounds.xMin >= box.xMax
+          || node.bounds.yMax <= box.yMin || node.bounds.yMin >= box.yMax
+          || node.bounds.zMax <= box.zMin || node.bounds.zMin >= box.zMax)
+        {
+          continue;
+        }
+      if (node.count == 0)
+        {
+          NS_ASSERT (top + 2 <= 64);
+          stack[top++] = static_cast<uint32_t> (&node - &m_nodes[0]) + 1;
+          stack[top++] = node.right;
+          continue;
+        }
+      for (uint32_t i = node.start; i < node.start + node.count; ++i)
+        {
+          if (m_xMax[i] > box.xMin && m_xMin[i] < box.xMax
+              && m_yMax[i] > box.yMin && m_yMin[i] < box.yMax
+              && m_zMax[i] > box.zMin && m_zMin[i] < box.zMax)
+            {
+              obstacles.push_back (m_order[i]);
+            }
+        }
+    }
+  return obstacles.size ();
+}
+
+uint32_t
+ObstacleWorld::CrossSegment (const Vector &a, const Vector &b,
+                             std::vector<ObstacleCrossing> *crossings) const
+{
+  if (m_obstacles.empty ())
+    {
+      return 0;
+    }
+  BuildIndex ();
+
+  // the segment is a + t * direction, for t in [0, 1]
+  Vector direction (b.x - a.x, b.y - a.y, b.z - a.z);
+  Vector back (-direction.x, -direction.y, -direction.z);
+  Vector inv (1.0 / direction.x, 1.0 / direction.y, 1.0 / direction.z);
+  uint32_t found = 0;
+
+  // any traversal order will do, since every hit is wanted; the tree is
+  // balanced, so its depth is bounded by the bits of the obstacle count
+  uint32_t stack[64];
+  uint32_t top = 0;
+  double tNear, tFar;
+  if (IntersectSlabs (m_nodes[0].bounds, a, inv, tNear, tFar, 0)
+      && tFar >= 0 && tNear <= 1)
+    {
+      stack[top++] = 0;
+    }
+  while (top > 0)
+    {
+      const BvhNode &node = m_nodes[stack[--top]];
+      if (node.count == 0)
+        {
+          uint32_t children[2] = { static_cast<uint32_t> (&node - &m_nodes[0]) + 1, node.right };
+          for (uint32_t c = 0; c < 2; ++c)
+            {
+              if (IntersectSlabs (m_nodes[children[c]].bounds, a, inv, tNear, tFar, 0)
+                  && tFar >= 0 && tNear <= 1)
+                {
+                  NS_ASSERT (top < 64);
+                  stack[top++] = children[c];
+                }
+            }
+          continue;
+        }
+      const double * const bounds[6] = {
+        &m_xMin[node.start], &m_xMax[node.start], &m_yMin[node.start],
+        &m_yMax[node.start], &m_zMin[node.start], &m_zMax[node.start]
+      };
+      double nearX[BVH_LEAF_SIZE], nearY[BVH_LEAF_SIZE], nearZ[BVH_LEAF_SIZE], far[BVH_LEAF_SIZE];
+      IntersectLeaf (bounds, a, inv, nearX, nearY, nearZ, far);
+      for (uint32_t i = 0; i < node.count; ++i)
+        {
+          tNear = SelectEntry (nearX[i], nearY[i], nearZ[i], inv, 0);
+          // NaN parameters, as for a segment in the plane of a side, miss
+          if (!(tNear <= far[i] && far[i] >= 0 && tNear <= 1))
+            {
+              continue;
+            }
+          uint32_t id = m_order[node.start + i];
+          double enter = std::max (tNear, 0.0);
+          double exit = std::min (far[i], 1.0);
+          const Ptr<const ObstacleShape> &shape = m_shapes[id];
+          if (shape != 0)
+            {
+              // the exact entry from a, and exit as the entry from b
+              Vector normal;
+              double t;
+              if (shape->IsInside (a))
+                {
+                  enter = 0.0;
+                }
+              else if (shape->Intersect (a, direction, t, normal) && t <= 1)
+                {
+                  enter = t;
+                }
+              else
+                {
+                  continue;
+                }
+              if (shape->IsInside (b))
+                {
+                  exit = 1.0;
+                }
+              else if (shape->Intersect (b, back, t, normal))
+                {
+                  exit = 1.0 - t;
+                }
+            }
+          found++;
+          if (crossings == 0)
+            {
+              return found;
+            }
+          ObstacleCrossing crossing;
+          crossing.obstacle = id;
+          crossing.enter = enter;
+          crossing.exit = exit;
+          crossings->push_back (crossing);
+        }
+    }
+  return found;
+}
+
+void
+ObstacleWorld::BuildIndex (void) const
+{
+  if (m_indexed)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << m_obstacles.size ());
+  m_nodes.clear ();
+  if (m_obstacles.empty ())
+    {
+      // the queries return before looking at the empty tree
+      m_order.clear ();
+      m_indexed = true;
+      return;
+    }
+  m_nodes.reserve (2 * (m_obstacles.size () / BVH_LEAF_SIZE + 1));
+  m_order.resize (m_obstacles.size ());
+  for (uint32_t i = 0; i < m_order.size (); ++i)
+    {
+      m_order[i] = i;
+    }
+  BuildNode (0, m_order.size ());
+
+  // lay the leaves out as structure of arrays, each one padded with
+  // copies of its first obstacle up to BVH_LEAF_SIZE entries
+  std::vector<uint32_t> order;
+  order.reserve (m_nodes.size () * BVH_LEAF_SIZE);
+  for (std::vector<BvhNode>::iterator node = m_nodes.begin (); node != m_nodes.end (); ++node)
+    {
+      if (node->count == 0)
+        {
+          continue;
+        }
+      uint32_t start = order.size ();
+      for (uint32_t i = 0; i < BVH_LEAF_SIZE; ++i)
+        {
+          order.push_back (m_order[node->start + (i < node->count ? i : 0)]);
+        }
+      node->start = start;
+    }
+  m_order.swap (order);
+  m_xMin.resize (m_order.size ());
+  m_xMax.resize (m_order.size ());
+  m_yMin.resize (m_order.size ());
+  m_yMax.resize (m_order.size ());
+  m_zMin.resize (m_order.size ());
+  m_zMax.resize (m_order.size ());
+  for (uint32_t i = 0; i < m_order.size (); ++i)
+    {
+      const Box &box = m_obstacles[m_order[i]];
+      m_xMin[i] = box.xMin;
+      m_xMax[i] = box.xMax;
+      m_yMin[i] = box.yMin;
+      m_yMax[i] = box.yMax;
+      m_zMin[i] = box.zMin;
+      m_zMax[i] = box.zMax;
+    }
+  m_indexed = true;
+}
+
+/**
+ * Orders obstacle indices by the center of their boxes along one axis
+ */
+class BoxCenterLess
+{
+public:
+  /**
+   * \param obstacles the obstacles the indices refer to
+   * \param axis the axis to compare, 0 for x, 1 for y and 2 for z
+   */
+  BoxCenterLess (const std::vector<Box> &obstacles, int axis)
+    : m_obstacles (obstacles),
+      m_axis (axis)
+  {
+  }
+  /**
+   * \param a index of an obstacle
+   * \param b index of another obstacle
+   * \return true if the center of a is before the center of b
+   */
+  bool operator () (uint32_t a, uint32_t b) const
+  {
+    return Center (m_obstacles[a]) < Center (m_obstacles[b]);
+  }
+private:
+  double Center (const Box &box) const
+  {
+    switch (m_axis)
+      {
+      case 0:
+        return box.xMin + box.xMax;
+      case 1:
+        return box.yMin + box.yMax;
+      default:
+        return box.zMin + box.zMax;
+      }
+  }
+  const std::vector<Box> &m_obstacles; //!< obstacles being ordered
+  int m_axis; //!< axis being compared
+};
+
+uint32_t
+ObstacleWorld::BuildNode (uint32_t start, uint32_t end) const
+{
+  uint32_t index = m_nodes.size ();
+  m_nodes.push_back (BvhNode ());
+
+  const Box &first = m_obstacles[m_order[start]];
+  Box bounds = first;
+  Box centers (first.xMin + first.xMax, first.xMin + first.xMax,
+               first.yMin + first.yMax, first.yMin + first.yMax,
+               first.zMin + first.zMax, first.zMin + first.zMax);
+  for (uint32_t i = start + 1; i < end; ++i)
+    {
+      const Box &box = m_obstacles[m_order[i]];
+      bounds.xMin = std::min (bounds.xMin, box.xMin);
+      bounds.xMax = std::max (bounds.xMax, box.xMax);
+      bounds.yMin = std::min (bounds.yMin, box.yMin);
+      bounds.yMax = std::max (bounds.yMax, box.yMax);
+      bounds.zMin = std::min (bounds.zMin, box.zMin);
+      bounds.zMax = std::max (bounds.zMax, box.zMax);
+      centers.xMin = std::min (centers.xMin, box.xMin + box.xMax);
+      centers.xMax = std::max (centers.xMax, box.xMin + box.xMax);
+      centers.yMin = std::min (centers.yMin, box.yMin + box.yMax);
+      centers.yMax = std::max (centers.yMax, box.yMin + box.yMax);
+      centers.zMin = std::min (centers.zMin, box.zMin + box.zMax);
+      centers.zMax = std::max (centers.zMax, box.zMin + box.zMax);
+    }
+  m_nodes[index].bounds = bounds;
+
+  if (end - start <= BVH_LEAF_SIZE)
+    {
+      m_nodes[index].start = start;
+      m_nodes[index].count = end - start;
+      m_nodes[index].right = 0;
+      return index;
+    }
+
+  // split at the median center along the axis with the largest spread
+  double dx = centers.xMax - centers.xMin;
+  double dy = centers.yMax - centers.yMin;
+  double dz = centers.zMax - centers.zMin;
+  int axis = (dx >= dy && dx >= dz) ? 0 : (dy >= dz ? 1 : 2);
+  uint32_t middle = start + (end - start) / 2;
+  std::nth_element (m_order.begin () + start, m_order.begin () + middle,
+                    m_order.begin () + end, BoxCenterLess (m_obstacles, axis));
+
+  BuildNode (start, middle);
+  uint32_t right = BuildNode (middle, end);
+  m_nodes[index].start = start;
+  m_nodes[index].count = 0;
+  m_nodes[index].right = right;
+  return index;
+}
+
+/**
+ * \param position the coordinate of the position on an axis
+ * \param velocity the coordinate of the velocity on the same axis
+ * \param min the lower bound on the axis
+ * \param max the upper bound on the axis
+ * \return the time to leave the bounds on this axis, infinite if never
+ */
+static inline double
+ExitTime (double position, double velocity, double min, double max)
+{
+  if (velocity > 0.0)
+    {
+      return std::max (0.0, (max - position) / velocity);
+    }
+  else if (velocity < 0.0)
+    {
+      return std::max (0.0, (min - position) / velocity);
+    }
+  return std::numeric_limits<double>::infinity ();
+}
+
+/**
+ * \param velocity the velocity to reflect
+ * \param side the side to reflect it on
+ */
+static inline void
+Reflect (Vector &velocity, Box::Side side)
+{
+  switch (side)
+    {
+    case Box::RIGHT:
+    case Box::LEFT:
+      velocity.x = -velocity.x;
+      break;
+    case Box::TOP:
+    case Box::BOTTOM:
+      velocity.y = -velocity.y;
+      break;
+    case Box::UP:
+    case Box::DOWN:
+      velocity.z = -velocity.z;
+      break;
+    }
+}
+
+WalkEvent
+CalculateWalkEvent (const Box &bounds, const ObstacleWorld *obstacles,
+                    const Vector &position, const Vector &velocity, double timeout)
+{
+  WalkEvent event;
+  event.type = WalkEvent::TIMEOUT;
+  event.delay = timeout;
+  event.side = Box::RIGHT;
+  event.obstacle = -1;
+  event.normal = Vector (0.0, 0.0, 0.0);
+  event.velocity = velocity;
+
+  double exit[3];
+  Box::Side sides[3];
+  exit[0] = ExitTime (position.x, velocity.x, bounds.xMin, bounds.xMax);
+  sides[0] = velocity.x > 0.0 ? Box::RIGHT : Box::LEFT;
+  exit[1] = ExitTime (position.y, velocity.y, bounds.yMin, bounds.yMax);
+  sides[1] = velocity.y > 0.0 ? Box::TOP : Box::BOTTOM;
+  exit[2] = ExitTime (position.z, velocity.z, bounds.zMin, bounds.zMax);
+  sides[2] = velocity.z > 0.0 ? Box::UP : Box::DOWN;
+  double boundsDelay = std::min (exit[0], std::min (exit[1], exit[2]));
+  double limit = std::min (boundsDelay, timeout);
+
+  double speed = std::sqrt (velocity.x * velocity.x + velocity.y * velocity.y + velocity.z * velocity.z);
+  if (obstacles != 0 && speed > 0.0)
+    {
+      // the limit is finite: a moving position leaves the bounds
+      double distance = limit * speed;
+      Box::Side side;
+      Vector normal;
+      int32_t obstacle = obstacles->FindClosestCollision (position, velocity, distance, side, normal);
+      if (obstacle != -1)
+        {
+          event.type = WalkEvent::OBSTACLE;
+          event.delay = std::min (distance / speed, limit);
+          event.side = side;
+          event.obstacle = obstacle;
+          event.normal = normal;
+          if (obstacles->IsBox (obstacle))
+            {
+              Reflect (event.velocity, side);
+            }
+          else
+            {
+              double dot = 2.0 * (velocity.x * normal.x + velocity.y * normal.y + velocity.z * normal.z);
+              event.velocity = Vector (velocity.x - dot * normal.x,
+                                       velocity.y - dot * normal.y,
+                                       velocity.z - dot * normal.z);
+            }
+          return event;
+        }
+    }
+
+  if (boundsDelay <= timeout)
+    {
+      event.type = WalkEvent::BOUNDS;
+      event.delay = boundsDelay;
+      for (int k = 2; k >= 0; k--)
+        {
+          if (exit[k] == boundsDelay)
+            {
+              event.side = sides[k];
+              Vector outward = SideNormal (sides[k]);
+              event.normal = Vector (-outward.x, -outward.y, -outward.z);
+              Reflect (event.velocity, sides[k]);
+            }
+        }
+    }
+  return event;
+}
+
+} // namespace ns3
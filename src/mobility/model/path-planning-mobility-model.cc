@@ -0,0 +1,166 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#include "path-planning-mobility-model.h"
+#include "ns3/simulator.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PathPlanningMobilityModel");
+
+NS_OBJECT_ENSURE_REGISTERED (PathPlanningMobilityModel);
+
+/**
+ * Number of targets drawn before giving up on reaching one, when the
+ * targets drawn are unreachable.
+ */
+static const uint32_t MAX_TARGET_DRAWS = 100;
+
+TypeId
+PathPlanningMobilityModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PathPlanningMobilityModel")
+    .SetParent<WaypointMobilityModel> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<PathPlanningMobilityModel> ()
+    .AddAttribute ("Navigation",
+                   "The grid the paths are planned on, shared with the other mobility models.",
+                   PointerValue (),
+                   MakePointerAccessor (&PathPlanningMobilityModel::m_navigation),
+                   MakePointerChecker<NavigationGrid> ())
+    .AddAttribute ("Speed",
+                   "A random variable used to pick the speed of each path (m/s).",
+                   StringValue ("ns3::ConstantRandomVariable[Constant=10.0]"),
+                   MakePointerAccessor (&PathPlanningMobilityModel::m_speed),
+                   MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("Pause",
+                   "A random variable used to pick the pause at each target drawn (s).",
+                   StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"),
+                   MakePointerAccessor (&PathPlanningMobilityModel::m_pause),
+                   MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("Targets",
+                   "The position allocator used to draw the targets, or none to add them with AddTarget.",
+                   PointerValue (),
+                   MakePointerAccessor (&PathPlanningMobilityModel::m_targets),
+                   MakePointerChecker<PositionAllocator> ());
+  return tid;
+}
+
+PathPlanningMobilityModel::PathPlanningMobilityModel ()
+  : m_planned (false)
+{
+}
+
+PathPlanningMobilityModel::~PathPlanningMobilityModel ()
+{
+}
+
+void
+PathPlanningMobilityModel::DoInitialize (void)
+{
+  if (m_targets != 0)
+    {
+      NextTarget ();
+    }
+  WaypointMobilityModel::DoInitialize ();
+}
+
+void
+PathPlanningMobilityModel::DoDispose (void)
+{
+  m_event.Cancel ();
+  m_navigation = 0;
+  m_targets = 0;
+  WaypointMobilityModel::DoDispose ();
+}
+
+int64_t
+PathPlanningMobilityModel::DoAssignStreams (int64_t stream)
+{
+  m_speed->SetStream (stream);
+  m_pause->SetStream (stream + 1);
+  int64_t targetStreams = 0;
+  if (m_targets != 0)
+    {
+      targetStreams = m_targets->AssignStreams (stream + 2);
+    }
+  return 2 + targetStreams;
+}
+
+bool
+PathPlanningMobilityModel::AddTarget (const Vector &target)
+{
+  NS_LOG_FUNCTION (this << target);
+  NS_ASSERT_MSG (m_navigation != 0, "No navigation grid set");
+  Time now = Simulator::Now ();
+  bool standing = !m_planned || m_arrival < now;
+  Vector start = standing ? GetPosition () : m_end;
+  Time time = standing ? now : m_arrival;
+
+  if (!m_navigation->FindPath (start, target, m_path))
+    {
+      NS_LOG_DEBUG ("No path from " << start << " to " << target);
+      return false;
+    }
+  if (standing)
+    {
+      AddWaypoint (Waypoint (now, start));
+    }
+  double speed = m_speed->GetValue ();
+  NS_ASSERT (speed > 0.0);
+  Time departure = time;
+  double elapsed = 0.0;
+  for (uint32_t i = 1; i < m_path.size (); ++i)
+    {
+      elapsed += CalculateDistance (m_path[i - 1], m_path[i]) / speed;
+      Time corner = departure + Seconds (elapsed);
+      // corners closer than the time resolution are merged, since the
+      // waypoints must be strictly ordered
+      if (corner > time)
+        {
+          AddWaypoint (Waypoint (corner, m_path[i]));
+          time = corner;
+        }
+    }
+  m_planned = true;
+  m_end = m_path.back ();
+  m_arrival = time;
+  return true;
+}
+
+void
+PathPlanningMobilityModel::NextTarget (void)
+{
+  for (uint32_t draw = 0; draw < MAX_TARGET_DRAWS; ++draw)
+    {
+      if (AddTarget (m_targets->GetNext ()))
+        {
+          Time pause = Seconds (m_pause->GetValue ());
+          m_event = Simulator::Schedule (m_arrival - Simulator::Now () + pause,
+                                         &PathPlanningMobilityModel::NextTarget, this);
+          return;
+        }
+    }
+  NS_LOG_WARN ("No reachable target drawn, the node stops");
+}
+
+} // namespace ns3
@@ -0,0 +1,106 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#ifndef PATH_PLANNING_MOBILITY_MODEL_H
+#define PATH_PLANNING_MOBILITY_MODEL_H
+
+#include <vector>
+#include "waypoint-mobility-model.h"
+#include "navigation-grid.h"
+#include "position-allocator.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/ptr.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Fly between targets along paths planned around the obstacles.
+ *
+ * Each target is reached along a path planned by the NavigationGrid set
+ * as "Navigation", shared by every node, and flown at a speed drawn from
+ * "Speed" for the whole path. The corners of the path are added as
+ * waypoints, so that the motion is the one of a WaypointMobilityModel.
+ *
+ * Targets are either given one after the other with AddTarget, which
+ * plans from the end of the previous path, or drawn from the position
+ * allocator set as "Targets": the node then pauses for a time drawn from
+ * "Pause" at each target, and flies to the next one, like the
+ * RandomWaypointMobilityModel. Use an ObstacleFreeBoxPositionAllocator to
+ * draw targets outside of the obstacles.
+ * \code
+    Ptr<NavigationGrid> navigation = CreateObject<NavigationGrid> ();
+    navigation->SetAttribute ("Obstacles", PointerValue (world));
+    navigation->SetAttribute ("Bounds", BoxValue (bounds));
+
+    MobilityHelper mobility;
+    mobility.SetMobilityModel ("ns3::PathPlanningMobilityModel",
+      "Navigation", PointerValue (navigation),
+      "Targets", PointerValue (targets));
+ * \endcode
+ */
+class PathPlanningMobilityModel : public WaypointMobilityModel
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  PathPlanningMobilityModel ();
+  virtual ~PathPlanningMobilityModel ();
+
+  /**
+   * \param target the position to fly to, outside of every obstacle
+   * \return true if a path to the target was found and added, false
+   *         if the target is unreachable
+   *
+   * The path starts at the end of the previous one, or at the current
+   * position if the node stands still.
+   */
+  bool AddTarget (const Vector &target);
+
+protected:
+  virtual void DoInitialize (void);
+  virtual void DoDispose (void);
+
+private:
+  virtual int64_t DoAssignStreams (int64_t stream);
+  /**
+   * Fly to the next target of the position allocator, and schedule the
+   * following one after the pause.
+   */
+  void NextTarget (void);
+
+  Ptr<NavigationGrid> m_navigation; //!< shared grid the paths are planned on
+  Ptr<RandomVariableStream> m_speed; //!< speed of each path (m/s)
+  Ptr<RandomVariableStream> m_pause; //!< pause at each target drawn from m_targets (s)
+  Ptr<PositionAllocator> m_targets; //!< targets to draw, or 0
+  std::vector<Vector> m_path; //!< corners of the last path planned
+  bool m_planned; //!< whether a path was added
+  Vector m_end; //!< end of the last path added
+  Time m_arrival; //!< time the end of the last path is reached
+  EventId m_event; //!< event ID of the next target drawn
+};
+
+} // namespace ns3
+
+#endif /* PATH_PLANNING_MOBILITY_MODEL_H */
@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#include "piecewise-linear-trajectory.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PiecewiseLinearTrajectory");
+
+PiecewiseLinearTrajectory::PiecewiseLinearTrajectory ()
+  : m_first (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+PiecewiseLinearTrajectory::AddLeg (Time start, const Vector &origin, const Vector &velocity)
+{
+  NS_LOG_FUNCTION (this << start << origin << velocity);
+  NS_ASSERT_MSG (m_first == m_legs.size () || m_legs.back ().start <= start,
+                 "Legs must be added in start order");
+  if (m_first < m_legs.size () && m_legs.back ().start == start)
+    {
+      m_legs.pop_back ();
+    }
+  Leg leg;
+  leg.start = start;
+  leg.origin = origin;
+  leg.velocity = velocity;
+  m_legs.push_back (leg);
+}
+
+uint32_t
+PiecewiseLinearTrajectory::GetNLegs (void) const
+{
+  return m_legs.size () - m_first;
+}
+
+Time
+PiecewiseLinearTrajectory::GetLastStart (void) const
+{
+  NS_ASSERT (m_first < m_legs.size ());
+  return m_legs.back ().start;
+}
+
+uint32_t
+PiecewiseLinearTrajectory::FindLeg (Time t) const
+{
+  NS_ASSERT_MSG (m_first < m_legs.size () && m_legs[m_first].start <= t,
+                 "No leg in progress at " << t);
+  // the last leg is the one in progress in the common case of a query
+  // at the current time
+  if (m_legs.back ().start <= t)
+    {
+      return m_legs.size () - 1;
+    }
+  uint32_t low = m_first;
+  uint32_t high = m_legs.size () - 1;
+  // invariant: m_legs[low].start <= t < m_legs[high].start
+  while (high - low > 1)
+    {
+      uint32_t middle = low + (high - low) / 2;
+      if (m_legs[middle].start <= t)
+        {
+          low = middle;
+        }
+      else
+        {
+          high = middle;
+        }
+    }
+  return low;
+}
+
+Vector
+PiecewiseLinearTrajectory::GetPosition (Time t) const
+{
+  const Leg &leg = m_legs[FindLeg (t)];
+  double deltaS = (t - leg.start).GetSeconds ();
+  return Vector (leg.origin.x + leg.velocity.x * deltaS,
+                 leg.origin.y + leg.velocity.y * deltaS,
+                 leg.origin.z + leg.velocity.z * deltaS);
+}
+
+Vector
+PiecewiseLinearTrajectory::GetPosition (Time t, const Box &bounds) const
+{
+  Vector position = GetPosition (t);
+  position.x = std::max (bounds.xMin, std::min (bounds.xMax, position.x));
+  position.y = std::max (bounds.yMin, std::min (bounds.yMax, position.y));
+  position.z = std::max (bounds.zMin, std::min (bounds.zMax, position.z));
+  return position;
+}
+
+Vector
+PiecewiseLinearTrajectory::GetVelocity (Time t) const
+{
+  return m_legs[FindLeg (t)].velocity;
+}
+
+void
+PiecewiseLinearTrajectory::DiscardBefore (Time t)
+{
+  NS_LOG_FUNCTION (this << t);
+  while (m_first + 1 < m_legs.size () && m_legs[m_first + 1].start <= t)
+    {
+      m_first++;
+    }
+  // compact once the discarded legs outnumber the kept ones, so that
+  // discarding is amortized constant time per leg
+  if (m_first > 0 && m_first >= m_legs.size () - m_first)
+    {
+      m_legs.erase (m_legs.begin (), m_legs.begin () + m_first);
+      m_first = 0;
+    }
+}
+
+void
+PiecewiseLinearTrajectory::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_legs.clear ();
+  m_first = 0;
+}
+
+} // namespace ns3
@@ -20,9 +20,11 @@
 #include "ns3/simulator.h"
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include "ns3/log.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
 #include "random-direction-3d-mobility-model.h"
 
 namespace ns3 {
@@ -42,6 +44,8 @@ namespace ns3 {
 	    .AddAttribute ("Bounds", "The 3d bounding box",BoxValue (Box (-100, 100, -100, 100, 0, 100)),MakeBoxAccessor (&RandomDirection3dMobilityModel::m_bounds),MakeBoxChecker ())
 	    .AddAttribute ("Speed", "A random variable to control the speed (m/s).",StringValue ("ns3::UniformRandomVariable[Min=1.0|Max=2.0]"),MakePointerAccessor (&RandomDirection3dMobilityModel::m_speed),MakePointerChecker<RandomVariableStream> ())
 	    .AddAttribute ("Pause", "A random variable to control the pause (s).",StringValue ("ns3::ConstantRandomVariable[Constant=2.0]"),MakePointerAccessor (&RandomDirection3dMobilityModel::m_pause),MakePointerChecker<RandomVariableStream> ())
+	    .AddAttribute ("Obstacles","The set of obstacles, shared with the other mobility models.",PointerValue (),MakePointerAccessor (&RandomDirection3dMobilityModel::m_obstacles),MakePointerChecker<ObstacleWorld> ())
+	    .AddAttribute ("Lazy","Compute the trajectory only when the position is queried, instead of scheduling an event at every change of course.",BooleanValue (false),MakeBooleanAccessor (&RandomDirection3dMobilityModel::m_lazy),MakeBooleanChecker ())
 	    ;
     return tid;
   }
@@ -50,91 +54,142 @@ namespace ns3 {
   {
     m_direction = CreateObject <UniformRandomVariable> ();
     m_pitch = CreateObject <UniformRandomVariable> ();
+    m_trajectory.AddLeg (Simulator::Now (), Vector (0.0, 0.0, 0.0), Vector (0.0, 0.0, 0.0));
+    m_next = Time::Max ();
+    m_nextAction = ACTION_INITIALIZE;
     m_closestObstacle = -1;
   }
 
   void
   RandomDirection3dMobilityModel::AddObstacle (const Box &obstacle)
   {
-    m_obstacles.push_back(obstacle);
+    if (m_obstacles == 0)
+      {
+	m_obstacles = CreateObject<ObstacleWorld> ();
+      }
+    m_obstacles->AddObstacle (obstacle);
   }
 
   void
   RandomDirection3dMobilityModel::DoDispose (void)
   {
+    m_obstacles = 0;
     // chain up.
     MobilityModel::DoDispose ();
   }
   void
   RandomDirection3dMobilityModel::DoInitialize (void)
   {
-    DoInitializePrivate ();
+    m_next = Simulator::Now ();
+    m_nextAction = ACTION_INITIALIZE;
+    Advance (m_next);
     MobilityModel::DoInitialize ();
   }
 
   void
-  RandomDirection3dMobilityModel::DoInitializePrivate (void)
+  RandomDirection3dMobilityModel::Update (void)
+  {
+    Advance (Simulator::Now ());
+  }
+
+  void
+  RandomDirection3dMobilityModel::Advance (Time now)
+  {
+    if (m_next > now)
+      {
+	return;
+      }
+    while (m_next <= now)
+      {
+	switch (m_nextAction)
+	{
+	  case ACTION_INITIALIZE:
+	    DoInitializePrivate (m_next);
+	    break;
+	  case ACTION_PAUSE:
+	    BeginPause (m_next);
+	    break;
+	  case ACTION_RESET:
+	    ResetDirectionAndSpeed (m_next);
+	    break;
+	}
+      }
+    m_trajectory.DiscardBefore (now);
+    if (!m_lazy)
+      {
+	m_event.Cancel ();
+	m_event = Simulator::Schedule (m_next - now, &RandomDirection3dMobilityModel::Update, this);
+      }
+    NotifyCourseChange ();
+  }
+
+  void
+  RandomDirection3dMobilityModel::DoInitializePrivate (Time at)
   {
     double direction = m_direction->GetValue (0, 2 * M_PI);
     double pitch = m_direction->GetValue (0, M_PI);
-    SetDirectionAndPitchAndSpeed (direction, pitch);
+    SetDirectionAndPitchAndSpeed (at, direction, pitch);
   }
 
   void
-  RandomDirection3dMobilityModel::BeginPause (void)
+  RandomDirection3dMobilityModel::BeginPause (Time at)
   {
-    m_helper.Update ();
-    m_helper.Pause ();
+    m_trajectory.AddLeg (at, m_trajectory.GetPosition (at), Vector (0.0, 0.0, 0.0));
     Time pause = Seconds (m_pause->GetValue ());
-    m_event.Cancel ();
-    m_event = Simulator::Schedule (pause, &RandomDirection3dMobilityModel::ResetDirectionAndSpeed, this);
-    NotifyCourseChange ();
+    m_next = at + pause;
+    m_nextAction = ACTION_RESET;
   }
 
   void
-  RandomDirection3dMobilityModel::SetDirectionAndPitchAndSpeed (double direction, double pitch)
+  RandomDirection3dMobilityModel::SetDirectionAndPitchAndSpeed (Time at, double direction, double pitch)
   {
     NS_LOG_FUNCTION_NOARGS ();
-    m_helper.UpdateWithBounds (m_bounds);
-    Vector position = m_helper.GetCurrentPosition ();
+    Vector position = m_trajectory.GetPosition (at, m_bounds);
     double speed = m_speed->GetValue ();
     const Vector vel (std::cos (direction) * std::sin (pitch) * speed,
 		      std::sin (direction) * std::sin (pitch) * speed,
 		      std::cos (pitch) * speed);
-    m_helper.SetVelocity (vel);
-    m_helper.Unpause ();
-    Vector next = m_bounds.CalculateIntersection (position, vel);
+    m_trajectory.AddLeg (at, position, vel);
 
-    double distance = CalculateDistance (position, next);
-    m_closestObstacle = -1;
-    int obstacle_id = 0;
-    for (std::vector<Box>::iterator it = m_obstacles.begin() ; it != m_obstacles.end(); ++it)
+    WalkEvent event = CalculateWalkEvent (m_bounds, PeekPointer (m_obstacles), position, vel,
+                                          std::numeric_limits<double>::infinity ());
+    m_closestObstacle = event.obstacle;
+    m_closestSide = event.side;
+    m_closestNormal = event.normal;
+    if (event.type == WalkEvent::TIMEOUT)
       {
-	Vector collision;
-	if (it->WillCollide(position,vel,collision) && CalculateDistance(position,collision) < distance)
-	  {
-	    distance = CalculateDistance(position,collision);
-	    m_closestObstacle = obstacle_id;
-	  }
-	obstacle_id++;
+	// a still node never reaches anything
+	m_next = Time::Max ();
       }
-
-    Time delay = Seconds (distance / speed);
-    m_event.Cancel ();
-    m_event = Simulator::Schedule (delay, &RandomDirection3dMobilityModel::BeginPause, this);
-    NotifyCourseChange ();
+    else
+      {
+	m_next = at + Seconds (event.delay);
+      }
+    m_nextAction = ACTION_PAUSE;
   }
   void
-  RandomDirection3dMobilityModel::ResetDirectionAndSpeed (void)
+  RandomDirection3dMobilityModel::ResetDirectionAndSpeed (Time at)
   {
     double direction = m_direction->GetValue (0, 2*M_PI);
     double pitch = m_pitch->GetValue (0, M_PI);
 
-    m_helper.UpdateWithBounds (m_bounds);
-    Vector position = m_helper.GetCurrentPosition ();
+    const Vector &n = m_closestNormal;
 
-    if (m_closestObstacle > -1) {
-	switch (m_obstacles[m_closestObstacle].GetClosestSide(position))
+    if (m_closestObstacle > -1 && (n.x != 0.0) + (n.y != 0.0) + (n.z != 0.0) > 1) {
+	// oblique face of an obstacle shape: leave it through the half
+	// space in front of it
+	Vector u (std::cos (direction) * std::sin (pitch),
+		  std::sin (direction) * std::sin (pitch),
+		  std::cos (pitch));
+	double dot = u.x * n.x + u.y * n.y + u.z * n.z;
+	if (dot < 0.0)
+	  {
+	    u = Vector (u.x - 2 * dot * n.x, u.y - 2 * dot * n.y, u.z - 2 * dot * n.z);
+	  }
+	direction = std::atan2 (u.y, u.x);
+	pitch = std::acos (std::max (-1.0, std::min (1.0, u.z)));
+    }else if (m_closestObstacle > -1) {
+	switch (m_closestSide)
 	{
 	  case Box::RIGHT:
 	    direction += -M_PI / 2;
@@ -156,7 +211,7 @@ namespace ns3 {
 	    break;
 	}
     }else{
-	switch (m_bounds.GetClosestSide (position))
+	switch (m_closestSide)
 	{
 	  case Box::RIGHT:
 	    direction += M_PI / 2;
@@ -179,26 +234,36 @@ namespace ns3 {
 	}
     }
 
-    SetDirectionAndPitchAndSpeed (direction, pitch);
+    SetDirectionAndPitchAndSpeed (at, direction, pitch);
   }
   Vector
   RandomDirection3dMobilityModel::DoGetPosition (void) const
   {
-    m_helper.UpdateWithBounds (m_bounds);
-    return m_helper.GetCurrentPosition ();
+    Time now = Simulator::Now ();
+    // catching up with the current time only extends the trajectory
+    const_cast<RandomDirection3dMobilityModel *> (this)->Advance (now);
+    return m_trajectory.GetPosition (now, m_bounds);
   }
   void
   RandomDirection3dMobilityModel::DoSetPosition (const Vector &position)
   {
-    m_helper.SetPosition (position);
+    m_trajectory.Clear ();
+    m_trajectory.AddLeg (Simulator::Now (), position, Vector (0.0, 0.0, 0.0));
+    m_next = Simulator::Now ();
+    m_nextAction = ACTION_INITIALIZE;
     Simulator::Remove (m_event);
     m_event.Cancel ();
-    m_event = Simulator::ScheduleNow (&RandomDirection3dMobilityModel::DoInitializePrivate, this);
+    if (!m_lazy)
+      {
+	m_event = Simulator::ScheduleNow (&RandomDirection3dMobilityModel::Update, this);
+      }
   }
   Vector
   RandomDirection3dMobilityModel::DoGetVelocity (void) const
   {
-    return m_helper.GetVelocity ();
+    Time now = Simulator::Now ();
+    const_cast<RandomDirection3dMobilityModel *> (this)->Advance (now);
+    return m_trajectory.GetVelocity (now);
   }
   int64_t
   RandomDirection3dMobilityModel::DoAssignStreams (int64_t stream)
@@ -25,9 +25,10 @@
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
 #include "ns3/box.h"
+#include "ns3/obstacle-world.h"
 #include "ns3/random-variable-stream.h"
 #include "mobility-model.h"
-#include "constant-velocity-helper.h"
+#include "piecewise-linear-trajectory.h"
 
 namespace ns3 {
 
@@ -40,6 +41,10 @@ namespace ns3 {
  * then travels in the specific direction until it reaches one of
  * the boundaries of the model. When it reaches the boundary, it pauses,
  * selects a new direction and speed, aso.
+ *
+ * As in RandomWalk3dMobilityModel, the "Lazy" attribute makes the
+ * trajectory be computed only when a query goes past its known part,
+ * instead of scheduling an event at every pause and departure.
  */
 class RandomDirection3dMobilityModel : public MobilityModel
 {
@@ -53,6 +58,9 @@ public:
   /**
    * \param obstacle an obstacle to be added
    *
+   * The obstacle is added to the ObstacleWorld set through the
+   * "Obstacles" attribute, which is shared by every model using it.
+   * If no world was set, a private one is created for this model.
    * The box must be inside the boundaries,
    * this method does not verify it.
    * This method assumes the box has dimensions > 0
@@ -60,23 +68,45 @@ public:
   void AddObstacle(const Box &obstacle);
 
 private:
+  /** The change of course pending at the end of the known trajectory */
+  enum Action {
+    ACTION_INITIALIZE,
+    ACTION_PAUSE,
+    ACTION_RESET
+  };
+  /**
+   * Event handler, compute the trajectory up to the current time
+   */
+  void Update (void);
+  /**
+   * Apply every change of course due up to the given time, and notify
+   * the course change if there was one.
+   * \param now the current time
+   */
+  void Advance (Time now);
   /**
    * Set a new direction and speed
+   * \param at the time of the change of course
    */
-  void ResetDirectionAndSpeed (void);
+  void ResetDirectionAndSpeed (Time at);
   /**
-   * Pause, cancel currently scheduled event, schedule end of pause event
+   * Pause, and set the end of the pause as next change of course
+   * \param at the time the pause starts
    */
-  void BeginPause (void);
+  void BeginPause (Time at);
   /**
-   * Set new velocity and direction, and schedule next pause event  
+   * Set new velocity and direction, and set the next pause as next
+   * change of course
+   * \param at the time of the change of course
    * \param direction (radians)
+   * \param pitch (radians)
    */
-  void SetDirectionAndPitchAndSpeed (double direction, double pitch);
+  void SetDirectionAndPitchAndSpeed (Time at, double direction, double pitch);
   /**
    * Sets a new random direction and calls SetDirectionAndSpeed
+   * \param at the time of the change of course
    */
-  void DoInitializePrivate (void);
+  void DoInitializePrivate (Time at);
   virtual void DoDispose (void);
   virtual void DoInitialize (void);
   virtual Vector DoGetPosition (void) const;
@@ -88,12 +118,17 @@ private:
   Ptr<RandomVariableStream> m_speed; //!< a random variable to control speed
   Ptr<RandomVariableStream> m_pause; //!< a random variable to control pause 
   EventId m_event; //!< event ID of next scheduled event
-  ConstantVelocityHelper m_helper; //!< helper for velocity computations
+  PiecewiseLinearTrajectory m_trajectory; //!< known part of the trajectory
+  bool m_lazy; //!< whether the trajectory is computed only when queried
+  Time m_next; //!< time of the next change of course
+  enum Action m_nextAction; //!< next change of course
   Box m_bounds; //!< Bounds of the area to cruise
 
   Ptr<UniformRandomVariable> m_pitch; //!< rv for picking pitch
-  mutable std::vector<Box> m_obstacles; // list of obstacles
+  Ptr<ObstacleWorld> m_obstacles; //!< obstacles shared with the other models
   int m_closestObstacle; // if collision is detected, this wil be set as the id of the obstacle in the array
+  Box::Side m_closestSide; //!< side of the closest obstacle hit, if any
+  Vector m_closestNormal; //!< normal of the face of the closest obstacle hit, if any
 };
 
 } // namespace ns3
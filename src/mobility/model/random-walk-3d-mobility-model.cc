@@ -20,10 +20,12 @@
 #include "random-walk-3d-mobility-model.h"
 #include "ns3/enum.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include <algorithm>
 #include <cmath>
 
 namespace ns3 {
@@ -45,35 +47,81 @@ namespace ns3 {
 	    .AddAttribute ("Mode","The mode indicates the condition used to ""change the current speed and direction",EnumValue (RandomWalk3dMobilityModel::MODE_DISTANCE),MakeEnumAccessor (&RandomWalk3dMobilityModel::m_mode),MakeEnumChecker (RandomWalk3dMobilityModel::MODE_DISTANCE, "Distance",RandomWalk3dMobilityModel::MODE_TIME, "Time"))
 	    .AddAttribute ("Direction","A random variable used to pick the direction (radians).",StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=6.283184]"),MakePointerAccessor (&RandomWalk3dMobilityModel::m_direction),MakePointerChecker<RandomVariableStream> ())
 	    .AddAttribute ("Pitch","A random variable used to pick the pitch (radians).",StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=3.141592]"),MakePointerAccessor (&RandomWalk3dMobilityModel::m_pitch),MakePointerChecker<RandomVariableStream> ())
-	    .AddAttribute ("Speed","A random variable used to pick the speed (m/s).",StringValue ("ns3::UniformRandomVariable[Min=2.0|Max=4.0]"),MakePointerAccessor (&RandomWalk3dMobilityModel::m_speed),MakePointerChecker<RandomVariableStream> ());
+	    .AddAttribute ("Speed","A random variable used to pick the speed (m/s).",StringValue ("ns3::UniformRandomVariable[Min=2.0|Max=4.0]"),MakePointerAccessor (&RandomWalk3dMobilityModel::m_speed),MakePointerChecker<RandomVariableStream> ())
+	    .AddAttribute ("Obstacles","The set of obstacles, shared with the other mobility models.",PointerValue (),MakePointerAccessor (&RandomWalk3dMobilityModel::m_obstacles),MakePointerChecker<ObstacleWorld> ())
+	    .AddAttribute ("Lazy","Compute the walk only when the position is queried, instead of scheduling an event at every change of course.",BooleanValue (false),MakeBooleanAccessor (&RandomWalk3dMobilityModel::m_lazy),MakeBooleanChecker ());
     return tid;
   }
 
+  RandomWalk3dMobilityModel::RandomWalk3dMobilityModel ()
+  {
+    m_trajectory.AddLeg (Simulator::Now (), Vector (0.0, 0.0, 0.0), Vector (0.0, 0.0, 0.0));
+    m_next = Time::Max ();
+    m_nextAction = ACTION_WALK;
+  }
+
   void
   RandomWalk3dMobilityModel::AddObstacle (const Box &obstacle)
   {
-    m_obstacles.push_back(obstacle);
+    if (m_obstacles == 0)
+      {
+	m_obstacles = CreateObject<ObstacleWorld> ();
+      }
+    m_obstacles->AddObstacle (obstacle);
   }
 
   void
   RandomWalk3dMobilityModel::DoInitialize (void)
   {
-    DoInitializePrivate ();
+    m_next = Simulator::Now ();
+    m_nextAction = ACTION_WALK;
+    Advance (m_next);
     MobilityModel::DoInitialize ();
   }
 
   void
-  RandomWalk3dMobilityModel::DoInitializePrivate (void)
+  RandomWalk3dMobilityModel::Update (void)
+  {
+    Advance (Simulator::Now ());
+  }
+
+  void
+  RandomWalk3dMobilityModel::Advance (Time now)
+  {
+    if (m_next > now)
+      {
+	return;
+      }
+    while (m_next <= now)
+      {
+	if (m_nextAction == ACTION_WALK)
+	  {
+	    ChangeDirection (m_next);
+	  }
+	else
+	  {
+	    Rebound (m_next, m_nextTimeLeft);
+	  }
+      }
+    m_trajectory.DiscardBefore (now);
+    if (!m_lazy)
+      {
+	m_event.Cancel ();
+	m_event = Simulator::Schedule (m_next - now, &RandomWalk3dMobilityModel::Update, this);
+      }
+    NotifyCourseChange ();
+  }
+
+  void
+  RandomWalk3dMobilityModel::ChangeDirection (Time at)
   {
-    m_helper.Update ();
+    Vector position = m_trajectory.GetPosition (at);
     double speed = m_speed->GetValue ();
     double direction = m_direction->GetValue ();
     double pitch = m_pitch->GetValue ();
     Vector vector (std::cos (direction) * std::sin(pitch) * speed,
 		   std::sin (direction) * std::sin(pitch) * speed,
 		   std::cos (pitch) * speed);
-    m_helper.SetVelocity (vector);
-    m_helper.Unpause ();
 
     Time delayLeft;
     if (m_mode == RandomWalk3dMobilityModel::MODE_TIME)
@@ -84,124 +132,74 @@ namespace ns3 {
       {
 	delayLeft = Seconds (m_modeDistance / speed);
       }
-    DoWalk (delayLeft);
+    DoWalk (at, position, vector, delayLeft);
   }
 
   void
-  RandomWalk3dMobilityModel::DoWalk (Time delayLeft)
+  RandomWalk3dMobilityModel::DoWalk (Time at, const Vector &position, const Vector &speed, Time delayLeft)
   {
-    Vector position = m_helper.GetCurrentPosition ();
-    Vector speed = m_helper.GetVelocity ();
+    m_trajectory.AddLeg (at, position, speed);
 
-    double speedM = std::sqrt(speed.x*speed.x + speed.y*speed.y + speed.z*speed.z);
-
-    Vector nextPosition = position;
-    nextPosition.x += speed.x * delayLeft.GetSeconds ();
-    nextPosition.y += speed.y * delayLeft.GetSeconds ();
-    nextPosition.z += speed.z * delayLeft.GetSeconds ();
-
-    m_event.Cancel ();
-
-    if (m_bounds.IsInside (nextPosition))
+    WalkEvent event = CalculateWalkEvent (m_bounds, PeekPointer (m_obstacles), position, speed, delayLeft.GetSeconds ());
+    if (event.type == WalkEvent::TIMEOUT)
       {
-	double distance = CalculateDistance (position, nextPosition);
-	m_closestObstacle = -1;
-	int obstacle_id = 0;
-	for (std::vector<Box>::iterator it = m_obstacles.begin() ; it != m_obstacles.end(); ++it)
-	  {
-	    Vector collision;
-	    if (it->WillCollide(position,speed,collision) && CalculateDistance(position,collision) < distance)
-	      {
-		distance = CalculateDistance(position,collision);
-		m_closestObstacle = obstacle_id;
-	      }
-	    obstacle_id++;
-	  }
-	Time delay_tmp = Seconds(distance/speedM);
-	m_event = Simulator::Schedule (delay_tmp, &RandomWalk3dMobilityModel::DoInitializePrivate, this);
+	m_next = at + delayLeft;
+	m_nextAction = ACTION_WALK;
       }
     else
       {
-	nextPosition = m_bounds.CalculateIntersection (position, speed);
-	double distance = CalculateDistance (position, nextPosition);
-	m_closestObstacle = -1;
-	int obstacle_id = 0;
-	for (std::vector<Box>::iterator it = m_obstacles.begin() ; it != m_obstacles.end(); ++it)
-	  {
-	    Vector collision;
-	    if (it->WillCollide(position,speed,collision) && CalculateDistance(position,collision) < distance)
-	      {
-		distance = CalculateDistance(position,collision);
-		m_closestObstacle = obstacle_id;
-	      }
-	    obstacle_id++;
-	  }
-	Time delay_tmp = Seconds(distance/speedM);
-
-	m_event = Simulator::Schedule (delay_tmp, &RandomWalk3dMobilityModel::Rebound, this,
-				       delayLeft - delay_tmp);
+	// the bounds and the obstacles are both rebounded on, keeping
+	// the rest of the walk
+	Time delay = std::min (Seconds (event.delay), delayLeft);
+	m_next = at + delay;
+	m_nextAction = ACTION_REBOUND;
+	m_nextTimeLeft = delayLeft - delay;
+	m_nextVelocity = event.velocity;
       }
-    NotifyCourseChange ();
   }
 
   void
-  RandomWalk3dMobilityModel::Rebound (Time delayLeft)
+  RandomWalk3dMobilityModel::Rebound (Time at, Time delayLeft)
   {
-    m_helper.UpdateWithBounds (m_bounds);
-    Vector position = m_helper.GetCurrentPosition ();
-    Vector speed = m_helper.GetVelocity ();
-    Box bx;
-    if (m_closestObstacle == -1){
-	bx = m_bounds;
-    }
-    else
-      {
-	bx = m_obstacles[m_closestObstacle];
-      }
-    switch (bx.GetClosestSide (position))
-    {
-      case Box::RIGHT:
-      case Box::LEFT:
-	speed.x = -speed.x;
-	break;
-      case Box::TOP:
-      case Box::BOTTOM:
-	speed.y = -speed.y;
-	break;
-      case Box::UP:
-      case Box::DOWN:
-	speed.z = -speed.z;
-	break;
-    }
-    m_helper.SetVelocity (speed);
-    m_helper.Unpause ();
-    DoWalk (delayLeft);
+    Vector position = m_trajectory.GetPosition (at, m_bounds);
+    DoWalk (at, position, m_nextVelocity, delayLeft);
   }
 
   void
   RandomWalk3dMobilityModel::DoDispose (void)
   {
+    m_obstacles = 0;
     // chain up
     MobilityModel::DoDispose ();
   }
   Vector
   RandomWalk3dMobilityModel::DoGetPosition (void) const
   {
-    m_helper.UpdateWithBounds (m_bounds);
-    return m_helper.GetCurrentPosition ();
+    Time now = Simulator::Now ();
+    // catching up with the current time only extends the trajectory
+    const_cast<RandomWalk3dMobilityModel *> (this)->Advance (now);
+    return m_trajectory.GetPosition (now, m_bounds);
   }
   void
   RandomWalk3dMobilityModel::DoSetPosition (const Vector &position)
   {
     NS_ASSERT (m_bounds.IsInside (position));
-    m_helper.SetPosition (position);
+    m_trajectory.Clear ();
+    m_trajectory.AddLeg (Simulator::Now (), position, Vector (0.0, 0.0, 0.0));
+    m_next = Simulator::Now ();
+    m_nextAction = ACTION_WALK;
     Simulator::Remove (m_event);
-    m_event = Simulator::ScheduleNow (&RandomWalk3dMobilityModel::DoInitializePrivate, this);
+    if (!m_lazy)
+      {
+	m_event = Simulator::ScheduleNow (&RandomWalk3dMobilityModel::Update, this);
+      }
   }
   Vector
   RandomWalk3dMobilityModel::DoGetVelocity (void) const
   {
-    return m_helper.GetVelocity ();
+    Time now = Simulator::Now ();
+    const_cast<RandomWalk3dMobilityModel *> (this)->Advance (now);
+    return m_trajectory.GetVelocity (now);
   }
   int64_t
   RandomWalk3dMobilityModel::DoAssignStreams (int64_t stream)
@@ -24,9 +24,10 @@
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
 #include "ns3/box.h"
+#include "ns3/obstacle-world.h"
 #include "ns3/random-variable-stream.h"
 #include "mobility-model.h"
-#include "constant-velocity-helper.h"
+#include "piecewise-linear-trajectory.h"
 
 namespace ns3 {
 
@@ -39,9 +40,17 @@ namespace ns3 {
  * with the user-provided random variables until
  * either a fixed distance has been walked or until a fixed amount
  * of time. If we hit one of the boundaries (specified by a rectangle),
- * of the model, we rebound on the boundary with a reflexive angle
- * and speed. This model is often identified as a brownian motion
- * model.
+ * of the model, or one of the obstacles, we rebound on it with a
+ * reflexive angle and speed, and walk on for the rest of the time.
+ * This model is often identified as a brownian motion model.
+ *
+ * The walk is stored as a PiecewiseLinearTrajectory. By default an event
+ * is scheduled at every change of course; with the "Lazy" attribute set,
+ * the changes of course are instead computed when a position or velocity
+ * query goes past the known part of the trajectory, so that nodes which
+ * are seldom queried cost no scheduler events. The trajectory is the
+ * same in both cases, but in lazy mode CourseChange is only fired when
+ * a query finds that the course changed.
  */
 class RandomWalk3dMobilityModel : public MobilityModel
 {
@@ -51,6 +60,7 @@ public:
    * \return the object TypeId
    */
   static TypeId GetTypeId (void);
+  RandomWalk3dMobilityModel ();
   /** An enum representing the different working modes of this module. */
   enum Mode  {
     MODE_DISTANCE,
@@ -59,6 +69,9 @@ public:
   /**
    * \param obstacle an obstacle to be added
    *
+   * The obstacle is added to the ObstacleWorld set through the
+   * "Obstacles" attribute, which is shared by every model using it.
+   * If no world was set, a private one is created for this model.
    * The box must be inside the boundaries,
    * this method does not verify it.
    * This method assumes the box has dimensions > 0
@@ -66,20 +79,41 @@ public:
   void AddObstacle(const Box &obstacle);
 
 private:
+  /** The change of course pending at the end of the known trajectory */
+  enum Action {
+    ACTION_WALK,
+    ACTION_REBOUND
+  };
   /**
-   * \brief Performs the rebound of the node if it reaches a boundary
-   * \param timeLeft The remaining time of the walk
+   * Event handler, compute the trajectory up to the current time
    */
-  void Rebound (Time timeLeft);
+  void Update (void);
   /**
-   * Walk according to position and velocity, until distance is reached,
-   * time is reached, or intersection with the bounding box
+   * Apply every change of course due up to the given time, and notify
+   * the course change if there was one.
+   * \param now the current time
+   */
+  void Advance (Time now);
+  /**
+   * \brief Pick a new random speed and direction and start walking
+   * \param at the time of the change of course
    */
-  void DoWalk (Time timeLeft);
+  void ChangeDirection (Time at);
   /**
-   * Perform initialization of the object before MobilityModel::DoInitialize ()
+   * \brief Performs the rebound of the node if it reaches a boundary or an obstacle
+   * \param at the time of the rebound
+   * \param timeLeft The remaining time of the walk
+   */
+  void Rebound (Time at, Time timeLeft);
+  /**
+   * Walk according to position and velocity, until distance is reached,
+   * time is reached, or intersection with the bounding box or an obstacle
+   * \param at the time the walk starts
+   * \param position the position the walk starts from
+   * \param velocity the velocity of the walk
+   * \param timeLeft The remaining time of the walk
    */
-  void DoInitializePrivate (void);
+  void DoWalk (Time at, const Vector &position, const Vector &velocity, Time timeLeft);
   virtual void DoDispose (void);
   virtual void DoInitialize (void);
   virtual Vector DoGetPosition (void) const;
@@ -87,8 +121,12 @@ private:
   virtual Vector DoGetVelocity (void) const;
   virtual int64_t DoAssignStreams (int64_t);
 
-  ConstantVelocityHelper m_helper; //!< helper for this object
+  PiecewiseLinearTrajectory m_trajectory; //!< known part of the walk
   EventId m_event; //!< stored event ID 
+  bool m_lazy; //!< whether the walk is computed only when queried
+  Time m_next; //!< time of the next change of course
+  enum Action m_nextAction; //!< next change of course
+  Time m_nextTimeLeft; //!< remaining time of the walk after the next rebound
   enum Mode m_mode; //!< whether in time or distance mode
   double m_modeDistance; //!< Change direction and speed after this distance
   Time m_modeTime; //!< Change current direction and speed after this delay
@@ -97,8 +135,8 @@ private:
   Box m_bounds; //!< Bounds of the area to cruise
 
   Ptr<RandomVariableStream> m_pitch; //!< rv for picking pitch
-  mutable std::vector<Box> m_obstacles; // list of obstacles
-  int m_closestObstacle; // if collision is detected, this wil be set as the id of the obstacle in the array
+  Ptr<ObstacleWorld> m_obstacles; //!< obstacles shared with the other models
+  Vector m_nextVelocity; //!< velocity after the next rebound
 };
 
 } // namespace ns3
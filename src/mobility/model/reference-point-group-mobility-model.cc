@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#include "reference-point-group-mobility-model.h"
+#include "ns3/pointer.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (ReferencePointGroupMobilityModel);
+
+TypeId
+ReferencePointGroupMobilityModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ReferencePointGroupMobilityModel")
+    .SetParent<MobilityModel> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<ReferencePointGroupMobilityModel> ()
+    .AddAttribute ("Group",
+                   "The group whose leader this node follows.",
+                   PointerValue (),
+                   MakePointerAccessor (&ReferencePointGroupMobilityModel::m_group),
+                   MakePointerChecker<ReferencePointGroup> ());
+  return tid;
+}
+
+ReferencePointGroupMobilityModel::ReferencePointGroupMobilityModel ()
+  : m_joined (false),
+    m_groupIndex (0)
+{
+}
+
+ReferencePointGroupMobilityModel::~ReferencePointGroupMobilityModel ()
+{
+}
+
+void
+ReferencePointGroupMobilityModel::DoDispose (void)
+{
+  if (m_joined && m_group != 0)
+    {
+      m_group->Remove (m_groupIndex);
+    }
+  m_group = 0;
+  MobilityModel::DoDispose ();
+}
+
+void
+ReferencePointGroupMobilityModel::JoinGroup (void)
+{
+  if (!m_joined)
+    {
+      m_joined = true;
+      m_groupIndex = m_group->Add (this, Vector ());
+    }
+}
+
+void
+ReferencePointGroupMobilityModel::SetOffset (const Vector &offset)
+{
+  NS_ASSERT_MSG (m_group != 0, "No group set");
+  JoinGroup ();
+  m_group->SetOffset (m_groupIndex, offset);
+  NotifyCourseChange ();
+}
+
+Vector
+ReferencePointGroupMobilityModel::GetOffset (void) const
+{
+  NS_ASSERT_MSG (m_group != 0, "No group set");
+  const_cast<ReferencePointGroupMobilityModel *> (this)->JoinGroup ();
+  return m_group->GetOffset (m_groupIndex);
+}
+
+Vector
+ReferencePointGroupMobilityModel::DoGetPosition (void) const
+{
+  if (m_group == 0)
+    {
+      return m_position;
+    }
+  const_cast<ReferencePointGroupMobilityModel *> (this)->JoinGroup ();
+  return m_group->GetPosition (m_groupIndex);
+}
+
+void
+ReferencePointGroupMobilityModel::DoSetPosition (const Vector &position)
+{
+  if (m_group == 0)
+    {
+      m_position = position;
+      NotifyCourseChange ();
+      return;
+    }
+  Vector leader = m_group->GetLeader ()->GetPosition ();
+  SetOffset (Vector (position.x - leader.x, position.y - leader.y, position.z - leader.z));
+}
+
+Vector
+ReferencePointGroupMobilityModel::DoGetVelocity (void) const
+{
+  if (m_group == 0)
+    {
+      return Vector ();
+    }
+  const_cast<ReferencePointGroupMobilityModel *> (this)->JoinGroup ();
+  return m_group->GetVelocity (m_groupIndex);
+}
+
+} // namespace ns3
@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#ifndef REFERENCE_POINT_GROUP_MOBILITY_MODEL_H
+#define REFERENCE_POINT_GROUP_MOBILITY_MODEL_H
+
+#include "mobility-model.h"
+#include "reference-point-group.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief A member of a formation following the leader of a
+ * ReferencePointGroup.
+ *
+ * The model is a facade: the position is computed by the group set as
+ * "Group", at a fixed offset from the leader, and CourseChange is fired
+ * whenever the leader changes course. SetPosition sets the offset, so
+ * that the member is at the given position at the current time; place
+ * the leader first. Without a group, the model stands still.
+ */
+class ReferencePointGroupMobilityModel : public MobilityModel
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  ReferencePointGroupMobilityModel ();
+  virtual ~ReferencePointGroupMobilityModel ();
+
+  /**
+   * \param offset the position of this node relative to the leader
+   *
+   * The "Group" attribute must be set.
+   */
+  void SetOffset (const Vector &offset);
+  /**
+   * \return the position of this node relative to the leader, without
+   *         the clamping on the obstacles
+   */
+  Vector GetOffset (void) const;
+
+private:
+  friend class ReferencePointGroup;
+
+  virtual void DoDispose (void);
+  virtual Vector DoGetPosition (void) const;
+  virtual void DoSetPosition (const Vector &position);
+  virtual Vector DoGetVelocity (void) const;
+  /**
+   * Add this node to the group, if not done yet
+   */
+  void JoinGroup (void);
+
+  Ptr<ReferencePointGroup> m_group; //!< group this node follows, if any
+  bool m_joined; //!< whether this node was added to the group
+  uint32_t m_groupIndex; //!< index of this node in the group
+  Vector m_position; //!< position without a group
+};
+
+} // namespace ns3
+
+#endif /* REFERENCE_POINT_GROUP_MOBILITY_MODEL_H */
@@ -0,0 +1,363 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#include "reference-point-group.h"
+#include "reference-point-group-mobility-model.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ReferencePointGroup");
+
+NS_OBJECT_ENSURE_REGISTERED (ReferencePointGroup);
+
+TypeId
+ReferencePointGroup::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ReferencePointGroup")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<ReferencePointGroup> ()
+    .AddAttribute ("Leader",
+                   "The mobility model the members follow.",
+                   PointerValue (),
+                   MakePointerAccessor (&ReferencePointGroup::SetLeader,
+                                        &ReferencePointGroup::GetLeader),
+                   MakePointerChecker<MobilityModel> ())
+    .AddAttribute ("Obstacles",
+                   "The obstacles the members avoid, shared with the leader.",
+                   PointerValue (),
+                   MakePointerAccessor (&ReferencePointGroup::m_obstacles),
+                   MakePointerChecker<ObstacleWorld> ())
+    .AddAttribute ("Radius",
+                   "The distance kept from an obstacle crossing the offset of a member (m).",
+                   DoubleValue (0.5),
+                   MakeDoubleAccessor (&ReferencePointGroup::m_radius),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("Horizon",
+                   "The longest time the obstacles found around the path of the leader are used.",
+                   TimeValue (Seconds (10.0)),
+                   MakeTimeAccessor (&ReferencePointGroup::m_horizon),
+                   MakeTimeChecker ());
+  return tid;
+}
+
+ReferencePointGroup::ReferencePointGroup ()
+  : m_radius (0.5),
+    m_reach (0.0),
+    m_fresh (false),
+    m_sweptValid (false),
+    m_nSearches (0)
+{
+}
+
+ReferencePointGroup::~ReferencePointGroup ()
+{
+}
+
+void
+ReferencePointGroup::DoDispose (void)
+{
+  SetLeader (0);
+  m_obstacles = 0;
+  for (uint32_t i = 0; i < m_models.size (); ++i)
+    {
+      m_models[i] = 0;
+    }
+  Object::DoDispose ();
+}
+
+void
+ReferencePointGroup::SetLeader (Ptr<MobilityModel> leader)
+{
+  if (m_leader != 0)
+    {
+      m_leader->TraceDisconnectWithoutContext ("CourseChange",
+                                               MakeCallback (&ReferencePointGroup::LeaderCourseChange, this));
+    }
+  m_leader = leader;
+  if (m_leader != 0)
+    {
+      m_leader->TraceConnectWithoutContext ("CourseChange",
+                                            MakeCallback (&ReferencePointGroup::LeaderCourseChange, this));
+    }
+  m_fresh = false;
+  m_sweptValid = false;
+}
+
+Ptr<MobilityModel>
+ReferencePointGroup::GetLeader (void) const
+{
+  return m_leader;
+}
+
+uint32_t
+ReferencePointGroup::Add (ReferencePointGroupMobilityModel *model, const Vector &offset)
+{
+  m_models.push_back (model);
+  m_offsets.push_back (Vector ());
+  m_positions.push_back (Vector ());
+  m_velocities.push_back (Vector ());
+  m_clampObstacles.push_back (-1);
+  m_clampNormals.push_back (Vector ());
+  SetOffset (m_models.size () - 1, offset);
+  return m_models.size () - 1;
+}
+
+void
+ReferencePointGroup::Remove (uint32_t i)
+{
+  NS_ASSERT (i < m_models.size ());
+  m_models[i] = 0;
+}
+
+uint32_t
+ReferencePointGroup::GetNNodes (void) const
+{
+  return m_models.size ();
+}
+
+void
+ReferencePointGroup::SetOffset (uint32_t i, const Vector &offset)
+{
+  NS_ASSERT (i < m_offsets.size ());
+  m_offsets[i] = offset;
+  double length = std::sqrt (offset.x * offset.x + offset.y * offset.y + offset.z * offset.z);
+  if (length + m_radius > m_reach)
+    {
+      // the formation may now reach obstacles which were not searched
+      m_reach = length + m_radius;
+      m_sweptValid = false;
+    }
+  m_fresh = false;
+}
+
+Vector
+ReferencePointGroup::GetOffset (uint32_t i) const
+{
+  NS_ASSERT (i < m_offsets.size ());
+  return m_offsets[i];
+}
+
+Vector
+ReferencePointGroup::GetPosition (uint32_t i) const
+{
+  NS_ASSERT (i < m_positions.size ());
+  UpdateAndNotify ();
+  return m_positions[i];
+}
+
+Vector
+ReferencePointGroup::GetVelocity (uint32_t i) const
+{
+  NS_ASSERT (i < m_velocities.size ());
+  UpdateAndNotify ();
+  return m_velocities[i];
+}
+
+uint32_t
+ReferencePointGroup::GetNSearches (void) const
+{
+  return m_nSearches;
+}
+
+void
+ReferencePointGroup::LeaderCourseChange (Ptr<const MobilityModel> leader)
+{
+  m_fresh = false;
+  m_sweptValid = false;
+  // all the members change course now, whatever face they slide on
+  m_leaderChange = Simulator::Now ();
+  for (uint32_t i = 0; i < m_models.size (); ++i)
+    {
+      if (m_models[i] != 0)
+        {
+          m_models[i]->NotifyCourseChange ();
+        }
+    }
+}
+
+void
+ReferencePointGroup::Sweep (const Vector &leader) const
+{
+  Time now = Simulator::Now ();
+  Vector velocity = m_leader->GetVelocity ();
+  double horizon = m_horizon.GetSeconds ();
+  Vector end (leader.x + velocity.x * horizon, leader.y + velocity.y * horizon,
+              leader.z + velocity.z * horizon);
+  m_swept = Box (std::min (leader.x, end.x), std::max (leader.x, end.x),
+                 std::min (leader.y, end.y), std::max (leader.y, end.y),
+                 std::min (leader.z, end.z), std::max (leader.z, end.z));
+  m_sweptUntil = now + m_horizon;
+  m_sweptValid = true;
+  m_candidates.clear ();
+  if (m_obstacles != 0)
+    {
+      Box reach (m_swept.xMin - m_reach, m_swept.xMax + m_reach,
+                 m_swept.yMin - m_reach, m_swept.yMax + m_reach,
+                 m_swept.zMin - m_reach, m_swept.zMax + m_reach);
+      m_obstacles->FindOverlaps (reach, m_candidates);
+      m_nSearches++;
+    }
+  NS_LOG_DEBUG ("Leg from " << leader << ", " << m_candidates.size () << " obstacles within reach");
+}
+
+double
+ReferencePointGroup::Enter (uint32_t obstacle, const Vector &origin, const Vector &direction, Vector &normal) const
+{
+  Ptr<const ObstacleShape> shape = m_obstacles->GetShape (obstacle);
+  if (shape != 0)
+    {
+      double t;
+      return shape->Intersect (origin, direction, t, normal) ? t : 2.0;
+    }
+  const Box &box = m_obstacles->GetObstacle (obstacle);
+  const double o[3] = { origin.x, origin.y, origin.z };
+  const double d[3] = { direction.x, direction.y, direction.z };
+  const double lo[3] = { box.xMin, box.yMin, box.zMin };
+  const double hi[3] = { box.xMax, box.yMax, box.zMax };
+  double tNear = 0.0;
+  double tFar = 1.0;
+  uint32_t nearAxis = 3;
+  for (uint32_t axis = 0; axis < 3; ++axis)
+    {
+      if (d[axis] == 0.0)
+        {
+          if (o[axis] <= lo[axis] || o[axis] >= hi[axis])
+            {
+              return 2.0;
+            }
+          continue;
+        }
+      double t1 = (lo[axis] - o[axis]) / d[axis];
+      double t2 = (hi[axis] - o[axis]) / d[axis];
+      if (std::min (t1, t2) > tNear)
+        {
+          tNear = std::min (t1, t2);
+          nearAxis = axis;
+        }
+      tFar = std::min (tFar, std::max (t1, t2));
+    }
+  normal = Vector (nearAxis == 0 ? 1.0 : 0.0, nearAxis == 1 ? 1.0 : 0.0, nearAxis == 2 ? 1.0 : 0.0);
+  // a segment which only grazes the box does not enter it
+  return tNear < tFar ? tNear : 2.0;
+}
+
+void
+ReferencePointGroup::Update (void) const
+{
+  Time now = Simulator::Now ();
+  if (m_fresh && m_updated == now)
+    {
+      return;
+    }
+  NS_ASSERT_MSG (m_leader != 0, "No leader set");
+  Vector leader = m_leader->GetPosition ();
+  Vector velocity = m_leader->GetVelocity ();
+  if (!m_sweptValid || now > m_sweptUntil || !m_swept.IsInside (leader))
+    {
+      Sweep (leader);
+    }
+
+  for (uint32_t i = 0; i < m_offsets.size (); ++i)
+    {
+      if (m_models[i] == 0)
+        {
+          continue;
+        }
+      const Vector &offset = m_offsets[i];
+      double s = 1.0;
+      int32_t entered = -1;
+      Vector normal;
+      for (uint32_t c = 0; c < m_candidates.size (); ++c)
+        {
+          Vector n;
+          double t = Enter (m_candidates[c], leader, offset, n);
+          if (t < s)
+            {
+              s = t;
+              entered = m_candidates[c];
+              normal = n;
+            }
+        }
+      Vector v = velocity;
+      if (s < 1.0)
+        {
+          double length = std::sqrt (offset.x * offset.x + offset.y * offset.y + offset.z * offset.z);
+          s -= m_radius / length;
+          // the member slides so that normal . (leader + s * offset) stays
+          // constant, or stays with the leader once pulled in all the way
+          double along = normal.x * offset.x + normal.y * offset.y + normal.z * offset.z;
+          if (s > 0.0 && along != 0.0)
+            {
+              double ds = -(normal.x * velocity.x + normal.y * velocity.y + normal.z * velocity.z) / along;
+              v = Vector (velocity.x + offset.x * ds, velocity.y + offset.y * ds, velocity.z + offset.z * ds);
+            }
+          else
+            {
+              s = std::max (0.0, s);
+              normal = Vector ();
+            }
+        }
+      if (entered != m_clampObstacles[i]
+          || normal.x != m_clampNormals[i].x || normal.y != m_clampNormals[i].y || normal.z != m_clampNormals[i].z)
+        {
+          m_clampObstacles[i] = entered;
+          m_clampNormals[i] = normal;
+          m_changed.push_back (i);
+        }
+      m_positions[i] = Vector (leader.x + offset.x * s, leader.y + offset.y * s,
+                               leader.z + offset.z * s);
+      m_velocities[i] = v;
+    }
+  m_updated = now;
+  m_fresh = true;
+}
+
+void
+ReferencePointGroup::UpdateAndNotify (void) const
+{
+  Update ();
+  if (m_changed.empty ())
+    {
+      return;
+    }
+  // the listeners may query the positions again, which are fresh by now
+  std::vector<uint32_t> changed;
+  changed.swap (m_changed);
+  if (Simulator::Now () == m_leaderChange)
+    {
+      // already notified with the leader
+      return;
+    }
+  for (std::vector<uint32_t>::const_iterator i = changed.begin (); i != changed.end (); ++i)
+    {
+      if (m_models[*i] != 0)
+        {
+          m_models[*i]->NotifyCourseChange ();
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,199 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#ifndef REFERENCE_POINT_GROUP_H
+#define REFERENCE_POINT_GROUP_H
+
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/box.h"
+#include "ns3/obstacle-world.h"
+#include "mobility-model.h"
+
+namespace ns3 {
+
+class ReferencePointGroupMobilityModel;
+
+/**
+ * \ingroup mobility
+ * \brief Moves a formation of nodes along with a leader, among obstacles.
+ *
+ * The members of a group, the ReferencePointGroupMobilityModel attached
+ * to it through their "Group" attribute, keep a fixed offset from the
+ * leader, any mobility model set as "Leader", such as a
+ * RandomWalk3dMobilityModel avoiding the same obstacles. Only the leader
+ * schedules events and searches collisions; the members follow its
+ * CourseChange.
+ * \code
+    Ptr<ReferencePointGroup> group = CreateObject<ReferencePointGroup> ();
+    group->SetAttribute ("Leader", PointerValue (leaderMobility));
+    group->SetAttribute ("Obstacles", PointerValue (world));
+
+    MobilityHelper mobility;
+    mobility.SetMobilityModel ("ns3::ReferencePointGroupMobilityModel",
+      "Group", PointerValue (group));
+    mobility.SetPositionAllocator (formation);
+    mobility.Install (members);
+ * \endcode
+ *
+ * A member whose offset crosses an obstacle is pulled toward the leader,
+ * to "Radius" before the obstacle along the offset, so that the
+ * formation squeezes around the obstacles the leader flies by. The
+ * obstacles are searched once per leg of the leader, for the whole
+ * group: the ones overlapping the box swept by the sphere holding the
+ * formation, as the leader follows its velocity for "Horizon", are kept,
+ * and the offsets are only clamped against these, or not at all if there
+ * are none. The search is done again at the next course change of the
+ * leader, once the horizon is over, or if the leader leaves the swept
+ * box. The positions of all the members are computed together, once per
+ * simulation time.
+ *
+ * While a member is pulled in, it slides along the face of the obstacle
+ * crossing its offset, and its velocity is the one of this slide rather
+ * than the one of the leader. The members are notified of a course change
+ * with the leader, and also when a member starts or stops being pulled
+ * in, or moves to another face; since the positions are only computed when
+ * queried, the latter notifications are done at the first query which
+ * sees the change.
+ *
+ * Members are not kept inside any bounds: the offsets should leave room
+ * around the bounds of the leader.
+ */
+class ReferencePointGroup : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  ReferencePointGroup ();
+  virtual ~ReferencePointGroup ();
+
+  /**
+   * \param leader the mobility model the group follows
+   */
+  void SetLeader (Ptr<MobilityModel> leader);
+  /**
+   * \return the mobility model the group follows
+   */
+  Ptr<MobilityModel> GetLeader (void) const;
+  /**
+   * \param model the facade of the new member
+   * \param offset the position of the member relative to the leader
+   * \return the index of the member in the group
+   */
+  uint32_t Add (ReferencePointGroupMobilityModel *model, const Vector &offset);
+  /**
+   * \param i index of a member
+   *
+   * The member stops following the leader. Its index is not reused.
+   */
+  void Remove (uint32_t i);
+  /**
+   * \return the number of members added to the group
+   */
+  uint32_t GetNNodes (void) const;
+  /**
+   * \param i index of a member
+   * \param offset the new position of the member relative to the leader
+   */
+  void SetOffset (uint32_t i, const Vector &offset);
+  /**
+   * \param i index of a member
+   * \return the position of the member relative to the leader
+   */
+  Vector GetOffset (uint32_t i) const;
+  /**
+   * \param i index of a member
+   * \return the current position of the member
+   */
+  Vector GetPosition (uint32_t i) const;
+  /**
+   * \param i index of a member
+   * \return the current velocity of the member
+   */
+  Vector GetVelocity (uint32_t i) const;
+  /**
+   * \return the number of searches of the obstacles done so far
+   */
+  uint32_t GetNSearches (void) const;
+
+private:
+  virtual void DoDispose (void);
+  /**
+   * Follow a course change of the leader
+   * \param leader the leader
+   */
+  void LeaderCourseChange (Ptr<const MobilityModel> leader);
+  /**
+   * Compute the positions of the members at the current time, if not
+   * done yet
+   */
+  void Update (void) const;
+  /**
+   * Search the obstacles the formation may reach from the current
+   * position of the leader
+   * \param leader the current position of the leader
+   */
+  void Sweep (const Vector &leader) const;
+  /**
+   * \param obstacle index of an obstacle
+   * \param origin a position outside of the obstacle
+   * \param direction the direction of a segment from the origin
+   * \param normal the normal of the face entered, if any
+   * \return the fraction of the segment where the obstacle is entered,
+   *         or more than 1 if it is not
+   */
+  double Enter (uint32_t obstacle, const Vector &origin, const Vector &direction, Vector &normal) const;
+  /**
+   * Compute the positions, and notify the course changes of the members
+   * which moved to another face of the obstacles
+   */
+  void UpdateAndNotify (void) const;
+
+  Ptr<MobilityModel> m_leader; //!< mobility model the group follows
+  Ptr<ObstacleWorld> m_obstacles; //!< obstacles the members avoid, or 0
+  double m_radius; //!< distance kept from the obstacles along the offsets
+  Time m_horizon; //!< longest time a search of the obstacles is used
+
+  std::vector<ReferencePointGroupMobilityModel *> m_models; //!< member facades, 0 once removed
+  std::vector<Vector> m_offsets; //!< offset of each member
+  double m_reach; //!< radius of the sphere holding the formation
+
+  mutable std::vector<Vector> m_positions; //!< position of each member at m_updated
+  mutable std::vector<Vector> m_velocities; //!< velocity of each member at m_updated
+  mutable std::vector<int32_t> m_clampObstacles; //!< obstacle each member is pulled in by, or -1
+  mutable std::vector<Vector> m_clampNormals; //!< normal of the face each member slides on, or 0 if it stays with the leader
+  mutable std::vector<uint32_t> m_changed; //!< members which moved to another face at m_updated
+  Time m_leaderChange; //!< time of the last course change of the leader
+  mutable Time m_updated; //!< time of m_positions
+  mutable bool m_fresh; //!< whether m_positions is valid at m_updated
+  mutable std::vector<uint32_t> m_candidates; //!< obstacles the formation may reach
+  mutable Box m_swept; //!< box the leader walks in while m_candidates is valid
+  mutable Time m_sweptUntil; //!< end of the validity of m_candidates
+  mutable bool m_sweptValid; //!< whether m_candidates is valid
+  mutable uint32_t m_nSearches; //!< number of searches of the obstacles
+};
+
+} // namespace ns3
+
+#endif /* REFERENCE_POINT_GROUP_H */
@@ -0,0 +1,285 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#include "spatial-grid.h"
+#include "ns3/simulator.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include <cmath>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SpatialGrid");
+
+// 21 bits per axis, the cells of each axis being centered on 0
+static const int64_t AXIS_BIAS = 1 << 20;
+static const uint64_t AXIS_MASK = (1 << 21) - 1;
+
+SpatialGrid::SpatialGrid ()
+  : m_cellSize (100.0),
+    m_nItems (0),
+    m_maxSpeed (0.0),
+    m_nRebins (0)
+{
+}
+
+void
+SpatialGrid::SetCellSize (double cellSize)
+{
+  NS_ASSERT (cellSize > 0);
+  m_cellSize = cellSize;
+  m_cells.clear ();
+  for (uint32_t id = 0; id < m_items.size (); ++id)
+    {
+      if (m_items[id].present)
+        {
+          Insert (id);
+        }
+    }
+}
+
+double
+SpatialGrid::GetCellSize (void) const
+{
+  return m_cellSize;
+}
+
+uint64_t
+SpatialGrid::Clamp (int64_t i)
+{
+  return std::min (std::max (i + AXIS_BIAS, int64_t (0)), int64_t (AXIS_MASK));
+}
+
+uint64_t
+SpatialGrid::GetKey (const Vector &position) const
+{
+  uint64_t x = Clamp (static_cast<int64_t> (std::floor (position.x / m_cellSize)));
+  uint64_t y = Clamp (static_cast<int64_t> (std::floor (position.y / m_cellSize)));
+  uint64_t z = Clamp (static_cast<int64_t> (std::floor (position.z / m_cellSize)));
+  return (x << 42) | (y << 21) | z;
+}
+
+void
+SpatialGrid::Insert (uint32_t id)
+{
+  Item &item = m_items[id];
+  item.cell = GetKey (item.position);
+  std::vector<uint32_t> &cell = m_cells[item.cell];
+  item.slot = cell.size ();
+  cell.push_back (id);
+}
+
+void
+SpatialGrid::Unlink (uint32_t id)
+{
+  Item &item = m_items[id];
+  Cells::iterator cell = m_cells.find (item.cell);
+  NS_ASSERT (cell != m_cells.end () && cell->second[item.slot] == id);
+  uint32_t last = cell->second.back ();
+  cell->second[item.slot] = last;
+  m_items[last].slot = item.slot;
+  cell->second.pop_back ();
+  if (cell->second.empty ())
+    {
+      m_cells.erase (cell);
+    }
+}
+
+void
+SpatialGrid::Update (uint32_t id, const Vector &position, const Vector &velocity)
+{
+  if (id >= m_items.size ())
+    {
+      Item item;
+      item.present = false;
+      item.listed = false;
+      m_items.resize (id + 1, item);
+    }
+  Item &item = m_items[id];
+  item.position = position;
+  item.velocity = velocity;
+  item.time = Simulator::Now ();
+  if (!item.present)
+    {
+      item.present = true;
+      m_nItems++;
+      Insert (id);
+    }
+  else if (GetKey (position) != item.cell)
+    {
+      Unlink (id);
+      Insert (id);
+    }
+  double speed = std::sqrt (velocity.x * velocity.x + velocity.y * velocity.y + velocity.z * velocity.z);
+  if (speed > 0 && !item.listed)
+    {
+      item.listed = true;
+      m_moving.push_back (id);
+    }
+  m_maxSpeed = std::max (m_maxSpeed, speed);
+}
+
+void
+SpatialGrid::Remove (uint32_t id)
+{
+  if (id >= m_items.size () || !m_items[id].present)
+    {
+      return;
+    }
+  Unlink (id);
+  m_items[id].present = false;
+  m_nItems--;
+}
+
+void
+SpatialGrid::Clear (void)
+{
+  m_items.clear ();
+  m_cells.clear ();
+  m_moving.clear ();
+  m_nItems = 0;
+  m_maxSpeed = 0.0;
+  m_binTime = Simulator::Now ();
+}
+
+void
+SpatialGrid::Rebin (void)
+{
+  Time now = Simulator::Now ();
+  double maxSpeed = 0.0;
+  uint32_t kept = 0;
+  for (uint32_t k = 0; k < m_moving.size (); ++k)
+    {
+      uint32_t id = m_moving[k];
+      Item &item = m_items[id];
+      if (!item.present || (item.velocity.x == 0 && item.velocity.y == 0 && item.velocity.z == 0))
+        {
+          item.listed = false;
+          continue;
+        }
+      double t = (now - item.time).GetSeconds ();
+      item.position = Vector (item.position.x + item.velocity.x * t,
+                              item.position.y + item.velocity.y * t,
+                              item.position.z + item.velocity.z * t);
+      item.time = now;
+      if (GetKey (item.position) != item.cell)
+        {
+          Unlink (id);
+          Insert (id);
+        }
+      const Vector &v = item.velocity;
+      maxSpeed = std::max (maxSpeed, std::sqrt (v.x * v.x + v.y * v.y + v.z * v.z));
+      m_moving[kept++] = id;
+    }
+  m_moving.resize (kept);
+  m_maxSpeed = maxSpeed;
+  m_binTime = now;
+  m_nRebins++;
+  NS_LOG_DEBUG ("placed " << kept << " moving items again");
+}
+
+void
+SpatialGrid::FindNear (const Vector &center, double radius, std::vector<uint32_t> &items)
+{
+  items.clear ();
+  double drift = m_maxSpeed * (Simulator::Now () - m_binTime).GetSeconds ();
+  if (drift > m_cellSize / 2)
+    {
+      Rebin ();
+      drift = 0.0;
+    }
+  // the items may have moved by up to the drift since they were placed
+  double reach = radius + drift;
+  int64_t lo[3];
+  int64_t hi[3];
+  const double c[3] = { center.x, center.y, center.z };
+  double nCells = 1.0;
+  for (uint32_t axis = 0; axis < 3; ++axis)
+    {
+      lo[axis] = Clamp (static_cast<int64_t> (std::floor ((c[axis] - reach) / m_cellSize)));
+      hi[axis] = Clamp (static_cast<int64_t> (std::floor ((c[axis] + reach) / m_cellSize)));
+      nCells *= hi[axis] - lo[axis] + 1;
+    }
+  double reach2 = reach * reach;
+
+  if (nCells > m_cells.size ())
+    {
+      // fewer occupied cells than cells in the box: walk the occupied ones
+      for (Cells::const_iterator cell = m_cells.begin (); cell != m_cells.end (); ++cell)
+        {
+          int64_t x = (cell->first >> 42) & AXIS_MASK;
+          int64_t y = (cell->first >> 21) & AXIS_MASK;
+          int64_t z = cell->first & AXIS_MASK;
+          if (x < lo[0] || x > hi[0] || y < lo[1] || y > hi[1] || z < lo[2] || z > hi[2])
+            {
+              continue;
+            }
+          for (uint32_t k = 0; k < cell->second.size (); ++k)
+            {
+              const Vector &p = m_items[cell->second[k]].position;
+              double dx = p.x - center.x, dy = p.y - center.y, dz = p.z - center.z;
+              if (dx * dx + dy * dy + dz * dz <= reach2)
+                {
+                  items.push_back (cell->second[k]);
+                }
+            }
+        }
+      return;
+    }
+
+  for (int64_t x = lo[0]; x <= hi[0]; ++x)
+    {
+      for (int64_t y = lo[1]; y <= hi[1]; ++y)
+        {
+          for (int64_t z = lo[2]; z <= hi[2]; ++z)
+            {
+              uint64_t key = (uint64_t (x) << 42) | (uint64_t (y) << 21) | uint64_t (z);
+              Cells::const_iterator cell = m_cells.find (key);
+              if (cell == m_cells.end ())
+                {
+                  continue;
+                }
+              for (uint32_t k = 0; k < cell->second.size (); ++k)
+                {
+                  const Vector &p = m_items[cell->second[k]].position;
+                  double dx = p.x - center.x, dy = p.y - center.y, dz = p.z - center.z;
+                  if (dx * dx + dy * dy + dz * dz <= reach2)
+                    {
+                      items.push_back (cell->second[k]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+uint32_t
+SpatialGrid::GetNItems (void) const
+{
+  return m_nItems;
+}
+
+uint32_t
+SpatialGrid::GetNRebins (void) const
+{
+  return m_nRebins;
+}
+
+} // namespace ns3
@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Finds the moving items near a position, with cubic cells.
+ *
+ * Each item is kept in the cell of the position it was given at its
+ * last Update, usually from the CourseChange trace of its mobility
+ * model, along with its velocity. As the items move away from their
+ * cell, the searches are widened by the distance the fastest item may
+ * have covered since the items were last placed, so that no item within
+ * the searched radius is missed. Once that distance grows beyond half a
+ * cell, the moving items are placed again at the position extrapolated
+ * from their velocity, which costs one pass over them every half cell
+ * covered by the fastest one, whatever the number of searches.
+ *
+ * The items must report every change of velocity: the models computing
+ * their trajectory only when queried, such as the "Lazy" 3D models,
+ * might turn unnoticed.
+ *
+ * The occupied cells only are stored, in a map, so that the items may
+ * roam an unbounded space.
+ */
+class SpatialGrid
+{
+public:
+  SpatialGrid ();
+
+  /**
+   * \param cellSize the side of the cells (m)
+   *
+   * The items already added are placed again.
+   */
+  void SetCellSize (double cellSize);
+  /**
+   * \return the side of the cells (m)
+   */
+  double GetCellSize (void) const;
+  /**
+   * \param id the identifier of an item, added if new
+   * \param position the position of the item at the current time
+   * \param velocity the velocity of the item from now on
+   */
+  void Update (uint32_t id, const Vector &position, const Vector &velocity);
+  /**
+   * \param id the identifier of an item, ignored if not added
+   */
+  void Remove (uint32_t id);
+  /**
+   * Remove all the items
+   */
+  void Clear (void);
+  /**
+   * \param center the center of the searched sphere
+   * \param radius the radius of the searched sphere (m)
+   * \param items on return, the identifiers of the items which may lie
+   *        within the sphere at the current time, including some beyond
+   *        it, in no particular order
+   */
+  void FindNear (const Vector &center, double radius, std::vector<uint32_t> &items);
+  /**
+   * \return the number of items added
+   */
+  uint32_t GetNItems (void) const;
+  /**
+   * \return the number of times the moving items were placed again
+   */
+  uint32_t GetNRebins (void) const;
+
+private:
+  /** An item of the grid */
+  struct Item
+  {
+    Vector position;   //!< position at time
+    Vector velocity;   //!< velocity since time
+    Time time;         //!< time of the position
+    uint64_t cell;     //!< key of the cell holding the item
+    uint32_t slot;     //!< index of the item in its cell
+    bool present;      //!< whether the item was added
+    bool listed;       //!< whether the item is in m_moving
+  };
+  /** The cells, by key */
+  typedef std::map<uint64_t, std::vector<uint32_t> > Cells;
+
+  /**
+   * \param position a position
+   * \return the key of the cell holding the position
+   */
+  uint64_t GetKey (const Vector &position) const;
+  /**
+   * \param i the index of a cell along an axis
+   * \return the index clamped to the range of the keys
+   */
+  static uint64_t Clamp (int64_t i);
+  /**
+   * \param id an item to place in the cell of its position
+   */
+  void Insert (uint32_t id);
+  /**
+   * \param id an item to remove from its cell
+   */
+  void Unlink (uint32_t id);
+  /**
+   * Place the moving items again, at their current position
+   */
+  void Rebin (void);
+
+  double m_cellSize; //!< side of the cells
+  std::vector<Item> m_items; //!< items, by identifier
+  uint32_t m_nItems; //!< number of items added
+  Cells m_cells; //!< items of each occupied cell
+  std::vector<uint32_t> m_moving; //!< items with a velocity, possibly stopped or removed since
+  double m_maxSpeed; //!< speed of the fastest item since m_binTime
+  Time m_binTime; //!< time when the moving items were last placed
+  uint32_t m_nRebins; //!< number of times the moving items were placed again
+};
+
+} // namespace ns3
+
+#endif /* SPATIAL_GRID_H */
@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#include "trajectory-cache-mobility-model.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TrajectoryCacheMobilityModel");
+
+NS_OBJECT_ENSURE_REGISTERED (TrajectoryCacheMobilityModel);
+
+TypeId
+TrajectoryCacheMobilityModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TrajectoryCacheMobilityModel")
+    .SetParent<MobilityModel> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<TrajectoryCacheMobilityModel> ()
+    .AddAttribute ("CourseChanges",
+                   "Whether to fire CourseChange at the start of each recorded leg.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&TrajectoryCacheMobilityModel::m_courseChanges),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+TrajectoryCacheMobilityModel::TrajectoryCacheMobilityModel ()
+  : m_legs (0),
+    m_nLegs (0),
+    m_current (0),
+    m_courseChanges (true),
+    m_detached (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TrajectoryCacheMobilityModel::~TrajectoryCacheMobilityModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TrajectoryCacheMobilityModel::SetTrajectory (Ptr<const TrajectoryCache> cache, uint32_t node)
+{
+  NS_LOG_FUNCTION (this << cache << node);
+  NS_ASSERT_MSG (cache->GetNLegs (node) > 0, "No trajectory recorded for node " << node);
+  m_cache = cache;
+  m_legs = cache->GetLegs (node);
+  m_nLegs = cache->GetNLegs (node);
+  m_current = 0;
+  m_detached = false;
+}
+
+void
+TrajectoryCacheMobilityModel::DoInitialize (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_courseChanges && !m_detached && m_nLegs > 0)
+    {
+      ScheduleNextLeg ();
+    }
+  MobilityModel::DoInitialize ();
+}
+
+void
+TrajectoryCacheMobilityModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_event.Cancel ();
+  m_legs = 0;
+  m_nLegs = 0;
+  m_cache = 0;
+  MobilityModel::DoDispose ();
+}
+
+int32_t
+TrajectoryCacheMobilityModel::FindLeg (int64_t t) const
+{
+  NS_ASSERT (m_nLegs > 0);
+  // the leg of the last query, or the one after it, in the common case
+  // of queries at increasing times
+  uint32_t i = m_current;
+  if (m_legs[i].start <= t)
+    {
+      if (i + 1 == m_nLegs || t < m_legs[i + 1].start)
+        {
+          return i;
+        }
+      if (i + 2 == m_nLegs || t < m_legs[i + 2].start)
+        {
+          m_current = i + 1;
+          return m_current;
+        }
+    }
+  if (t < m_legs[0].start)
+    {
+      return -1;
+    }
+  uint32_t low = 0;
+  uint32_t high = m_nLegs;
+  // invariant: m_legs[low].start <= t, and t < m_legs[high].start if any
+  while (high - low > 1)
+    {
+      uint32_t middle = low + (high - low) / 2;
+      if (m_legs[middle].start <= t)
+        {
+          low = middle;
+        }
+      else
+        {
+          high = middle;
+        }
+    }
+  m_current = low;
+  return low;
+}
+
+Vector
+TrajectoryCacheMobilityModel::DoGetPosition (void) const
+{
+  if (m_detached || m_nLegs == 0)
+    {
+      return m_position;
+    }
+  Time now = Simulator::Now ();
+  int32_t i = FindLeg (now.GetTimeStep ());
+  if (i < 0)
+    {
+      return Vector (m_legs[0].origin[0], m_legs[0].origin[1], m_legs[0].origin[2]);
+    }
+  const TrajectoryCache::Leg &leg = m_legs[i];
+  // same arithmetic as the recorded models, so that the replay matches them
+  double deltaS = (now - TimeStep (leg.start)).GetSeconds ();
+  return Vector (leg.origin[0] + leg.velocity[0] * deltaS,
+                 leg.origin[1] + leg.velocity[1] * deltaS,
+                 leg.origin[2] + leg.velocity[2] * deltaS);
+}
+
+void
+TrajectoryCacheMobilityModel::DoSetPosition (const Vector &position)
+{
+  NS_LOG_FUNCTION (this << position);
+  m_detached = true;
+  m_position = position;
+  m_event.Cancel ();
+  NotifyCourseChange ();
+}
+
+Vector
+TrajectoryCacheMobilityModel::DoGetVelocity (void) const
+{
+  if (m_detached || m_nLegs == 0)
+    {
+      return Vector (0.0, 0.0, 0.0);
+    }
+  int32_t i = FindLeg (Simulator::Now ().GetTimeStep ());
+  if (i < 0)
+    {
+      return Vector (0.0, 0.0, 0.0);
+    }
+  const TrajectoryCache::Leg &leg = m_legs[i];
+  return Vector (leg.velocity[0], leg.velocity[1], leg.velocity[2]);
+}
+
+void
+TrajectoryCacheMobilityModel::StartLeg (void)
+{
+  NS_LOG_FUNCTION (this);
+  NotifyCourseChange ();
+  ScheduleNextLeg ();
+}
+
+void
+TrajectoryCacheMobilityModel::ScheduleNextLeg (void)
+{
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  int32_t i = FindLeg (now);
+  uint32_t next = i + 1;
+  if (next < m_nLegs)
+    {
+      m_event = Simulator::Schedule (TimeStep (m_legs[next].start - now),
+                                     &TrajectoryCacheMobilityModel::StartLeg, this);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,186 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#include "trajectory-cache.h"
+#include "ns3/assert.h"
+#include "ns3/fatal-error.h"
+#include "ns3/log.h"
+#include <fstream>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TrajectoryCache");
+
+namespace {
+
+/** Header of a trajectory file */
+struct Header
+{
+  char magic[8];       //!< "ns3traj"
+  uint32_t version;    //!< version of the layout
+  uint32_t resolution; //!< Time::Unit of the start times
+  uint64_t nNodes;     //!< number of node ids
+};
+
+/** Magic bytes starting a trajectory file */
+const char g_magic[8] = "ns3traj";
+/** Version of the layout written */
+const uint32_t g_version = 1;
+
+} // anonymous namespace
+
+TrajectoryCache::TrajectoryCache (std::string filename)
+  : m_map (0),
+    m_size (0),
+    m_nNodes (0),
+    m_first (0),
+    m_legs (0)
+{
+  NS_LOG_FUNCTION (this << filename);
+  int fd = open (filename.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      NS_FATAL_ERROR ("Cannot open trajectory file " << filename);
+    }
+  struct stat st;
+  if (fstat (fd, &st) != 0 || static_cast<uint64_t> (st.st_size) < sizeof (Header))
+    {
+      close (fd);
+      NS_FATAL_ERROR ("Trajectory file " << filename << " is too short");
+    }
+  m_size = st.st_size;
+  m_map = mmap (0, m_size, PROT_READ, MAP_SHARED, fd, 0);
+  // the mapping stays valid once the descriptor is closed
+  close (fd);
+  if (m_map == MAP_FAILED)
+    {
+      m_map = 0;
+      NS_FATAL_ERROR ("Cannot map trajectory file " << filename);
+    }
+
+  const Header *header = static_cast<const Header *> (m_map);
+  if (std::memcmp (header->magic, g_magic, sizeof (g_magic)) != 0
+      || header->version != g_version)
+    {
+      NS_FATAL_ERROR (filename << " is not a trajectory file of version " << g_version);
+    }
+  if (header->resolution != static_cast<uint32_t> (Time::GetResolution ()))
+    {
+      NS_FATAL_ERROR ("Trajectory file " << filename << " was written with another Time resolution");
+    }
+  m_nNodes = header->nNodes;
+  m_first = reinterpret_cast<const uint64_t *> (header + 1);
+  m_legs = reinterpret_cast<const Leg *> (m_first + m_nNodes + 1);
+  uint64_t legsOffset = sizeof (Header) + (header->nNodes + 1) * sizeof (uint64_t);
+  if (header->nNodes > UINT32_MAX
+      || m_size < legsOffset
+      || m_size != legsOffset + m_first[m_nNodes] * sizeof (Leg))
+    {
+      NS_FATAL_ERROR ("Trajectory file " << filename << " is truncated");
+    }
+}
+
+TrajectoryCache::~TrajectoryCache ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_map != 0)
+    {
+      munmap (m_map, m_size);
+    }
+}
+
+uint32_t
+TrajectoryCache::GetNNodes (void) const
+{
+  return m_nNodes;
+}
+
+uint32_t
+TrajectoryCache::GetNLegs (uint32_t node) const
+{
+  if (node >= m_nNodes)
+    {
+      return 0;
+    }
+  return m_first[node + 1] - m_first[node];
+}
+
+const TrajectoryCache::Leg *
+TrajectoryCache::GetLegs (uint32_t node) const
+{
+  NS_ASSERT (GetNLegs (node) > 0);
+  return m_legs + m_first[node];
+}
+
+bool
+TrajectoryCache::Write (std::string filename, const std::vector<std::vector<Leg> > &legs)
+{
+  NS_LOG_FUNCTION (filename << legs.size ());
+  std::ofstream os (filename.c_str (), std::ios::binary | std::ios::trunc);
+  if (!os.is_open ())
+    {
+      NS_LOG_WARN ("Cannot open trajectory file " << filename);
+      return false;
+    }
+  Header header;
+  std::memset (&header, 0, sizeof (header));
+  std::memcpy (header.magic, g_magic, sizeof (g_magic));
+  header.version = g_version;
+  header.resolution = Time::GetResolution ();
+  header.nNodes = legs.size ();
+  os.write (reinterpret_cast<const char *> (&header), sizeof (header));
+
+  uint64_t first = 0;
+  for (std::vector<std::vector<Leg> >::const_iterator i = legs.begin (); i != legs.end (); ++i)
+    {
+      os.write (reinterpret_cast<const char *> (&first), sizeof (first));
+      first += i->size ();
+    }
+  os.write (reinterpret_cast<const char *> (&first), sizeof (first));
+  for (std::vector<std::vector<Leg> >::const_iterator i = legs.begin (); i != legs.end (); ++i)
+    {
+      if (!i->empty ())
+        {
+          os.write (reinterpret_cast<const char *> (&(*i)[0]), i->size () * sizeof (Leg));
+        }
+    }
+  os.close ();
+  return !os.fail ();
+}
+
+TrajectoryCache::Leg
+TrajectoryCache::MakeLeg (Time start, const Vector &origin, const Vector &velocity)
+{
+  Leg leg;
+  leg.start = start.GetTimeStep ();
+  leg.origin[0] = origin.x;
+  leg.origin[1] = origin.y;
+  leg.origin[2] = origin.z;
+  leg.velocity[0] = velocity.x;
+  leg.velocity[1] = velocity.y;
+  leg.velocity[2] = velocity.z;
+  return leg;
+}
+
+} // namespace ns3
@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#ifndef TRAJECTORY_CACHE_H
+#define TRAJECTORY_CACHE_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "ns3/simple-ref-count.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief A file of recorded piecewise linear trajectories, mapped in memory.
+ *
+ * The file holds, for each node id, the legs of its trajectory sorted by
+ * start time. It is written once by TrajectoryCache::Write, usually
+ * through TrajectoryCacheHelper, and then mapped read-only by every run
+ * replaying it, so that the legs of all the nodes are shared between the
+ * TrajectoryCacheMobilityModel instances, and between the processes
+ * replaying the same file, without being parsed.
+ *
+ * The layout, in the byte order of the host, is:
+ *  - a header: the 8 bytes "ns3traj", a uint32_t version, the uint32_t
+ *    Time resolution the start times are expressed in, and the uint64_t
+ *    number N of node ids;
+ *  - N+1 uint64_t: the index of the first leg of each node id, followed
+ *    by the total number of legs;
+ *  - the legs, 56 bytes each: the int64_t start time step, then the
+ *    origin and the velocity as 3 doubles each.
+ */
+class TrajectoryCache : public SimpleRefCount<TrajectoryCache>
+{
+public:
+  /** A leg of a trajectory, as stored in the file */
+  struct Leg
+  {
+    int64_t start;     //!< start of the leg, in time steps
+    double origin[3];  //!< position at the start of the leg
+    double velocity[3]; //!< constant velocity during the leg
+  };
+
+  /**
+   * Map a file in memory. Aborts the simulation if the file cannot be
+   * read, or was not written by Write with the current Time resolution.
+   * \param filename the file to map
+   */
+  TrajectoryCache (std::string filename);
+  ~TrajectoryCache ();
+
+  /**
+   * \return the number of node ids in the file
+   */
+  uint32_t GetNNodes (void) const;
+  /**
+   * \param node a node id
+   * \return the number of legs of the node, 0 if it was not recorded
+   */
+  uint32_t GetNLegs (uint32_t node) const;
+  /**
+   * \param node a node id with at least one leg
+   * \return the legs of the node, sorted by start time
+   */
+  const Leg * GetLegs (uint32_t node) const;
+
+  /**
+   * Write a file of trajectories
+   * \param filename the file to write
+   * \param legs the legs of each node id, sorted by start time
+   * \return true if the file was written
+   */
+  static bool Write (std::string filename, const std::vector<std::vector<Leg> > &legs);
+  /**
+   * \param start the start of the leg
+   * \param origin the position at the start of the leg
+   * \param velocity the velocity during the leg
+   * \return the leg
+   */
+  static Leg MakeLeg (Time start, const Vector &origin, const Vector &velocity);
+
+private:
+  /** The copy constructor is disabled: the mapping is not shared. */
+  TrajectoryCache (const TrajectoryCache &);
+  /** The assignment operator is disabled: the mapping is not shared. */
+  TrajectoryCache & operator = (const TrajectoryCache &);
+
+  void *m_map;             //!< start of the mapping
+  uint64_t m_size;         //!< size of the mapping
+  uint32_t m_nNodes;       //!< number of node ids
+  const uint64_t *m_first; //!< index of the first leg of each node id
+  const Leg *m_legs;       //!< legs of all the nodes
+};
+
+} // namespace ns3
+
+#endif /* TRAJECTORY_CACHE_H */
@@ -0,0 +1,242 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/box.h"
+#include "ns3/obstacle-world.h"
+#include "ns3/obstacle-shape.h"
+#include "ns3/obstacle-gauss-markov-mobility-model.h"
+#include "ns3/obstacle-gauss-markov-swarm.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+
+using namespace ns3;
+
+/**
+ * Move a swarm among boxes, then among shapes, and check that its nodes
+ * stay in the bounds, out of the obstacles, move continuously and report
+ * their course changes, the same way whatever the number of threads.
+ */
+class ObstacleGaussMarkovSwarmTest : public TestCase
+{
+public:
+  ObstacleGaussMarkovSwarmTest ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Create a swarm of nodes, and run it
+   * \param stream the first random stream to use
+   * \param threads the number of threads updating the nodes
+   * \return the final positions of the nodes
+   */
+  std::vector<Vector> RunSwarm (int64_t stream, uint32_t threads);
+  /**
+   * Check the positions of every node
+   */
+  void Check (void);
+  /**
+   * \param model the model whose course changed
+   */
+  void CourseChange (Ptr<const MobilityModel> model);
+
+  Ptr<ObstacleWorld> m_world; //!< obstacles
+  std::vector<Ptr<MobilityModel> > m_models; //!< facades of the nodes
+  std::vector<Vector> m_positions; //!< positions at the previous check
+  Time m_lastCheck; //!< time of the previous check
+  uint32_t m_courseChanges; //!< number of course changes notified
+};
+
+ObstacleGaussMarkovSwarmTest::ObstacleGaussMarkovSwarmTest ()
+  : TestCase ("Check the motion of an ObstacleGaussMarkovSwarm")
+{
+}
+
+void
+ObstacleGaussMarkovSwarmTest::CourseChange (Ptr<const MobilityModel> model)
+{
+  m_courseChanges++;
+}
+
+void
+ObstacleGaussMarkovSwarmTest::Check (void)
+{
+  Box bounds (0.0, 100.0, 0.0, 100.0, 0.0, 100.0);
+  double elapsed = (Simulator::Now () - m_lastCheck).GetSeconds ();
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      Vector position = m_models[i]->GetPosition ();
+      NS_TEST_ASSERT_MSG_EQ (bounds.IsInside (position), true, "Node " << i << " out of bounds");
+      for (uint32_t o = 0; o < m_world->GetNObstacles (); o++)
+        {
+          bool inside;
+          if (m_world->IsBox (o))
+            {
+              const Box &b = m_world->GetObstacle (o);
+              inside = b.xMin + 1e-3 < position.x && position.x < b.xMax - 1e-3
+                && b.yMin + 1e-3 < position.y && position.y < b.yMax - 1e-3
+                && b.zMin + 1e-3 < position.z && position.z < b.zMax - 1e-3;
+            }
+          else
+            {
+              // rounding may leave a position on a face slightly inside
+              Ptr<const ObstacleShape> shape = m_world->GetShape (o);
+              inside = shape->IsInside (Vector (position.x - 1e-3, position.y, position.z))
+                && shape->IsInside (Vector (position.x + 1e-3, position.y, position.z))
+                && shape->IsInside (Vector (position.x, position.y - 1e-3, position.z))
+                && shape->IsInside (Vector (position.x, position.y + 1e-3, position.z))
+                && shape->IsInside (Vector (position.x, position.y, position.z - 1e-3))
+                && shape->IsInside (Vector (position.x, position.y, position.z + 1e-3));
+            }
+          NS_TEST_ASSERT_MSG_EQ (inside, false, "Node " << i << " inside obstacle " << o << " at " << position);
+        }
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (CalculateDistance (position, m_positions[i]), 20.0 * elapsed + 1e-6,
+                                   "Node " << i << " jumped");
+      m_positions[i] = position;
+    }
+  m_lastCheck = Simulator::Now ();
+}
+
+std::vector<Vector>
+ObstacleGaussMarkovSwarmTest::RunSwarm (int64_t stream, uint32_t threads)
+{
+  Ptr<ObstacleGaussMarkovSwarm> swarm = CreateObject<ObstacleGaussMarkovSwarm> ();
+  swarm->SetAttribute ("Bounds", BoxValue (Box (0.0, 100.0, 0.0, 100.0, 0.0, 100.0)));
+  swarm->SetAttribute ("TimeStep", TimeValue (Seconds (0.1)));
+  swarm->SetAttribute ("Alpha", DoubleValue (0.85));
+  swarm->SetAttribute ("MeanVelocity", StringValue ("ns3::UniformRandomVariable[Min=5.0|Max=10.0]"));
+  swarm->SetAttribute ("MeanPitch", StringValue ("ns3::UniformRandomVariable[Min=-0.5|Max=0.5]"));
+  swarm->SetAttribute ("NormalVelocity", StringValue ("ns3::NormalRandomVariable[Mean=0.0|Variance=1.0|Bound=2.0]"));
+  swarm->SetAttribute ("NormalDirection", StringValue ("ns3::NormalRandomVariable[Mean=0.0|Variance=0.2|Bound=0.4]"));
+  swarm->SetAttribute ("NormalPitch", StringValue ("ns3::NormalRandomVariable[Mean=0.0|Variance=0.02|Bound=0.04]"));
+  swarm->SetAttribute ("Obstacles", PointerValue (m_world));
+  swarm->SetAttribute ("Threads", UintegerValue (threads));
+  stream += swarm->AssignStreams (stream);
+
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::ObstacleGaussMarkovMobilityModel");
+  factory.Set ("Swarm", PointerValue (swarm));
+  m_models.clear ();
+  m_positions.clear ();
+  for (uint32_t i = 0; i < 50; i++)
+    {
+      Ptr<MobilityModel> model = factory.Create<MobilityModel> ();
+      stream += model->AssignStreams (stream);
+      Vector position (5.0 + 1.5 * i, 50.0 + (i % 7), 50.0 + (i % 11));
+      model->SetPosition (position);
+      model->TraceConnectWithoutContext ("CourseChange",
+                                         MakeCallback (&ObstacleGaussMarkovSwarmTest::CourseChange, this));
+      m_models.push_back (model);
+      m_positions.push_back (position);
+    }
+  m_lastCheck = Seconds (0.0);
+  m_courseChanges = 0;
+  for (double t = 0.37; t < 30.0; t += 0.37)
+    {
+      Simulator::Schedule (Seconds (t), &ObstacleGaussMarkovSwarmTest::Check, this);
+    }
+  Simulator::Stop (Seconds (30.0));
+  Simulator::Run ();
+
+  std::vector<Vector> positions;
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      positions.push_back (m_models[i]->GetPosition ());
+      m_models[i]->Dispose ();
+    }
+  m_models.clear ();
+  swarm->Dispose ();
+  Simulator::Destroy ();
+  return positions;
+}
+
+void
+ObstacleGaussMarkovSwarmTest::DoRun (void)
+{
+  m_world = CreateObject<ObstacleWorld> ();
+  m_world->AddObstacle (Box (20.0, 40.0, 20.0, 40.0, 0.0, 60.0));
+  m_world->AddObstacle (Box (60.0, 80.0, 10.0, 30.0, 0.0, 100.0));
+  m_world->AddObstacle (Box (30.0, 70.0, 70.0, 90.0, 0.0, 40.0));
+
+  std::vector<Vector> first = RunSwarm (1, 1);
+  // 300 ticks for 50 nodes, less the ones missed right after a rebound
+  NS_TEST_ASSERT_MSG_GT (m_courseChanges, 50 * 250, "Course changes not notified");
+
+  std::vector<Vector> second = RunSwarm (1, 1);
+  for (uint32_t i = 0; i < first.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (CalculateDistance (first[i], second[i]), 0.0, "Swarm motion not reproducible");
+    }
+
+  // each node draws from its own streams, so that splitting the swarm
+  // among threads changes nothing
+  std::vector<Vector> threaded = RunSwarm (1, 4);
+  for (uint32_t i = 0; i < first.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (first[i].x, threaded[i].x, "Swarm motion depends on the number of threads");
+      NS_TEST_EXPECT_MSG_EQ (first[i].y, threaded[i].y, "Swarm motion depends on the number of threads");
+      NS_TEST_EXPECT_MSG_EQ (first[i].z, threaded[i].z, "Swarm motion depends on the number of threads");
+    }
+
+  // the same among shapes, which the threads hit at once
+  m_world = CreateObject<ObstacleWorld> ();
+  std::vector<Vector2D> footprint;
+  footprint.push_back (Vector2D (10.0, 10.0));
+  footprint.push_back (Vector2D (40.0, 10.0));
+  footprint.push_back (Vector2D (40.0, 20.0));
+  footprint.push_back (Vector2D (20.0, 20.0));
+  footprint.push_back (Vector2D (20.0, 40.0));
+  footprint.push_back (Vector2D (10.0, 40.0));
+  m_world->AddObstacle (Create<PrismObstacle> (footprint, 0.0, 60.0));
+  std::vector<Vector> points;
+  points.push_back (Vector (70.0, 50.0, 0.0));
+  points.push_back (Vector (90.0, 70.0, 0.0));
+  points.push_back (Vector (70.0, 90.0, 0.0));
+  points.push_back (Vector (50.0, 70.0, 0.0));
+  points.push_back (Vector (70.0, 70.0, 80.0));
+  m_world->AddObstacle (Create<ConvexObstacle> (points));
+  m_world->AddObstacle (Box (60.0, 80.0, 10.0, 30.0, 0.0, 100.0));
+
+  first = RunSwarm (1, 1);
+  threaded = RunSwarm (1, 4);
+  for (uint32_t i = 0; i < first.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (first[i].x, threaded[i].x, "Swarm motion among shapes depends on the number of threads");
+      NS_TEST_EXPECT_MSG_EQ (first[i].y, threaded[i].y, "Swarm motion among shapes depends on the number of threads");
+      NS_TEST_EXPECT_MSG_EQ (first[i].z, threaded[i].z, "Swarm motion among shapes depends on the number of threads");
+    }
+  m_world = 0;
+}
+
+static class ObstacleGaussMarkovSwarmTestSuite : public TestSuite
+{
+public:
+  ObstacleGaussMarkovSwarmTestSuite ();
+} g_obstacleGaussMarkovSwarmTestSuite;
+
+ObstacleGaussMarkovSwarmTestSuite::ObstacleGaussMarkovSwarmTestSuite ()
+  : TestSuite ("obstacle-gauss-markov-swarm", UNIT)
+{
+  AddTestCase (new ObstacleGaussMarkovSwarmTest, TestCase::QUICK);
+}
@@ -0,0 +1,168 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+
+#include "ns3/test.h"
+#include "ns3/pointer.h"
+#include "ns3/double.h"
+#include "ns3/box.h"
+#include "ns3/obstacle-world.h"
+#include "ns3/obstacle-shape.h"
+#include "ns3/obstacle-position-allocator.h"
+#include "ns3/rng-seed-manager.h"
+#include <set>
+
+using namespace ns3;
+
+/**
+ * Check that the random positions are in the bounds, outside of the
+ * obstacles, and spread uniformly over the free space, with and without
+ * voxels.
+ */
+class ObstacleFreeBoxPositionAllocatorTest : public TestCase
+{
+public:
+  /**
+   * \param voxelSize the "VoxelSize" attribute of the allocator
+   */
+  ObstacleFreeBoxPositionAllocatorTest (double voxelSize);
+private:
+  virtual void DoRun (void);
+
+  double m_voxelSize; //!< size of the voxels
+};
+
+ObstacleFreeBoxPositionAllocatorTest::ObstacleFreeBoxPositionAllocatorTest (double voxelSize)
+  : TestCase (voxelSize > 0.0 ? "Check the random positions outside of obstacles, with voxels"
+              : "Check the random positions outside of obstacles"),
+    m_voxelSize (voxelSize)
+{
+}
+
+void
+ObstacleFreeBoxPositionAllocatorTest::DoRun (void)
+{
+  RngSeedManager::SetSeed (3);
+  RngSeedManager::SetRun (1);
+
+  // the obstacles fill 90% of the box: the free space is the slab
+  // 90 < x < 100, less a prism standing in it
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  for (uint32_t i = 0; i < 9; ++i)
+    {
+      world->AddObstacle (Box (i * 10.0, i * 10.0 + 10.0, 0.0, 100.0, 0.0, 100.0));
+    }
+  std::vector<Vector2D> footprint;
+  footprint.push_back (Vector2D (92.0, 0.0));
+  footprint.push_back (Vector2D (92.0, 50.0));
+  footprint.push_back (Vector2D (98.0, 50.0));
+  world->AddObstacle (Create<PrismObstacle> (footprint, 0.0, 50.0));
+
+  Ptr<ObstacleFreeBoxPositionAllocator> allocator = CreateObject<ObstacleFreeBoxPositionAllocator> ();
+  allocator->SetAttribute ("Bounds", BoxValue (Box (0.0, 100.0, 0.0, 100.0, 0.0, 100.0)));
+  allocator->SetAttribute ("Obstacles", PointerValue (world));
+  allocator->SetAttribute ("VoxelSize", DoubleValue (m_voxelSize));
+  allocator->AssignStreams (1);
+
+  uint32_t n = 5000;
+  uint32_t high = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      Vector position = allocator->GetNext ();
+      NS_TEST_ASSERT_MSG_EQ (Box (0.0, 100.0, 0.0, 100.0, 0.0, 100.0).IsInside (position), true,
+                             "Position " << position << " out of bounds");
+      NS_TEST_ASSERT_MSG_GT (position.x, 90.0, "Position " << position << " inside a box");
+      NS_TEST_ASSERT_MSG_EQ (world->GetShape (9)->IsInside (position), false,
+                             "Position " << position << " inside the prism");
+      high += position.z > 50.0;
+    }
+  // the prism takes 7500 m^3 of the 50000 m^3 of the slab below z = 50
+  double expected = 50000.0 / (100000.0 - 7500.0);
+  NS_TEST_EXPECT_MSG_EQ_TOL (high / double (n), expected, 0.03, "Positions not uniform");
+
+  // obstacles added later are avoided too
+  world->AddObstacle (Box (90.0, 100.0, 0.0, 100.0, 50.0, 100.0));
+  for (uint32_t i = 0; i < 1000; ++i)
+    {
+      Vector position = allocator->GetNext ();
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (position.z, 50.0, "Position " << position << " inside a new obstacle");
+    }
+}
+
+/**
+ * Check that the grid points inside obstacles are skipped, and that the
+ * grid starts over once exhausted.
+ */
+class ObstacleFreeGridPositionAllocatorTest : public TestCase
+{
+public:
+  ObstacleFreeGridPositionAllocatorTest ();
+private:
+  virtual void DoRun (void);
+};
+
+ObstacleFreeGridPositionAllocatorTest::ObstacleFreeGridPositionAllocatorTest ()
+  : TestCase ("Check the grid positions outside of obstacles")
+{
+}
+
+void
+ObstacleFreeGridPositionAllocatorTest::DoRun (void)
+{
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  world->AddObstacle (Box (5.0, 15.0, 5.0, 15.0, 5.0, 15.0));
+  // the points on the surface of an obstacle are outside of it
+  world->AddObstacle (Box (20.0, 30.0, 0.0, 20.0, 0.0, 20.0));
+
+  Ptr<ObstacleFreeGridPositionAllocator> allocator = CreateObject<ObstacleFreeGridPositionAllocator> ();
+  allocator->SetAttribute ("Bounds", BoxValue (Box (0.0, 20.0, 0.0, 20.0, 0.0, 20.0)));
+  allocator->SetAttribute ("DeltaX", DoubleValue (10.0));
+  allocator->SetAttribute ("DeltaY", DoubleValue (10.0));
+  allocator->SetAttribute ("DeltaZ", DoubleValue (10.0));
+  allocator->SetAttribute ("Obstacles", PointerValue (world));
+
+  std::set<std::pair<double, std::pair<double, double> > > seen;
+  Vector first = allocator->GetNext ();
+  NS_TEST_EXPECT_MSG_EQ (CalculateDistance (first, Vector (0.0, 0.0, 0.0)), 0.0, "Wrong first grid point");
+  seen.insert (std::make_pair (first.x, std::make_pair (first.y, first.z)));
+  for (uint32_t i = 1; i < 26; ++i)
+    {
+      Vector position = allocator->GetNext ();
+      NS_TEST_ASSERT_MSG_GT (CalculateDistance (position, Vector (10.0, 10.0, 10.0)), 0.0,
+                             "Grid point inside an obstacle");
+      seen.insert (std::make_pair (position.x, std::make_pair (position.y, position.z)));
+    }
+  NS_TEST_EXPECT_MSG_EQ (seen.size (), 26, "Grid points repeated");
+  Vector again = allocator->GetNext ();
+  NS_TEST_EXPECT_MSG_EQ (CalculateDistance (again, first), 0.0, "Grid not started over");
+}
+
+static class ObstaclePositionAllocatorTestSuite : public TestSuite
+{
+public:
+  ObstaclePositionAllocatorTestSuite ();
+} g_obstaclePositionAllocatorTestSuite;
+
+ObstaclePositionAllocatorTestSuite::ObstaclePositionAllocatorTestSuite ()
+  : TestSuite ("obstacle-position-allocator", UNIT)
+{
+  AddTestCase (new ObstacleFreeBoxPositionAllocatorTest (0.0), TestCase::QUICK);
+  AddTestCase (new ObstacleFreeBoxPositionAllocatorTest (7.0), TestCase::QUICK);
+  AddTestCase (new ObstacleFreeGridPositionAllocatorTest, TestCase::QUICK);
+}
@@ -0,0 +1,695 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/pointer.h"
+#include "ns3/box.h"
+#include "ns3/obstacle-world.h"
+#include "ns3/obstacle-shape.h"
+#include "ns3/object-factory.h"
+#include "ns3/random-walk-3d-mobility-model.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace ns3;
+
+/**
+ * Check that the closest obstacle along a ray is reported, and that
+ * obstacles out of reach are ignored.
+ */
+class ObstacleWorldClosestCollisionTest : public TestCase
+{
+public:
+  ObstacleWorldClosestCollisionTest ();
+private:
+  virtual void DoRun (void);
+};
+
+ObstacleWorldClosestCollisionTest::ObstacleWorldClosestCollisionTest ()
+  : TestCase ("Check the closest collision reported by an ObstacleWorld")
+{
+}
+
+void
+ObstacleWorldClosestCollisionTest::DoRun (void)
+{
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  world->AddObstacle (Box (50.0, 60.0, -5.0, 5.0, 0.0, 10.0));
+  world->AddObstacle (Box (20.0, 30.0, -5.0, 5.0, 0.0, 10.0));
+  world->AddObstacle (Box (20.0, 30.0, 50.0, 60.0, 0.0, 10.0));
+  NS_TEST_ASSERT_MSG_EQ (world->GetNObstacles (), 3, "Wrong number of obstacles");
+
+  Vector position (0.0, 0.1, 5.1);
+  Vector velocity (1.0, 0.001, 0.001);
+
+  double distance = 1000.0;
+  int32_t closest = world->FindClosestCollision (position, velocity, distance);
+  NS_TEST_ASSERT_MSG_EQ (closest, 1, "Wrong closest obstacle");
+  NS_TEST_EXPECT_MSG_EQ_TOL (distance, 20.0, 0.01, "Wrong distance to the closest obstacle");
+
+  distance = 10.0;
+  closest = world->FindClosestCollision (position, velocity, distance);
+  NS_TEST_ASSERT_MSG_EQ (closest, -1, "Obstacle beyond the maximum distance reported");
+  NS_TEST_EXPECT_MSG_EQ (distance, 10.0, "Distance changed without a collision");
+
+  // a hit at exactly the maximum distance is reported
+  distance = 20.0;
+  closest = world->FindClosestCollision (Vector (0.0, 0.0, 5.0), Vector (1.0, 0.0, 0.0), distance);
+  NS_TEST_ASSERT_MSG_EQ (closest, 1, "Obstacle at the maximum distance not reported");
+  NS_TEST_EXPECT_MSG_EQ (distance, 20.0, "Wrong distance to the closest obstacle");
+}
+
+/**
+ * Check the side of the obstacle reported for a collision.
+ */
+class ObstacleWorldCollisionSideTest : public TestCase
+{
+public:
+  ObstacleWorldCollisionSideTest ();
+private:
+  virtual void DoRun (void);
+  /**
+   * \param world the world to query
+   * \param position the origin of the ray
+   * \param velocity the direction of the ray
+   * \param expected the side that should be hit
+   */
+  void CheckSide (Ptr<ObstacleWorld> world, Vector position, Vector velocity, Box::Side expected);
+};
+
+ObstacleWorldCollisionSideTest::ObstacleWorldCollisionSideTest ()
+  : TestCase ("Check the side of the obstacle reported by an ObstacleWorld")
+{
+}
+
+void
+ObstacleWorldCollisionSideTest::CheckSide (Ptr<ObstacleWorld> world, Vector position, Vector velocity, Box::Side expected)
+{
+  double distance = 1000.0;
+  Box::Side side;
+  int32_t closest = world->FindClosestCollision (position, velocity, distance, side);
+  NS_TEST_ASSERT_MSG_EQ (closest, 0, "Obstacle not hit from " << position);
+  NS_TEST_EXPECT_MSG_EQ (side, expected, "Wrong side hit from " << position);
+}
+
+void
+ObstacleWorldCollisionSideTest::DoRun (void)
+{
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  world->AddObstacle (Box (10.0, 20.0, 10.0, 20.0, 10.0, 20.0));
+
+  CheckSide (world, Vector (0.0, 14.0, 16.0), Vector (1.0, 0.1, -0.1), Box::LEFT);
+  CheckSide (world, Vector (30.0, 14.0, 16.0), Vector (-1.0, 0.1, -0.1), Box::RIGHT);
+  CheckSide (world, Vector (14.0, 0.0, 16.0), Vector (0.1, 1.0, -0.1), Box::BOTTOM);
+  CheckSide (world, Vector (14.0, 30.0, 16.0), Vector (0.1, -1.0, -0.1), Box::TOP);
+  CheckSide (world, Vector (14.0, 16.0, 0.0), Vector (0.1, -0.1, 1.0), Box::DOWN);
+  CheckSide (world, Vector (14.0, 16.0, 30.0), Vector (0.1, -0.1, -1.0), Box::UP);
+
+  // moving away from an obstacle, or from its surface, is not a collision
+  double distance = 1000.0;
+  Box::Side side;
+  NS_TEST_EXPECT_MSG_EQ (world->FindClosestCollision (Vector (0.0, 14.0, 16.0), Vector (-1.0, 0.1, 0.1), distance, side),
+                         -1, "Obstacle behind the position reported");
+  NS_TEST_EXPECT_MSG_EQ (world->FindClosestCollision (Vector (10.0, 14.0, 16.0), Vector (-1.0, 0.1, 0.1), distance, side),
+                         -1, "Obstacle left through its surface reported");
+}
+
+/**
+ * Compare the indexed collision search against an exhaustive search over
+ * a random set of obstacles.
+ */
+class ObstacleWorldIndexTest : public TestCase
+{
+public:
+  ObstacleWorldIndexTest ();
+private:
+  virtual void DoRun (void);
+};
+
+ObstacleWorldIndexTest::ObstacleWorldIndexTest ()
+  : TestCase ("Check the indexed collision search of an ObstacleWorld")
+{
+}
+
+void
+ObstacleWorldIndexTest::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable> ();
+
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  std::vector<Box> obstacles;
+  for (uint32_t i = 0; i < 500; i++)
+    {
+      double x = rv->GetValue (0.0, 1000.0);
+      double y = rv->GetValue (0.0, 1000.0);
+      Box box (x, x + rv->GetValue (5.0, 30.0), y, y + rv->GetValue (5.0, 30.0), 0.0, rv->GetValue (10.0, 100.0));
+      world->AddObstacle (box);
+      obstacles.push_back (box);
+    }
+
+  uint32_t hits = 0;
+  for (uint32_t q = 0; q < 500; q++)
+    {
+      Vector position (rv->GetValue (0.0, 1000.0), rv->GetValue (0.0, 1000.0), rv->GetValue (0.0, 120.0));
+      bool outside = true;
+      for (uint32_t i = 0; i < obstacles.size (); i++)
+        {
+          outside = outside && !obstacles[i].IsInside (position);
+        }
+      if (!outside)
+        {
+          continue;
+        }
+      Vector velocity (rv->GetValue (-1.0, 1.0), rv->GetValue (-1.0, 1.0), rv->GetValue (-0.2, 0.2));
+      double speed = std::sqrt (velocity.x * velocity.x + velocity.y * velocity.y + velocity.z * velocity.z);
+
+      // exhaustive search over the parameter of the ray entry point
+      int32_t expected = -1;
+      double expectedT = 300.0 / speed;
+      for (uint32_t i = 0; i < obstacles.size (); i++)
+        {
+          const Box &b = obstacles[i];
+          double tx1 = (b.xMin - position.x) / velocity.x, tx2 = (b.xMax - position.x) / velocity.x;
+          double ty1 = (b.yMin - position.y) / velocity.y, ty2 = (b.yMax - position.y) / velocity.y;
+          double tz1 = (b.zMin - position.z) / velocity.z, tz2 = (b.zMax - position.z) / velocity.z;
+          double tNear = std::max (std::min (tx1, tx2), std::max (std::min (ty1, ty2), std::min (tz1, tz2)));
+          double tFar = std::min (std::max (tx1, tx2), std::min (std::max (ty1, ty2), std::max (tz1, tz2)));
+          if (tNear <= tFar && tNear >= 0 && tNear < expectedT)
+            {
+              expectedT = tNear;
+              expected = i;
+            }
+        }
+
+      double distance = 300.0;
+      int32_t closest = world->FindClosestCollision (position, velocity, distance);
+      NS_TEST_ASSERT_MSG_EQ (closest, expected, "Indexed search disagrees with exhaustive search from " << position);
+      if (expected != -1)
+        {
+          NS_TEST_ASSERT_MSG_EQ_TOL (distance, expectedT * speed, 1e-6, "Wrong collision distance from " << position);
+          hits++;
+        }
+    }
+  NS_TEST_ASSERT_MSG_GT (hits, 0, "No collision exercised");
+}
+
+/**
+ * Check that a single world can be shared by several mobility models
+ * through the "Obstacles" attribute.
+ */
+class ObstacleWorldSharedTest : public TestCase
+{
+public:
+  ObstacleWorldSharedTest ();
+private:
+  virtual void DoRun (void);
+};
+
+ObstacleWorldSharedTest::ObstacleWorldSharedTest ()
+  : TestCase ("Check that an ObstacleWorld is shared by the mobility models")
+{
+}
+
+void
+ObstacleWorldSharedTest::DoRun (void)
+{
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  world->AddObstacle (Box (20.0, 30.0, 20.0, 30.0, 0.0, 10.0));
+
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::RandomWalk3dMobilityModel");
+  factory.Set ("Obstacles", PointerValue (world));
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Ptr<RandomWalk3dMobilityModel> model = factory.Create<RandomWalk3dMobilityModel> ();
+      PointerValue value;
+      model->GetAttribute ("Obstacles", value);
+      NS_TEST_ASSERT_MSG_EQ (value.Get<ObstacleWorld> (), world, "Obstacle world not shared");
+      model->Dispose ();
+    }
+  Simulator::Destroy ();
+}
+
+/**
+ * Check the next event of a walk: the earliest of the mode timeout, the
+ * bounds and the obstacles, with the reflected velocity.
+ */
+class ObstacleWorldWalkEventTest : public TestCase
+{
+public:
+  ObstacleWorldWalkEventTest ();
+private:
+  virtual void DoRun (void);
+};
+
+ObstacleWorldWalkEventTest::ObstacleWorldWalkEventTest ()
+  : TestCase ("Check the next walk event in the bounds and obstacles")
+{
+}
+
+void
+ObstacleWorldWalkEventTest::DoRun (void)
+{
+  Box bounds (0.0, 100.0, 0.0, 100.0, 0.0, 100.0);
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  world->AddObstacle (Box (50.0, 60.0, 40.0, 60.0, 0.0, 50.0));
+
+  // nothing is reached before the timeout
+  WalkEvent event = CalculateWalkEvent (bounds, PeekPointer (world), Vector (10.0, 10.0, 10.0), Vector (2.0, 0.0, 0.0), 5.0);
+  NS_TEST_ASSERT_MSG_EQ (event.type, WalkEvent::TIMEOUT, "Timeout expected");
+  NS_TEST_EXPECT_MSG_EQ (event.delay, 5.0, "Wrong timeout delay");
+  NS_TEST_EXPECT_MSG_EQ (event.velocity.x, 2.0, "Velocity changed on a timeout");
+
+  // the bounds are reached first, at the exact time of the slab exit
+  event = CalculateWalkEvent (bounds, PeekPointer (world), Vector (10.0, 10.0, 10.0), Vector (2.0, 0.0, 0.0), 100.0);
+  NS_TEST_ASSERT_MSG_EQ (event.type, WalkEvent::BOUNDS, "Bounds expected");
+  NS_TEST_EXPECT_MSG_EQ (event.delay, 45.0, "Wrong delay to the bounds");
+  NS_TEST_EXPECT_MSG_EQ (event.side, Box::RIGHT, "Wrong side of the bounds");
+  NS_TEST_EXPECT_MSG_EQ (event.velocity.x, -2.0, "Velocity not reflected on the bounds");
+
+  // reaching a corner reflects both axes
+  event = CalculateWalkEvent (bounds, 0, Vector (90.0, 10.0, 10.0), Vector (1.0, -1.0, 0.0), 100.0);
+  NS_TEST_ASSERT_MSG_EQ (event.type, WalkEvent::BOUNDS, "Bounds expected");
+  NS_TEST_EXPECT_MSG_EQ (event.delay, 10.0, "Wrong delay to the corner");
+  NS_TEST_EXPECT_MSG_EQ (event.velocity.x, -1.0, "Velocity not reflected on the first side");
+  NS_TEST_EXPECT_MSG_EQ (event.velocity.y, 1.0, "Velocity not reflected on the second side");
+
+  // an obstacle before the bounds and the timeout
+  event = CalculateWalkEvent (bounds, PeekPointer (world), Vector (10.0, 50.0, 10.0), Vector (4.0, 0.0, 0.0), 100.0);
+  NS_TEST_ASSERT_MSG_EQ (event.type, WalkEvent::OBSTACLE, "Obstacle expected");
+  NS_TEST_EXPECT_MSG_EQ (event.obstacle, 0, "Wrong obstacle");
+  NS_TEST_EXPECT_MSG_EQ (event.side, Box::LEFT, "Wrong side of the obstacle");
+  NS_TEST_EXPECT_MSG_EQ_TOL (event.delay, 10.0, 1e-9, "Wrong delay to the obstacle");
+  NS_TEST_EXPECT_MSG_EQ (event.velocity.x, -4.0, "Velocity not reflected on the obstacle");
+
+  // the obstacle beyond the timeout is ignored, and the delay never
+  // exceeds the timeout
+  event = CalculateWalkEvent (bounds, PeekPointer (world), Vector (10.0, 50.0, 10.0), Vector (4.0, 0.0, 0.0), 9.0);
+  NS_TEST_ASSERT_MSG_EQ (event.type, WalkEvent::TIMEOUT, "Obstacle beyond the timeout reported");
+  NS_TEST_EXPECT_MSG_EQ (event.delay, 9.0, "Wrong timeout delay");
+
+  // a still node never reaches anything
+  event = CalculateWalkEvent (bounds, PeekPointer (world), Vector (10.0, 50.0, 10.0), Vector (0.0, 0.0, 0.0), 9.0);
+  NS_TEST_ASSERT_MSG_EQ (event.type, WalkEvent::TIMEOUT, "Still node reached something");
+}
+
+/**
+ * Check the intersection of rays with prisms and convex hulls, alone and
+ * indexed along with boxes.
+ */
+class ObstacleWorldShapeTest : public TestCase
+{
+public:
+  ObstacleWorldShapeTest ();
+private:
+  virtual void DoRun (void);
+};
+
+ObstacleWorldShapeTest::ObstacleWorldShapeTest ()
+  : TestCase ("Check the collisions with prism and convex obstacles")
+{
+}
+
+void
+ObstacleWorldShapeTest::DoRun (void)
+{
+  // an L-shaped footprint, given clockwise
+  std::vector<Vector2D> footprint;
+  footprint.push_back (Vector2D (0.0, 0.0));
+  footprint.push_back (Vector2D (0.0, 20.0));
+  footprint.push_back (Vector2D (10.0, 20.0));
+  footprint.push_back (Vector2D (10.0, 10.0));
+  footprint.push_back (Vector2D (20.0, 10.0));
+  footprint.push_back (Vector2D (20.0, 0.0));
+  Ptr<PrismObstacle> prism = Create<PrismObstacle> (footprint, 0.0, 10.0);
+  NS_TEST_EXPECT_MSG_EQ (prism->IsInside (Vector (5.0, 15.0, 5.0)), true, "Point of the footprint not inside");
+  NS_TEST_EXPECT_MSG_EQ (prism->IsInside (Vector (15.0, 15.0, 5.0)), false, "Point of the notch inside");
+  NS_TEST_EXPECT_MSG_EQ (prism->IsInside (Vector (5.0, 15.0, 11.0)), false, "Point above the roof inside");
+
+  double t;
+  Vector normal;
+  // from the notch, inside the bounding box but outside of the prism
+  NS_TEST_ASSERT_MSG_EQ (prism->Intersect (Vector (15.0, 15.0, 5.0), Vector (-2.0, 0.0, 0.0), t, normal), true, "Inner wall missed");
+  NS_TEST_EXPECT_MSG_EQ_TOL (t, 2.5, 1e-12, "Wrong time to the inner wall");
+  NS_TEST_EXPECT_MSG_EQ (CalculateDistance (normal, Vector (1.0, 0.0, 0.0)), 0.0, "Wrong normal of the inner wall");
+  NS_TEST_EXPECT_MSG_EQ (prism->Intersect (Vector (15.0, 15.0, 5.0), Vector (1.0, 0.0, 0.0), t, normal), false, "Hit out of the notch");
+  NS_TEST_ASSERT_MSG_EQ (prism->Intersect (Vector (5.0, 5.0, 20.0), Vector (0.0, 0.0, -1.0), t, normal), true, "Roof missed");
+  NS_TEST_EXPECT_MSG_EQ_TOL (t, 10.0, 1e-12, "Wrong time to the roof");
+  NS_TEST_EXPECT_MSG_EQ (normal.z, 1.0, "Wrong normal of the roof");
+  // leaving a wall it stands on
+  NS_TEST_EXPECT_MSG_EQ (prism->Intersect (Vector (10.0, 15.0, 5.0), Vector (1.0, 0.0, 0.0), t, normal), false, "Wall hit when leaving it");
+
+  // a diamond column, as the hull of its corners and of an inner point
+  std::vector<Vector> points;
+  for (uint32_t z = 0; z < 2; z++)
+    {
+      points.push_back (Vector (50.0, 40.0, 10.0 * z));
+      points.push_back (Vector (60.0, 50.0, 10.0 * z));
+      points.push_back (Vector (50.0, 60.0, 10.0 * z));
+      points.push_back (Vector (40.0, 50.0, 10.0 * z));
+    }
+  points.push_back (Vector (50.0, 50.0, 5.0));
+  Ptr<ConvexObstacle> diamond = Create<ConvexObstacle> (points);
+  NS_TEST_EXPECT_MSG_EQ (diamond->GetNFaces (), 6, "Wrong number of faces");
+  NS_TEST_EXPECT_MSG_EQ (diamond->IsInside (Vector (50.0, 50.0, 5.0)), true, "Center not inside");
+  NS_TEST_EXPECT_MSG_EQ (diamond->IsInside (Vector (42.0, 42.0, 5.0)), false, "Corner of the bounding box inside");
+  NS_TEST_ASSERT_MSG_EQ (diamond->Intersect (Vector (30.0, 30.0, 5.0), Vector (1.0, 1.0, 0.0), t, normal), true, "Face missed");
+  NS_TEST_EXPECT_MSG_EQ_TOL (t, 15.0, 1e-9, "Wrong time to the face");
+  NS_TEST_EXPECT_MSG_EQ_TOL (normal.x, -std::sqrt (0.5), 1e-12, "Wrong normal of the face");
+  NS_TEST_EXPECT_MSG_EQ_TOL (normal.y, -std::sqrt (0.5), 1e-12, "Wrong normal of the face");
+  NS_TEST_EXPECT_MSG_EQ (diamond->Intersect (Vector (42.0, 42.0, 5.0), Vector (-1.0, 0.0, 0.0), t, normal), false, "Hit behind the ray");
+
+  // indexed along with a box
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  world->AddObstacle (Box (80.0, 90.0, 0.0, 100.0, 0.0, 10.0));
+  world->AddObstacle (prism);
+  world->AddObstacle (diamond);
+  NS_TEST_EXPECT_MSG_EQ (world->GetShape (0), 0, "Box obstacle has a shape");
+  NS_TEST_EXPECT_MSG_EQ (world->GetShape (2), diamond, "Shape not kept");
+  NS_TEST_EXPECT_MSG_EQ (world->GetObstacle (1).xMax, 20.0, "Wrong bounding box of the prism");
+  double distance = 1000.0;
+  Box::Side side;
+  NS_TEST_EXPECT_MSG_EQ (world->FindClosestCollision (Vector (30.0, 47.0, 5.0), Vector (1.0, 0.0, 0.0), distance, side, normal),
+                         2, "Diamond not hit first");
+  NS_TEST_EXPECT_MSG_EQ_TOL (distance, 13.0, 1e-9, "Wrong distance to the diamond");
+  distance = 1000.0;
+  NS_TEST_EXPECT_MSG_EQ (world->FindClosestCollision (Vector (30.0, 70.0, 5.0), Vector (1.0, 0.0, 0.0), distance, side, normal),
+                         0, "Box not hit past the diamond");
+  NS_TEST_EXPECT_MSG_EQ (side, Box::LEFT, "Wrong side of the box");
+  NS_TEST_EXPECT_MSG_EQ (normal.x, -1.0, "Wrong normal of the box");
+  distance = 1000.0;
+  NS_TEST_EXPECT_MSG_EQ (world->FindClosestCollision (Vector (15.0, 15.0, 5.0), Vector (0.0, -1.0, 0.0), distance, side, normal),
+                         1, "Prism not hit from its notch");
+  NS_TEST_EXPECT_MSG_EQ_TOL (distance, 5.0, 1e-12, "Wrong distance to the prism");
+  NS_TEST_EXPECT_MSG_EQ (side, Box::TOP, "Wrong side of the prism");
+
+  // specular reflection on an oblique face
+  WalkEvent event = CalculateWalkEvent (Box (0.0, 100.0, 0.0, 100.0, 0.0, 100.0), PeekPointer (world),
+                                        Vector (30.0, 47.0, 5.0), Vector (1.0, 0.0, 0.0), 100.0);
+  NS_TEST_ASSERT_MSG_EQ (event.type, WalkEvent::OBSTACLE, "Obstacle expected");
+  NS_TEST_EXPECT_MSG_EQ_TOL (event.velocity.x, 0.0, 1e-12, "Wrong reflected velocity");
+  NS_TEST_EXPECT_MSG_EQ_TOL (event.velocity.y, -1.0, 1e-12, "Wrong reflected velocity");
+  NS_TEST_EXPECT_MSG_EQ_TOL (event.velocity.z, 0.0, 1e-12, "Wrong reflected velocity");
+}
+
+/**
+ * Check that the 3D obstacle models never walk into prism and convex
+ * obstacles.
+ */
+class ObstacleWorldShapeWalkTest : public TestCase
+{
+public:
+  /**
+   * \param model the TypeId name of the mobility model to check
+   */
+  ObstacleWorldShapeWalkTest (std::string model);
+private:
+  virtual void DoRun (void);
+  /**
+   * Check that no model is deep inside a shape
+   */
+  void Check (void);
+
+  std::string m_model; //!< name of the checked model
+  Ptr<ObstacleWorld> m_world; //!< obstacles
+  std::vector<Ptr<MobilityModel> > m_models; //!< models checked
+};
+
+ObstacleWorldShapeWalkTest::ObstacleWorldShapeWalkTest (std::string model)
+  : TestCase ("Check that " + model + " stays out of obstacle shapes"),
+    m_model (model)
+{
+}
+
+void
+ObstacleWorldShapeWalkTest::Check (void)
+{
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      Vector p = m_models[i]->GetPosition ();
+      for (uint32_t o = 0; o < m_world->GetNObstacles (); o++)
+        {
+          Ptr<const ObstacleShape> shape = m_world->GetShape (o);
+          // rounding may leave a position on a face slightly inside
+          bool inside = shape->IsInside (Vector (p.x - 1e-6, p.y, p.z)) && shape->IsInside (Vector (p.x + 1e-6, p.y, p.z))
+            && shape->IsInside (Vector (p.x, p.y - 1e-6, p.z)) && shape->IsInside (Vector (p.x, p.y + 1e-6, p.z))
+            && shape->IsInside (Vector (p.x, p.y, p.z - 1e-6)) && shape->IsInside (Vector (p.x, p.y, p.z + 1e-6));
+          NS_TEST_ASSERT_MSG_EQ (inside, false, "Node " << i << " inside obstacle " << o << " at " << p);
+        }
+    }
+}
+
+void
+ObstacleWorldShapeWalkTest::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  m_world = CreateObject<ObstacleWorld> ();
+  std::vector<Vector2D> footprint;
+  footprint.push_back (Vector2D (10.0, 10.0));
+  footprint.push_back (Vector2D (40.0, 10.0));
+  footprint.push_back (Vector2D (40.0, 20.0));
+  footprint.push_back (Vector2D (20.0, 20.0));
+  footprint.push_back (Vector2D (20.0, 40.0));
+  footprint.push_back (Vector2D (10.0, 40.0));
+  m_world->AddObstacle (Create<PrismObstacle> (footprint, 0.0, 60.0));
+  std::vector<Vector> points;
+  points.push_back (Vector (70.0, 50.0, 0.0));
+  points.push_back (Vector (90.0, 70.0, 0.0));
+  points.push_back (Vector (70.0, 90.0, 0.0));
+  points.push_back (Vector (50.0, 70.0, 0.0));
+  points.push_back (Vector (70.0, 70.0, 80.0));
+  m_world->AddObstacle (Create<ConvexObstacle> (points));
+
+  ObjectFactory factory;
+  factory.SetTypeId (m_model);
+  factory.Set ("Bounds", BoxValue (Box (0.0, 100.0, 0.0, 100.0, 0.0, 100.0)));
+  factory.Set ("Obstacles", PointerValue (m_world));
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Ptr<MobilityModel> model = factory.Create<MobilityModel> ();
+      model->SetPosition (Vector (5.0 + 9.0 * i, 95.0 - 4.0 * i, 90.0));
+      model->Initialize ();
+      m_models.push_back (model);
+    }
+  for (double t = 0.0; t < 300.0; t += 0.1)
+    {
+      Simulator::Schedule (Seconds (t), &ObstacleWorldShapeWalkTest::Check, this);
+    }
+  Simulator::Stop (Seconds (300.0));
+  Simulator::Run ();
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      m_models[i]->Dispose ();
+    }
+  m_models.clear ();
+  Simulator::Destroy ();
+}
+
+/**
+ * Check the segment queries of an ObstacleWorld against an exhaustive
+ * search, with boxes and a shape.
+ */
+class ObstacleWorldCrossingTest : public TestCase
+{
+public:
+  ObstacleWorldCrossingTest ();
+private:
+  virtual void DoRun (void);
+};
+
+ObstacleWorldCrossingTest::ObstacleWorldCrossingTest ()
+  : TestCase ("Check the segment crossings of an ObstacleWorld")
+{
+}
+
+void
+ObstacleWorldCrossingTest::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (2);
+  Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable> ();
+
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  std::vector<Box> obstacles;
+  for (uint32_t i = 0; i < 300; i++)
+    {
+      double x = rv->GetValue (0.0, 1000.0);
+      double y = rv->GetValue (0.0, 1000.0);
+      Box box (x, x + rv->GetValue (5.0, 30.0), y, y + rv->GetValue (5.0, 30.0), 0.0, rv->GetValue (10.0, 100.0));
+      world->AddObstacle (box);
+      obstacles.push_back (box);
+    }
+
+  std::vector<ObstacleCrossing> crossings;
+  uint32_t blocked = 0;
+  for (uint32_t q = 0; q < 300; q++)
+    {
+      Vector a (rv->GetValue (0.0, 1000.0), rv->GetValue (0.0, 1000.0), rv->GetValue (0.0, 120.0));
+      Vector b (rv->GetValue (0.0, 1000.0), rv->GetValue (0.0, 1000.0), rv->GetValue (0.0, 120.0));
+      std::vector<uint32_t> expected;
+      for (uint32_t i = 0; i < obstacles.size (); i++)
+        {
+          const Box &o = obstacles[i];
+          double tx1 = (o.xMin - a.x) / (b.x - a.x), tx2 = (o.xMax - a.x) / (b.x - a.x);
+          double ty1 = (o.yMin - a.y) / (b.y - a.y), ty2 = (o.yMax - a.y) / (b.y - a.y);
+          double tz1 = (o.zMin - a.z) / (b.z - a.z), tz2 = (o.zMax - a.z) / (b.z - a.z);
+          double tNear = std::max (std::min (tx1, tx2), std::max (std::min (ty1, ty2), std::min (tz1, tz2)));
+          double tFar = std::min (std::max (tx1, tx2), std::min (std::max (ty1, ty2), std::max (tz1, tz2)));
+          if (tNear <= tFar && tFar >= 0 && tNear <= 1)
+            {
+              expected.push_back (i);
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (world->FindCrossings (a, b, crossings), expected.size (), "Wrong number of crossings");
+      NS_TEST_ASSERT_MSG_EQ (world->IsBlocked (a, b), !expected.empty (), "Wrong line of sight");
+      std::vector<uint32_t> found;
+      for (uint32_t i = 0; i < crossings.size (); i++)
+        {
+          found.push_back (crossings[i].obstacle);
+          NS_TEST_ASSERT_MSG_EQ ((crossings[i].enter <= crossings[i].exit), true, "Crossing inverted");
+        }
+      std::sort (found.begin (), found.end ());
+      NS_TEST_ASSERT_MSG_EQ ((found == expected), true, "Wrong obstacles crossed");
+      blocked += !expected.empty ();
+    }
+  NS_TEST_ASSERT_MSG_GT (blocked, 0, "No crossing exercised");
+
+  // the ends may be inside an obstacle, and a concave shape spans from the
+  // first entry to the last exit
+  world = CreateObject<ObstacleWorld> ();
+  world->AddObstacle (Box (0.0, 10.0, 0.0, 10.0, 0.0, 10.0));
+  std::vector<Vector2D> u;
+  u.push_back (Vector2D (20.0, 0.0));
+  u.push_back (Vector2D (50.0, 0.0));
+  u.push_back (Vector2D (50.0, 10.0));
+  u.push_back (Vector2D (40.0, 10.0));
+  u.push_back (Vector2D (40.0, 5.0));
+  u.push_back (Vector2D (30.0, 5.0));
+  u.push_back (Vector2D (30.0, 10.0));
+  u.push_back (Vector2D (20.0, 10.0));
+  world->AddObstacle (Create<PrismObstacle> (u, 0.0, 10.0));
+  NS_TEST_ASSERT_MSG_EQ (world->FindCrossings (Vector (5.0, 8.0, 1.0), Vector (60.0, 8.0, 1.0), crossings), 2, "Wrong crossings");
+  for (uint32_t i = 0; i < crossings.size (); i++)
+    {
+      double enter = crossings[i].obstacle == 0 ? 0.0 : 15.0 / 55.0;
+      double exit = crossings[i].obstacle == 0 ? 5.0 / 55.0 : 45.0 / 55.0;
+      NS_TEST_EXPECT_MSG_EQ_TOL (crossings[i].enter, enter, 1e-9, "Wrong entry");
+      NS_TEST_EXPECT_MSG_EQ_TOL (crossings[i].exit, exit, 1e-9, "Wrong exit");
+    }
+  // the segment through the notch of the U, above its floor
+  NS_TEST_EXPECT_MSG_EQ (world->IsBlocked (Vector (35.0, 7.0, 1.0), Vector (35.0, 20.0, 1.0)), false, "Notch blocks");
+  NS_TEST_EXPECT_MSG_EQ (world->IsBlocked (Vector (35.0, 7.0, 1.0), Vector (35.0, -5.0, 1.0)), true, "Base does not block");
+}
+
+/**
+ * Check that the obstacle containing a position is found, against a
+ * test of every obstacle.
+ */
+class ObstacleWorldFindObstacleTest : public TestCase
+{
+public:
+  ObstacleWorldFindObstacleTest ();
+private:
+  virtual void DoRun (void);
+};
+
+ObstacleWorldFindObstacleTest::ObstacleWorldFindObstacleTest ()
+  : TestCase ("Check the obstacle containing a position")
+{
+}
+
+void
+ObstacleWorldFindObstacleTest::DoRun (void)
+{
+  RngSeedManager::SetSeed (5);
+  RngSeedManager::SetRun (1);
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  NS_TEST_ASSERT_MSG_EQ (world->FindObstacle (Vector (1.0, 1.0, 1.0)), -1, "Obstacle found in an empty world");
+
+  for (uint32_t i = 0; i < 200; ++i)
+    {
+      double x = random->GetValue (0.0, 190.0);
+      double y = random->GetValue (0.0, 190.0);
+      world->AddObstacle (Box (x, x + 10.0, y, y + 10.0, 0.0, random->GetValue (5.0, 50.0)));
+    }
+  std::vector<Vector2D> footprint;
+  footprint.push_back (Vector2D (0.0, 0.0));
+  footprint.push_back (Vector2D (0.0, 20.0));
+  footprint.push_back (Vector2D (10.0, 20.0));
+  footprint.push_back (Vector2D (10.0, 10.0));
+  footprint.push_back (Vector2D (20.0, 10.0));
+  footprint.push_back (Vector2D (20.0, 0.0));
+  world->AddObstacle (Create<PrismObstacle> (footprint, 60.0, 70.0));
+
+  // the notch of the L is inside the bounding box only
+  NS_TEST_EXPECT_MSG_EQ (world->FindObstacle (Vector (5.0, 5.0, 65.0)), 200, "Prism not found");
+  NS_TEST_EXPECT_MSG_EQ (world->FindObstacle (Vector (15.0, 15.0, 65.0)), -1, "Notch of the prism found");
+  // the surface is outside, as for Box::IsOutside
+  NS_TEST_EXPECT_MSG_EQ (world->FindObstacle (Vector (5.0, 5.0, 70.0)), -1, "Roof of the prism found");
+
+  for (uint32_t n = 0; n < 10000; ++n)
+    {
+      Vector position (random->GetValue (0.0, 200.0), random->GetValue (0.0, 200.0),
+                       random->GetValue (0.0, 55.0));
+      bool inside = false;
+      for (uint32_t i = 0; i < 200 && !inside; ++i)
+        {
+          inside = !world->GetObstacle (i).IsOutside (position);
+        }
+      int32_t found = world->FindObstacle (position);
+      bool isFound = found != -1;
+      NS_TEST_ASSERT_MSG_EQ (isFound, inside, "Wrong containment of " << position);
+      if (found != -1)
+        {
+          NS_TEST_ASSERT_MSG_EQ (world->GetObstacle (found).IsOutside (position), false,
+                                 "Obstacle found does not contain " << position);
+        }
+    }
+}
+
+static class ObstacleWorldTestSuite : public TestSuite
+{
+public:
+  ObstacleWorldTestSuite ();
+} g_obstacleWorldTestSuite;
+
+ObstacleWorldTestSuite::ObstacleWorldTestSuite ()
+  : TestSuite ("obstacle-world", UNIT)
+{
+  AddTestCase (new ObstacleWorldClosestCollisionTest, TestCase::QUICK);
+  AddTestCase (new ObstacleWorldCollisionSideTest, TestCase::QUICK);
+  AddTestCase (new ObstacleWorldIndexTest, TestCase::QUICK);
+  AddTestCase (new ObstacleWorldSharedTest, TestCase::QUICK);
+  AddTestCase (new ObstacleWorldWalkEventTest, TestCase::QUICK);
+  AddTestCase (new ObstacleWorldShapeTest, TestCase::QUICK);
+  AddTestCase (new ObstacleWorldCrossingTest, TestCase::QUICK);
+  AddTestCase (new ObstacleWorldFindObstacleTest, TestCase::QUICK);
+  AddTestCase (new ObstacleWorldShapeWalkTest ("ns3::RandomWalk3dMobilityModel"), TestCase::QUICK);
+  AddTestCase (new ObstacleWorldShapeWalkTest ("ns3::RandomDirection3dMobilityModel"), TestCase::QUICK);
+  AddTestCase (new ObstacleWorldShapeWalkTest ("ns3::ObstacleGaussMarkovMobilityModel"), TestCase::QUICK);
+}
@@ -0,0 +1,288 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/pointer.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/callback.h"
+#include "ns3/box.h"
+#include "ns3/obstacle-world.h"
+#include "ns3/navigation-grid.h"
+#include "ns3/path-planning-mobility-model.h"
+#include "ns3/obstacle-position-allocator.h"
+#include "ns3/rng-seed-manager.h"
+#include <cmath>
+
+using namespace ns3;
+
+/**
+ * \param path the corners of a path
+ * \return the length of the path
+ */
+static double
+GetLength (const std::vector<Vector> &path)
+{
+  double length = 0.0;
+  for (uint32_t i = 1; i < path.size (); ++i)
+    {
+      length += CalculateDistance (path[i - 1], path[i]);
+    }
+  return length;
+}
+
+/**
+ * Create a world with a wall across the middle of the bounds
+ * (0, 100, 0, 100, 0, 20), open for y > 80.
+ *
+ * \return the world
+ */
+static Ptr<ObstacleWorld>
+CreateWallWorld (void)
+{
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  world->AddObstacle (Box (40.0, 60.0, 0.0, 80.0, 0.0, 20.0));
+  return world;
+}
+
+/**
+ * Check the paths planned around a wall, and the ends which cannot be
+ * joined.
+ */
+class NavigationGridPathTest : public TestCase
+{
+public:
+  NavigationGridPathTest ();
+private:
+  virtual void DoRun (void);
+};
+
+NavigationGridPathTest::NavigationGridPathTest ()
+  : TestCase ("Check the paths planned around obstacles")
+{
+}
+
+void
+NavigationGridPathTest::DoRun (void)
+{
+  Ptr<ObstacleWorld> world = CreateWallWorld ();
+  Ptr<NavigationGrid> navigation = CreateObject<NavigationGrid> ();
+  navigation->SetAttribute ("Bounds", BoxValue (Box (0.0, 100.0, 0.0, 100.0, 0.0, 20.0)));
+  navigation->SetAttribute ("Resolution", DoubleValue (5.0));
+  navigation->SetAttribute ("Obstacles", PointerValue (world));
+  NS_TEST_ASSERT_MSG_EQ (navigation->GetNCells (), 20 * 20 * 4, "Wrong number of cells");
+  NS_TEST_ASSERT_MSG_EQ (navigation->GetNBlocked (), 4 * 16 * 4, "Wrong number of blocked cells");
+
+  std::vector<Vector> path;
+  Vector from (10.0, 10.0, 10.0);
+  Vector to (90.0, 10.0, 10.0);
+  bool found = navigation->FindPath (from, to, path);
+  NS_TEST_ASSERT_MSG_EQ (found, true, "No path around the wall");
+  NS_TEST_ASSERT_MSG_GT (path.size (), 2, "Path through the wall");
+  NS_TEST_EXPECT_MSG_EQ (CalculateDistance (path.front (), from), 0.0, "Path does not start at the start");
+  NS_TEST_EXPECT_MSG_EQ (CalculateDistance (path.back (), to), 0.0, "Path does not end at the end");
+  for (uint32_t i = 1; i < path.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (world->IsBlocked (path[i - 1], path[i]), false,
+                             "Leg " << path[i - 1] << " " << path[i] << " crosses the wall");
+    }
+  // the shortest path goes over the corners (40, 80) and (60, 80)
+  double shortest = 2 * std::sqrt (30.0 * 30.0 + 70.0 * 70.0) + 20.0;
+  double length = GetLength (path);
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (length, shortest - 1e-9, "Path shorter than possible");
+  NS_TEST_EXPECT_MSG_LT (length, 1.05 * shortest, "Path much longer than the shortest");
+
+  // in sight, the path is straight
+  found = navigation->FindPath (from, Vector (30.0, 90.0, 5.0), path);
+  NS_TEST_ASSERT_MSG_EQ (found, true, "No straight path");
+  NS_TEST_EXPECT_MSG_EQ (path.size (), 2, "Straight path with corners");
+
+  // an end inside the wall, or out of the bounds
+  found = navigation->FindPath (from, Vector (50.0, 10.0, 10.0), path);
+  NS_TEST_EXPECT_MSG_EQ (found, false, "Path into the wall");
+  found = navigation->FindPath (from, Vector (150.0, 10.0, 10.0), path);
+  NS_TEST_EXPECT_MSG_EQ (found, false, "Path out of the bounds");
+
+  // closing the gap leaves no path, until the grid is rebuilt without it
+  world->AddObstacle (Box (40.0, 60.0, 80.0, 100.0, 0.0, 20.0));
+  found = navigation->FindPath (from, to, path);
+  NS_TEST_EXPECT_MSG_EQ (found, false, "Path through the closed wall");
+}
+
+/**
+ * Check that a node flying to its targets never enters an obstacle and
+ * reaches them in time.
+ */
+class PathPlanningMobilityModelTest : public TestCase
+{
+public:
+  PathPlanningMobilityModelTest ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the position of the node, and schedule the next check
+   */
+  void Check (void);
+  /**
+   * Count a course change of the random node
+   * \param model the model of the node
+   */
+  void CourseChange (Ptr<const MobilityModel> model);
+
+  Ptr<ObstacleWorld> m_world; //!< obstacles
+  Ptr<PathPlanningMobilityModel> m_model; //!< model of the node flying to given targets
+  Ptr<PathPlanningMobilityModel> m_random; //!< model of the node flying to random targets
+  uint32_t m_changes; //!< course changes of the random node
+};
+
+PathPlanningMobilityModelTest::PathPlanningMobilityModelTest ()
+  : TestCase ("Check the motion of the path planning mobility model"),
+    m_changes (0)
+{
+}
+
+void
+PathPlanningMobilityModelTest::Check (void)
+{
+  Vector position = m_model->GetPosition ();
+  NS_TEST_ASSERT_MSG_EQ (m_world->FindObstacle (position), -1, "Node at " << position << " inside the wall");
+  Vector random = m_random->GetPosition ();
+  NS_TEST_ASSERT_MSG_EQ (m_world->FindObstacle (random), -1, "Node at " << random << " inside the wall");
+  NS_TEST_ASSERT_MSG_EQ (Box (0.0, 100.0, 0.0, 100.0, 0.0, 20.0).IsInside (random), true,
+                         "Node at " << random << " out of the bounds");
+  Simulator::Schedule (Seconds (0.1), &PathPlanningMobilityModelTest::Check, this);
+}
+
+void
+PathPlanningMobilityModelTest::CourseChange (Ptr<const MobilityModel> model)
+{
+  m_changes++;
+}
+
+void
+PathPlanningMobilityModelTest::DoRun (void)
+{
+  RngSeedManager::SetSeed (7);
+  RngSeedManager::SetRun (1);
+  m_world = CreateWallWorld ();
+  Box bounds (0.0, 100.0, 0.0, 100.0, 0.0, 20.0);
+  Ptr<NavigationGrid> navigation = CreateObject<NavigationGrid> ();
+  navigation->SetAttribute ("Bounds", BoxValue (bounds));
+  navigation->SetAttribute ("Obstacles", PointerValue (m_world));
+
+  m_model = CreateObject<PathPlanningMobilityModel> ();
+  m_model->SetAttribute ("Navigation", PointerValue (navigation));
+  m_model->SetAttribute ("Speed", StringValue ("ns3::ConstantRandomVariable[Constant=10.0]"));
+  m_model->SetPosition (Vector (10.0, 10.0, 10.0));
+  bool added = m_model->AddTarget (Vector (90.0, 10.0, 10.0));
+  NS_TEST_ASSERT_MSG_EQ (added, true, "Target not reached");
+  // an unreachable target leaves the path unchanged
+  added = m_model->AddTarget (Vector (50.0, 10.0, 10.0));
+  NS_TEST_ASSERT_MSG_EQ (added, false, "Target inside the wall reached");
+  // then back, from the end of the first path
+  added = m_model->AddTarget (Vector (10.0, 10.0, 10.0));
+  NS_TEST_ASSERT_MSG_EQ (added, true, "Target not reached");
+
+  Ptr<ObstacleFreeBoxPositionAllocator> targets = CreateObject<ObstacleFreeBoxPositionAllocator> ();
+  targets->SetAttribute ("Bounds", BoxValue (bounds));
+  targets->SetAttribute ("Obstacles", PointerValue (m_world));
+  m_random = CreateObject<PathPlanningMobilityModel> ();
+  m_random->SetAttribute ("Navigation", PointerValue (navigation));
+  m_random->SetAttribute ("Targets", PointerValue (targets));
+  m_random->SetAttribute ("Pause", StringValue ("ns3::ConstantRandomVariable[Constant=1.0]"));
+  m_random->SetPosition (Vector (90.0, 90.0, 10.0));
+  m_random->AssignStreams (1);
+  m_random->TraceConnectWithoutContext ("CourseChange",
+                                        MakeCallback (&PathPlanningMobilityModelTest::CourseChange, this));
+  m_random->Initialize ();
+
+  Simulator::Schedule (Seconds (0.05), &PathPlanningMobilityModelTest::Check, this);
+  // the shortest path, both ways, at 10 m/s
+  double shortest = 2 * std::sqrt (30.0 * 30.0 + 70.0 * 70.0) + 20.0;
+  Simulator::Stop (Seconds (2 * 1.05 * shortest / 10.0));
+  Simulator::Run ();
+
+  Vector end = m_model->GetPosition ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (CalculateDistance (end, Vector (10.0, 10.0, 10.0)), 0.0, 1e-6,
+                             "Node not back at its start");
+  // a course change at each corner of each path
+  NS_TEST_EXPECT_MSG_GT (m_changes, 3, "Random node not flying to its targets");
+  Simulator::Destroy ();
+}
+
+/**
+ * Check that a node flying to random targets draws no more of them once
+ * its model is disposed during the simulation.
+ */
+class PathPlanningDisposeTest : public TestCase
+{
+public:
+  PathPlanningDisposeTest ();
+private:
+  virtual void DoRun (void);
+};
+
+PathPlanningDisposeTest::PathPlanningDisposeTest ()
+  : TestCase ("Check the disposal of the path planning mobility model while it flies")
+{
+}
+
+void
+PathPlanningDisposeTest::DoRun (void)
+{
+  Ptr<ObstacleWorld> world = CreateWallWorld ();
+  Box bounds (0.0, 100.0, 0.0, 100.0, 0.0, 20.0);
+  Ptr<NavigationGrid> navigation = CreateObject<NavigationGrid> ();
+  navigation->SetAttribute ("Bounds", BoxValue (bounds));
+  navigation->SetAttribute ("Obstacles", PointerValue (world));
+  Ptr<ObstacleFreeBoxPositionAllocator> targets = CreateObject<ObstacleFreeBoxPositionAllocator> ();
+  targets->SetAttribute ("Bounds", BoxValue (bounds));
+  targets->SetAttribute ("Obstacles", PointerValue (world));
+
+  Ptr<PathPlanningMobilityModel> model = CreateObject<PathPlanningMobilityModel> ();
+  model->SetAttribute ("Navigation", PointerValue (navigation));
+  model->SetAttribute ("Targets", PointerValue (targets));
+  model->SetAttribute ("Speed", StringValue ("ns3::ConstantRandomVariable[Constant=50.0]"));
+  model->SetAttribute ("Pause", StringValue ("ns3::ConstantRandomVariable[Constant=0.5]"));
+  model->SetPosition (Vector (90.0, 90.0, 10.0));
+  model->Initialize ();
+
+  // the next target would be drawn after the disposal, without targets
+  Simulator::Schedule (Seconds (0.1), &PathPlanningMobilityModel::Dispose, model);
+  Simulator::Stop (Seconds (60.0));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), Seconds (60.0), "Simulation not run to its end");
+  Simulator::Destroy ();
+}
+
+static class PathPlanningTestSuite : public TestSuite
+{
+public:
+  PathPlanningTestSuite ();
+} g_pathPlanningTestSuite;
+
+PathPlanningTestSuite::PathPlanningTestSuite ()
+  : TestSuite ("path-planning", UNIT)
+{
+  AddTestCase (new NavigationGridPathTest, TestCase::QUICK);
+  AddTestCase (new PathPlanningMobilityModelTest, TestCase::QUICK);
+  AddTestCase (new PathPlanningDisposeTest, TestCase::QUICK);
+}
@@ -0,0 +1,204 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/box.h"
+#include "ns3/obstacle-world.h"
+#include "ns3/mobility-model.h"
+#include "ns3/piecewise-linear-trajectory.h"
+#include "ns3/random-variable-stream.h"
+
+using namespace ns3;
+
+/**
+ * Check the evaluation of a piecewise linear trajectory.
+ */
+class PiecewiseLinearTrajectoryTest : public TestCase
+{
+public:
+  PiecewiseLinearTrajectoryTest ();
+private:
+  virtual void DoRun (void);
+};
+
+PiecewiseLinearTrajectoryTest::PiecewiseLinearTrajectoryTest ()
+  : TestCase ("Check the evaluation of a PiecewiseLinearTrajectory")
+{
+}
+
+void
+PiecewiseLinearTrajectoryTest::DoRun (void)
+{
+  PiecewiseLinearTrajectory trajectory;
+  trajectory.AddLeg (Seconds (0.0), Vector (0.0, 0.0, 0.0), Vector (1.0, 0.0, 0.0));
+  trajectory.AddLeg (Seconds (10.0), Vector (10.0, 0.0, 0.0), Vector (0.0, 2.0, 0.0));
+  trajectory.AddLeg (Seconds (20.0), Vector (10.0, 20.0, 0.0), Vector (0.0, 0.0, 0.0));
+  // a leg starting with the last one replaces it
+  trajectory.AddLeg (Seconds (20.0), Vector (10.0, 20.0, 0.0), Vector (0.0, 0.0, -1.0));
+  NS_TEST_ASSERT_MSG_EQ (trajectory.GetNLegs (), 3, "Wrong number of legs");
+  NS_TEST_ASSERT_MSG_EQ (trajectory.GetLastStart (), Seconds (20.0), "Wrong last leg");
+
+  Vector position = trajectory.GetPosition (Seconds (5.0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (position.x, 5.0, 1e-9, "Wrong position in the first leg");
+  position = trajectory.GetPosition (Seconds (15.0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (position.x, 10.0, 1e-9, "Wrong position in the second leg");
+  NS_TEST_EXPECT_MSG_EQ_TOL (position.y, 10.0, 1e-9, "Wrong position in the second leg");
+  position = trajectory.GetPosition (Seconds (25.0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (position.z, -5.0, 1e-9, "Wrong position in the last leg");
+  position = trajectory.GetPosition (Seconds (25.0), Box (0.0, 100.0, 0.0, 100.0, 0.0, 100.0));
+  NS_TEST_EXPECT_MSG_EQ (position.z, 0.0, "Position not moved inside the bounds");
+  NS_TEST_EXPECT_MSG_EQ_TOL (trajectory.GetVelocity (Seconds (10.0)).y, 2.0, 1e-9, "Wrong velocity at a leg start");
+
+  // the leg in progress is kept, together with the later ones
+  trajectory.DiscardBefore (Seconds (15.0));
+  NS_TEST_ASSERT_MSG_EQ (trajectory.GetNLegs (), 2, "Wrong number of legs kept");
+  position = trajectory.GetPosition (Seconds (15.0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (position.y, 10.0, 1e-9, "Wrong position after discarding legs");
+
+  for (uint32_t i = 3; i < 100; i++)
+    {
+      trajectory.AddLeg (Seconds (10.0 * i), Vector (i, 0.0, 0.0), Vector (0.0, 0.0, 0.0));
+    }
+  trajectory.DiscardBefore (Seconds (505.0));
+  NS_TEST_ASSERT_MSG_EQ (trajectory.GetNLegs (), 50, "Wrong number of legs kept");
+  NS_TEST_EXPECT_MSG_EQ_TOL (trajectory.GetPosition (Seconds (733.0)).x, 73.0, 1e-9, "Wrong leg found");
+}
+
+/**
+ * Check that a mobility model computing its trajectory lazily moves
+ * exactly as the same model scheduling an event at every change of
+ * course.
+ */
+class LazyTrajectoryTest : public TestCase
+{
+public:
+  /**
+   * \param model the TypeId name of the mobility model to test
+   */
+  LazyTrajectoryTest (std::string model);
+private:
+  virtual void DoRun (void);
+  /**
+   * \param lazy the value of the "Lazy" attribute
+   * \param world the obstacles
+   * \return a new model, started in the middle of the bounds
+   */
+  Ptr<MobilityModel> CreateModel (bool lazy, Ptr<ObstacleWorld> world);
+  /**
+   * Compare the positions and velocities of the two models
+   */
+  void Compare (void);
+
+  std::string m_model; //!< name of the tested model
+  Ptr<MobilityModel> m_eager; //!< model scheduling events
+  Ptr<MobilityModel> m_lazy; //!< model computing its trajectory on queries
+};
+
+LazyTrajectoryTest::LazyTrajectoryTest (std::string model)
+  : TestCase ("Check the lazy trajectory of " + model),
+    m_model (model)
+{
+}
+
+Ptr<MobilityModel>
+LazyTrajectoryTest::CreateModel (bool lazy, Ptr<ObstacleWorld> world)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (m_model);
+  factory.Set ("Bounds", BoxValue (Box (0.0, 100.0, 0.0, 100.0, 0.0, 100.0)));
+  factory.Set ("Obstacles", PointerValue (world));
+  factory.Set ("Lazy", BooleanValue (lazy));
+  Ptr<MobilityModel> model = factory.Create<MobilityModel> ();
+  model->AssignStreams (1);
+  model->SetPosition (Vector (50.0, 50.0, 50.0));
+  model->Initialize ();
+  return model;
+}
+
+void
+LazyTrajectoryTest::Compare (void)
+{
+  Vector lazy = m_lazy->GetPosition ();
+  Vector eager = m_eager->GetPosition ();
+  NS_TEST_EXPECT_MSG_EQ (lazy.x, eager.x, "Lazy position differs at " << Simulator::Now ());
+  NS_TEST_EXPECT_MSG_EQ (lazy.y, eager.y, "Lazy position differs at " << Simulator::Now ());
+  NS_TEST_EXPECT_MSG_EQ (lazy.z, eager.z, "Lazy position differs at " << Simulator::Now ());
+  Vector lazyVelocity = m_lazy->GetVelocity ();
+  Vector eagerVelocity = m_eager->GetVelocity ();
+  NS_TEST_EXPECT_MSG_EQ (lazyVelocity.x, eagerVelocity.x, "Lazy velocity differs at " << Simulator::Now ());
+  NS_TEST_EXPECT_MSG_EQ (lazyVelocity.y, eagerVelocity.y, "Lazy velocity differs at " << Simulator::Now ());
+  NS_TEST_EXPECT_MSG_EQ (lazyVelocity.z, eagerVelocity.z, "Lazy velocity differs at " << Simulator::Now ());
+}
+
+void
+LazyTrajectoryTest::DoRun (void)
+{
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  world->AddObstacle (Box (10.0, 30.0, 10.0, 30.0, 0.0, 40.0));
+  world->AddObstacle (Box (70.0, 90.0, 60.0, 80.0, 0.0, 60.0));
+  world->AddObstacle (Box (20.0, 40.0, 70.0, 90.0, 0.0, 20.0));
+
+  m_eager = CreateModel (false, world);
+  m_lazy = CreateModel (true, world);
+
+  // queries a few seconds apart, so that the lazy model catches up with
+  // several changes of course at once
+  Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable> ();
+  rv->SetStream (10);
+  double t = 0.0;
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      t += rv->GetValue (0.0, 20.0);
+      Simulator::Schedule (Seconds (t), &LazyTrajectoryTest::Compare, this);
+    }
+  Simulator::Stop (Seconds (t + 1.0));
+  Simulator::Run ();
+  m_eager->Dispose ();
+  m_lazy->Dispose ();
+  m_eager = 0;
+  m_lazy = 0;
+  Simulator::Destroy ();
+
+  // without queries, a lazy model leaves no event behind
+  Ptr<MobilityModel> lazy = CreateModel (true, world);
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (Simulator::IsFinished (), true, "Events left by a lazy model");
+  lazy->Dispose ();
+  Simulator::Destroy ();
+}
+
+static class PiecewiseLinearTrajectoryTestSuite : public TestSuite
+{
+public:
+  PiecewiseLinearTrajectoryTestSuite ();
+} g_piecewiseLinearTrajectoryTestSuite;
+
+PiecewiseLinearTrajectoryTestSuite::PiecewiseLinearTrajectoryTestSuite ()
+  : TestSuite ("piecewise-linear-trajectory", UNIT)
+{
+  AddTestCase (new PiecewiseLinearTrajectoryTest, TestCase::QUICK);
+  AddTestCase (new LazyTrajectoryTest ("ns3::RandomWalk3dMobilityModel"), TestCase::QUICK);
+  AddTestCase (new LazyTrajectoryTest ("ns3::RandomDirection3dMobilityModel"), TestCase::QUICK);
+  AddTestCase (new LazyTrajectoryTest ("ns3::ObstacleGaussMarkovMobilityModel"), TestCase::QUICK);
+}
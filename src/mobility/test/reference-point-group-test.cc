@@ -0,0 +1,356 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/nstime.h"
+#include "ns3/callback.h"
+#include "ns3/box.h"
+#include "ns3/obstacle-world.h"
+#include "ns3/obstacle-shape.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/random-walk-3d-mobility-model.h"
+#include "ns3/reference-point-group.h"
+#include "ns3/reference-point-group-mobility-model.h"
+#include "ns3/rng-seed-manager.h"
+#include <cmath>
+
+using namespace ns3;
+
+/**
+ * Check that the members keep their offset from the leader, and change
+ * course with it.
+ */
+class ReferencePointGroupFollowTest : public TestCase
+{
+public:
+  ReferencePointGroupFollowTest ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Count a course change of a member
+   * \param model the model of the member
+   */
+  void CourseChange (Ptr<const MobilityModel> model);
+  /**
+   * Check the positions and velocities of the members
+   */
+  void Check (void);
+
+  Ptr<ConstantVelocityMobilityModel> m_leader; //!< leader
+  std::vector<Ptr<ReferencePointGroupMobilityModel> > m_members; //!< members
+  std::vector<Vector> m_offsets; //!< offset of each member
+  uint32_t m_changes; //!< course changes of the members
+};
+
+ReferencePointGroupFollowTest::ReferencePointGroupFollowTest ()
+  : TestCase ("Check that the members of a group follow the leader"),
+    m_changes (0)
+{
+}
+
+void
+ReferencePointGroupFollowTest::CourseChange (Ptr<const MobilityModel> model)
+{
+  m_changes++;
+}
+
+void
+ReferencePointGroupFollowTest::Check (void)
+{
+  Vector leader = m_leader->GetPosition ();
+  for (uint32_t i = 0; i < m_members.size (); ++i)
+    {
+      Vector position = m_members[i]->GetPosition ();
+      Vector expected (leader.x + m_offsets[i].x, leader.y + m_offsets[i].y, leader.z + m_offsets[i].z);
+      NS_TEST_ASSERT_MSG_EQ_TOL (CalculateDistance (position, expected), 0.0, 1e-9,
+                                 "Member " << i << " off its offset");
+      Vector velocity = m_members[i]->GetVelocity ();
+      NS_TEST_ASSERT_MSG_EQ_TOL (CalculateDistance (velocity, m_leader->GetVelocity ()), 0.0, 1e-9,
+                                 "Member " << i << " not at the speed of the leader");
+    }
+}
+
+void
+ReferencePointGroupFollowTest::DoRun (void)
+{
+  m_leader = CreateObject<ConstantVelocityMobilityModel> ();
+  m_leader->SetPosition (Vector (10.0, 20.0, 30.0));
+  m_leader->SetVelocity (Vector (1.0, 2.0, 0.0));
+  Ptr<ReferencePointGroup> group = CreateObject<ReferencePointGroup> ();
+  group->SetAttribute ("Leader", PointerValue (m_leader));
+
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      Ptr<ReferencePointGroupMobilityModel> member = CreateObject<ReferencePointGroupMobilityModel> ();
+      member->SetAttribute ("Group", PointerValue (group));
+      m_offsets.push_back (Vector (i * 2.0, -1.0 * i, 0.5));
+      // set through the absolute position of the member
+      member->SetPosition (Vector (10.0 + i * 2.0, 20.0 - i, 30.5));
+      NS_TEST_ASSERT_MSG_EQ_TOL (CalculateDistance (member->GetOffset (), m_offsets[i]), 0.0, 1e-9,
+                                 "Wrong offset from the position");
+      member->TraceConnectWithoutContext ("CourseChange",
+                                          MakeCallback (&ReferencePointGroupFollowTest::CourseChange, this));
+      m_members.push_back (member);
+    }
+  NS_TEST_ASSERT_MSG_EQ (group->GetNNodes (), 4, "Wrong number of members");
+
+  Simulator::Schedule (Seconds (1.5), &ReferencePointGroupFollowTest::Check, this);
+  Simulator::Schedule (Seconds (2.0), &ConstantVelocityMobilityModel::SetVelocity, m_leader, Vector (0.0, 0.0, -3.0));
+  Simulator::Schedule (Seconds (2.5), &ReferencePointGroupFollowTest::Check, this);
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_changes, 4, "Course change of the leader not followed");
+
+  // without obstacles, no search is done
+  NS_TEST_EXPECT_MSG_EQ (group->GetNSearches (), 0, "Obstacles searched without a world");
+  for (uint32_t i = 0; i < m_members.size (); ++i)
+    {
+      m_members[i]->Dispose ();
+    }
+  Simulator::Destroy ();
+}
+
+/**
+ * Check that a formation following a leader among obstacles never enters
+ * them, with one search of the obstacles per leg of the leader.
+ */
+class ReferencePointGroupObstacleTest : public TestCase
+{
+public:
+  ReferencePointGroupObstacleTest ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Check that no member is inside an obstacle
+   */
+  void Check (void);
+  /**
+   * Count a course change of the leader
+   * \param model the model of the leader
+   */
+  void LeaderCourseChange (Ptr<const MobilityModel> model);
+
+  Ptr<ObstacleWorld> m_world; //!< obstacles
+  std::vector<Ptr<ReferencePointGroupMobilityModel> > m_members; //!< members
+  uint32_t m_legs; //!< course changes of the leader
+};
+
+ReferencePointGroupObstacleTest::ReferencePointGroupObstacleTest ()
+  : TestCase ("Check that a formation stays out of the obstacles"),
+    m_legs (0)
+{
+}
+
+void
+ReferencePointGroupObstacleTest::LeaderCourseChange (Ptr<const MobilityModel> model)
+{
+  m_legs++;
+}
+
+void
+ReferencePointGroupObstacleTest::Check (void)
+{
+  for (uint32_t i = 0; i < m_members.size (); i++)
+    {
+      Vector p = m_members[i]->GetPosition ();
+      for (uint32_t o = 0; o < m_world->GetNObstacles (); o++)
+        {
+          Ptr<const ObstacleShape> shape = m_world->GetShape (o);
+          bool inside;
+          if (shape == 0)
+            {
+              const Box &box = m_world->GetObstacle (o);
+              inside = p.x > box.xMin + 1e-6 && p.x < box.xMax - 1e-6
+                && p.y > box.yMin + 1e-6 && p.y < box.yMax - 1e-6
+                && p.z > box.zMin + 1e-6 && p.z < box.zMax - 1e-6;
+            }
+          else
+            {
+              // rounding may leave a position on a face slightly inside
+              inside = shape->IsInside (Vector (p.x - 1e-6, p.y, p.z)) && shape->IsInside (Vector (p.x + 1e-6, p.y, p.z))
+                && shape->IsInside (Vector (p.x, p.y - 1e-6, p.z)) && shape->IsInside (Vector (p.x, p.y + 1e-6, p.z))
+                && shape->IsInside (Vector (p.x, p.y, p.z - 1e-6)) && shape->IsInside (Vector (p.x, p.y, p.z + 1e-6));
+            }
+          NS_TEST_ASSERT_MSG_EQ (inside, false, "Member " << i << " inside obstacle " << o << " at " << p);
+        }
+    }
+}
+
+void
+ReferencePointGroupObstacleTest::DoRun (void)
+{
+  RngSeedManager::SetSeed (2);
+  RngSeedManager::SetRun (1);
+  m_world = CreateObject<ObstacleWorld> ();
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      m_world->AddObstacle (Box (20.0 + i * 20.0, 30.0 + i * 20.0, 20.0, 80.0, 0.0, 70.0 - i * 10.0));
+    }
+  std::vector<Vector2D> footprint;
+  footprint.push_back (Vector2D (20.0, 85.0));
+  footprint.push_back (Vector2D (60.0, 85.0));
+  footprint.push_back (Vector2D (40.0, 95.0));
+  m_world->AddObstacle (Create<PrismObstacle> (footprint, 0.0, 90.0));
+
+  Ptr<RandomWalk3dMobilityModel> leader = CreateObject<RandomWalk3dMobilityModel> ();
+  leader->SetAttribute ("Bounds", BoxValue (Box (10.0, 90.0, 10.0, 90.0, 10.0, 90.0)));
+  leader->SetAttribute ("Obstacles", PointerValue (m_world));
+  leader->SetAttribute ("Mode", StringValue ("Time"));
+  leader->SetAttribute ("Time", TimeValue (Seconds (5.0)));
+  leader->SetPosition (Vector (15.0, 15.0, 50.0));
+  leader->AssignStreams (1);
+  leader->Initialize ();
+  leader->TraceConnectWithoutContext ("CourseChange",
+                                      MakeCallback (&ReferencePointGroupObstacleTest::LeaderCourseChange, this));
+
+  Ptr<ReferencePointGroup> group = CreateObject<ReferencePointGroup> ();
+  group->SetAttribute ("Leader", PointerValue (leader));
+  group->SetAttribute ("Obstacles", PointerValue (m_world));
+  for (uint32_t i = 0; i < 20; ++i)
+    {
+      Ptr<ReferencePointGroupMobilityModel> member = CreateObject<ReferencePointGroupMobilityModel> ();
+      member->SetAttribute ("Group", PointerValue (group));
+      double angle = 2 * M_PI * i / 20;
+      member->SetOffset (Vector (4.0 * std::cos (angle), 4.0 * std::sin (angle), (i % 3) - 1.0));
+      m_members.push_back (member);
+    }
+
+  for (double t = 0.0; t < 300.0; t += 0.1)
+    {
+      Simulator::Schedule (Seconds (t), &ReferencePointGroupObstacleTest::Check, this);
+    }
+  Simulator::Stop (Seconds (300.0));
+  Simulator::Run ();
+
+  // one search per leg of the leader, or per horizon on longer legs
+  uint32_t searches = group->GetNSearches ();
+  NS_TEST_EXPECT_MSG_GT (searches, 0, "Obstacles never searched");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (searches, m_legs + 300 / 10 + 1, "More than one search per leg");
+
+  for (uint32_t i = 0; i < m_members.size (); ++i)
+    {
+      m_members[i]->Dispose ();
+    }
+  leader->Dispose ();
+  Simulator::Destroy ();
+}
+
+/**
+ * Check the velocity and the course changes of a member pulled in by an
+ * obstacle crossing its offset.
+ */
+class ReferencePointGroupClampTest : public TestCase
+{
+public:
+  ReferencePointGroupClampTest ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Count a course change of the member
+   * \param model the model of the member
+   */
+  void CourseChange (Ptr<const MobilityModel> model);
+  /**
+   * Query the position of the member, which notices the changes of face
+   */
+  void Query (void);
+
+  Ptr<ReferencePointGroupMobilityModel> m_member; //!< member
+  uint32_t m_changes; //!< course changes of the member
+};
+
+ReferencePointGroupClampTest::ReferencePointGroupClampTest ()
+  : TestCase ("Check the motion of a member pulled in by an obstacle"),
+    m_changes (0)
+{
+}
+
+void
+ReferencePointGroupClampTest::CourseChange (Ptr<const MobilityModel> model)
+{
+  m_changes++;
+}
+
+void
+ReferencePointGroupClampTest::Query (void)
+{
+  m_member->GetPosition ();
+}
+
+void
+ReferencePointGroupClampTest::DoRun (void)
+{
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  world->AddObstacle (Box (10.0, 20.0, 3.0, 10.0, 0.0, 10.0));
+  // the leader flies toward the obstacle, which crosses the offset of the
+  // member from y = -2 on
+  Ptr<ConstantVelocityMobilityModel> leader = CreateObject<ConstantVelocityMobilityModel> ();
+  leader->SetPosition (Vector (15.0, -10.0, 5.0));
+  leader->SetVelocity (Vector (0.0, 1.0, 0.0));
+  Ptr<ReferencePointGroup> group = CreateObject<ReferencePointGroup> ();
+  group->SetAttribute ("Leader", PointerValue (leader));
+  group->SetAttribute ("Obstacles", PointerValue (world));
+  m_member = CreateObject<ReferencePointGroupMobilityModel> ();
+  m_member->SetAttribute ("Group", PointerValue (group));
+  m_member->SetOffset (Vector (0.0, 5.0, 0.0));
+  m_member->TraceConnectWithoutContext ("CourseChange",
+                                        MakeCallback (&ReferencePointGroupClampTest::CourseChange, this));
+
+  for (double t = 0.5; t < 12.0; t += 0.5)
+    {
+      Simulator::Schedule (Seconds (t), &ReferencePointGroupClampTest::Query, this);
+    }
+  Simulator::Stop (Seconds (5.0));
+  Simulator::Run ();
+  Vector velocity = m_member->GetVelocity ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (CalculateDistance (velocity, Vector (0.0, 1.0, 0.0)), 0.0, 1e-9,
+                             "Free member not at the speed of the leader");
+  NS_TEST_EXPECT_MSG_EQ (m_changes, 0, "Course change of a free member");
+
+  // pulled in, the member waits on the face of the obstacle
+  Simulator::Stop (Seconds (5.0));
+  Simulator::Run ();
+  Vector position = m_member->GetPosition ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (CalculateDistance (position, Vector (15.0, 2.5, 5.0)), 0.0, 1e-9,
+                             "Member not pulled in before the obstacle");
+  velocity = m_member->GetVelocity ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (CalculateDistance (velocity, Vector (0.0, 0.0, 0.0)), 0.0, 1e-9,
+                             "Member pulled in not sliding on the obstacle");
+  NS_TEST_EXPECT_MSG_EQ (m_changes, 1, "Course change of a member pulled in not notified");
+
+  m_member->Dispose ();
+  Simulator::Destroy ();
+}
+
+static class ReferencePointGroupTestSuite : public TestSuite
+{
+public:
+  ReferencePointGroupTestSuite ();
+} g_referencePointGroupTestSuite;
+
+ReferencePointGroupTestSuite::ReferencePointGroupTestSuite ()
+  : TestSuite ("reference-point-group", UNIT)
+{
+  AddTestCase (new ReferencePointGroupFollowTest, TestCase::QUICK);
+  AddTestCase (new ReferencePointGroupObstacleTest, TestCase::QUICK);
+  AddTestCase (new ReferencePointGroupClampTest, TestCase::QUICK);
+}
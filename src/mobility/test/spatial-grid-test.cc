@@ -0,0 +1,213 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/spatial-grid.h"
+#include <algorithm>
+
+using namespace ns3;
+
+/**
+ * Check that the items of a SpatialGrid within a sphere are all found,
+ * as they move and change course.
+ */
+class SpatialGridFindNearTest : public TestCase
+{
+public:
+  SpatialGridFindNearTest ();
+private:
+  virtual void DoRun (void);
+  /**
+   * \param id an item to give a new random velocity
+   */
+  void ChangeCourse (uint32_t id);
+  /**
+   * Compare a search of the grid to a linear scan of the items
+   */
+  void Check (void);
+  /**
+   * \param id an item
+   * \return the position of the item at the current time
+   */
+  Vector GetPosition (uint32_t id) const;
+
+  SpatialGrid m_grid; //!< grid checked
+  std::vector<Vector> m_positions; //!< position of each item at m_times
+  std::vector<Vector> m_velocities; //!< velocity of each item
+  std::vector<Time> m_times; //!< time of m_positions
+  std::vector<bool> m_present; //!< whether each item is in the grid
+  Ptr<UniformRandomVariable> m_rand; //!< random positions and velocities
+  uint32_t m_nFound; //!< items found within the searched spheres
+};
+
+SpatialGridFindNearTest::SpatialGridFindNearTest ()
+  : TestCase ("Check that a SpatialGrid finds the moving items near a position"),
+    m_nFound (0)
+{
+}
+
+Vector
+SpatialGridFindNearTest::GetPosition (uint32_t id) const
+{
+  double t = (Simulator::Now () - m_times[id]).GetSeconds ();
+  return Vector (m_positions[id].x + m_velocities[id].x * t,
+                 m_positions[id].y + m_velocities[id].y * t,
+                 m_positions[id].z + m_velocities[id].z * t);
+}
+
+void
+SpatialGridFindNearTest::ChangeCourse (uint32_t id)
+{
+  m_positions[id] = GetPosition (id);
+  m_times[id] = Simulator::Now ();
+  // a third of the items stand still
+  if (m_rand->GetValue () < 0.33)
+    {
+      m_velocities[id] = Vector ();
+    }
+  else
+    {
+      m_velocities[id] = Vector (m_rand->GetValue (-20.0, 20.0), m_rand->GetValue (-20.0, 20.0),
+                                 m_rand->GetValue (-2.0, 2.0));
+    }
+  // some items leave the grid for a while
+  if (m_present[id] && m_rand->GetValue () < 0.1)
+    {
+      m_grid.Remove (id);
+      m_present[id] = false;
+    }
+  else
+    {
+      m_grid.Update (id, m_positions[id], m_velocities[id]);
+      m_present[id] = true;
+    }
+  Simulator::Schedule (Seconds (m_rand->GetValue (0.5, 10.0)), &SpatialGridFindNearTest::ChangeCourse, this, id);
+}
+
+void
+SpatialGridFindNearTest::Check (void)
+{
+  Vector center (m_rand->GetValue (0.0, 1000.0), m_rand->GetValue (0.0, 1000.0), m_rand->GetValue (0.0, 100.0));
+  double radius = m_rand->GetValue (10.0, 300.0);
+  std::vector<uint32_t> found;
+  m_grid.FindNear (center, radius, found);
+  std::sort (found.begin (), found.end ());
+  for (uint32_t id = 0; id < m_positions.size (); ++id)
+    {
+      bool isFound = std::binary_search (found.begin (), found.end (), id);
+      if (m_present[id] && CalculateDistance (GetPosition (id), center) <= radius)
+        {
+          NS_TEST_ASSERT_MSG_EQ (isFound, true, "Item " << id << " within " << radius << " m of " << center << " missed");
+          m_nFound++;
+        }
+      else if (!m_present[id])
+        {
+          NS_TEST_ASSERT_MSG_EQ (isFound, false, "Removed item " << id << " found");
+        }
+    }
+}
+
+void
+SpatialGridFindNearTest::DoRun (void)
+{
+  RngSeedManager::SetSeed (3);
+  RngSeedManager::SetRun (1);
+  m_rand = CreateObject<UniformRandomVariable> ();
+  m_grid.SetCellSize (50.0);
+  uint32_t nItems = 300;
+  for (uint32_t id = 0; id < nItems; ++id)
+    {
+      m_positions.push_back (Vector (m_rand->GetValue (0.0, 1000.0), m_rand->GetValue (0.0, 1000.0),
+                                     m_rand->GetValue (0.0, 100.0)));
+      m_velocities.push_back (Vector ());
+      m_times.push_back (Seconds (0.0));
+      m_present.push_back (false);
+      Simulator::Schedule (Seconds (0.0), &SpatialGridFindNearTest::ChangeCourse, this, id);
+    }
+  for (double t = 0.1; t < 100.0; t += 0.3)
+    {
+      Simulator::Schedule (Seconds (t), &SpatialGridFindNearTest::Check, this);
+    }
+  Simulator::Stop (Seconds (100.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_GT (m_nFound, 1000, "Too few items within the searched spheres");
+  NS_TEST_EXPECT_MSG_GT (m_grid.GetNRebins (), 0, "Moving items never placed again");
+  // one pass over the moving items per half cell covered by the fastest
+  NS_TEST_EXPECT_MSG_LT (m_grid.GetNRebins (), 100 * 30 / 25 + 1, "Moving items placed again too often");
+}
+
+/**
+ * Check that changing the cell size keeps the items.
+ */
+class SpatialGridCellSizeTest : public TestCase
+{
+public:
+  SpatialGridCellSizeTest ();
+private:
+  virtual void DoRun (void);
+};
+
+SpatialGridCellSizeTest::SpatialGridCellSizeTest ()
+  : TestCase ("Check that a SpatialGrid keeps its items through a change of cell size")
+{
+}
+
+void
+SpatialGridCellSizeTest::DoRun (void)
+{
+  SpatialGrid grid;
+  grid.Update (0, Vector (-10.0, 5.0, 0.0), Vector ());
+  grid.Update (1, Vector (10.0, 5.0, 0.0), Vector ());
+  grid.Update (2, Vector (500.0, 500.0, 0.0), Vector ());
+  grid.Update (1, Vector (12.0, 5.0, 0.0), Vector ());
+  NS_TEST_ASSERT_MSG_EQ (grid.GetNItems (), 3, "Wrong number of items");
+
+  std::vector<uint32_t> found;
+  grid.FindNear (Vector (0.0, 0.0, 0.0), 20.0, found);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 2, "Wrong number of items found");
+  grid.SetCellSize (7.0);
+  grid.FindNear (Vector (0.0, 0.0, 0.0), 20.0, found);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 2, "Items lost by the change of cell size");
+  grid.FindNear (Vector (0.0, 0.0, 0.0), 1000.0, found);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 3, "Items lost by the change of cell size");
+  grid.Remove (0);
+  grid.FindNear (Vector (0.0, 0.0, 0.0), 20.0, found);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "Removed item found");
+  NS_TEST_ASSERT_MSG_EQ (found[0], 1, "Wrong item found");
+  Simulator::Destroy ();
+}
+
+static class SpatialGridTestSuite : public TestSuite
+{
+public:
+  SpatialGridTestSuite ();
+} g_spatialGridTestSuite;
+
+SpatialGridTestSuite::SpatialGridTestSuite ()
+  : TestSuite ("spatial-grid", UNIT)
+{
+  AddTestCase (new SpatialGridFindNearTest, TestCase::QUICK);
+  AddTestCase (new SpatialGridCellSizeTest, TestCase::QUICK);
+}
@@ -0,0 +1,191 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/pointer.h"
+#include "ns3/box.h"
+#include "ns3/node-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/obstacle-world.h"
+#include "ns3/trajectory-cache.h"
+#include "ns3/trajectory-cache-helper.h"
+#include "ns3/trajectory-cache-mobility-model.h"
+
+using namespace ns3;
+
+/**
+ * Record the trajectories of an obstacle mobility model, and check that
+ * TrajectoryCacheMobilityModel replays them.
+ */
+class TrajectoryCacheTest : public TestCase
+{
+public:
+  /**
+   * \param model the TypeId name of the mobility model to record
+   */
+  TrajectoryCacheTest (std::string model);
+private:
+  virtual void DoRun (void);
+  /**
+   * Store the positions and velocities of the models
+   */
+  void Sample (void);
+  /**
+   * \param model the model whose course changed
+   */
+  void CourseChange (Ptr<const MobilityModel> model);
+
+  std::string m_model; //!< name of the recorded model
+  std::vector<Ptr<MobilityModel> > m_models; //!< models sampled
+  std::vector<Vector> m_positions; //!< positions sampled
+  std::vector<Vector> m_velocities; //!< velocities sampled
+  uint32_t m_courseChanges; //!< number of course changes notified
+};
+
+TrajectoryCacheTest::TrajectoryCacheTest (std::string model)
+  : TestCase ("Check the record and replay of " + model),
+    m_model (model)
+{
+}
+
+void
+TrajectoryCacheTest::Sample (void)
+{
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      m_positions.push_back (m_models[i]->GetPosition ());
+      m_velocities.push_back (m_models[i]->GetVelocity ());
+    }
+}
+
+void
+TrajectoryCacheTest::CourseChange (Ptr<const MobilityModel> model)
+{
+  m_courseChanges++;
+}
+
+void
+TrajectoryCacheTest::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("trajectory-cache-test.traj");
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  world->AddObstacle (Box (10.0, 30.0, 10.0, 30.0, 0.0, 40.0));
+  world->AddObstacle (Box (70.0, 90.0, 60.0, 80.0, 0.0, 60.0));
+
+  // record
+  NodeContainer nodes;
+  nodes.Create (5);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (40.0), "MinY", DoubleValue (40.0),
+                                 "DeltaX", DoubleValue (5.0), "DeltaY", DoubleValue (5.0),
+                                 "GridWidth", UintegerValue (3));
+  mobility.SetMobilityModel (m_model,
+                             "Bounds", BoxValue (Box (0.0, 100.0, 0.0, 100.0, 0.0, 100.0)),
+                             "Obstacles", PointerValue (world));
+  mobility.Install (nodes);
+  mobility.AssignStreams (nodes, 1);
+  TrajectoryCacheHelper cache (filename);
+  cache.Record (nodes);
+  std::vector<uint32_t> ids;
+  m_models.clear ();
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      ids.push_back (nodes.Get (i)->GetId ());
+      m_models.push_back (nodes.Get (i)->GetObject<MobilityModel> ());
+    }
+  for (double t = 0.0; t < 100.0; t += 0.731)
+    {
+      Simulator::Schedule (Seconds (t), &TrajectoryCacheTest::Sample, this);
+    }
+  Simulator::Stop (Seconds (100.0));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (cache.Write (), true, "Trajectory file not written");
+  m_models.clear ();
+  Simulator::Destroy ();
+  std::vector<Vector> positions = m_positions;
+  std::vector<Vector> velocities = m_velocities;
+  m_positions.clear ();
+  m_velocities.clear ();
+
+  // replay
+  Ptr<TrajectoryCache> file = Create<TrajectoryCache> (filename);
+  uint32_t nLegs = 0;
+  for (uint32_t i = 0; i < ids.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_GT (file->GetNLegs (ids[i]), 1, "Trajectory not recorded");
+      nLegs += file->GetNLegs (ids[i]);
+      Ptr<TrajectoryCacheMobilityModel> model = CreateObject<TrajectoryCacheMobilityModel> ();
+      model->SetTrajectory (file, ids[i]);
+      model->TraceConnectWithoutContext ("CourseChange", MakeCallback (&TrajectoryCacheTest::CourseChange, this));
+      model->Initialize ();
+      m_models.push_back (model);
+    }
+  m_courseChanges = 0;
+  for (double t = 0.0; t < 100.0; t += 0.731)
+    {
+      Simulator::Schedule (Seconds (t), &TrajectoryCacheTest::Sample, this);
+    }
+  Simulator::Stop (Seconds (100.0));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_positions.size (), positions.size (), "Wrong number of samples");
+  for (uint32_t i = 0; i < positions.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_LT (CalculateDistance (positions[i], m_positions[i]), 1e-9, "Replayed position differs");
+      NS_TEST_EXPECT_MSG_EQ (CalculateDistance (velocities[i], m_velocities[i]), 0.0, "Replayed velocity differs");
+    }
+  // every leg but the first ones fires a course change, except the legs
+  // starting at the stop time
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (m_courseChanges, nLegs - ids.size (), "Too many course changes");
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (m_courseChanges, nLegs - 2 * ids.size (), "Course changes missed");
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      m_models[i]->Dispose ();
+    }
+  m_models.clear ();
+  Simulator::Destroy ();
+
+  // without course changes, the replay leaves no event
+  Ptr<TrajectoryCacheMobilityModel> model = CreateObjectWithAttributes<TrajectoryCacheMobilityModel> ("CourseChanges", BooleanValue (false));
+  model->SetTrajectory (file, ids[0]);
+  model->Initialize ();
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (Simulator::IsFinished (), true, "Events left by the replay");
+  model->Dispose ();
+  Simulator::Destroy ();
+}
+
+static class TrajectoryCacheTestSuite : public TestSuite
+{
+public:
+  TrajectoryCacheTestSuite ();
+} g_trajectoryCacheTestSuite;
+
+TrajectoryCacheTestSuite::TrajectoryCacheTestSuite ()
+  : TestSuite ("trajectory-cache", UNIT)
+{
+  AddTestCase (new TrajectoryCacheTest ("ns3::RandomWalk3dMobilityModel"), TestCase::QUICK);
+  AddTestCase (new TrajectoryCacheTest ("ns3::RandomDirection3dMobilityModel"), TestCase::QUICK);
+  AddTestCase (new TrajectoryCacheTest ("ns3::ObstacleGaussMarkovMobilityModel"), TestCase::QUICK);
+}
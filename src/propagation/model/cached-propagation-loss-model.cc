@@ -0,0 +1,248 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+#include "cached-propagation-loss-model.h"
+#include "ns3/mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/pointer.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CachedPropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED (CachedPropagationLossModel);
+
+/** End of a bucket chain */
+static const uint32_t NONE = 0xffffffff;
+
+TypeId
+CachedPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Propagation")
+    .AddConstructor<CachedPropagationLossModel> ()
+    .AddAttribute ("Model", "The model whose results are cached.",
+                   PointerValue (),
+                   MakePointerAccessor (&CachedPropagationLossModel::SetModel,
+                                        &CachedPropagationLossModel::GetModel),
+                   MakePointerChecker<PropagationLossModel> ())
+    .AddAttribute ("CellSize", "The side of the cells the positions are quantized to (m).",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&CachedPropagationLossModel::m_cellSize),
+                   MakeDoubleChecker<double> (1e-6))
+    .AddAttribute ("Capacity", "The maximum number of cached results.",
+                   UintegerValue (65536),
+                   MakeUintegerAccessor (&CachedPropagationLossModel::m_capacity),
+                   MakeUintegerChecker<uint32_t> (1, 0x7fffffff))
+    .AddAttribute ("Hits", "The number of results found in the cache.",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&CachedPropagationLossModel::GetHits),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("Misses", "The number of results computed by the cached model.",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&CachedPropagationLossModel::GetMisses),
+                   MakeUintegerChecker<uint64_t> ())
+  ;
+  return tid;
+}
+
+CachedPropagationLossModel::CachedPropagationLossModel ()
+  : m_hand (0),
+    m_cellSizeUsed (0.0),
+    m_capacityUsed (0),
+    m_hits (0),
+    m_misses (0)
+{
+}
+
+CachedPropagationLossModel::~CachedPropagationLossModel ()
+{
+}
+
+void
+CachedPropagationLossModel::SetModel (Ptr<PropagationLossModel> model)
+{
+  m_model = model;
+  Clear ();
+}
+
+Ptr<PropagationLossModel>
+CachedPropagationLossModel::GetModel (void) const
+{
+  return m_model;
+}
+
+void
+CachedPropagationLossModel::Clear (void)
+{
+  m_entries.clear ();
+  m_buckets.clear ();
+  m_hand = 0;
+}
+
+uint64_t
+CachedPropagationLossModel::GetHits (void) const
+{
+  return m_hits;
+}
+
+uint64_t
+CachedPropagationLossModel::GetMisses (void) const
+{
+  return m_misses;
+}
+
+uint32_t
+CachedPropagationLossModel::Hash (const int64_t key[6], double txPowerDbm) const
+{
+  uint64_t power;
+  std::memcpy (&power, &txPowerDbm, sizeof (power));
+  uint64_t h = power * 0x9e3779b97f4a7c15ULL;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      h = (h ^ static_cast<uint64_t> (key[i])) * 0x100000001b3ULL;
+      h ^= h >> 29;
+    }
+  return static_cast<uint32_t> (h ^ (h >> 32)) & (m_buckets.size () - 1);
+}
+
+uint32_t
+CachedPropagationLossModel::Evict (void) const
+{
+  // second chance to the entries used since the hand last passed
+  while (m_entries[m_hand].referenced)
+    {
+      m_entries[m_hand].referenced = false;
+      m_hand = (m_hand + 1) % m_entries.size ();
+    }
+  uint32_t slot = m_hand;
+  m_hand = (m_hand + 1) % m_entries.size ();
+
+  // unlink it from its bucket
+  const Entry &victim = m_entries[slot];
+  uint32_t *link = &m_buckets[Hash (victim.cells, victim.txPowerDbm)];
+  while (*link != slot)
+    {
+      NS_ASSERT (*link != NONE);
+      link = &m_entries[*link].next;
+    }
+  *link = victim.next;
+  return slot;
+}
+
+double
+CachedPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                           Ptr<MobilityModel> a,
+                                           Ptr<MobilityModel> b) const
+{
+  NS_ASSERT_MSG (m_model != 0, "No model to cache");
+  if (m_buckets.empty () || m_cellSizeUsed != m_cellSize || m_capacityUsed != m_capacity)
+    {
+      m_entries.clear ();
+      m_entries.reserve (m_capacity);
+      uint32_t buckets = 1;
+      while (buckets < m_capacity)
+        {
+          buckets <<= 1;
+        }
+      m_buckets.assign (buckets, NONE);
+      m_hand = 0;
+      m_cellSizeUsed = m_cellSize;
+      m_capacityUsed = m_capacity;
+    }
+
+  Vector pa = a->GetPosition ();
+  Vector pb = b->GetPosition ();
+  int64_t key[6] = {
+    static_cast<int64_t> (std::floor (pa.x / m_cellSize)),
+    static_cast<int64_t> (std::floor (pa.y / m_cellSize)),
+    static_cast<int64_t> (std::floor (pa.z / m_cellSize)),
+    static_cast<int64_t> (std::floor (pb.x / m_cellSize)),
+    static_cast<int64_t> (std::floor (pb.y / m_cellSize)),
+    static_cast<int64_t> (std::floor (pb.z / m_cellSize))
+  };
+  uint32_t bucket = Hash (key, txPowerDbm);
+  for (uint32_t i = m_buckets[bucket]; i != NONE; i = m_entries[i].next)
+    {
+      Entry &entry = m_entries[i];
+      if (entry.txPowerDbm == txPowerDbm && std::memcmp (entry.cells, key, sizeof (key)) == 0)
+        {
+          entry.referenced = true;
+          m_hits++;
+          return entry.rxPowerDbm;
+        }
+    }
+
+  m_misses++;
+  double rxPowerDbm = m_model->CalcRxPower (txPowerDbm, a, b);
+  uint32_t slot;
+  if (m_entries.size () < m_capacity)
+    {
+      slot = m_entries.size ();
+      m_entries.push_back (Entry ());
+    }
+  else
+    {
+      slot = Evict ();
+    }
+  Entry &entry = m_entries[slot];
+  std::memcpy (entry.cells, key, sizeof (key));
+  entry.txPowerDbm = txPowerDbm;
+  entry.rxPowerDbm = rxPowerDbm;
+  entry.referenced = false;
+  entry.next = m_buckets[bucket];
+  m_buckets[bucket] = slot;
+  NS_LOG_LOGIC (this << " miss, " << rxPowerDbm << " dBm cached in slot " << slot);
+  return rxPowerDbm;
+}
+
+double
+CachedPropagationLossModel::DoGetMaxRange (double lossDb) const
+{
+  if (m_model == 0)
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  // a result may come from any pair of positions in the same cells, up
+  // to a cell diagonal away at each end
+  return m_model->GetMaxRange (lossDb, 0.0) + 2 * std::sqrt (3.0) * m_cellSize;
+}
+
+double
+CachedPropagationLossModel::DoGetMaxGain (void) const
+{
+  return m_model != 0 ? m_model->GetMaxGain () : std::numeric_limits<double>::infinity ();
+}
+
+int64_t
+CachedPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  return m_model != 0 ? m_model->AssignStreams (stream) : 0;
+}
+
+} // namespace ns3
@@ -60,14 +60,20 @@ ItuR1411LosPropagationLossModel::~ItuR1411LosPropagationLossModel ()
 
 double
 ItuR1411LosPropagationLossModel::GetLoss (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  return DoGetLoss (a->GetPosition (), b->GetPosition ());
+}
+
+double
+ItuR1411LosPropagationLossModel::DoGetLoss (const Vector &a, const Vector &b) const
 {
   NS_LOG_FUNCTION (this);
-  double dist = a->GetDistanceFrom (b);
+  double dist = CalculateDistance (a, b);
   double lossLow = 0.0;
   double lossUp = 0.0;
-  NS_ASSERT_MSG (a->GetPosition ().z > 0 && b->GetPosition ().z > 0, "nodes' height must be greater than 0");
-  double Lbp = std::fabs (20 * std::log10 ((m_lambda * m_lambda) / (8 * M_PI * a->GetPosition ().z * b->GetPosition ().z)));
-  double Rbp = (4 * a->GetPosition ().z * b->GetPosition ().z) / m_lambda;
+  NS_ASSERT_MSG (a.z > 0 && b.z > 0, "nodes' height must be greater than 0");
+  double Lbp = std::fabs (20 * std::log10 ((m_lambda * m_lambda) / (8 * M_PI * a.z * b.z)));
+  double Rbp = (4 * a.z * b.z) / m_lambda;
   NS_LOG_LOGIC (this << " Lbp " << Lbp << " Rbp " << Rbp << " lambda " << m_lambda);
   if (dist <= Rbp)
     {
@@ -102,6 +108,18 @@ ItuR1411LosPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return (txPowerDbm - GetLoss (a, b));
 }
 
+void
+ItuR1411LosPropagationLossModel::DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                                     const Ptr<MobilityModel> *receivers,
+                                                     uint32_t n, double *powerDbm) const
+{
+  Vector position = a->GetPosition ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      powerDbm[i] -= DoGetLoss (position, receivers[i]->GetPosition ());
+    }
+}
+
 int64_t
 ItuR1411LosPropagationLossModel::DoAssignStreams (int64_t stream)
 {
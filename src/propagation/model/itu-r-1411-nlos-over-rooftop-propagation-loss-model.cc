@@ -100,6 +100,12 @@ ItuR1411NlosOverRooftopPropagationLossModel::~ItuR1411NlosOverRooftopPropagation
 
 double
 ItuR1411NlosOverRooftopPropagationLossModel::GetLoss (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  return DoGetLoss (a->GetPosition (), b->GetPosition ());
+}
+
+double
+ItuR1411NlosOverRooftopPropagationLossModel::DoGetLoss (const Vector &a, const Vector &b) const
 {
   NS_LOG_FUNCTION (this << a << b);
   double Lori = 0.0;
@@ -120,9 +126,9 @@ ItuR1411NlosOverRooftopPropagationLossModel::GetLoss (Ptr<MobilityModel> a, Ptr<
       Lori = 2.5 + 0.075 * (m_streetsOrientation - 55);
     }
 
-  double distance = a->GetDistanceFrom (b);
-  double hb = (a->GetPosition ().z > b->GetPosition ().z ? a->GetPosition ().z : b->GetPosition ().z);
-  double hm = (a->GetPosition ().z < b->GetPosition ().z ? a->GetPosition ().z : b->GetPosition ().z);
+  double distance = CalculateDistance (a, b);
+  double hb = (a.z > b.z ? a.z : b.z);
+  double hm = (a.z < b.z ? a.z : b.z);
   NS_ASSERT_MSG (hm > 0 && hb > 0, "nodes' height must be greater then 0");
   double Dhb = hb - m_rooftopHeight;
   double ds = (m_lambda * distance * distance) / (Dhb * Dhb);
@@ -143,7 +149,7 @@ ItuR1411NlosOverRooftopPropagationLossModel::GetLoss (Ptr<MobilityModel> a, Ptr<
       else 
         {
           Lbsh = 0;
-          kd = 18.0 - 15 * Dhb / a->GetPosition ().z;
+          kd = 18.0 - 15 * Dhb / a.z;
           if (distance < 500)
             {
               ka = 54.0 - 1.6 * Dhb * distance / 1000;
@@ -220,6 +226,18 @@ ItuR1411NlosOverRooftopPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return (txPowerDbm - GetLoss (a, b));
 }
 
+void
+ItuR1411NlosOverRooftopPropagationLossModel::DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                                                 const Ptr<MobilityModel> *receivers,
+                                                                 uint32_t n, double *powerDbm) const
+{
+  Vector position = a->GetPosition ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      powerDbm[i] -= DoGetLoss (position, receivers[i]->GetPosition ());
+    }
+}
+
 int64_t
 ItuR1411NlosOverRooftopPropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -24,6 +24,7 @@
 #define ITU_R_1411_NLOS_OVER_ROOFTOP_PROPAGATION_LOSS_MODEL_H
 
 #include <ns3/propagation-loss-model.h>
+#include <ns3/vector.h>
 #include <ns3/propagation-environment.h>
 
 namespace ns3 {
@@ -89,7 +90,16 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                   const Ptr<MobilityModel> *receivers,
+                                   uint32_t n, double *powerDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  /**
+   * \param a the position of the first node
+   * \param b the position of the second node
+   * \return the loss in dB between the two positions
+   */
+  double DoGetLoss (const Vector &a, const Vector &b) const;
   
   double m_frequency; //!< frequency in MHz
   double m_lambda; //!< wavelength
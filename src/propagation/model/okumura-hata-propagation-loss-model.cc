@@ -74,17 +74,24 @@ OkumuraHataPropagationLossModel::~OkumuraHataPropagationLossModel ()
 
 double
 OkumuraHataPropagationLossModel::GetLoss (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  return DoGetLoss (a->GetPosition (), b->GetPosition ());
+}
+
+double
+OkumuraHataPropagationLossModel::DoGetLoss (const Vector &a, const Vector &b) const
 {
   double loss = 0.0;
   double fmhz = m_frequency / 1e6;
-  double dist = a->GetDistanceFrom (b) / 1000.0; 
+  double distance = CalculateDistance (a, b);
+  double dist = distance / 1000.0; 
   if (m_frequency <= 1.500e9)
     {
       // standard Okumura Hata 
       // see eq. (4.4.1) in the COST 231 final report
       double log_f = std::log10 (fmhz);
-      double hb = (a->GetPosition ().z > b->GetPosition ().z ? a->GetPosition ().z : b->GetPosition ().z);
-      double hm = (a->GetPosition ().z < b->GetPosition ().z ? a->GetPosition ().z : b->GetPosition ().z);
+      double hb = (a.z > b.z ? a.z : b.z);
+      double hm = (a.z < b.z ? a.z : b.z);
       NS_ASSERT_MSG (hb > 0 && hm > 0, "nodes' height must be greater then 0");
       double log_aHeight = 13.82 * std::log10 (hb);
       double log_bHeight = 0.0;
@@ -104,7 +111,7 @@ OkumuraHataPropagationLossModel::GetLoss (Ptr<MobilityModel> a, Ptr<MobilityMode
           log_bHeight = 0.8 + (1.1 * log_f - 0.7) * hm - 1.56 * log_f;
         }
 
-      NS_LOG_INFO (this << " logf " << 26.16 * log_f << " loga " << log_aHeight << " X " << (((44.9 - (6.55 * std::log10 (hb)) )) * std::log10 (a->GetDistanceFrom (b))) << " logb " << log_bHeight);
+      NS_LOG_INFO (this << " logf " << 26.16 * log_f << " loga " << log_aHeight << " X " << (((44.9 - (6.55 * std::log10 (hb)) )) * std::log10 (distance)) << " logb " << log_bHeight);
       loss = 69.55 + (26.16 * log_f) - log_aHeight + (((44.9 - (6.55 * std::log10 (hb)) )) * std::log10 (dist)) - log_bHeight;
       if (m_environment == SubUrbanEnvironment)
         {
@@ -122,8 +129,8 @@ OkumuraHataPropagationLossModel::GetLoss (Ptr<MobilityModel> a, Ptr<MobilityMode
       // see eq. (4.4.3) in the COST 231 final report
 
       double log_f = std::log10 (fmhz);
-      double hb = (a->GetPosition ().z > b->GetPosition ().z ? a->GetPosition ().z : b->GetPosition ().z);
-      double hm = (a->GetPosition ().z < b->GetPosition ().z ? a->GetPosition ().z : b->GetPosition ().z);
+      double hb = (a.z > b.z ? a.z : b.z);
+      double hm = (a.z < b.z ? a.z : b.z);
       NS_ASSERT_MSG (hb > 0 && hm > 0, "nodes' height must be greater then 0");
       double log_aHeight = 13.82 * std::log10 (hb);
       double log_bHeight = 0.0;
@@ -152,6 +159,18 @@ OkumuraHataPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return (txPowerDbm - GetLoss (a, b));
 }
 
+void
+OkumuraHataPropagationLossModel::DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                                     const Ptr<MobilityModel> *receivers,
+                                                     uint32_t n, double *powerDbm) const
+{
+  Vector position = a->GetPosition ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      powerDbm[i] -= DoGetLoss (position, receivers[i]->GetPosition ());
+    }
+}
+
 int64_t
 OkumuraHataPropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -29,6 +29,8 @@
 #include "ns3/string.h"
 #include "ns3/pointer.h"
 #include <cmath>
+#include <limits>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -81,6 +83,96 @@ PropagationLossModel::CalcRxPower (double txPowerDbm,
   return self;
 }
 
+void
+PropagationLossModel::CalcRxPowerBatch (double txPowerDbm,
+                                        Ptr<MobilityModel> a,
+                                        const std::vector<Ptr<MobilityModel> > &receivers,
+                                        std::vector<double> &rxPowerDbm) const
+{
+  rxPowerDbm.assign (receivers.size (), txPowerDbm);
+  if (receivers.empty ())
+    {
+      return;
+    }
+  for (const PropagationLossModel *model = this; model != 0; model = PeekPointer (model->m_next))
+    {
+      model->DoCalcRxPowerBatch (a, &receivers[0], receivers.size (), &rxPowerDbm[0]);
+    }
+}
+
+void
+PropagationLossModel::DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                          const Ptr<MobilityModel> *receivers,
+                                          uint32_t n, double *powerDbm) const
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      powerDbm[i] = DoCalcRxPower (powerDbm[i], a, receivers[i]);
+    }
+}
+
+double
+PropagationLossModel::GetMaxRange (double txPowerDbm, double rxThresholdDbm) const
+{
+  // the gains of the other models are summed over the whole chain, and
+  // the one of each model is taken back out of the sum when its own
+  // range is computed
+  const double infinity = std::numeric_limits<double>::infinity ();
+  double finiteGains = 0.0;
+  uint32_t unbounded = 0;
+  for (const PropagationLossModel *model = this; model != 0; model = PeekPointer (model->m_next))
+    {
+      double gain = model->DoGetMaxGain ();
+      if (gain == infinity)
+        {
+          unbounded++;
+        }
+      else
+        {
+          finiteGains += gain;
+        }
+    }
+  double range = infinity;
+  if (unbounded > 1)
+    {
+      return range;
+    }
+  for (const PropagationLossModel *model = this; model != 0; model = PeekPointer (model->m_next))
+    {
+      double gain = model->DoGetMaxGain ();
+      if (unbounded == 1 && gain != infinity)
+        {
+          continue;
+        }
+      double otherGains = (gain == infinity) ? finiteGains : finiteGains - gain;
+      range = std::min (range, model->DoGetMaxRange (txPowerDbm - rxThresholdDbm + otherGains));
+    }
+  return range;
+}
+
+double
+PropagationLossModel::GetMaxGain (void) const
+{
+  double gain = 0.0;
+  for (const PropagationLossModel *model = this; model != 0; model = PeekPointer (model->m_next))
+    {
+      gain += model->DoGetMaxGain ();
+    }
+  return gain;
+}
+
+double
+PropagationLossModel::DoGetMaxRange (double lossDb) const
+{
+  return std::numeric_limits<double>::infinity ();
+}
+
+double
+PropagationLossModel::DoGetMaxGain (void) const
+{
+  return std::numeric_limits<double>::infinity ();
+}
+
 int64_t
 PropagationLossModel::AssignStreams (int64_t stream)
 {
@@ -253,7 +345,24 @@ FriisPropagationLossModel::DoCalcRxPower (double txPowerDbm,
    * L: system loss (unit-less)
    * lambda: wavelength (m)
    */
-  double distance = a->GetDistanceFrom (b);
+  return GetRxPower (txPowerDbm, a->GetDistanceFrom (b));
+}
+
+void
+FriisPropagationLossModel::DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                               const Ptr<MobilityModel> *receivers,
+                                               uint32_t n, double *powerDbm) const
+{
+  Vector position = a->GetPosition ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      powerDbm[i] = GetRxPower (powerDbm[i], CalculateDistance (position, receivers[i]->GetPosition ()));
+    }
+}
+
+double
+FriisPropagationLossModel::GetRxPower (double txPowerDbm, double distance) const
+{
   if (distance < 3*m_lambda)
     {
       NS_LOG_WARN ("distance not within the far field region => inaccurate propagation loss value");
@@ -269,6 +378,23 @@ FriisPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm - std::max (lossDb, m_minLoss);
 }
 
+double
+FriisPropagationLossModel::DoGetMaxRange (double lossDb) const
+{
+  if (lossDb < m_minLoss)
+    {
+      return 0.0;
+    }
+  // the distance where -10 log10 (lambda^2 / (16 pi^2 d^2 L)) = lossDb
+  return m_lambda / (4 * M_PI) * std::sqrt (std::pow (10.0, lossDb / 10.0) / m_systemLoss);
+}
+
+double
+FriisPropagationLossModel::DoGetMaxGain (void) const
+{
+  return -m_minLoss;
+}
+
 int64_t
 FriisPropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -505,7 +631,24 @@ LogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
                                                 Ptr<MobilityModel> a,
                                                 Ptr<MobilityModel> b) const
 {
-  double distance = a->GetDistanceFrom (b);
+  return GetRxPower (txPowerDbm, a->GetDistanceFrom (b));
+}
+
+void
+LogDistancePropagationLossModel::DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                                     const Ptr<MobilityModel> *receivers,
+                                                     uint32_t n, double *powerDbm) const
+{
+  Vector position = a->GetPosition ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      powerDbm[i] = GetRxPower (powerDbm[i], CalculateDistance (position, receivers[i]->GetPosition ()));
+    }
+}
+
+double
+LogDistancePropagationLossModel::GetRxPower (double txPowerDbm, double distance) const
+{
   if (distance <= m_referenceDistance)
     {
       return txPowerDbm;
@@ -531,6 +674,28 @@ LogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm + rxc;
 }
 
+double
+LogDistancePropagationLossModel::DoGetMaxRange (double lossDb) const
+{
+  if (m_exponent <= 0)
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  // there is no loss up to the reference distance
+  double range = m_referenceDistance * std::pow (10.0, (lossDb - m_referenceLoss) / (10 * m_exponent));
+  return std::max (range, m_referenceDistance);
+}
+
+double
+LogDistancePropagationLossModel::DoGetMaxGain (void) const
+{
+  if (m_exponent < 0)
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  return std::max (0.0, -m_referenceLoss);
+}
+
 int64_t
 LogDistancePropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -919,6 +1084,19 @@ RangePropagationLossModel::DoCalcRxPower (double txPowerDbm,
     }
 }
 
+double
+RangePropagationLossModel::DoGetMaxRange (double lossDb) const
+{
+  // beyond the range, the signal is lost whatever the budget
+  return m_range;
+}
+
+double
+RangePropagationLossModel::DoGetMaxGain (void) const
+{
+  return 0.0;
+}
+
 int64_t
 RangePropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -28,6 +28,7 @@
 #include "ns3/object.h"
 #include "ns3/random-variable-stream.h"
 #include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -93,6 +94,50 @@ public:
                       Ptr<MobilityModel> a,
                       Ptr<MobilityModel> b) const;
 
+  /**
+   * Returns the Rx Power at several receivers of the same transmission,
+   * taking into account all the PropagatinLossModel(s) chained to the
+   * current one. The result is the same as calling CalcRxPower for each
+   * receiver in turn, but each model of the chain handles the whole set
+   * at once, so that it can look the source up and compute the terms
+   * that do not depend on the receiver only once.
+   *
+   * \param txPowerDbm current transmission power (in dBm)
+   * \param a the mobility model of the source
+   * \param receivers the mobility models of the destinations
+   * \param rxPowerDbm on return, the reception power at each destination
+   *        (in dBm)
+   */
+  void CalcRxPowerBatch (double txPowerDbm,
+                         Ptr<MobilityModel> a,
+                         const std::vector<Ptr<MobilityModel> > &receivers,
+                         std::vector<double> &rxPowerDbm) const;
+
+  /**
+   * Returns a distance beyond which the Rx power is always below a
+   * threshold, taking into account all the PropagationLossModel(s)
+   * chained to the current one. The bound is conservative: a receiver
+   * closer than the range may still be below the threshold.
+   *
+   * The range of the chain is the smallest range of its models, each
+   * one being given the loss budget raised by the largest gains the
+   * other models may apply. There is no bound, and the range is
+   * infinite, if no model knows its range, or if more than one model
+   * may apply an unbounded gain, such as the random fading models.
+   *
+   * \param txPowerDbm transmission power (in dBm)
+   * \param rxThresholdDbm the reception power threshold (in dBm)
+   * \returns the range (in m), or infinity if it is not bounded
+   */
+  double GetMaxRange (double txPowerDbm, double rxThresholdDbm) const;
+
+  /**
+   * \returns an upper bound of the gain (in dB) the chain of models
+   * starting at the current one may apply to the signal, that is the
+   * opposite of its smallest loss, or infinity if it is not bounded
+   */
+  double GetMaxGain (void) const;
+
   /**
    * If this loss model uses objects of type RandomVariableStream,
    * set the stream numbers to the integers starting with the offset
@@ -134,6 +179,41 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const = 0;
 
+  /**
+   * Applies the loss of this particular PropagationLossModel only to
+   * several receivers. The default calls DoCalcRxPower for each receiver
+   * in turn; subclasses override it to share the work done for the
+   * source, and must then return the same powers.
+   *
+   * \param a the mobility model of the source
+   * \param receivers the mobility models of the n destinations
+   * \param n the number of destinations
+   * \param powerDbm the power reaching this model at each destination
+   *        (in dBm), replaced by the power after its loss
+   */
+  virtual void DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                   const Ptr<MobilityModel> *receivers,
+                                   uint32_t n, double *powerDbm) const;
+
+  /**
+   * Returns a distance beyond which this particular PropagationLossModel
+   * always attenuates the signal by more than a given loss. The default
+   * returns infinity, for the models which cannot tell.
+   *
+   * \param lossDb a loss (in dB)
+   * \returns the range (in m), or infinity if it is not bounded
+   */
+  virtual double DoGetMaxRange (double lossDb) const;
+
+  /**
+   * Returns an upper bound of the gain this particular
+   * PropagationLossModel may apply to the signal. The default returns
+   * infinity, for the models which cannot tell.
+   *
+   * \returns the largest gain (in dB), or infinity if it is not bounded
+   */
+  virtual double DoGetMaxGain (void) const;
+
   /**
    * Subclasses must implement this; those not using random variables
    * can return zero
@@ -321,7 +401,18 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                   const Ptr<MobilityModel> *receivers,
+                                   uint32_t n, double *powerDbm) const;
+  virtual double DoGetMaxRange (double lossDb) const;
+  virtual double DoGetMaxGain (void) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  /**
+   * \param txPowerDbm the transmission power (in dBm)
+   * \param distance the distance between the nodes (in m)
+   * \returns the reception power (in dBm)
+   */
+  double GetRxPower (double txPowerDbm, double distance) const;
 
   /**
    * Transforms a Dbm value to Watt
@@ -529,7 +620,18 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                   const Ptr<MobilityModel> *receivers,
+                                   uint32_t n, double *powerDbm) const;
+  virtual double DoGetMaxRange (double lossDb) const;
+  virtual double DoGetMaxGain (void) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  /**
+   * \param txPowerDbm the transmission power (in dBm)
+   * \param distance the distance between the nodes (in m)
+   * \returns the reception power (in dBm)
+   */
+  double GetRxPower (double txPowerDbm, double distance) const;
 
   /**
    *  Creates a default reference loss model
@@ -844,6 +946,8 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual double DoGetMaxRange (double lossDb) const;
+  virtual double DoGetMaxGain (void) const;
   virtual int64_t DoAssignStreams (int64_t stream);
 private:
   double m_range; //!< Maximum Transmission Range (meters)
@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+
+#include <ns3/test.h>
+#include <ns3/double.h>
+#include <ns3/uinteger.h>
+#include <ns3/pointer.h>
+#include <ns3/cached-propagation-loss-model.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/constant-position-mobility-model.h>
+
+using namespace ns3;
+
+/**
+ * Check the hits, misses and evictions of the CachedPropagationLossModel
+ */
+class CachedPropagationLossModelTestCase : public TestCase
+{
+public:
+  CachedPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param model the cache
+   * \param hits the expected number of hits
+   * \param misses the expected number of misses
+   */
+  void CheckCounters (Ptr<CachedPropagationLossModel> model, uint64_t hits, uint64_t misses);
+};
+
+CachedPropagationLossModelTestCase::CachedPropagationLossModelTestCase ()
+  : TestCase ("Check the cache of a propagation loss model")
+{
+}
+
+void
+CachedPropagationLossModelTestCase::CheckCounters (Ptr<CachedPropagationLossModel> model, uint64_t hits, uint64_t misses)
+{
+  UintegerValue value;
+  model->GetAttribute ("Hits", value);
+  NS_TEST_EXPECT_MSG_EQ (value.Get (), hits, "Wrong number of hits");
+  model->GetAttribute ("Misses", value);
+  NS_TEST_EXPECT_MSG_EQ (value.Get (), misses, "Wrong number of misses");
+}
+
+void
+CachedPropagationLossModelTestCase::DoRun (void)
+{
+  Ptr<FriisPropagationLossModel> friis = CreateObject<FriisPropagationLossModel> ();
+  Ptr<CachedPropagationLossModel> cache = CreateObject<CachedPropagationLossModel> ();
+  cache->SetAttribute ("Model", PointerValue (friis));
+  cache->SetAttribute ("CellSize", DoubleValue (1.0));
+
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0.5, 0.5, 0.5));
+  b->SetPosition (Vector (100.5, 0.5, 0.5));
+  double expected = friis->CalcRxPower (16.0, a, b);
+  double rxPower = cache->CalcRxPower (16.0, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (rxPower, expected, 1e-12, "Wrong first result");
+  CheckCounters (cache, 0, 1);
+
+  // moves inside the cells reuse the result
+  b->SetPosition (Vector (100.9, 0.1, 0.7));
+  rxPower = cache->CalcRxPower (16.0, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (rxPower, expected, 1e-12, "Result not reused");
+  CheckCounters (cache, 1, 1);
+  // but not another power, the reverse link or another cell
+  cache->CalcRxPower (10.0, a, b);
+  cache->CalcRxPower (16.0, b, a);
+  CheckCounters (cache, 1, 3);
+  b->SetPosition (Vector (101.5, 0.5, 0.5));
+  rxPower = cache->CalcRxPower (16.0, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (rxPower, friis->CalcRxPower (16.0, a, b), 1e-12,
+                             "Result not computed again in another cell");
+  CheckCounters (cache, 1, 4);
+  // negative coordinates are cells too
+  b->SetPosition (Vector (-0.5, 0.5, 0.5));
+  cache->CalcRxPower (16.0, a, b);
+  CheckCounters (cache, 1, 5);
+
+  // with room for two results, the one not used since the last pass of
+  // the clock hand goes first
+  cache = CreateObject<CachedPropagationLossModel> ();
+  cache->SetAttribute ("Model", PointerValue (friis));
+  cache->SetAttribute ("Capacity", UintegerValue (2));
+  Ptr<MobilityModel> c = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> d = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (10.5, 0.5, 0.5));
+  c->SetPosition (Vector (20.5, 0.5, 0.5));
+  d->SetPosition (Vector (30.5, 0.5, 0.5));
+  cache->CalcRxPower (16.0, a, b);
+  cache->CalcRxPower (16.0, a, c);
+  cache->CalcRxPower (16.0, a, b);
+  CheckCounters (cache, 1, 2);
+  rxPower = cache->CalcRxPower (16.0, a, d);
+  NS_TEST_EXPECT_MSG_EQ_TOL (rxPower, friis->CalcRxPower (16.0, a, d), 1e-12,
+                             "Wrong result after an eviction");
+  CheckCounters (cache, 1, 3);
+  rxPower = cache->CalcRxPower (16.0, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (rxPower, friis->CalcRxPower (16.0, a, b), 1e-12,
+                             "Wrong result kept");
+  CheckCounters (cache, 2, 3);
+  cache->CalcRxPower (16.0, a, c);
+  CheckCounters (cache, 2, 4);
+
+  // many more links than entries still give the right results
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      c->SetPosition (Vector (i % 7 + 0.5, 50.5 + i % 13, 0.5));
+      rxPower = cache->CalcRxPower (16.0, a, c);
+      NS_TEST_ASSERT_MSG_EQ_TOL (rxPower, friis->CalcRxPower (16.0, a, c), 1e-12,
+                                 "Wrong result under eviction");
+    }
+}
+
+class CachedPropagationLossModelTestSuite : public TestSuite
+{
+public:
+  CachedPropagationLossModelTestSuite ();
+};
+
+CachedPropagationLossModelTestSuite::CachedPropagationLossModelTestSuite ()
+  : TestSuite ("cached-propagation-loss-model", UNIT)
+{
+  AddTestCase (new CachedPropagationLossModelTestCase, TestCase::QUICK);
+}
+
+static CachedPropagationLossModelTestSuite g_cachedPropagationLossModelTestSuite;
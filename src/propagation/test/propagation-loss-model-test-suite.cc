@@ -22,6 +22,9 @@
 #include "ns3/config.h"
 #include "ns3/double.h"
 #include "ns3/propagation-loss-model.h"
+#include "ns3/okumura-hata-propagation-loss-model.h"
+#include "ns3/itu-r-1411-los-propagation-loss-model.h"
+#include "ns3/itu-r-1411-nlos-over-rooftop-propagation-loss-model.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/simulator.h"
 
@@ -436,6 +439,84 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class BatchPropagationLossModelTestCase : public TestCase
+{
+public:
+  BatchPropagationLossModelTestCase ();
+  virtual ~BatchPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compare CalcRxPowerBatch to CalcRxPower for each receiver
+   * \param model the first model of the chain
+   * \param a the sender
+   * \param receivers the receivers
+   * \param name the name of the chain, for the messages
+   */
+  void CheckBatch (Ptr<PropagationLossModel> model, Ptr<MobilityModel> a,
+                   const std::vector<Ptr<MobilityModel> > &receivers, std::string name);
+};
+
+BatchPropagationLossModelTestCase::BatchPropagationLossModelTestCase ()
+  : TestCase ("Test CalcRxPowerBatch against CalcRxPower")
+{
+}
+
+BatchPropagationLossModelTestCase::~BatchPropagationLossModelTestCase ()
+{
+}
+
+void
+BatchPropagationLossModelTestCase::CheckBatch (Ptr<PropagationLossModel> model, Ptr<MobilityModel> a,
+                                               const std::vector<Ptr<MobilityModel> > &receivers,
+                                               std::string name)
+{
+  std::vector<double> rxPowerDbm;
+  model->CalcRxPowerBatch (20.0, a, receivers, rxPowerDbm);
+  NS_TEST_ASSERT_MSG_EQ (rxPowerDbm.size (), receivers.size (), name << ": wrong number of powers");
+  for (uint32_t i = 0; i < receivers.size (); i++)
+    {
+      double expected = model->CalcRxPower (20.0, a, receivers[i]);
+      NS_TEST_EXPECT_MSG_EQ_TOL (rxPowerDbm[i], expected, 1e-9, name << ": wrong power at receiver " << i);
+    }
+}
+
+void
+BatchPropagationLossModelTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0.0, 0.0, 30.0));
+  std::vector<Ptr<MobilityModel> > receivers;
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+      b->SetPosition (Vector (i * i * 10.0, i * 3.0, 1.5 + i % 3));
+      receivers.push_back (b);
+    }
+
+  CheckBatch (CreateObject<FriisPropagationLossModel> (), a, receivers, "Friis");
+  CheckBatch (CreateObject<LogDistancePropagationLossModel> (), a, receivers, "LogDistance");
+  CheckBatch (CreateObject<OkumuraHataPropagationLossModel> (), a, receivers, "OkumuraHata");
+  CheckBatch (CreateObject<ItuR1411LosPropagationLossModel> (), a, receivers, "ItuR1411Los");
+  CheckBatch (CreateObject<ItuR1411NlosOverRooftopPropagationLossModel> (), a, receivers, "ItuR1411NlosOverRooftop");
+
+  // a chain mixing batch models with models using the default
+  Ptr<PropagationLossModel> chain = CreateObject<ThreeLogDistancePropagationLossModel> ();
+  Ptr<PropagationLossModel> friis = CreateObject<FriisPropagationLossModel> ();
+  Ptr<PropagationLossModel> hata = CreateObject<OkumuraHataPropagationLossModel> ();
+  hata->SetAttribute ("Frequency", DoubleValue (900e6));
+  chain->SetNext (friis);
+  friis->SetNext (hata);
+  hata->SetNext (CreateObject<RangePropagationLossModel> ());
+  CheckBatch (chain, a, receivers, "Chain");
+
+  std::vector<double> rxPowerDbm (3, 0.0);
+  chain->CalcRxPowerBatch (20.0, a, std::vector<Ptr<MobilityModel> > (), rxPowerDbm);
+  NS_TEST_EXPECT_MSG_EQ (rxPowerDbm.empty (), true, "Powers for no receivers");
+  Simulator::Destroy ();
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +531,7 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new BatchPropagationLossModelTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
@@ -266,6 +266,30 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_LOG_LOGIC ("converter map size: " << txInfoIteratorerator->second.m_spectrumConverterMap.size ());
   NS_LOG_LOGIC ("converter map first element: " << txInfoIteratorerator->second.m_spectrumConverterMap.begin ()->first);
 
+  // the propagation gains of all the receivers at once, so that the
+  // models look the sender up once per transmission
+  m_receiverMobility.clear ();
+  if (txMobility && m_propagationLoss)
+    {
+      for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
+           rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
+           ++rxInfoIterator)
+        {
+          for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxInfoIterator->second.m_rxPhySet.begin ();
+               rxPhyIterator != rxInfoIterator->second.m_rxPhySet.end ();
+               ++rxPhyIterator)
+            {
+              Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
+              if ((*rxPhyIterator) != txParams->txPhy && receiverMobility)
+                {
+                  m_receiverMobility.push_back (receiverMobility);
+                }
+            }
+        }
+      m_propagationLoss->CalcRxPowerBatch (0, txMobility, m_receiverMobility, m_propagationGainDb);
+    }
+  uint32_t k = 0;
+
   for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
        rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
        ++rxInfoIterator)
@@ -324,7 +348,8 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                     }
                   if (m_propagationLoss)
                     {
-                      double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
+                      NS_ASSERT (m_receiverMobility[k] == receiverMobility);
+                      double propagationGainDb = m_propagationGainDb[k++];
                       NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
                       pathLossDb -= propagationGainDb;
                     }                    
@@ -367,7 +392,7 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
         }
 
     }
-
+  m_receiverMobility.clear ();
 }
 
 void
@@ -27,8 +27,10 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
+#include <ns3/mobility-model.h>
 #include <map>
 #include <set>
+#include <vector>
 
 namespace ns3 {
 
@@ -174,6 +176,13 @@ private:
   double m_maxLossDb;
 
   TracedCallback<Ptr<SpectrumPhy>, Ptr<SpectrumPhy>, double > m_pathLossTrace;
+
+  /**
+   * mobility models of the receivers of the current transmission, whose
+   * propagation gains are computed at once into m_propagationGainDb
+   */
+  std::vector<Ptr<MobilityModel> > m_receiverMobility;
+  std::vector<double> m_propagationGainDb;
 };
 
 
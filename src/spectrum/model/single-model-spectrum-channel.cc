@@ -134,6 +134,25 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
   Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility ();
 
+  // the propagation gains of all the receivers at once, so that the
+  // models look the sender up once per transmission
+  m_receiverMobility.clear ();
+  if (senderMobility && m_propagationLoss)
+    {
+      for (PhyList::const_iterator rxPhyIterator = m_phyList.begin ();
+           rxPhyIterator != m_phyList.end ();
+           ++rxPhyIterator)
+        {
+          Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
+          if ((*rxPhyIterator) != txParams->txPhy && receiverMobility)
+            {
+              m_receiverMobility.push_back (receiverMobility);
+            }
+        }
+      m_propagationLoss->CalcRxPowerBatch (0, senderMobility, m_receiverMobility, m_propagationGainDb);
+    }
+  uint32_t k = 0;
+
   for (PhyList::const_iterator rxPhyIterator = m_phyList.begin ();
        rxPhyIterator != m_phyList.end ();
        ++rxPhyIterator)
@@ -166,7 +185,8 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                 }
               if (m_propagationLoss)
                 {
-                  double propagationGainDb = m_propagationLoss->CalcRxPower (0, senderMobility, receiverMobility);
+                  NS_ASSERT (m_receiverMobility[k] == receiverMobility);
+                  double propagationGainDb = m_propagationGainDb[k++];
                   NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
                   pathLossDb -= propagationGainDb;
                 }                    
@@ -207,7 +227,7 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
             }
         }
     }
-
+  m_receiverMobility.clear ();
 }
 
 void
@@ -25,6 +25,8 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-model.h>
 #include <ns3/traced-callback.h>
+#include <ns3/mobility-model.h>
+#include <vector>
 
 namespace ns3 {
 
@@ -110,6 +112,13 @@ private:
   double m_maxLossDb;
 
   TracedCallback<Ptr<SpectrumPhy>, Ptr<SpectrumPhy>, double > m_pathLossTrace;
+
+  /**
+   * mobility models of the receivers of the current transmission, whose
+   * propagation gains are computed at once into m_propagationGainDb
+   */
+  std::vector<Ptr<MobilityModel> > m_receiverMobility;
+  std::vector<double> m_propagationGainDb;
 };
 
 
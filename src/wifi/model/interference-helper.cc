@@ -89,32 +89,6 @@ InterferenceHelper::Event::GetPreambleType (void) const
 }
 
 
-/****************************************************************
- *       Class which records SNIR change events for a
- *       short period of time.
- ****************************************************************/
-
-InterferenceHelper::NiChange::NiChange (Time time, double delta)
-  : m_time (time),
-    m_delta (delta)
-{
-}
-Time
-InterferenceHelper::NiChange::GetTime (void) const
-{
-  return m_time;
-}
-double
-InterferenceHelper::NiChange::GetDelta (void) const
-{
-  return m_delta;
-}
-bool
-InterferenceHelper::NiChange::operator < (const InterferenceHelper::NiChange& o) const
-{
-  return (m_time < o.m_time);
-}
-
 /****************************************************************
  *       The actual InterferenceHelper
  ****************************************************************/
@@ -181,8 +155,8 @@ InterferenceHelper::GetEnergyDuration (double energyW)
   noiseInterferenceW = m_firstPower;
   for (NiChanges::const_iterator i = m_niChanges.begin (); i != m_niChanges.end (); i++)
     {
-      noiseInterferenceW += i->GetDelta ();
-      end = i->GetTime ();
+      noiseInterferenceW += i->second;
+      end = i->first;
       if (end < now)
         {
           continue;
@@ -201,20 +175,18 @@ InterferenceHelper::AppendEvent (Ptr<InterferenceHelper::Event> event)
   Time now = Simulator::Now ();
   if (!m_rxing)
     {
-      NiChanges::iterator nowIterator = GetPosition (now);
+      // the changes up to now are only needed for their sum
+      NiChanges::iterator nowIterator = m_niChanges.upper_bound (now);
       for (NiChanges::iterator i = m_niChanges.begin (); i != nowIterator; i++)
         {
-          m_firstPower += i->GetDelta ();
+          m_firstPower += i->second;
         }
       m_niChanges.erase (m_niChanges.begin (), nowIterator);
-      m_niChanges.insert (m_niChanges.begin (), NiChange (event->GetStartTime (), event->GetRxPowerW ()));
-    }
-  else
-    {
-      AddNiChangeEvent (NiChange (event->GetStartTime (), event->GetRxPowerW ()));
     }
-  AddNiChangeEvent (NiChange (event->GetEndTime (), -event->GetRxPowerW ()));
-
+  // inserted after the changes at the same time, so that the start of
+  // the first event added while not receiving comes first
+  AddNiChangeEvent (event->GetStartTime (), event->GetRxPowerW ());
+  AddNiChangeEvent (event->GetEndTime (), -event->GetRxPowerW ());
 }
 
 
@@ -233,20 +205,22 @@ InterferenceHelper::CalculateSnr (double signal, double noiseInterference, WifiM
 }
 
 double
-InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event> event, NiChanges *ni) const
+InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event> event,
+                                                 NiChanges::const_iterator *first,
+                                                 NiChanges::const_iterator *last) const
 {
   double noiseInterference = m_firstPower;
   NS_ASSERT (m_rxing);
-  for (NiChanges::const_iterator i = m_niChanges.begin () + 1; i != m_niChanges.end (); i++)
+  // the first change is the start of the event received
+  *first = m_niChanges.begin ();
+  ++*first;
+  for (*last = *first; *last != m_niChanges.end (); ++*last)
     {
-      if ((event->GetEndTime () == i->GetTime ()) && event->GetRxPowerW () == -i->GetDelta ())
+      if ((event->GetEndTime () == (*last)->first) && event->GetRxPowerW () == -(*last)->second)
         {
           break;
         }
-      ni->push_back (*i);
     }
-  ni->insert (ni->begin (), NiChange (event->GetStartTime (), noiseInterference));
-  ni->push_back (NiChange (event->GetEndTime (), 0));
   return noiseInterference;
 }
 
@@ -264,23 +238,22 @@ InterferenceHelper::CalculateChunkSuccessRate (double snir, Time duration, WifiM
 }
 
 double
-InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const InterferenceHelper::Event> event, NiChanges *ni) const
+InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const InterferenceHelper::Event> event, double noiseInterferenceW,
+                                             NiChanges::const_iterator first, NiChanges::const_iterator last) const
 {
   double psr = 1.0; /* Packet Success Rate */
-  NiChanges::iterator j = ni->begin ();
-  Time previous = (*j).GetTime ();
+  Time previous = event->GetStartTime ();
   WifiMode payloadMode = event->GetPayloadMode ();
   WifiPreamble preamble = event->GetPreambleType ();
-  Time plcpHeaderStart = (*j).GetTime () + WifiPhy::GetPlcpPreambleDuration (payloadMode, preamble); //packet start time+ preamble
+  Time plcpHeaderStart = previous + WifiPhy::GetPlcpPreambleDuration (payloadMode, preamble); //packet start time+ preamble
   Time plcpHsigHeaderStart = plcpHeaderStart + WifiPhy::GetPlcpHeaderDuration (payloadMode, preamble);//packet start time+ preamble+L SIG
   Time plcpHtTrainingSymbolsStart = plcpHsigHeaderStart + WifiPhy::GetPlcpHtSigHeaderDuration (preamble);//packet start time+ preamble+L SIG+HT SIG
   Time plcpPayloadStart =plcpHtTrainingSymbolsStart + WifiPhy::GetPlcpHtTrainingSymbolDuration (preamble,event->GetTxVector()); //packet start time+ preamble+L SIG+HT SIG+Training
-  double noiseInterferenceW = (*j).GetDelta ();
   double powerW = event->GetRxPowerW ();
-    j++;
-  while (ni->end () != j)
+  // the changes while the event is received, then its end
+  for (NiChanges::const_iterator j = first; ; j++)
     {
-      Time current = (*j).GetTime ();
+      Time current = j == last ? event->GetEndTime () : j->first;
       NS_ASSERT (current >= previous);
       //Case 1: Both prev and curr point to the payload
       if (previous >= plcpPayloadStart)
@@ -350,9 +323,12 @@ InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const InterferenceHelper::Event
             }
         }
 
-      noiseInterferenceW += (*j).GetDelta ();
-      previous = (*j).GetTime ();
-      j++;
+      if (j == last)
+        {
+          break;
+        }
+      noiseInterferenceW += j->second;
+      previous = current;
     }
 
   double per = 1 - psr;
@@ -360,11 +336,11 @@ InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const InterferenceHelper::Event
 }
 
 double
-InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event> event, NiChanges *ni) const
+InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event> event, double noiseInterferenceW,
+                                            NiChanges::const_iterator first, NiChanges::const_iterator last) const
 {
   double psr = 1.0; /* Packet Success Rate */
-  NiChanges::iterator j = ni->begin ();
-  Time previous = (*j).GetTime ();
+  Time previous = event->GetStartTime ();
   WifiMode payloadMode = event->GetPayloadMode ();
   WifiPreamble preamble = event->GetPreambleType ();
   WifiMode MfHeaderMode ;
@@ -373,16 +349,15 @@ InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event>
       MfHeaderMode = WifiPhy::GetMFPlcpHeaderMode (payloadMode, preamble); //return L-SIG mode
     }
   WifiMode headerMode = WifiPhy::GetPlcpHeaderMode (payloadMode, preamble);
-  Time plcpHeaderStart = (*j).GetTime () + WifiPhy::GetPlcpPreambleDuration (payloadMode, preamble); // packet start time + preamble
+  Time plcpHeaderStart = previous + WifiPhy::GetPlcpPreambleDuration (payloadMode, preamble); // packet start time + preamble
   Time plcpHsigHeaderStart = plcpHeaderStart + WifiPhy::GetPlcpHeaderDuration (payloadMode, preamble); // packet start time + preamble+L SIG
   Time plcpHtTrainingSymbolsStart = plcpHsigHeaderStart + WifiPhy::GetPlcpHtSigHeaderDuration (preamble); // packet start time + preamble + L SIG + HT SIG
   Time plcpPayloadStart = plcpHtTrainingSymbolsStart + WifiPhy::GetPlcpHtTrainingSymbolDuration (preamble, event->GetTxVector()); // packet start time + preamble + L SIG + HT SIG + Training
-  double noiseInterferenceW = (*j).GetDelta ();
   double powerW = event->GetRxPowerW ();
-    j++;
-  while (ni->end () != j)
+  // the changes while the event is received, then its end
+  for (NiChanges::const_iterator j = first; ; j++)
     {
-      Time current = (*j).GetTime ();
+      Time current = j == last ? event->GetEndTime () : j->first;
       NS_ASSERT (current >= previous);
       //Case 1: previous is in HT-SIG: Non HT will not enter here since it didn't enter in the last two and they are all the same for non HT
       if (previous >= plcpHsigHeaderStart)
@@ -583,9 +558,12 @@ InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event>
             }
         }
 
-      noiseInterferenceW += (*j).GetDelta ();
-      previous = (*j).GetTime ();
-      j++;
+      if (j == last)
+        {
+          break;
+        }
+      noiseInterferenceW += j->second;
+      previous = current;
     }
 
   double per = 1 - psr;
@@ -595,8 +573,8 @@ InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event>
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculatePlcpPayloadSnrPer (Ptr<InterferenceHelper::Event> event)
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  NiChanges::const_iterator first, last;
+  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &first, &last);
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              event->GetPayloadMode ());
@@ -604,7 +582,7 @@ InterferenceHelper::CalculatePlcpPayloadSnrPer (Ptr<InterferenceHelper::Event> e
   /* calculate the SNIR at the start of the packet and accumulate
    * all SNIR changes in the snir vector.
    */
-  double per = CalculatePlcpPayloadPer (event, &ni);
+  double per = CalculatePlcpPayloadPer (event, noiseInterferenceW, first, last);
 
   struct SnrPer snrPer;
   snrPer.snr = snr;
@@ -615,8 +593,8 @@ InterferenceHelper::CalculatePlcpPayloadSnrPer (Ptr<InterferenceHelper::Event> e
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculatePlcpHeaderSnrPer (Ptr<InterferenceHelper::Event> event)
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  NiChanges::const_iterator first, last;
+  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &first, &last);
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              WifiPhy::GetPlcpHeaderMode (event->GetPayloadMode (), event->GetPreambleType ()));
@@ -624,7 +602,7 @@ InterferenceHelper::CalculatePlcpHeaderSnrPer (Ptr<InterferenceHelper::Event> ev
   /* calculate the SNIR at the start of the plcp header and accumulate
    * all SNIR changes in the snir vector.
    */
-  double per = CalculatePlcpHeaderPer (event, &ni);
+  double per = CalculatePlcpHeaderPer (event, noiseInterferenceW, first, last);
 
   struct SnrPer snrPer;
   snrPer.snr = snr;
@@ -639,16 +617,11 @@ InterferenceHelper::EraseEvents (void)
   m_rxing = false;
   m_firstPower = 0.0;
 }
-InterferenceHelper::NiChanges::iterator
-InterferenceHelper::GetPosition (Time moment)
-{
-  return std::upper_bound (m_niChanges.begin (), m_niChanges.end (), NiChange (moment, 0));
-
-}
 void
-InterferenceHelper::AddNiChangeEvent (NiChange change)
+InterferenceHelper::AddNiChangeEvent (Time time, double delta)
 {
-  m_niChanges.insert (GetPosition (change.GetTime ()), change);
+  // the position is searched from the end, where most changes go
+  m_niChanges.insert (m_niChanges.end (), std::make_pair (time, delta));
 }
 void
 InterferenceHelper::NotifyRxStart ()
@@ -23,6 +23,7 @@
 #include <stdint.h>
 #include <vector>
 #include <list>
+#include <map>
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
 #include "wifi-phy-standard.h"
@@ -210,45 +211,12 @@ private:
   void EraseEvents (void);
 private:
   /**
-   * Noise and Interference (thus Ni) event.
+   * The changes of the noise and interference (thus Ni) power (W), by
+   * time, and in the order they were added for the same time: a balanced
+   * tree, in which a change is added and the past ones are pruned in
+   * logarithmic time.
    */
-  class NiChange
-  {
-public:
-    /**
-     * Create a NiChange at the given time and the amount of NI change.
-     *
-     * \param time time of the event
-     * \param delta the power
-     */
-    NiChange (Time time, double delta);
-    /**
-     * Return the event time.
-     *
-     * \return the event time.
-     */
-    Time GetTime (void) const;
-    /**
-     * Return the power
-     *
-     * \return the power
-     */
-    double GetDelta (void) const;
-    /**
-     * Compare the event time of two NiChange objects (a < o).
-     *
-     * \param o
-     * \return true if a < o.time, false otherwise
-     */
-    bool operator < (const NiChange& o) const;
-private:
-    Time m_time;
-    double m_delta;
-  };
-  /**
-   * typedef for a vector of NiChanges
-   */
-  typedef std::vector <NiChange> NiChanges;
+  typedef std::multimap<Time, double> NiChanges;
   /**
    * typedef for a list of Events
    */
@@ -265,11 +233,13 @@ private:
   /**
    * Calculate noise and interference power in W.
    *
-   * \param event
-   * \param ni
-   * \return noise and interference power
+   * \param event the event received
+   * \param first on return, the first change after the start of the event
+   * \param last on return, the change ending the event
+   * \return noise and interference power at the start of the event
    */
-  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const;
+  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges::const_iterator *first,
+                                      NiChanges::const_iterator *last) const;
   /**
    * Calculate SNR (linear ratio) from the given signal power and noise+interference power.
    * (Mode is not currently used)
@@ -294,20 +264,26 @@ private:
    * Calculate the error rate of the given plcp payload. The plcp payload can be divided into
    * multiple chunks (e.g. due to interference from other transmissions).
    *
-   * \param event
-   * \param ni
+   * \param event the event received
+   * \param noiseInterferenceW the noise and interference power at the start of the event
+   * \param first the first change after the start of the event
+   * \param last the change ending the event
    * \return the error rate of the packet
    */
-  double CalculatePlcpPayloadPer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculatePlcpPayloadPer (Ptr<const Event> event, double noiseInterferenceW,
+                                  NiChanges::const_iterator first, NiChanges::const_iterator last) const;
   /**
    * Calculate the error rate of the plcp header. The plcp header can be divided into
    * multiple chunks (e.g. due to interference from other transmissions).
    *
-   * \param event
-   * \param ni
+   * \param event the event received
+   * \param noiseInterferenceW the noise and interference power at the start of the event
+   * \param first the first change after the start of the event
+   * \param last the change ending the event
    * \return the error rate of the packet
    */
-  double CalculatePlcpHeaderPer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculatePlcpHeaderPer (Ptr<const Event> event, double noiseInterferenceW,
+                                 NiChanges::const_iterator first, NiChanges::const_iterator last) const;
 
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<ErrorRateModel> m_errorRateModel;
@@ -315,14 +291,14 @@ private:
   NiChanges m_niChanges;
   double m_firstPower;
   bool m_rxing;
-  /// Returns an iterator to the first nichange, which is later than moment
-  NiChanges::iterator GetPosition (Time moment);
   /**
-   * Add NiChange to the list at the appropriate position.
+   * Add a change of the noise and interference power, after the others
+   * at the same time.
    *
-   * \param change
+   * \param time the time of the change
+   * \param delta the change of power (W)
    */
-  void AddNiChangeEvent (NiChange change);
+  void AddNiChangeEvent (Time time, double delta);
 };
 
 } // namespace ns3
@@ -25,10 +25,15 @@
 #include "ns3/log.h"
 #include "ns3/pointer.h"
 #include "ns3/object-factory.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/event-impl.h"
 #include "yans-wifi-channel.h"
 #include "yans-wifi-phy.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
+#include <algorithm>
+#include <limits>
 
 namespace ns3 {
 
@@ -36,6 +41,94 @@ NS_LOG_COMPONENT_DEFINE ("YansWifiChannel");
 
 NS_OBJECT_ENSURE_REGISTERED (YansWifiChannel);
 
+/**
+ * The receptions of a transmission, sorted by arrival time, and delivered
+ * by the same event, scheduled again in the context of each receiver
+ * once the previous one is delivered.
+ */
+class YansWifiChannel::FanOut : public EventImpl
+{
+public:
+  /** A reception of the transmission */
+  struct Reception
+  {
+    Time arrival;       //!< time the first bit reaches the PHY
+    uint32_t phy;       //!< index of the PHY
+    uint32_t node;      //!< context of the reception
+    double rxPowerDbm;  //!< received power
+    /**
+     * \param o another reception
+     * \return whether this one is delivered first: in the order of the
+     *         PHYs for the same arrival time, as with one event each
+     */
+    bool operator< (const Reception &o) const
+    {
+      return arrival < o.arrival || (arrival == o.arrival && phy < o.phy);
+    }
+  };
+
+  FanOut ()
+    : m_channel (0),
+      m_next (0)
+  {
+  }
+  /**
+   * \return whether the receptions were all delivered, so that this
+   *         fan-out may be reused
+   */
+  bool IsIdle (void) const
+  {
+    return GetReferenceCount () == 1;
+  }
+  /**
+   * Schedule the first reception, once m_receptions is filled
+   */
+  void Start (void)
+  {
+    std::sort (m_receptions.begin (), m_receptions.end ());
+    m_next = 0;
+    ScheduleNext ();
+  }
+
+  const YansWifiChannel *m_channel;   //!< the channel
+  Ptr<const Packet> m_packet;         //!< the packet, shared by the receivers
+  ReceiveParams m_params;             //!< the parameters of the transmission
+  std::vector<Reception> m_receptions; //!< the receptions, by arrival time
+
+private:
+  /**
+   * Schedule the next reception, in the context of its node
+   */
+  void ScheduleNext (void)
+  {
+    const Reception &r = m_receptions[m_next];
+    // the scheduler releases a reference once the event is invoked
+    Ref ();
+    Simulator::ScheduleWithContext (r.node, r.arrival - Simulator::Now (), this);
+  }
+  virtual void Notify (void)
+  {
+    const Reception &r = m_receptions[m_next++];
+    Ptr<const Packet> packet = m_packet;
+    ReceiveParams params = m_params;
+    params.rxPowerDbm = r.rxPowerDbm;
+    uint32_t phy = r.phy;
+    // scheduled before the delivery, as the next reception would have
+    // been with one event each
+    if (m_next < m_receptions.size ())
+      {
+        ScheduleNext ();
+      }
+    else
+      {
+        m_packet = 0;
+      }
+    m_channel->Receive (phy, packet, params);
+  }
+
+  uint32_t m_next; //!< index of the next reception
+};
+
 TypeId
 YansWifiChannel::GetTypeId (void)
 {
@@ -51,11 +144,37 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("SpatialIndex",
+                   "Whether to index the PHYs by position, and to deliver a frame "
+                   "only to the PHYs within the range of the propagation loss model.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_spatialIndex),
+                   MakeBooleanChecker ())
+    .AddAttribute ("CellSize",
+                   "The side of the cells of the spatial index (m), or 0 to use the "
+                   "range of the first transmission.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_cellSize),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("PruningMargin",
+                   "With SpatialIndex, the margin (dB) below the lowest EnergyDetectionThreshold "
+                   "of the PHYs under which a frame is not delivered.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_pruningMargin),
+                   MakeDoubleChecker<double> (0.0))
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_spatialIndex (false),
+    m_cellSize (0.0),
+    m_pruningMargin (0.0),
+    m_gridReady (false),
+    m_nIndexed (0),
+    m_thresholdDbm (std::numeric_limits<double>::infinity ()),
+    m_rangeTxPowerDbm (std::numeric_limits<double>::quiet_NaN ()),
+    m_range (std::numeric_limits<double>::infinity ())
 {
 }
 YansWifiChannel::~YansWifiChannel ()
@@ -64,10 +183,29 @@ YansWifiChannel::~YansWifiChannel ()
   m_phyList.clear ();
 }
 
+void
+YansWifiChannel::DoDispose (void)
+{
+  for (std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator i = m_mobilityPhys.begin ();
+       i != m_mobilityPhys.end (); ++i)
+    {
+      m_phyMobility[i->second[0]]->TraceDisconnectWithoutContext ("CourseChange",
+                                                                  MakeCallback (&YansWifiChannel::CourseChange, this));
+    }
+  m_mobilityPhys.clear ();
+  m_phyMobility.clear ();
+  m_grid.Clear ();
+  m_nIndexed = 0;
+  m_nodeIds.clear ();
+  m_fanOuts.clear ();
+  WifiChannel::DoDispose ();
+}
+
 void
 YansWifiChannel::SetPropagationLossModel (Ptr<PropagationLossModel> loss)
 {
   m_loss = loss;
+  m_rangeTxPowerDbm = std::numeric_limits<double>::quiet_NaN ();
 }
 void
 YansWifiChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel> delay)
@@ -81,52 +219,181 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 {
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
-  uint32_t j = 0;
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+  m_receivers.clear ();
+  m_receiverMobility.clear ();
+  bool pruned = false;
+  if (m_spatialIndex)
     {
-      if (sender != (*i))
+      IndexPhys ();
+      if (txPowerDbm != m_rangeTxPowerDbm)
         {
-          // For now don't account for inter channel interference
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
-            {
-              continue;
-            }
-
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
-          Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
+          m_range = m_loss->GetMaxRange (txPowerDbm, m_thresholdDbm);
+          m_rangeTxPowerDbm = txPowerDbm;
+          NS_LOG_DEBUG ("range at " << txPowerDbm << "dbm: " << m_range << "m");
+        }
+      pruned = m_range != std::numeric_limits<double>::infinity ();
+    }
+  if (pruned)
+    {
+      if (!m_gridReady)
+        {
+          m_grid.SetCellSize (m_cellSize > 0 ? m_cellSize : std::max (m_range, 1.0));
+          m_gridReady = true;
+        }
+      m_grid.FindNear (senderMobility->GetPosition (), m_range, m_near);
+      // in the order of the PHY list, as without the index
+      std::sort (m_near.begin (), m_near.end ());
+      for (uint32_t k = 0; k < m_near.size (); k++)
+        {
+          uint32_t j = m_near[k];
+          if (m_phyList[j] != sender && m_phyChannel[j] == sender->GetChannelNumber ())
             {
-              dstNode = 0xffffffff;
+              m_receivers.push_back (j);
+              m_receiverMobility.push_back (m_phyMobility[j]);
             }
-          else
+        }
+    }
+  else
+    {
+      // For now don't account for inter channel interference
+      std::map<uint16_t, std::vector<uint32_t> >::const_iterator phys = m_channelPhys.find (sender->GetChannelNumber ());
+      if (phys != m_channelPhys.end ())
+        {
+          for (std::vector<uint32_t>::const_iterator i = phys->second.begin (); i != phys->second.end (); i++)
             {
-              dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
+              uint32_t j = *i;
+              if (sender != m_phyList[j])
+                {
+                  m_receivers.push_back (j);
+                  m_receiverMobility.push_back (m_phyList[j]->GetMobility ()->GetObject<MobilityModel> ());
+                }
             }
+        }
+    }
 
-          double *atts = new double[3];
-          *atts = rxPowerDbm;
-          *(atts+1)= packetType;
-          *(atts+2)= duration.GetNanoSeconds();
+  // the losses of all the receivers at once, so that the models look
+  // the sender up once per transmission
+  m_loss->CalcRxPowerBatch (txPowerDbm, senderMobility, m_receiverMobility, m_rxPowerDbm);
 
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive, this,
-                                          j, copy, atts, txVector, preamble);
+  Ptr<FanOut> fanOut;
+  for (uint32_t k = 0; k < m_fanOuts.size (); k++)
+    {
+      if (m_fanOuts[k]->IsIdle ())
+        {
+          fanOut = m_fanOuts[k];
+          break;
         }
     }
+  if (fanOut == 0)
+    {
+      fanOut = Create<FanOut> ();
+      m_fanOuts.push_back (fanOut);
+    }
+  fanOut->m_receptions.clear ();
+  for (uint32_t k = 0; k < m_receivers.size (); k++)
+    {
+      uint32_t j = m_receivers[k];
+      if (pruned && m_rxPowerDbm[k] < m_thresholdDbm)
+        {
+          NS_LOG_LOGIC ("not delivered to " << j << " below " << m_thresholdDbm << "dbm");
+          continue;
+        }
+      Ptr<MobilityModel> receiverMobility = m_receiverMobility[k];
+      Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
+      NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << m_rxPowerDbm[k] << "dbm, " <<
+                    "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+      FanOut::Reception reception;
+      reception.arrival = Simulator::Now () + delay;
+      reception.phy = j;
+      reception.node = GetNodeId (j);
+      reception.rxPowerDbm = m_rxPowerDbm[k];
+      fanOut->m_receptions.push_back (reception);
+    }
+  if (!fanOut->m_receptions.empty ())
+    {
+      fanOut->m_channel = this;
+      // a single copy shared by all the receivers, should the sender
+      // change its own packet afterwards: the PHYs copy it again only if
+      // they pass it up to their MAC
+      fanOut->m_packet = packet->Copy ();
+      fanOut->m_params.txVector = txVector;
+      fanOut->m_params.preamble = preamble;
+      fanOut->m_params.packetType = packetType;
+      fanOut->m_params.duration = duration;
+      fanOut->Start ();
+    }
+  m_receiverMobility.clear ();
+}
+
+void
+YansWifiChannel::IndexPhys (void) const
+{
+  for (; m_nIndexed < m_phyList.size (); m_nIndexed++)
+    {
+      uint32_t j = m_nIndexed;
+      Ptr<YansWifiPhy> phy = m_phyList[j];
+      NS_ASSERT_MSG (phy->GetMobility () != 0, "PHY " << j << " has no mobility model");
+      Ptr<MobilityModel> mobility = phy->GetMobility ()->GetObject<MobilityModel> ();
+      NS_ASSERT (mobility != 0);
+      m_phyMobility.push_back (mobility);
+      std::vector<uint32_t> &phys = m_mobilityPhys[PeekPointer (mobility)];
+      if (phys.empty ())
+        {
+          mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&YansWifiChannel::CourseChange, this));
+        }
+      phys.push_back (j);
+      m_grid.Update (j, mobility->GetPosition (), mobility->GetVelocity ());
+
+      double threshold = phy->GetEdThreshold () - phy->GetRxGain () - m_pruningMargin;
+      if (threshold < m_thresholdDbm)
+        {
+          m_thresholdDbm = threshold;
+          m_rangeTxPowerDbm = std::numeric_limits<double>::quiet_NaN ();
+        }
+    }
+}
+
+void
+YansWifiChannel::CourseChange (Ptr<const MobilityModel> mobility) const
+{
+  std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator i = m_mobilityPhys.find (PeekPointer (mobility));
+  if (i == m_mobilityPhys.end ())
+    {
+      return;
+    }
+  Vector position = mobility->GetPosition ();
+  Vector velocity = mobility->GetVelocity ();
+  for (uint32_t k = 0; k < i->second.size (); k++)
+    {
+      m_grid.Update (i->second[k], position, velocity);
+    }
 }
 
 void
-YansWifiChannel::Receive (uint32_t i, Ptr<Packet> packet, double *atts,
-                          WifiTxVector txVector, WifiPreamble preamble) const
+YansWifiChannel::Receive (uint32_t i, Ptr<const Packet> packet, ReceiveParams params) const
 {
-  m_phyList[i]->StartReceivePlcp (packet, *atts, txVector, preamble,*(atts+1), NanoSeconds(*(atts+2)));
-  delete[] atts;
+  m_phyList[i]->StartReceivePlcp (packet, params.rxPowerDbm, params.txVector, params.preamble,
+                                  params.packetType, params.duration);
+}
+
+uint32_t
+YansWifiChannel::GetNodeId (uint32_t i) const
+{
+  if (m_nodeIds.size () < m_phyList.size ())
+    {
+      m_nodeIds.resize (m_phyList.size (), 0xffffffff);
+    }
+  // the helpers attach the device after the channel: look it up at the
+  // first transmission instead of in Add
+  if (m_nodeIds[i] == 0xffffffff)
+    {
+      Ptr<Object> device = m_phyList[i]->GetDevice ();
+      if (device != 0)
+        {
+          m_nodeIds[i] = device->GetObject<NetDevice> ()->GetNode ()->GetId ();
+        }
+    }
+  return m_nodeIds[i];
 }
 
 uint32_t
@@ -143,9 +410,35 @@ YansWifiChannel::GetDevice (uint32_t i) const
 void
 YansWifiChannel::Add (Ptr<YansWifiPhy> phy)
 {
+  m_phyIndex[PeekPointer (phy)] = m_phyList.size ();
+  m_channelPhys[phy->GetChannelNumber ()].push_back (m_phyList.size ());
+  m_phyChannel.push_back (phy->GetChannelNumber ());
   m_phyList.push_back (phy);
 }
 
+void
+YansWifiChannel::UpdateChannelNumber (Ptr<YansWifiPhy> phy)
+{
+  std::map<const YansWifiPhy *, uint32_t>::const_iterator i = m_phyIndex.find (PeekPointer (phy));
+  NS_ASSERT (i != m_phyIndex.end ());
+  uint32_t j = i->second;
+  uint16_t channelNumber = phy->GetChannelNumber ();
+  if (m_phyChannel[j] == channelNumber)
+    {
+      return;
+    }
+  NS_LOG_DEBUG ("PHY " << j << " moved from channel " << m_phyChannel[j] << " to " << channelNumber);
+  std::vector<uint32_t> &from = m_channelPhys[m_phyChannel[j]];
+  from.erase (std::lower_bound (from.begin (), from.end (), j));
+  if (from.empty ())
+    {
+      m_channelPhys.erase (m_phyChannel[j]);
+    }
+  std::vector<uint32_t> &to = m_channelPhys[channelNumber];
+  to.insert (std::lower_bound (to.begin (), to.end (), j), j);
+  m_phyChannel[j] = channelNumber;
+}
+
 int64_t
 YansWifiChannel::AssignStreams (int64_t stream)
 {
@@ -21,6 +21,7 @@
 #define YANS_WIFI_CHANNEL_H
 
 #include <vector>
+#include <map>
 #include <stdint.h>
 #include "ns3/packet.h"
 #include "wifi-channel.h"
@@ -28,10 +29,12 @@
 #include "wifi-preamble.h"
 #include "wifi-tx-vector.h"
 #include "ns3/nstime.h"
+#include "ns3/spatial-grid.h"
 
 namespace ns3 {
 
 class NetDevice;
+class MobilityModel;
 class PropagationLossModel;
 class PropagationDelayModel;
 class YansWifiPhy;
@@ -47,6 +50,28 @@ class YansWifiPhy;
  * class and contains a ns3::PropagationLossModel and a ns3::PropagationDelayModel.
  * By default, no propagation models are set so, it is the caller's responsability
  * to set them before using the channel.
+ *
+ * With "SpatialIndex", the PHYs are kept in a SpatialGrid, moved along
+ * the CourseChange trace of their mobility model, and a transmission
+ * only reaches the PHYs within the range of the propagation loss model,
+ * as bounded by PropagationLossModel::GetMaxRange, which the grid finds
+ * without visiting the others. The threshold of the range is the lowest
+ * EnergyDetectionThreshold of the PHYs, less their RxGain and the
+ * "PruningMargin": the frames received below it are not delivered at
+ * all, so that they neither reach the PHY nor add to its interference.
+ * The cells are as large as the range of the first transmission, unless
+ * "CellSize" is set. If the loss model cannot bound its range, as with
+ * the random fading models, every PHY is visited as usual.
+ *
+ * The receptions of a transmission are delivered by a single event,
+ * scheduled again in the context of each receiver in the order of their
+ * propagation delay, rather than by one event per receiver, so that the
+ * scheduler holds one event per transmission in flight.
+ *
+ * The thresholds and the mobility model of a PHY are read when the PHY
+ * is first indexed, at the first transmission after it was added, and
+ * the mobility models must fire CourseChange at every change of
+ * velocity: the "Lazy" 3D models are not supported.
  */
 class YansWifiChannel : public WifiChannel
 {
@@ -67,6 +92,15 @@ public:
    */
   void Add (Ptr<YansWifiPhy> phy);
 
+  /**
+   * \param phy a YansWifiPhy of the PHY list which switched channel
+   *
+   * This method should not be invoked by normal users. It is
+   * currently invoked only from YansWifiPhy::SetChannelNumber, so
+   * that Send visits only the PHYs on the channel of the sender.
+   */
+  void UpdateChannelNumber (Ptr<YansWifiPhy> phy);
+
   /**
    * \param loss the new propagation loss model.
    */
@@ -112,23 +146,73 @@ private:
    */
   typedef std::vector<Ptr<YansWifiPhy> > PhyList;
   /**
-   * This method is scheduled by Send for each associated YansWifiPhy.
+   * The parameters of a reception, held by value in the event of Receive
+   */
+  struct ReceiveParams
+  {
+    double rxPowerDbm;      //!< the received power (dBm)
+    WifiTxVector txVector;  //!< the TXVECTOR of the packet
+    WifiPreamble preamble;  //!< the type of preamble of the packet
+    uint8_t packetType;     //!< whether the packet is part of an A-MPDU, and the last one
+    Time duration;          //!< the transmission duration of the packet
+  };
+  /**
+   * The receptions of a transmission, delivered by a single event
+   */
+  class FanOut;
+  /**
+   * This method is called for each associated YansWifiPhy by the FanOut
+   * of the transmission, in the context of the node of the PHY.
    * The method then calls the corresponding YansWifiPhy that the first
    * bit of the packet has arrived.
    *
    * \param i index of the corresponding YansWifiPhy in the PHY list
-   * \param packet the packet being sent
-   * \param atts a vector containing the received power in dBm and the packet type
-   * \param txVector the TXVECTOR of the packet
-   * \param preamble the type of preamble being used to send the packet
+   * \param packet the packet being sent, shared by all the receivers
+   * \param params the received power and the other parameters of the reception
    */
-  void Receive (uint32_t i, Ptr<Packet> packet, double *atts,
-                WifiTxVector txVector, WifiPreamble preamble) const;
-
+  void Receive (uint32_t i, Ptr<const Packet> packet, ReceiveParams params) const;
+  /**
+   * \param i index of a YansWifiPhy in the PHY list
+   * \return the identifier of the node of its device, or 0xffffffff if
+   *         it has none, looked up once
+   */
+  uint32_t GetNodeId (uint32_t i) const;
+  /**
+   * Add the PHYs added since the last transmission to the spatial grid
+   */
+  void IndexPhys (void) const;
+  /**
+   * Move the PHYs of a node in the spatial grid
+   *
+   * \param mobility the mobility model of the node
+   */
+  void CourseChange (Ptr<const MobilityModel> mobility) const;
+  virtual void DoDispose (void);
 
   PhyList m_phyList; //!< List of YansWifiPhys connected to this YansWifiChannel
+  std::vector<uint16_t> m_phyChannel; //!< channel number of each PHY
+  std::map<const YansWifiPhy *, uint32_t> m_phyIndex; //!< index of each PHY in m_phyList
+  std::map<uint16_t, std::vector<uint32_t> > m_channelPhys; //!< index of the PHYs on each channel number, in order
   Ptr<PropagationLossModel> m_loss; //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay; //!< Propagation delay model
+  mutable std::vector<uint32_t> m_nodeIds; //!< node of the device of each PHY, once known
+  mutable std::vector<uint32_t> m_receivers; //!< index of the receivers of the current Send
+  mutable std::vector<Ptr<MobilityModel> > m_receiverMobility; //!< their mobility models
+  mutable std::vector<double> m_rxPowerDbm; //!< the power they receive
+  mutable std::vector<Ptr<FanOut> > m_fanOuts; //!< the fan-out events, reused once delivered
+
+  bool m_spatialIndex; //!< whether only the PHYs within range are visited
+  double m_cellSize; //!< side of the cells of the grid, or 0 for the first range
+  double m_pruningMargin; //!< margin below the lowest threshold of the PHYs, in dB
+  mutable SpatialGrid m_grid; //!< the PHYs indexed, by position
+  mutable bool m_gridReady; //!< whether the cell size of the grid is set
+  mutable uint32_t m_nIndexed; //!< number of PHYs of m_phyList indexed
+  mutable double m_thresholdDbm; //!< power below which a frame is not delivered
+  mutable std::vector<Ptr<MobilityModel> > m_phyMobility; //!< mobility model of each indexed PHY
+  mutable std::map<const MobilityModel *, std::vector<uint32_t> > m_mobilityPhys; //!< indexed PHYs of each mobility model
+  mutable double m_rangeTxPowerDbm; //!< transmission power of m_range
+  mutable double m_range; //!< range at m_rangeTxPowerDbm
+  mutable std::vector<uint32_t> m_near; //!< PHYs found in range of the current Send
 };
 
 } // namespace ns3
@@ -391,6 +391,10 @@ YansWifiPhy::SetChannelNumber (uint16_t nch)
       // this is not channel switch, this is initialization
       NS_LOG_DEBUG ("start at channel " << nch);
       m_channelNumber = nch;
+      if (m_channel != 0)
+        {
+          m_channel->UpdateChannelNumber (this);
+        }
       return;
     }
 
@@ -434,6 +438,10 @@ switchChannel:
    * out the state of the medium after the switching.
    */
   m_channelNumber = nch;
+  if (m_channel != 0)
+    {
+      m_channel->UpdateChannelNumber (this);
+    }
 }
 
 uint16_t
@@ -519,7 +527,7 @@ YansWifiPhy::SetReceiveErrorCallback (RxErrorCallback callback)
 }
 
 void
-YansWifiPhy::StartReceivePlcp (Ptr<Packet> packet,
+YansWifiPhy::StartReceivePlcp (Ptr<const Packet> packet,
                                double rxPowerDbm,
                                WifiTxVector txVector,
                                enum WifiPreamble preamble,
@@ -672,7 +680,7 @@ YansWifiPhy::StartReceivePlcp (Ptr<Packet> packet,
     }
 }
 void
-YansWifiPhy::StartReceivePacket (Ptr<Packet> packet,
+YansWifiPhy::StartReceivePacket (Ptr<const Packet> packet,
                                  WifiTxVector txVector,
                                  enum WifiPreamble preamble, 
                                  uint8_t packetType,
@@ -1003,7 +1011,7 @@ YansWifiPhy::GetPowerDbm (uint8_t power) const
 }
 
 void
-YansWifiPhy::EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, uint8_t packetType, Ptr<InterferenceHelper::Event> event)
+YansWifiPhy::EndReceive (Ptr<const Packet> packet, enum WifiPreamble preamble, uint8_t packetType, Ptr<InterferenceHelper::Event> event)
 {
   NS_LOG_FUNCTION (this << packet << event);
   NS_ASSERT (IsStateRx ());
@@ -1034,7 +1042,7 @@ YansWifiPhy::EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, uint8_t
       double signalDbm = RatioToDb (event->GetRxPowerW ()) + 30;
       double noiseDbm = RatioToDb (event->GetRxPowerW () / snrPer.snr) - GetRxNoiseFigure () + 30;
       NotifyMonitorSniffRx (packet, (uint16_t)GetChannelFrequencyMhz (), GetChannelNumber (), dataRate500KbpsUnits, isShortPreamble, signalDbm, noiseDbm);
-      m_state->SwitchFromRxEndOk (packet, snrPer.snr, event->GetTxVector (), event->GetPreambleType ());
+      m_state->SwitchFromRxEndOk (packet->Copy (), snrPer.snr, event->GetTxVector (), event->GetPreambleType ());
     }
     else
     {
@@ -102,14 +102,15 @@ public:
   /**
    * Starting receiving the plcp of a packet (i.e. the first bit of the preamble has arrived).
    *
-   * \param packet the arriving packet
+   * \param packet the arriving packet, shared by all the receivers of the
+   *        transmission: it is copied only when passed up to the MAC
    * \param rxPowerDbm the receive power in dBm
    * \param txVector the TXVECTOR of the arriving packet
    * \param preamble the preamble of the arriving packet
    * \param packetType The type of the received packet (values: 0 not an A-MPDU, 1 corresponds to any packets in an A-MPDU except the last one, 2 is the last packet in an A-MPDU) 
    * \param rxDuration the duration needed for the reception of the packet
    */
-  void StartReceivePlcp (Ptr<Packet> packet,
+  void StartReceivePlcp (Ptr<const Packet> packet,
                          double rxPowerDbm,
                          WifiTxVector txVector,
                          WifiPreamble preamble,
@@ -124,7 +125,7 @@ public:
    * \param packetType The type of the received packet (values: 0 not an A-MPDU, 1 corresponds to any packets in an A-MPDU except the last one, 2 is the last packet in an A-MPDU) 
    * \param event the corresponding event of the first time the packet arrives
    */
-  void StartReceivePacket (Ptr<Packet> packet,
+  void StartReceivePacket (Ptr<const Packet> packet,
                            WifiTxVector txVector,
                            WifiPreamble preamble,
                            uint8_t packetType,
@@ -480,7 +481,7 @@ private:
    * \param packetType The type of the received packet (values: 0 not an A-MPDU, 1 corresponds to any packets in an A-MPDU except the last one, 2 is the last packet in an A-MPDU)
    * \param event the corresponding event of the first time the packet arrives
    */
-  void EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, uint8_t packetType, Ptr<InterferenceHelper::Event> event);
+  void EndReceive (Ptr<const Packet> packet, enum WifiPreamble preamble, uint8_t packetType, Ptr<InterferenceHelper::Event> event);
 
 private:
   virtual void DoInitialize (void);
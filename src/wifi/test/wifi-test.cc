@@ -30,6 +30,7 @@
 #include "ns3/error-rate-model.h"
 #include "ns3/yans-error-rate-model.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
 #include "ns3/node.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
@@ -41,6 +42,9 @@
 #include "ns3/edca-txop-n.h"
 #include "ns3/config.h"
 #include "ns3/boolean.h"
+#include "ns3/random-variable-stream.h"
+#include <sstream>
+#include <cstdlib>
 
 using namespace ns3;
 
@@ -476,6 +480,363 @@ Bug555TestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_secondTransmissionTime, expectedSecondTransmissionTime, "The second transmission time not correct!");
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the spatial index of the YansWifiChannel delivers the
+ * frames which can be received, as the nodes move across its cells, and
+ * that the others are not delivered at all.
+ */
+class YansWifiChannelSpatialIndexTest : public TestCase
+{
+public:
+  YansWifiChannelSpatialIndexTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * Run the nodes over a channel
+   * \param spatialIndex whether the channel indexes the PHYs
+   */
+  void RunOne (bool spatialIndex);
+  /**
+   * \param dev the device sending a broadcast frame
+   */
+  void SendOnePacket (Ptr<WifiNetDevice> dev);
+  /**
+   * Count a frame received by a node
+   * \param device the receiving device
+   * \param packet the packet received
+   * \param protocol the protocol of the packet
+   * \param sender the address of the sender
+   * \return true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &sender);
+  /**
+   * Count a frame dropped by a PHY
+   * \param packet the packet dropped
+   */
+  void PhyRxDrop (Ptr<const Packet> packet);
+
+  std::map<uint32_t, uint32_t> m_received; //!< frames received by each node
+  uint32_t m_dropped; //!< frames dropped by the PHYs
+};
+
+YansWifiChannelSpatialIndexTest::YansWifiChannelSpatialIndexTest ()
+  : TestCase ("Check the frames delivered by a YansWifiChannel with a spatial index"),
+    m_dropped (0)
+{
+}
+
+void
+YansWifiChannelSpatialIndexTest::SendOnePacket (Ptr<WifiNetDevice> dev)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+bool
+YansWifiChannelSpatialIndexTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                                          uint16_t protocol, const Address &sender)
+{
+  m_received[device->GetNode ()->GetId ()]++;
+  return true;
+}
+
+void
+YansWifiChannelSpatialIndexTest::PhyRxDrop (Ptr<const Packet> packet)
+{
+  m_dropped++;
+}
+
+void
+YansWifiChannelSpatialIndexTest::RunOne (bool spatialIndex)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  ObjectFactory manager;
+  manager.SetTypeId ("ns3::ConstantRateWifiManager");
+  ObjectFactory macFactory;
+  macFactory.SetTypeId ("ns3::AdhocWifiMac");
+
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetAttribute ("SpatialIndex", BooleanValue (spatialIndex));
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+
+  // nodes crossing a square of 600 m, several times the range
+  Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable> ();
+  rand->SetStream (1);
+  for (uint32_t i = 0; i < 30; ++i)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+      Ptr<WifiMac> mac = macFactory.Create<WifiMac> ();
+      mac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+      AssignWifiRandomStreams (mac, 100 + 10 * i);
+      Ptr<ConstantVelocityMobilityModel> mobility = CreateObject<ConstantVelocityMobilityModel> ();
+      Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+      phy->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+      phy->SetChannel (channel);
+      phy->SetDevice (dev);
+      phy->SetMobility (node);
+      phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+      phy->AssignStreams (10 * i + 109);
+      phy->TraceConnectWithoutContext ("PhyRxDrop", MakeCallback (&YansWifiChannelSpatialIndexTest::PhyRxDrop, this));
+
+      mobility->SetPosition (Vector (rand->GetValue (0.0, 600.0), rand->GetValue (0.0, 600.0), 0.0));
+      mobility->SetVelocity (Vector (rand->GetValue (-20.0, 20.0), rand->GetValue (-20.0, 20.0), 0.0));
+      node->AggregateObject (mobility);
+      mac->SetAddress (Mac48Address::Allocate ());
+      dev->SetMac (mac);
+      dev->SetPhy (phy);
+      dev->SetRemoteStationManager (manager.Create<WifiRemoteStationManager> ());
+      node->AddDevice (dev);
+      dev->SetReceiveCallback (MakeCallback (&YansWifiChannelSpatialIndexTest::Receive, this));
+
+      // one sender at a time, so that the frames do not collide
+      for (uint32_t k = 0; k < 4; ++k)
+        {
+          Simulator::Schedule (Seconds (1.0 + 0.1 * i + 3.0 * k),
+                               &YansWifiChannelSpatialIndexTest::SendOnePacket, this, dev);
+        }
+      // half of the nodes turn on the way
+      if (i % 2 == 0)
+        {
+          Simulator::Schedule (Seconds (rand->GetValue (1.0, 12.0)), &ConstantVelocityMobilityModel::SetVelocity,
+                               mobility, Vector (rand->GetValue (-20.0, 20.0), rand->GetValue (-20.0, 20.0), 0.0));
+        }
+    }
+
+  Simulator::Stop (Seconds (15.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+YansWifiChannelSpatialIndexTest::DoRun (void)
+{
+  RunOne (false);
+  std::map<uint32_t, uint32_t> received = m_received;
+  uint32_t dropped = m_dropped;
+  m_received.clear ();
+  m_dropped = 0;
+  RunOne (true);
+
+  uint32_t total = 0;
+  for (std::map<uint32_t, uint32_t>::const_iterator i = received.begin (); i != received.end (); ++i)
+    {
+      total += i->second;
+    }
+  NS_TEST_ASSERT_MSG_GT (total, 30, "Too few frames received to compare");
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), received.size (), "Not the same receivers with the spatial index");
+  std::map<uint32_t, uint32_t>::const_iterator j = m_received.begin ();
+  for (std::map<uint32_t, uint32_t>::const_iterator i = received.begin (); i != received.end (); ++i, ++j)
+    {
+      // the node ids grow from one run to the next
+      NS_TEST_ASSERT_MSG_EQ (j->first - i->first, m_received.begin ()->first - received.begin ()->first,
+                             "Not the same receivers with the spatial index");
+      NS_TEST_ASSERT_MSG_EQ (j->second, i->second, "Not the same frames received with the spatial index");
+    }
+  // the frames too weak to be received are not delivered any more
+  NS_TEST_ASSERT_MSG_LT (m_dropped, dropped, "Frames below the threshold delivered with the spatial index");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the receptions of a transmission, delivered by a single
+ * event, reach the PHYs in the order of their propagation delay and in
+ * the context of their node.
+ */
+class YansWifiChannelFanOutTest : public TestCase
+{
+public:
+  YansWifiChannelFanOutTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * Record the start of a reception
+   * \param context the index of the receiving PHY
+   * \param packet the packet received
+   */
+  void PhyRxBegin (std::string context, Ptr<const Packet> packet);
+
+  std::vector<uint32_t> m_phys; //!< PHYs which started to receive, in order
+  std::vector<Time> m_times; //!< time each of them started to
+  std::vector<uint32_t> m_contexts; //!< context each of them started to in
+};
+
+YansWifiChannelFanOutTest::YansWifiChannelFanOutTest ()
+  : TestCase ("Check the order and the context of the receptions of a YansWifiChannel")
+{
+}
+
+void
+YansWifiChannelFanOutTest::PhyRxBegin (std::string context, Ptr<const Packet> packet)
+{
+  m_phys.push_back (std::atoi (context.c_str ()));
+  m_times.push_back (Simulator::Now ());
+  m_contexts.push_back (Simulator::GetContext ());
+}
+
+void
+YansWifiChannelFanOutTest::DoRun (void)
+{
+  ObjectFactory manager;
+  manager.SetTypeId ("ns3::ConstantRateWifiManager");
+  ObjectFactory macFactory;
+  macFactory.SetTypeId ("ns3::AdhocWifiMac");
+
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<FriisPropagationLossModel> ());
+
+  // the sender first, then the receivers out of the order of their distance
+  const double distances[] = { 0.0, 300.0, 100.0, 200.0, 100.0 };
+  std::vector<Ptr<WifiNetDevice> > devices;
+  std::vector<uint32_t> nodeIds;
+  for (uint32_t i = 0; i < 5; ++i)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+      Ptr<WifiMac> mac = macFactory.Create<WifiMac> ();
+      mac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+      phy->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+      phy->SetChannel (channel);
+      phy->SetDevice (dev);
+      phy->SetMobility (node);
+      phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+      std::ostringstream oss;
+      oss << i;
+      phy->TraceConnect ("PhyRxBegin", oss.str (), MakeCallback (&YansWifiChannelFanOutTest::PhyRxBegin, this));
+      mobility->SetPosition (Vector (distances[i], 0.0, 0.0));
+      node->AggregateObject (mobility);
+      mac->SetAddress (Mac48Address::Allocate ());
+      dev->SetMac (mac);
+      dev->SetPhy (phy);
+      dev->SetRemoteStationManager (manager.Create<WifiRemoteStationManager> ());
+      node->AddDevice (dev);
+      devices.push_back (dev);
+      nodeIds.push_back (node->GetId ());
+    }
+  Simulator::Schedule (Seconds (1.0), &WifiNetDevice::Send, devices[0], Create<Packet> (100),
+                       devices[0]->GetBroadcast (), 1);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // the same delay for the same distance: in the order of the PHYs
+  const uint32_t expected[] = { 2, 4, 3, 1 };
+  NS_TEST_ASSERT_MSG_EQ (m_phys.size (), 4, "Not all the receivers reached");
+  for (uint32_t k = 0; k < 4; ++k)
+    {
+      uint32_t j = expected[k];
+      NS_TEST_ASSERT_MSG_EQ (m_phys[k], j, "Reception " << k << " out of order");
+      NS_TEST_ASSERT_MSG_EQ (m_contexts[k], nodeIds[j], "Reception " << k << " not in the context of its node");
+      // the frame is sent after a backoff: time the receptions from the first
+      Time delay = Seconds (distances[j] / 299792458.0) - Seconds (distances[expected[0]] / 299792458.0);
+      bool onTime = m_times[k] - m_times[0] == delay;
+      NS_TEST_ASSERT_MSG_EQ (onTime, true, "Reception " << k << " at " << m_times[k]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that a YansWifiChannel delivers the frames to the PHYs on the
+ * channel of the sender only, as the PHYs switch channel.
+ */
+class YansWifiChannelSwitchingTest : public TestCase
+{
+public:
+  YansWifiChannelSwitchingTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * Count the start of a reception
+   * \param context the index of the receiving PHY
+   * \param packet the packet received
+   */
+  void PhyRxBegin (std::string context, Ptr<const Packet> packet);
+
+  uint32_t m_received[3]; //!< receptions started by each PHY
+};
+
+YansWifiChannelSwitchingTest::YansWifiChannelSwitchingTest ()
+  : TestCase ("Check the PHYs reached by a YansWifiChannel as they switch channel")
+{
+}
+
+void
+YansWifiChannelSwitchingTest::PhyRxBegin (std::string context, Ptr<const Packet> packet)
+{
+  m_received[std::atoi (context.c_str ())]++;
+}
+
+void
+YansWifiChannelSwitchingTest::DoRun (void)
+{
+  ObjectFactory manager;
+  manager.SetTypeId ("ns3::ConstantRateWifiManager");
+  ObjectFactory macFactory;
+  macFactory.SetTypeId ("ns3::AdhocWifiMac");
+
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<FriisPropagationLossModel> ());
+
+  std::vector<Ptr<WifiNetDevice> > devices;
+  std::vector<Ptr<YansWifiPhy> > phys;
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      m_received[i] = 0;
+      Ptr<Node> node = CreateObject<Node> ();
+      Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+      Ptr<WifiMac> mac = macFactory.Create<WifiMac> ();
+      mac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+      phy->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+      phy->SetChannel (channel);
+      phy->SetDevice (dev);
+      phy->SetMobility (node);
+      phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+      std::ostringstream oss;
+      oss << i;
+      phy->TraceConnect ("PhyRxBegin", oss.str (), MakeCallback (&YansWifiChannelSwitchingTest::PhyRxBegin, this));
+      mobility->SetPosition (Vector (10.0 * i, 0.0, 0.0));
+      node->AggregateObject (mobility);
+      mac->SetAddress (Mac48Address::Allocate ());
+      dev->SetMac (mac);
+      dev->SetPhy (phy);
+      dev->SetRemoteStationManager (manager.Create<WifiRemoteStationManager> ());
+      node->AddDevice (dev);
+      devices.push_back (dev);
+      phys.push_back (phy);
+    }
+  // the last PHY starts on another channel, before it is initialized
+  phys[2]->SetChannelNumber (2);
+  // a frame on each channel, then the second PHY joins the last one
+  Simulator::Schedule (Seconds (1.0), &WifiNetDevice::Send, devices[0], Create<Packet> (100),
+                       devices[0]->GetBroadcast (), 1);
+  Simulator::Schedule (Seconds (1.5), &WifiNetDevice::Send, devices[2], Create<Packet> (100),
+                       devices[2]->GetBroadcast (), 1);
+  Simulator::Schedule (Seconds (2.0), &YansWifiPhy::SetChannelNumber, phys[1], 2);
+  Simulator::Schedule (Seconds (3.0), &WifiNetDevice::Send, devices[0], Create<Packet> (100),
+                       devices[0]->GetBroadcast (), 1);
+  Simulator::Schedule (Seconds (3.5), &WifiNetDevice::Send, devices[2], Create<Packet> (100),
+                       devices[2]->GetBroadcast (), 1);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // the second PHY receives the first frame on channel 1, the last one on
+  // channel 2, and no other PHY shares the channel of a sender
+  NS_TEST_ASSERT_MSG_EQ (m_received[0], 0, "Frame received on another channel");
+  NS_TEST_ASSERT_MSG_EQ (m_received[1], 2, "Frames not received on the channel of the sender");
+  NS_TEST_ASSERT_MSG_EQ (m_received[2], 0, "Frame received on another channel");
+}
+
 //-----------------------------------------------------------------------------
 class WifiTestSuite : public TestSuite
 {
@@ -490,6 +851,9 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new QosUtilsIsOldPacketTest, TestCase::QUICK);
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); // Bug 991
   AddTestCase (new Bug555TestCase, TestCase::QUICK); // Bug 555
+  AddTestCase (new YansWifiChannelSpatialIndexTest, TestCase::QUICK);
+  AddTestCase (new YansWifiChannelFanOutTest, TestCase::QUICK);
+  AddTestCase (new YansWifiChannelSwitchingTest, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite;
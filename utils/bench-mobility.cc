@@ -0,0 +1,300 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "ns3/core-module.h"
+#include "ns3/box.h"
+#include "ns3/obstacle-world.h"
+#include "ns3/obstacle-position-allocator.h"
+#include "ns3/mobility-model.h"
+
+using namespace ns3;
+
+// Minimum duration of each timed GetPosition loop (ms)
+int64_t g_minTime = 200;
+
+/**
+ * \return the number of bytes allocated on the heap, or 0 if unknown
+ */
+static uint64_t
+GetHeapInUse (void)
+{
+#ifdef __GLIBC__
+#if __GLIBC_PREREQ (2, 33)
+  // mallinfo2 reports in size_t, the int fields of mallinfo wrap past 2 GiB
+  struct mallinfo2 info = mallinfo2 ();
+  return info.uordblks + info.hblkhd;
+#else
+  struct mallinfo info = mallinfo ();
+  return static_cast<unsigned int> (info.uordblks) + static_cast<unsigned int> (info.hblkhd);
+#endif
+#else
+  return 0;
+#endif
+}
+
+/**
+ * A mobility model configuration swept by the benchmark.
+ */
+struct Model
+{
+  std::string name;       //!< name in the output
+  std::string typeId;     //!< TypeId of the model
+  std::string mode;       //!< "Mode" attribute of the model, if not empty
+};
+
+/**
+ * Measure the events scheduled, the GetPosition rate and the memory of a
+ * population of nodes moving among obstacles.
+ */
+class Bench
+{
+public:
+  Bench (double side, double height, Time duration, bool lazy, std::ostream &os)
+    : m_side (side),
+      m_height (height),
+      m_duration (duration),
+      m_lazy (lazy),
+      m_os (os)
+  {
+    m_rand = CreateObject<UniformRandomVariable> ();
+  }
+
+  void RunBench (const Model &model, uint32_t nNodes, uint32_t nObstacles);
+
+private:
+  Ptr<UniformRandomVariable> m_rand;
+  double m_side;
+  double m_height;
+  Time m_duration;
+  bool m_lazy;
+  std::ostream &m_os;
+};
+
+void
+Bench::RunBench (const Model &model, uint32_t nNodes, uint32_t nObstacles)
+{
+  // buildings scattered over a square area, below the top of the bounds
+  Box bounds (0.0, m_side, 0.0, m_side, 0.0, m_height);
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  for (uint32_t i = 0; i < nObstacles; ++i)
+    {
+      double x = m_rand->GetValue (0.0, m_side);
+      double y = m_rand->GetValue (0.0, m_side);
+      world->AddObstacle (Box (x, x + m_rand->GetValue (10.0, 30.0),
+                               y, y + m_rand->GetValue (10.0, 30.0),
+                               0.0, m_rand->GetValue (10.0, 0.8 * m_height)));
+    }
+
+  // drawing the positions indexes the obstacles, before the heap is
+  // measured
+  Ptr<ObstacleFreeBoxPositionAllocator> positions = CreateObject<ObstacleFreeBoxPositionAllocator> ();
+  positions->SetAttribute ("Bounds", BoxValue (bounds));
+  positions->SetAttribute ("Obstacles", PointerValue (world));
+  std::vector<Vector> starts;
+  starts.reserve (nNodes);
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      starts.push_back (positions->GetNext ());
+    }
+
+  ObjectFactory factory;
+  factory.SetTypeId (model.typeId);
+  factory.Set ("Bounds", BoxValue (bounds));
+  factory.Set ("Lazy", BooleanValue (m_lazy));
+  if (nObstacles > 0)
+    {
+      factory.Set ("Obstacles", PointerValue (world));
+    }
+  if (!model.mode.empty ())
+    {
+      factory.Set ("Mode", StringValue (model.mode));
+    }
+
+  SystemWallClockMs time;
+  std::vector<Ptr<MobilityModel> > models;
+  models.reserve (nNodes);
+  uint64_t heap = GetHeapInUse ();
+  time.Start ();
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      Ptr<MobilityModel> mobility = factory.Create<MobilityModel> ();
+      mobility->SetPosition (starts[i]);
+      mobility->Initialize ();
+      models.push_back (mobility);
+    }
+  int64_t init = time.End ();
+  uint64_t bytes = std::max (GetHeapInUse (), heap) - heap;
+
+  // event uids are sequential, so that the ones scheduled during the run
+  // lie between two markers; the stop event is not counted, but the
+  // events still pending at the end of the run are
+  EventId first = Simulator::Schedule (Seconds (0.0), &MobilityModel::GetPosition, models[0]);
+  Simulator::Stop (m_duration);
+  time.Start ();
+  Simulator::Run ();
+  int64_t run = time.End ();
+  EventId last = Simulator::Schedule (Seconds (0.0), &MobilityModel::GetPosition, models[0]);
+  uint64_t events = last.GetUid () - first.GetUid () - 2;
+
+  // GetPosition is repeated until it ran for at least g_minTime ms, since
+  // a single pass over few nodes is below the clock resolution; the mean
+  // altitude is written out so that the calls are not optimized away
+  uint64_t queries = 0;
+  int64_t query = 0;
+  double sum = 0.0;
+  time.Start ();
+  while (query < g_minTime)
+    {
+      for (uint32_t i = 0; i < nNodes; ++i)
+        {
+          sum += models[i]->GetPosition ().z;
+        }
+      queries += nNodes;
+      query = time.End ();
+    }
+
+  m_os << model.name << ","
+       << m_lazy << ","
+       << nNodes << ","
+       << nObstacles << ","
+       << m_duration.GetSeconds () << ","
+       << init << ","
+       << run << ","
+       << events << ",";
+  // a run below the clock resolution has no meaningful rate
+  if (run > 0)
+    {
+      m_os << events * 1000.0 / run;
+    }
+  m_os << ","
+       << queries * 1000.0 / query << ","
+       << bytes / nNodes << ","
+       << sum / queries
+       << std::endl;
+
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      models[i]->Dispose ();
+    }
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  std::string name = "all";
+  uint32_t minNodes = 1;
+  uint32_t maxNodes = 100000;
+  uint32_t minObstacles = 0;
+  uint32_t maxObstacles = 100000;
+  double side = 10000.0;
+  double height = 250.0;
+  double duration = 10.0;
+  bool lazy = false;
+  std::string output = "-";
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the 3D mobility models among obstacles.\n"
+             "\n"
+             "For each model, the number of nodes grows tenfold from --minNodes\n"
+             "to --maxNodes and the number of obstacles from --minObstacles to\n"
+             "--maxObstacles, 0 being followed by 10. The nodes start out of the\n"
+             "obstacles and move for --duration simulated seconds. One CSV line\n"
+             "is written per run, with the events scheduled per wall clock\n"
+             "second during the run (empty if it took less than 1 ms), the\n"
+             "GetPosition calls per second once it is over, the heap allocated\n"
+             "per node by the model (glibc only, 0 elsewhere) and the mean\n"
+             "altitude of the nodes. The models are RandomWalk3d-Distance,\n"
+             "RandomWalk3d-Time, RandomDirection3d and ObstacleGaussMarkov.");
+  cmd.AddValue ("model",        "model to run, or all (default all)",                 name);
+  cmd.AddValue ("minNodes",     "smallest number of nodes (default 1)",               minNodes);
+  cmd.AddValue ("maxNodes",     "largest number of nodes (default 1E5)",              maxNodes);
+  cmd.AddValue ("minObstacles", "smallest number of obstacles (default 0)",           minObstacles);
+  cmd.AddValue ("maxObstacles", "largest number of obstacles (default 1E5)",          maxObstacles);
+  cmd.AddValue ("side",         "side of the square area in m (default 1E4)",         side);
+  cmd.AddValue ("height",       "height of the area in m (default 250)",              height);
+  cmd.AddValue ("duration",     "simulated time of each run in s (default 10)",       duration);
+  cmd.AddValue ("lazy",         "set the Lazy attribute of the models (default 0)",   lazy);
+  cmd.AddValue ("time",         "minimum time of each GetPosition loop in ms (default 200)", g_minTime);
+  cmd.AddValue ("output",       "CSV file, or - for the standard output (default -)", output);
+  cmd.Parse (argc, argv);
+
+  std::vector<Model> models;
+  Model model;
+  model.name = "RandomWalk3d-Distance";
+  model.typeId = "ns3::RandomWalk3dMobilityModel";
+  model.mode = "Distance";
+  models.push_back (model);
+  model.name = "RandomWalk3d-Time";
+  model.mode = "Time";
+  models.push_back (model);
+  model.name = "RandomDirection3d";
+  model.typeId = "ns3::RandomDirection3dMobilityModel";
+  model.mode = "";
+  models.push_back (model);
+  model.name = "ObstacleGaussMarkov";
+  model.typeId = "ns3::ObstacleGaussMarkovMobilityModel";
+  models.push_back (model);
+
+  std::ofstream file;
+  if (output != "-")
+    {
+      file.open (output.c_str ());
+      if (!file.is_open ())
+        {
+          std::cerr << "Could not open " << output << std::endl;
+          return 1;
+        }
+    }
+  std::ostream &os = (output == "-") ? std::cout : file;
+
+  Bench bench (side, height, Seconds (duration), lazy, os);
+
+  os << "model,lazy,nodes,obstacles,duration_s,init_ms,run_ms,events_scheduled,"
+     << "scheduled_per_s,positions_per_s,bytes_per_node,mean_z" << std::endl;
+  bool found = false;
+  for (uint32_t m = 0; m < models.size (); ++m)
+    {
+      if (name != "all" && name != models[m].name)
+        {
+          continue;
+        }
+      found = true;
+      for (uint32_t n = std::max (minNodes, uint32_t (1)); n <= maxNodes; n *= 10)
+        {
+          for (uint32_t o = minObstacles; o <= maxObstacles; o = (o == 0) ? 10 : o * 10)
+            {
+              bench.RunBench (models[m], n, o);
+            }
+        }
+    }
+  if (!found)
+    {
+      std::cerr << "Unknown model " << name << std::endl;
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,189 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Nevada, Reno
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Paulo Regis <pregis@nevada.unr.edu>
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/box.h"
+#include "ns3/obstacle-world.h"
+
+using namespace ns3;
+
+#define LOG(x)   std::cout << x << std::endl
+
+// Output field width
+int g_fwidth = 14;
+// Minimum duration of each timed search loop (ms)
+int64_t g_minTime = 200;
+
+/**
+ * Compare the closest collision search of ObstacleWorld against the
+ * linear scan over Box::WillCollide done by the mobility models before
+ * the obstacles were indexed.
+ */
+class Bench
+{
+public:
+  Bench (uint32_t queries, double side)
+    : m_queries (queries),
+      m_side (side)
+  {
+    m_rand = CreateObject<UniformRandomVariable> ();
+  }
+
+  void RunBench (uint32_t nObstacles);
+
+private:
+  Ptr<UniformRandomVariable> m_rand;
+  uint32_t m_queries;
+  double m_side;
+};
+
+void
+Bench::RunBench (uint32_t nObstacles)
+{
+  // buildings scattered over a square area, up to 200 m tall
+  std::vector<Box> obstacles;
+  Ptr<ObstacleWorld> world = CreateObject<ObstacleWorld> ();
+  for (uint32_t i = 0; i < nObstacles; ++i)
+    {
+      double x = m_rand->GetValue (0.0, m_side);
+      double y = m_rand->GetValue (0.0, m_side);
+      Box box (x, x + m_rand->GetValue (10.0, 50.0),
+               y, y + m_rand->GetValue (10.0, 50.0),
+               0.0, m_rand->GetValue (10.0, 200.0));
+      obstacles.push_back (box);
+      world->AddObstacle (box);
+    }
+
+  // rays start above the tallest building, so that they are outside
+  // every obstacle, and point downwards
+  std::vector<Vector> positions;
+  std::vector<Vector> velocities;
+  for (uint32_t i = 0; i < m_queries; ++i)
+    {
+      positions.push_back (Vector (m_rand->GetValue (0.0, m_side), m_rand->GetValue (0.0, m_side), 250.0));
+      velocities.push_back (Vector (m_rand->GetValue (-20.0, 20.0), m_rand->GetValue (-20.0, 20.0), -1.0));
+    }
+  double maxDistance = 2 * m_side;
+
+  // each search is repeated until it ran for at least g_minTime ms,
+  // since a single pass over the indexed searches is below the clock
+  // resolution
+  SystemWallClockMs time;
+  uint32_t linearHits = 0;
+  uint64_t linearQueries = 0;
+  int64_t linear = 0;
+  time.Start ();
+  while (linear < g_minTime)
+    {
+      linearHits = 0;
+      for (uint32_t q = 0; q < m_queries; ++q)
+        {
+          double distance = maxDistance;
+          int closest = -1;
+          for (uint32_t i = 0; i < obstacles.size (); ++i)
+            {
+              Vector collision;
+              if (obstacles[i].WillCollide (positions[q], velocities[q], collision)
+                  && CalculateDistance (positions[q], collision) < distance)
+                {
+                  distance = CalculateDistance (positions[q], collision);
+                  closest = i;
+                }
+            }
+          linearHits += (closest != -1);
+        }
+      linearQueries += m_queries;
+      linear = time.End ();
+    }
+
+  // the first search builds the index, time it separately
+  time.Start ();
+  double distance = maxDistance;
+  world->FindClosestCollision (positions[0], velocities[0], distance);
+  int64_t build = time.End ();
+
+  uint32_t indexedHits = 0;
+  uint64_t indexedQueries = 0;
+  int64_t indexed = 0;
+  time.Start ();
+  while (indexed < g_minTime)
+    {
+      indexedHits = 0;
+      for (uint32_t q = 0; q < m_queries; ++q)
+        {
+          distance = maxDistance;
+          indexedHits += (world->FindClosestCollision (positions[q], velocities[q], distance) != -1);
+        }
+      indexedQueries += m_queries;
+      indexed = time.End ();
+    }
+
+  double linearRate = linearQueries * 1000.0 / linear;
+  double indexedRate = indexedQueries * 1000.0 / indexed;
+  LOG (std::left << std::setw (g_fwidth) << nObstacles <<
+       std::setw (g_fwidth) << linearRate <<
+       std::setw (g_fwidth) << build <<
+       std::setw (g_fwidth) << indexedRate <<
+       std::setw (g_fwidth) << (indexedRate / linearRate) <<
+       std::setw (g_fwidth) << linearHits <<
+       std::setw (g_fwidth) << indexedHits);
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t minObstacles = 10;
+  uint32_t maxObstacles = 100000;
+  uint32_t queries = 1000;
+  double side = 10000.0;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the closest obstacle search of ObstacleWorld.\n"
+             "\n"
+             "The number of obstacles grows tenfold from --min to --max,\n"
+             "and for each count the same rays are searched with a linear\n"
+             "scan over Box::WillCollide and with the ObstacleWorld index.\n"
+             "The linear scan also reports obstacles lying behind the ray\n"
+             "origin, so its hit count may be higher.");
+  cmd.AddValue ("min",     "smallest number of obstacles (default 10)",    minObstacles);
+  cmd.AddValue ("max",     "largest number of obstacles (default 1E5)",    maxObstacles);
+  cmd.AddValue ("queries", "number of searches per count (default 1000)",  queries);
+  cmd.AddValue ("side",    "side of the square area in m (default 1E4)",   side);
+  cmd.AddValue ("time",    "minimum time of each timed loop in ms (default 200)", g_minTime);
+  cmd.Parse (argc, argv);
+
+  Bench bench (queries, side);
+
+  LOG (std::left << std::setw (g_fwidth) << "Obstacles" <<
+       std::setw (g_fwidth) << "Linear (q/s)" <<
+       std::setw (g_fwidth) << "Build (ms)" <<
+       std::setw (g_fwidth) << "Indexed (q/s)" <<
+       std::setw (g_fwidth) << "Speedup" <<
+       std::setw (g_fwidth) << "Linear hits" <<
+       std::setw (g_fwidth) << "Indexed hits");
+  for (uint32_t n = minObstacles; n <= maxObstacles; n *= 10)
+    {
+      bench.RunBench (n);
+    }
+  return 0;
+}